@@ -4,16 +4,94 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../src/alarm.c \
+../src/ambient.c \
+../src/baro.c \
+../src/bmp180.c \
+../src/canbus.c \
+../src/cobs.c \
+../src/config.c \
+../src/console.c \
 ../src/cr_startup_lpc17.c \
-../src/main.c 
+../src/crc.c \
+../src/datalog.c \
+../src/derived.c \
+../src/export.c \
+../src/filter.c \
+../src/fmt.c \
+../src/forecast.c \
+../src/gpioint.c \
+../src/http.c \
+../src/htu21d.c \
+../src/main.c \
+../src/metric.c \
+../src/modbus.c \
+../src/net.c \
+../src/sensor.c \
+../src/telemetry.c \
+../src/uart0.c \
+../src/vibration.c \
+../src/window.c 
 
 OBJS += \
+./src/alarm.o \
+./src/ambient.o \
+./src/baro.o \
+./src/bmp180.o \
+./src/canbus.o \
+./src/cobs.o \
+./src/config.o \
+./src/console.o \
 ./src/cr_startup_lpc17.o \
-./src/main.o 
+./src/crc.o \
+./src/datalog.o \
+./src/derived.o \
+./src/export.o \
+./src/filter.o \
+./src/fmt.o \
+./src/forecast.o \
+./src/gpioint.o \
+./src/http.o \
+./src/htu21d.o \
+./src/main.o \
+./src/metric.o \
+./src/modbus.o \
+./src/net.o \
+./src/sensor.o \
+./src/telemetry.o \
+./src/uart0.o \
+./src/vibration.o \
+./src/window.o 
 
 C_DEPS += \
+./src/alarm.d \
+./src/ambient.d \
+./src/baro.d \
+./src/bmp180.d \
+./src/canbus.d \
+./src/cobs.d \
+./src/config.d \
+./src/console.d \
 ./src/cr_startup_lpc17.d \
-./src/main.d 
+./src/crc.d \
+./src/datalog.d \
+./src/derived.d \
+./src/export.d \
+./src/filter.d \
+./src/fmt.d \
+./src/forecast.d \
+./src/gpioint.d \
+./src/http.d \
+./src/htu21d.d \
+./src/main.d \
+./src/metric.d \
+./src/modbus.d \
+./src/net.d \
+./src/sensor.d \
+./src/telemetry.d \
+./src/uart0.d \
+./src/vibration.d \
+./src/window.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -15,6 +15,7 @@ C_SRCS += \
 ../src/pca9532.c \
 ../src/rgb.c \
 ../src/rotary.c \
+../src/spibus.c \
 ../src/temp.c \
 ../src/uart2.c 
 
@@ -30,6 +31,7 @@ OBJS += \
 ./src/pca9532.o \
 ./src/rgb.o \
 ./src/rotary.o \
+./src/spibus.o \
 ./src/temp.o \
 ./src/uart2.o 
 
@@ -45,6 +47,7 @@ C_DEPS += \
 ./src/pca9532.d \
 ./src/rgb.d \
 ./src/rotary.d \
+./src/spibus.d \
 ./src/temp.d \
 ./src/uart2.d 
 
@@ -24,12 +24,28 @@ typedef enum
     ACC_RANGE_4G,
 } acc_range_t;
 
+/* Axes taking part in level detection (acc_setLevelDetection) */
+#define ACC_DETECT_X 0x01
+#define ACC_DETECT_Y 0x02
+#define ACC_DETECT_Z 0x04
+
+/* Detection source register bits (acc_getDetectionSource): latched INT1
+   and the axes that crossed the level detection threshold */
+#define ACC_DETSRC_INT1 0x01
+#define ACC_DETSRC_LDZ  0x20
+#define ACC_DETSRC_LDY  0x40
+#define ACC_DETSRC_LDX  0x80
+
 
 void acc_init (void);
 
 void acc_read (int8_t *x, int8_t *y, int8_t *z);
+int acc_readBurst (int8_t *x, int8_t *y, int8_t *z);
 void acc_setRange(acc_range_t range);
 void acc_setMode(acc_mode_t mode);
+void acc_setLevelDetection(uint8_t threshold, uint8_t axes);
+void acc_clearInterrupts(void);
+int acc_getDetectionSource(uint8_t *source);
 
 
 
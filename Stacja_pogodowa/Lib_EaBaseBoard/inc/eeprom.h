@@ -12,6 +12,9 @@
 void eeprom_init (void);
 int16_t eeprom_read(uint8_t* buf, uint16_t offset, uint16_t len);
 int16_t eeprom_write(uint8_t* buf, uint16_t offset, uint16_t len);
+int16_t eeprom_batchWrite(uint8_t* buf, uint16_t offset, uint16_t len);
+int16_t eeprom_batchFlush(void);
+int16_t eeprom_sync(void);
 
 
 #endif /* end __EEPROM_H */
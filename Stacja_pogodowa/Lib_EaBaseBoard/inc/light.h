@@ -44,6 +44,7 @@ typedef enum
 void light_init (void);
 void light_enable (void);
 uint32_t light_read(void);
+int light_readLux(uint32_t* pLux);
 void light_setMode(light_mode_t mode);
 void light_setWidth(light_width_t width);
 void light_setRange(light_range_t newRange);
@@ -20,6 +20,7 @@ typedef enum
 
 
 void oled_init (void);
+void oled_setContrast(uint8_t contrast);
 void oled_putPixel(uint8_t x, uint8_t y, oled_color_t color);
 void oled_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, oled_color_t color);
 void oled_circle(uint8_t x0, uint8_t y0, uint8_t r, oled_color_t color);
@@ -15,6 +15,7 @@
 
 
 void rgb_init (void);
+void rgb_initLeds (uint8_t ledMask);
 void rgb_setLeds (uint8_t ledMask);
 
 
@@ -0,0 +1,41 @@
+/*****************************************************************************
+ *   spibus.h:  Header file for the shared SSP1 bus manager
+ *
+ *   Copyright(C) 2009, Embedded Artists AB
+ *   All rights reserved.
+ *
+******************************************************************************/
+#ifndef __SPIBUS_H
+#define __SPIBUS_H
+
+#include "lpc_types.h"
+
+/*
+ * Devices on SSP1 of the base board. The 7-segment display and the
+ * DataFlash share the P2.2 chip select.
+ */
+typedef enum {
+    SPIBUS_DEV_OLED,
+    SPIBUS_DEV_LED7SEG,
+    SPIBUS_DEV_FLASH,
+    SPIBUS_DEV_COUNT,
+    SPIBUS_DEV_NONE = SPIBUS_DEV_COUNT
+} spibus_dev_t;
+
+
+void spibus_init (void);
+Bool spibus_acquire(spibus_dev_t dev);
+void spibus_lock(spibus_dev_t dev);
+void spibus_transfer(const uint8_t *txbuf, uint8_t *rxbuf, uint32_t length);
+void spibus_release(void);
+void spibus_restart(void);
+void spibus_flush(void);
+Bool spibus_disturbed(void);
+spibus_dev_t spibus_owner(void);
+
+
+
+#endif /* end __SPIBUS_H */
+/****************************************************************************
+**                            End Of File
+*****************************************************************************/
@@ -58,6 +58,14 @@
 
 #define ACC_MCTL_MODE(m) ((m) << 0)
 #define ACC_MCTL_GLVL(g) ((g) << 2)
+#define ACC_MCTL_DRPD    0x40
+
+#define ACC_CTL1_XDA     0x08
+#define ACC_CTL1_YDA     0x10
+#define ACC_CTL1_ZDA     0x20
+
+#define ACC_INTRST_CLR1  0x01
+#define ACC_INTRST_CLR2  0x02
 
 
 #define ACC_STATUS_DRDY 0x01
@@ -110,6 +118,37 @@ static int I2CWrite(uint8_t addr, uint8_t* buf, uint32_t len)
 }
 
 
+/*
+ * Write the register address and read len bytes in one transaction
+ * (repeated start). The register address auto-increments.
+ */
+static int I2CReadRegs(uint8_t addr, uint8_t reg, uint8_t* buf, uint32_t len)
+{
+	I2C_M_SETUP_Type setup;
+
+	setup.sl_addr7bit = addr;
+	setup.tx_data = &reg;
+	setup.tx_length = 1;
+	setup.rx_data = buf;
+	setup.rx_length = len;
+	setup.retransmissions_max = 3;
+
+	if (I2C_MasterTransferData(I2CDEV, &setup, I2C_TRANSFER_POLLING) == SUCCESS){
+		return (0);
+	} else {
+		return (-1);
+	}
+}
+
+static void writeReg(uint8_t reg, uint8_t data)
+{
+    uint8_t buf[2];
+
+    buf[0] = reg;
+    buf[1] = data;
+    I2CWrite(ACC_I2C_ADDR, buf, 2);
+}
+
 static uint8_t getStatus(void)
 {
     uint8_t buf[1];
@@ -178,32 +217,43 @@ void acc_init (void)
  *****************************************************************************/
 void acc_read (int8_t *x, int8_t *y, int8_t *z)
 {
-    uint8_t buf[1];
-
     /* wait for ready flag */
     while ((getStatus() & ACC_STATUS_DRDY) == 0);
 
-    /*
-     * Have experienced problems reading all registers
-     * at once. Change to reading them one-by-one.
-     */
-    buf[0] = ACC_ADDR_XOUT8;
-    I2CWrite(ACC_I2C_ADDR, buf, 1);
-    I2CRead(ACC_I2C_ADDR, buf, 1);
-
-    *x = (int8_t)buf[0];
+    acc_readBurst(x, y, z);
+}
 
-    buf[0] = ACC_ADDR_YOUT8;
-    I2CWrite(ACC_I2C_ADDR, buf, 1);
-    I2CRead(ACC_I2C_ADDR, buf, 1);
+/******************************************************************************
+ *
+ * Description:
+ *    Read accelerometer data for all three axes in one I2C transaction,
+ *    without waiting for the data ready flag. The earlier problems with
+ *    reading all registers at once came from a STOP condition between the
+ *    address write and the read; a repeated start reads the 8-bit outputs
+ *    with auto-increment.
+ *
+ * Params:
+ *   [out] x - read x value
+ *   [out] y - read y value
+ *   [out] z - read z value
+ *
+ * Returns:
+ *   0 on success, -1 if the sensor did not acknowledge
+ *
+ *****************************************************************************/
+int acc_readBurst (int8_t *x, int8_t *y, int8_t *z)
+{
+    uint8_t buf[3];
 
-    *y = (int8_t)buf[0];
+    if (I2CReadRegs(ACC_I2C_ADDR, ACC_ADDR_XOUT8, buf, 3) != 0) {
+        return -1;
+    }
 
-    buf[0] = ACC_ADDR_ZOUT8;
-    I2CWrite(ACC_I2C_ADDR, buf, 1);
-    I2CRead(ACC_I2C_ADDR, buf, 1);
+    *x = (int8_t)buf[0];
+    *y = (int8_t)buf[1];
+    *z = (int8_t)buf[2];
 
-    *z = (int8_t)buf[0];
+    return 0;
 }
 
 /******************************************************************************
@@ -248,3 +298,76 @@ void acc_setMode(acc_mode_t mode)
     setModeControl(mctl);
 }
 
+/******************************************************************************
+ *
+ * Description:
+ *    Configure level detection on INT1. The absolute value of acceleration
+ *    on any of the selected axes above the threshold sets INT1 high until
+ *    acc_clearInterrupts is called. In level detection mode the sensor
+ *    measures in the 8g range. Data ready is no longer routed to INT1.
+ *    Level detection starts with acc_setMode(ACC_MODE_LEVEL).
+ *
+ * Params:
+ *   [in] threshold - threshold in units of 1/16 g, 0 - 127
+ *   [in] axes      - axes taking part in detection (ACC_DETECT_x mask)
+ *
+ *****************************************************************************/
+void acc_setLevelDetection(uint8_t threshold, uint8_t axes)
+{
+    uint8_t ctl1 = 0;
+
+    /* INTPIN = 0, INTREG = 00: level detection on INT1, absolute threshold */
+    if ((axes & ACC_DETECT_X) == 0) {
+        ctl1 |= ACC_CTL1_XDA;
+    }
+    if ((axes & ACC_DETECT_Y) == 0) {
+        ctl1 |= ACC_CTL1_YDA;
+    }
+    if ((axes & ACC_DETECT_Z) == 0) {
+        ctl1 |= ACC_CTL1_ZDA;
+    }
+
+    writeReg(ACC_ADDR_CTL1, ctl1);
+    writeReg(ACC_ADDR_CTL2, 0x00); /* OR of the selected axes */
+    writeReg(ACC_ADDR_LDTH, threshold & 0x7f);
+
+    setModeControl(getModeControl() | ACC_MCTL_DRPD);
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Clear the latched INT1 and INT2 detection interrupts
+ *
+ *****************************************************************************/
+void acc_clearInterrupts(void)
+{
+    writeReg(ACC_ADDR_INTRST, ACC_INTRST_CLR1 | ACC_INTRST_CLR2);
+    writeReg(ACC_ADDR_INTRST, 0x00);
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Get the detection source register
+ *
+ * Params:
+ *   [out] source - DETSRC register: LDX, LDY, LDZ, PDX, PDY, PDZ, INT2,
+ *                  INT1 (bit 7 - 0), unchanged on error
+ *
+ * Returns:
+ *   0 on success, -1 if the sensor did not acknowledge
+ *
+ *****************************************************************************/
+int acc_getDetectionSource(uint8_t *source)
+{
+    uint8_t buf[1];
+
+    if (I2CReadRegs(ACC_I2C_ADDR, ACC_ADDR_DETSRC, buf, 1) != 0) {
+        return -1;
+    }
+
+    *source = buf[0];
+
+    return 0;
+}
@@ -39,6 +39,21 @@
 #define EEPROM_BLOCK_SIZE  256
 #define EEPROM_PAGE_SIZE    16
 
+/*
+ * Max number of address probes while waiting for the internal write cycle.
+ * One probe takes ~100 us at 100 kHz, the 24LC08 write cycle is max 5 ms.
+ */
+#define EEPROM_POLL_MAX    100
+
+/* Number of pages which can be staged by eeprom_batchWrite before a flush */
+#define EEPROM_BATCH_PAGES   8
+
+typedef struct
+{
+    uint16_t page;
+    uint16_t dirty;
+    uint8_t data[EEPROM_PAGE_SIZE];
+} eeprom_page_t;
 
 /******************************************************************************
  * External global variables
@@ -48,29 +63,16 @@
  * Local variables
  *****************************************************************************/
 
+/* I2C address of the block with a write cycle in progress, 0 if none */
+static uint8_t pendingAddr = 0;
+
+static eeprom_page_t batch[EEPROM_BATCH_PAGES];
+static uint8_t batchUsed = 0;
 
 /******************************************************************************
  * Local Functions
  *****************************************************************************/
 
-static int I2CRead(uint8_t addr, uint8_t* buf, uint32_t len)
-{
-	I2C_M_SETUP_Type rxsetup;
-
-	rxsetup.sl_addr7bit = addr;
-	rxsetup.tx_data = NULL;	// Get address to read at writing address
-	rxsetup.tx_length = 0;
-	rxsetup.rx_data = buf;
-	rxsetup.rx_length = len;
-	rxsetup.retransmissions_max = 3;
-
-	if (I2C_MasterTransferData(I2CDEV, &rxsetup, I2C_TRANSFER_POLLING) == SUCCESS){
-		return (0);
-	} else {
-		return (-1);
-	}
-}
-
 static int I2CWrite(uint8_t addr, uint8_t* buf, uint32_t len)
 {
 	I2C_M_SETUP_Type txsetup;
@@ -90,11 +92,117 @@ static int I2CWrite(uint8_t addr, uint8_t* buf, uint32_t len)
 }
 
 
-static void eepromDelay(void)
+static int I2CWriteRead(uint8_t addr, uint8_t* txBuf, uint32_t txLen,
+        uint8_t* rxBuf, uint32_t rxLen)
 {
-    volatile int i = 0;
+	I2C_M_SETUP_Type setup;
 
-    for (i = 0; i <0x20000; i++);
+	setup.sl_addr7bit = addr;
+	setup.tx_data = txBuf;
+	setup.tx_length = txLen;
+	setup.rx_data = rxBuf;	// Read after a repeated start
+	setup.rx_length = rxLen;
+	setup.retransmissions_max = 3;
+
+	if (I2C_MasterTransferData(I2CDEV, &setup, I2C_TRANSFER_POLLING) == SUCCESS){
+		return (0);
+	} else {
+		return (-1);
+	}
+}
+
+/*
+ * Acknowledge polling. The device does not acknowledge its address while
+ * the internal write cycle is in progress, so keep probing with a single
+ * byte read until it does.
+ */
+static int eepromWaitReady(void)
+{
+    I2C_M_SETUP_Type setup;
+    uint8_t dummy;
+    int i = 0;
+
+    if (pendingAddr == 0) {
+        return 0;
+    }
+
+    setup.sl_addr7bit = pendingAddr;
+    setup.tx_data = NULL;
+    setup.tx_length = 0;
+    setup.rx_data = &dummy;
+    setup.rx_length = 1;
+    setup.retransmissions_max = 0;
+
+    for (i = 0; i < EEPROM_POLL_MAX; i++) {
+        if (I2C_MasterTransferData(I2CDEV, &setup, I2C_TRANSFER_POLLING) == SUCCESS) {
+            pendingAddr = 0;
+            return 0;
+        }
+    }
+
+    pendingAddr = 0;
+    return -1;
+}
+
+/*
+ * Write one page (or a part of it). The write cycle is not waited for here,
+ * it is polled for before the next access to the device.
+ */
+static int eepromPageWrite(uint16_t offset, uint8_t* buf, uint16_t len)
+{
+    uint8_t addr = EEPROM_I2C_ADDR1 + (offset/EEPROM_BLOCK_SIZE);
+    uint8_t tmp[EEPROM_PAGE_SIZE+1];
+
+    if (eepromWaitReady() != 0) {
+        return -1;
+    }
+
+    tmp[0] = offset % EEPROM_BLOCK_SIZE;
+    memcpy(&tmp[1], buf, len);
+
+    if (I2CWrite(addr, tmp, len+1) != 0) {
+        return -1;
+    }
+
+    pendingAddr = addr;
+
+    return 0;
+}
+
+static int eepromFlushPage(eeprom_page_t* pg)
+{
+    uint8_t tmp[EEPROM_PAGE_SIZE];
+    uint16_t base = pg->page * EEPROM_PAGE_SIZE;
+    uint16_t range = 0;
+    int first = 0;
+    int last = EEPROM_PAGE_SIZE - 1;
+    int i = 0;
+
+    while (first < EEPROM_PAGE_SIZE && !(pg->dirty & (1 << first))) {
+        first++;
+    }
+    while (last > first && !(pg->dirty & (1 << last))) {
+        last--;
+    }
+
+    if (first == EEPROM_PAGE_SIZE) {
+        return 0;
+    }
+
+    /* fill the gaps between dirty bytes with the current content */
+    range = ((1 << (last + 1)) - 1) & ~((1 << first) - 1);
+    if ((pg->dirty & range) != range) {
+        if (eeprom_read(tmp, base + first, last - first + 1) < 0) {
+            return -1;
+        }
+        for (i = first; i <= last; i++) {
+            if (!(pg->dirty & (1 << i))) {
+                pg->data[i] = tmp[i - first];
+            }
+        }
+    }
+
+    return eepromPageWrite(base + first, &pg->data[first], last - first + 1);
 }
 
 /******************************************************************************
@@ -129,22 +237,34 @@ void eeprom_init (void)
 int16_t eeprom_read(uint8_t* buf, uint16_t offset, uint16_t len)
 {
     uint8_t addr = 0;
-    int i = 0;
-
-    uint16_t off = offset;
+    uint8_t off = 0;
+    uint16_t rLen = 0;
+    int16_t read = 0;
 
     if (len > EEPROM_TOTAL_SIZE || offset+len > EEPROM_TOTAL_SIZE) {
         return -1;
     }
 
-    addr = EEPROM_I2C_ADDR1 + (offset/EEPROM_BLOCK_SIZE);
-    off = offset % EEPROM_BLOCK_SIZE;
+    if (eepromWaitReady() != 0) {
+        return -1;
+    }
+
+    /* the word address wraps within a block, so read block by block */
+    while (len) {
+        addr = EEPROM_I2C_ADDR1 + (offset/EEPROM_BLOCK_SIZE);
+        off = offset % EEPROM_BLOCK_SIZE;
+        rLen = MIN(EEPROM_BLOCK_SIZE - off, len);
 
-    I2CWrite((addr), (uint8_t*)&off, 1);
-    for ( i = 0; i < 0x2000; i++);
-    I2CRead((addr), buf, len);
+        if (I2CWriteRead(addr, &off, 1, &buf[read], rLen) != 0) {
+            return -1;
+        }
 
-    return len;
+        len    -= rLen;
+        read   += rLen;
+        offset += rLen;
+    }
+
+    return read;
 
 }
 
@@ -164,38 +284,129 @@ int16_t eeprom_read(uint8_t* buf, uint16_t offset, uint16_t len)
  *****************************************************************************/
 int16_t eeprom_write(uint8_t* buf, uint16_t offset, uint16_t len)
 {
-    uint8_t addr = 0;
     int16_t written = 0;
     uint16_t wLen = 0;
-    uint16_t off = offset;
-    uint8_t tmp[17];
 
     if (len > EEPROM_TOTAL_SIZE || offset+len > EEPROM_TOTAL_SIZE) {
         return -1;
     }
 
-    addr = EEPROM_I2C_ADDR1 + (offset/EEPROM_BLOCK_SIZE);
-    off = offset % EEPROM_BLOCK_SIZE;
-    wLen = ((((off >> 4) + 1) << 4) - off);
+    wLen = EEPROM_PAGE_SIZE - (offset % EEPROM_PAGE_SIZE);
     wLen = MIN(wLen, len);
 
     while (len) {
-        tmp[0] = off;
-        memcpy(&tmp[1], (void*)&buf[written], wLen);
-        I2CWrite((addr), tmp, wLen+1);
-
-        /* delay to wait for a write cycle */
-        eepromDelay();
+        if (eepromPageWrite(offset, &buf[written], wLen) != 0) {
+            return -1;
+        }
 
         len     -= wLen;
         written += wLen;
-        off  += wLen;
+        offset  += wLen;
 
         wLen = MIN(EEPROM_PAGE_SIZE, len);
-
-        addr += off / EEPROM_BLOCK_SIZE;
-        off  = off % EEPROM_BLOCK_SIZE;
     }
 
     return written;
 }
+
+/******************************************************************************
+ *
+ * Description:
+ *    Stage data for writing to the EEPROM. Staged bytes are collected per
+ *    16-byte page and written with eeprom_batchFlush, one page write per
+ *    touched page. The batch is flushed automatically when it runs out of
+ *    free pages.
+ *
+ * Params:
+ *   [in] buf - data to write
+ *   [in] offset - offset to start to write to
+ *   [in] len - number of bytes to write
+ *
+ * Returns:
+ *   number of staged bytes or -1 in case of an error
+ *
+ *****************************************************************************/
+int16_t eeprom_batchWrite(uint8_t* buf, uint16_t offset, uint16_t len)
+{
+    uint16_t page = 0;
+    uint8_t pos = 0;
+    int16_t staged = 0;
+    int i = 0;
+
+    if (len > EEPROM_TOTAL_SIZE || offset+len > EEPROM_TOTAL_SIZE) {
+        return -1;
+    }
+
+    while (len) {
+        page = offset / EEPROM_PAGE_SIZE;
+        pos = offset % EEPROM_PAGE_SIZE;
+
+        for (i = 0; i < batchUsed; i++) {
+            if (batch[i].page == page) {
+                break;
+            }
+        }
+
+        if (i == batchUsed) {
+            if (batchUsed == EEPROM_BATCH_PAGES) {
+                if (eeprom_batchFlush() < 0) {
+                    return -1;
+                }
+                i = 0;
+            }
+            batch[i].page = page;
+            batch[i].dirty = 0;
+            batchUsed++;
+        }
+
+        batch[i].data[pos] = buf[staged];
+        batch[i].dirty |= (1 << pos);
+
+        len--;
+        staged++;
+        offset++;
+    }
+
+    return staged;
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Write all data staged with eeprom_batchWrite to the EEPROM
+ *
+ * Returns:
+ *   number of page writes or -1 in case of an error
+ *
+ *****************************************************************************/
+int16_t eeprom_batchFlush(void)
+{
+    int16_t pages = 0;
+    int i = 0;
+
+    for (i = 0; i < batchUsed; i++) {
+        if (eepromFlushPage(&batch[i]) != 0) {
+            batchUsed = 0;
+            return -1;
+        }
+        pages++;
+    }
+
+    batchUsed = 0;
+
+    return pages;
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Wait for the last write cycle to complete
+ *
+ * Returns:
+ *   0 on success or -1 if the device did not respond
+ *
+ *****************************************************************************/
+int16_t eeprom_sync(void)
+{
+    return eepromWaitReady();
+}
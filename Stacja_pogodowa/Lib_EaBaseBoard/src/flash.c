@@ -17,7 +17,7 @@
  *****************************************************************************/
 
 #include "lpc17xx_gpio.h"
-#include "lpc17xx_ssp.h"
+#include "spibus.h"
 #include "flash.h"
 
 /******************************************************************************
@@ -28,8 +28,9 @@
 #define MIN(x, y) ((x) < (y) ? (x) : (y))
 #endif
 
-#define FLASH_CS_OFF() GPIO_SetValue(2, 1<<2);
-#define FLASH_CS_ON()  GPIO_ClearValue( 2, 1<<2 )
+/* chip select (P2.2, shared with the 7-segment display) is driven by spibus */
+#define FLASH_CS_OFF() spibus_release()
+#define FLASH_CS_ON()  flashSelect()
 
 
 #define FLASH_CMD_RDID      0x9F        /* read device ID */
@@ -96,24 +97,34 @@ static struct _flash_info flash_devices[] = {
 
 static void SSPSend(uint8_t *buf, uint32_t Length)
 {
-    SSP_DATA_SETUP_Type xferConfig;
-
-	xferConfig.tx_data = buf;
-	xferConfig.rx_data = NULL;
-	xferConfig.length  = Length;
+    spibus_transfer(buf, NULL, Length);
+}
 
-    SSP_ReadWrite(LPC_SSP1, &xferConfig, SSP_TRANSFER_POLLING);
+static void SSPReceive( uint8_t *buf, uint32_t Length )
+{
+    spibus_transfer(NULL, buf, Length);
 }
 
-void SSPReceive( uint8_t *buf, uint32_t Length )
+/*
+ * Take the bus for the flash. The 7-segment display shares the chip select,
+ * so the flash sees its data as single byte commands. The only one that
+ * matters is "deep power down" (0xB9 is also a 7-segment pattern); the bus
+ * manager reports it and a "resume" command is sent first in that case.
+ */
+static void flashSelect(void)
 {
-    SSP_DATA_SETUP_Type xferConfig;
+    uint8_t cmd = FLASH_CMD_RES;
+    int i = 0;
+
+    spibus_lock(SPIBUS_DEV_FLASH);
 
-	xferConfig.tx_data = NULL;
-	xferConfig.rx_data = buf;
-	xferConfig.length  = Length;
+    if (spibus_disturbed()) {
+        SSPSend(&cmd, 1);
+        spibus_restart();
 
-    SSP_ReadWrite(LPC_SSP1, &xferConfig, SSP_TRANSFER_POLLING);
+        /* tRES, time to leave deep power down */
+        for (i = 0; i < 0x400; i++);
+    }
 }
 
 static void exitDeepPowerDown(void)
@@ -213,9 +224,6 @@ uint32_t flash_init (void)
     int i = 0;
 
 
-    GPIO_SetDir(2, 1<<2, 1);
-    FLASH_CS_OFF();
-
     exitDeepPowerDown();
     readDeviceId(deviceId);
 
@@ -7,8 +7,8 @@
  ******************************************************************************/
 
 /*
- * NOTE: SPI must have been initialized before calling any functions in
- * this file.
+ * NOTE: The SPI bus manager (spibus) must have been initialized before
+ * calling any functions in this file.
  *
  */
 
@@ -18,16 +18,13 @@
 
 
 #include "lpc17xx_gpio.h"
-#include "lpc17xx_ssp.h"
+#include "spibus.h"
 #include "led7seg.h"
 
 /******************************************************************************
  * Defines and typedefs
  *****************************************************************************/
 
-#define LED7_CS_OFF() GPIO_SetValue( 2, (1<<2) )
-#define LED7_CS_ON()  GPIO_ClearValue( 2, (1<<2) )
-
 
 /******************************************************************************
  * External global variables
@@ -84,9 +81,7 @@ static uint8_t chars[] = {
  *****************************************************************************/
 void led7seg_init (void)
 {
-    //GPIO_SetDir( 2, 2, 1 );
-	GPIO_SetDir( 2, (1<<2), 1 );
-    LED7_CS_OFF();
+    /* chip select (P2.2) is set up by spibus_init */
 }
 
 /******************************************************************************
@@ -105,9 +100,6 @@ void led7seg_init (void)
 void led7seg_setChar(uint8_t ch, uint32_t rawMode)
 {
     uint8_t val = 0xff;
-    SSP_DATA_SETUP_Type xferConfig;
-
-   // LED7_CS_ON();
 
     if (ch >= '-' && ch <= '|') {
         val = chars[ch-'-'];
@@ -117,15 +109,8 @@ void led7seg_setChar(uint8_t ch, uint32_t rawMode)
         val = ch;
     }
 
-	xferConfig.tx_data = &val;
-	xferConfig.rx_data = NULL;
-	xferConfig.length = 1;
-
-
-    LED7_CS_ON();
-    //SSP_SendData(LPC_SSP1, val);
-    SSP_ReadWrite(LPC_SSP1, &xferConfig, SSP_TRANSFER_POLLING);
-
-    LED7_CS_OFF();
+    spibus_lock(SPIBUS_DEV_LED7SEG);
+    spibus_transfer(&val, NULL, 1);
+    spibus_release();
 }
 
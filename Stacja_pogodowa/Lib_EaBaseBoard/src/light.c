@@ -177,19 +177,42 @@ void light_enable (void)
  *
  *****************************************************************************/
 uint32_t light_read(void)
+{
+    uint32_t lux = 0;
+
+    light_readLux(&lux);
+
+    return lux;
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Read sensor value and check that the sensor responded
+ *
+ * Params:
+ *    [out] pLux - read light sensor value (in units of Lux)
+ *
+ * Returns:
+ *      0 on success, -1 if the sensor did not acknowledge
+ *
+ *****************************************************************************/
+int light_readLux(uint32_t* pLux)
 {
     uint32_t data = 0;
     uint8_t buf[1];
 
     buf[0] = ADDR_LSB_SENSOR;
-    I2CWrite(LIGHT_I2C_ADDR, buf, 1);
-    I2CRead(LIGHT_I2C_ADDR, buf, 1);
+    if (I2CWrite(LIGHT_I2C_ADDR, buf, 1) != 0 || I2CRead(LIGHT_I2C_ADDR, buf, 1) != 0) {
+        return -1;
+    }
 
     data = buf[0];
 
     buf[0] = ADDR_MSB_SENSOR;
-    I2CWrite(LIGHT_I2C_ADDR, buf, 1);
-    I2CRead(LIGHT_I2C_ADDR, buf, 1);
+    if (I2CWrite(LIGHT_I2C_ADDR, buf, 1) != 0 || I2CRead(LIGHT_I2C_ADDR, buf, 1) != 0) {
+        return -1;
+    }
 
     data = (buf[0] << 8 | data);
 
@@ -197,7 +220,9 @@ uint32_t light_read(void)
     /* Rext = 100k */
     /* E = (range(k) * DATA)  / 2^n */
 
-    return (range*data / width);
+    *pLux = range*data / width;
+
+    return 0;
 }
 
 /******************************************************************************
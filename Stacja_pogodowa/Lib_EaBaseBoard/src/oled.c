@@ -20,7 +20,7 @@
 #include <string.h>
 #include "lpc17xx_gpio.h"
 #include "lpc17xx_i2c.h"
-#include "lpc17xx_ssp.h"
+#include "spibus.h"
 #include "oled.h"
 #include "font5x7.h"
 
@@ -35,8 +35,7 @@
 #define OLED_I2C_ADDR (0x3c)
 #else
 
-#define OLED_CS_OFF() GPIO_SetValue( 0, (1<<6) )
-#define OLED_CS_ON()  GPIO_ClearValue( 0, (1<<6) )
+/* chip select (P0.6) is driven by the SPI bus manager */
 #define OLED_DATA()   GPIO_SetValue( 2, (1<<7) )
 #define OLED_CMD()    GPIO_ClearValue( 2, (1<<7) )
 
@@ -123,18 +122,10 @@ writeCommand(uint8_t data)
     I2CWrite(OLED_I2C_ADDR, buf, 2);
 
 #else
-    SSP_DATA_SETUP_Type xferConfig;
+    spibus_lock(SPIBUS_DEV_OLED);
     OLED_CMD();
-    OLED_CS_ON();
-
-	xferConfig.tx_data = &data;
-	xferConfig.rx_data = NULL;
-	xferConfig.length  = 1;
-
-    SSP_ReadWrite(LPC_SSP1, &xferConfig, SSP_TRANSFER_POLLING);
-    //SSPSend( (uint8_t *)&data, 1 );
-
-    OLED_CS_OFF();
+    spibus_transfer(&data, NULL, 1);
+    spibus_release();
 #endif
 }
 
@@ -160,18 +151,10 @@ writeData(uint8_t data)
 
 
 #else
-    SSP_DATA_SETUP_Type xferConfig;
+    spibus_lock(SPIBUS_DEV_OLED);
     OLED_DATA();
-    OLED_CS_ON();
-
-	xferConfig.tx_data = &data;
-	xferConfig.rx_data = NULL;
-	xferConfig.length  = 1;
-
-    SSP_ReadWrite(LPC_SSP1, &xferConfig, SSP_TRANSFER_POLLING);
-    //SSPSend( (uint8_t *)&data, 1 );
-
-    OLED_CS_OFF();
+    spibus_transfer(&data, NULL, 1);
+    spibus_release();
 #endif
 }
 
@@ -205,24 +188,15 @@ writeDataLen(unsigned char data, unsigned int len)
 #else
     int i;
     uint8_t buf[140];
-    SSP_DATA_SETUP_Type xferConfig;
 
     for (i = 0; i < len; i++) {
         buf[i] = data;
     }
 
+    spibus_lock(SPIBUS_DEV_OLED);
     OLED_DATA();
-    OLED_CS_ON();
-
-	xferConfig.tx_data = buf;
-	xferConfig.rx_data = NULL;
-	xferConfig.length  = len;
-
-    SSP_ReadWrite(LPC_SSP1, &xferConfig, SSP_TRANSFER_POLLING);
-
-    //SSPSend( (uint8_t *)buf, len );
-
-    OLED_CS_OFF();
+    spibus_transfer(buf, NULL, len);
+    spibus_release();
 #endif
 }
 
@@ -359,16 +333,14 @@ void oled_init (void)
     //GPIO_SetDir(PORT0, 0, 1);
     GPIO_SetDir(2, (1<<1), 1);
     GPIO_SetDir(2, (1<<7), 1);
-    GPIO_SetDir(0, (1<<6), 1);
 
     /* make sure power is off */
     GPIO_ClearValue( 2, (1<<1) );
 
 #ifdef OLED_USE_I2C
+    GPIO_SetDir(0, (1<<6), 1);
     GPIO_ClearValue( 2, (1<<7)); // D/C#
     GPIO_ClearValue( 0, (1<<6)); // CS#
-#else
-    OLED_CS_OFF();
 #endif
 
     runInitSequence();
@@ -382,6 +354,21 @@ void oled_init (void)
     GPIO_SetValue( 2, (1<<1) );
 }
 
+/******************************************************************************
+ *
+ * Description:
+ *    Set the display contrast (brightness). The init sequence uses 0x32.
+ *
+ * Params:
+ *   [in] contrast - contrast value, 0x00 - 0xFF
+ *
+ *****************************************************************************/
+void oled_setContrast(uint8_t contrast)
+{
+    writeCommand(0x81);//(set contrast control register)
+    writeCommand(contrast);
+}
+
 /******************************************************************************
  *
  * Description:
@@ -25,6 +25,9 @@
  * Local variables
  *****************************************************************************/
 
+/* LEDs controlled by this driver, the others keep their pin untouched */
+static uint8_t enabledLeds = 0;
+
 /******************************************************************************
  * Local Functions
  *****************************************************************************/
@@ -41,10 +44,32 @@
  *****************************************************************************/
 void rgb_init (void)
 {
-    GPIO_SetDir( 2, 1, 1 );
-    GPIO_SetDir( 0, (1<<26), 1 );
-    GPIO_SetDir( 2, (1<<1), 1 );
+    rgb_initLeds(RGB_RED | RGB_BLUE | RGB_GREEN);
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Initialize only some of the LEDs. Use this when the pins of the other
+ *    LEDs are used for other functions (P2.0 - TXD1, P2.1 - OLED power).
+ *
+ * Params:
+ *    [in]  ledMask  - The LEDs to control
+ *
+ *****************************************************************************/
+void rgb_initLeds (uint8_t ledMask)
+{
+    enabledLeds = ledMask;
 
+    if ((ledMask & RGB_RED) != 0) {
+        GPIO_SetDir( 2, 1, 1 );
+    }
+    if ((ledMask & RGB_BLUE) != 0) {
+        GPIO_SetDir( 0, (1<<26), 1 );
+    }
+    if ((ledMask & RGB_GREEN) != 0) {
+        GPIO_SetDir( 2, (1<<1), 1 );
+    }
 }
 
 
@@ -54,27 +79,34 @@ void rgb_init (void)
  *    Set LED states
  *
  * Params:
- *    [in]  ledMask  - The mask is used to turn LEDs on or off
+ *    [in]  ledMask  - The mask is used to turn LEDs on or off. LEDs that
+ *                     were not initialized are left alone.
  *
  *****************************************************************************/
 void rgb_setLeds (uint8_t ledMask)
 {
-    if ((ledMask & RGB_RED) != 0) {
-        GPIO_SetValue( 2, 1);
-    } else {
-        GPIO_ClearValue( 2, 1 );
+    if ((enabledLeds & RGB_RED) != 0) {
+        if ((ledMask & RGB_RED) != 0) {
+            GPIO_SetValue( 2, 1);
+        } else {
+            GPIO_ClearValue( 2, 1 );
+        }
     }
 
-    if ((ledMask & RGB_BLUE) != 0) {
-        GPIO_SetValue( 0, (1<<26) );
-    } else {
-        GPIO_ClearValue( 0, (1<<26) );
+    if ((enabledLeds & RGB_BLUE) != 0) {
+        if ((ledMask & RGB_BLUE) != 0) {
+            GPIO_SetValue( 0, (1<<26) );
+        } else {
+            GPIO_ClearValue( 0, (1<<26) );
+        }
     }
 
-    if ((ledMask & RGB_GREEN) != 0) {
-        GPIO_SetValue( 2, (1<<1) );
-    } else {
-        GPIO_ClearValue( 2, (1<<1) );
+    if ((enabledLeds & RGB_GREEN) != 0) {
+        if ((ledMask & RGB_GREEN) != 0) {
+            GPIO_SetValue( 2, (1<<1) );
+        } else {
+            GPIO_ClearValue( 2, (1<<1) );
+        }
     }
 
 }
@@ -0,0 +1,441 @@
+/*****************************************************************************
+ *   spibus.c:  Manager for the SSP1 bus shared by the OLED display, the
+ *              7-segment display and the SPI DataFlash
+ *
+ *   Copyright(C) 2009, Embedded Artists AB
+ *   All rights reserved.
+ *
+ ******************************************************************************/
+
+/*
+ * NOTE: All access to SSP1 and to the chip selects of its devices must go
+ * through this module. A client acquires the bus for one device, does any
+ * number of transfers (all under a single chip select assertion) and then
+ * releases the bus.
+ *
+ * spibus_acquire() never blocks, so a client that completes its transfer
+ * from an interrupt (e.g. DMA) may keep the bus until then and call
+ * spibus_release() from the interrupt handler. spibus_lock() spins until
+ * the bus is free and must only be used from the main loop.
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "LPC17xx.h"
+#include "lpc17xx_gpio.h"
+#include "lpc17xx_pinsel.h"
+#include "lpc17xx_ssp.h"
+#include "spibus.h"
+
+/******************************************************************************
+ * Defines and typedefs
+ *****************************************************************************/
+
+#define SSPDEV LPC_SSP1
+
+/*
+ * Chip select is left asserted on release. Back-to-back transactions for
+ * the device then cost no chip select toggling or reconfiguration. The chip
+ * select is deasserted as soon as another device takes the bus.
+ */
+#define FLAG_KEEP_CS  0x01
+
+/*
+ * Device is a shift register that latches on the rising chip select edge.
+ * The last byte written to it is shifted in again after any other device
+ * on the same chip select has used the bus.
+ */
+#define FLAG_LATCH    0x02
+
+/*
+ * No command byte puts the device into a state it has to be brought back
+ * from (see sleepCmd)
+ */
+#define NO_CMD        (-1)
+
+typedef struct
+{
+    uint8_t csPort;
+    uint32_t csMask;
+    uint32_t clockRate;
+    uint32_t cpol;
+    uint32_t cpha;
+    uint8_t flags;
+    /* first byte of a foreign transaction on the shared chip select that
+       the device takes as a command it has to recover from, or NO_CMD */
+    int16_t sleepCmd;
+} spibus_cfg_t;
+
+/******************************************************************************
+ * Local variables
+ *****************************************************************************/
+
+static const spibus_cfg_t devices[SPIBUS_DEV_COUNT] = {
+    /* OLED (SSD1305, 250 ns min. clock cycle), CS P0.6 */
+    {0, (1<<6), 4000000, SSP_CPOL_HI, SSP_CPHA_FIRST, FLAG_KEEP_CS, NO_CMD},
+    /* 7-segment display (74HC595), CS P2.2 */
+    {2, (1<<2), 1000000, SSP_CPOL_HI, SSP_CPHA_FIRST, FLAG_LATCH, NO_CMD},
+    /* AT45DB DataFlash, CS P2.2, 0xB9 - deep power down */
+    {2, (1<<2), 10000000, SSP_CPOL_HI, SSP_CPHA_FIRST, 0, 0xB9},
+};
+
+/* register values for each device, computed once by the SSP driver */
+static uint32_t devCr0[SPIBUS_DEV_COUNT];
+static uint32_t devCpsr[SPIBUS_DEV_COUNT];
+
+static volatile spibus_dev_t owner = SPIBUS_DEV_NONE;
+static spibus_dev_t parked = SPIBUS_DEV_NONE;
+static spibus_dev_t configured = SPIBUS_DEV_NONE;
+
+/* another device has sent the sleep command of this one */
+static Bool disturbed[SPIBUS_DEV_COUNT];
+
+/* the next byte sent by the owner starts a command (chip select edge) */
+static Bool commandStart = FALSE;
+
+static uint8_t latchValue = 0xFF;
+static Bool latchValid = FALSE;
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+static void csOn(spibus_dev_t dev)
+{
+    GPIO_ClearValue(devices[dev].csPort, devices[dev].csMask);
+    commandStart = TRUE;
+}
+
+/*
+ * Every other device on the chip select of dev sees the first byte of the
+ * transaction as a command. Only the one that takes it as its sleep
+ * command is marked, so the usual 7-segment traffic costs the flash no
+ * resume.
+ */
+static void markDisturbed(spibus_dev_t dev, uint8_t cmd)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < SPIBUS_DEV_COUNT; i++) {
+        if (i != dev
+                && devices[i].sleepCmd == (int16_t)cmd
+                && devices[i].csPort == devices[dev].csPort
+                && devices[i].csMask == devices[dev].csMask)
+        {
+            disturbed[i] = TRUE;
+        }
+    }
+}
+
+static void csOff(spibus_dev_t dev)
+{
+    GPIO_SetValue(devices[dev].csPort, devices[dev].csMask);
+}
+
+static void configure(spibus_dev_t dev)
+{
+    if (configured == dev) {
+        return;
+    }
+
+    SSPDEV->CR1 &= ~SSP_CR1_SSP_EN;
+    SSPDEV->CR0 = devCr0[dev];
+    SSPDEV->CPSR = devCpsr[dev];
+    SSPDEV->CR1 |= SSP_CR1_SSP_EN;
+
+    configured = dev;
+}
+
+/*
+ * Shift the last 7-segment value in again after it was overwritten by a
+ * transaction for another device on the shared chip select.
+ */
+static void restoreLatch(spibus_dev_t released)
+{
+    uint32_t i = 0;
+
+    if (!latchValid) {
+        return;
+    }
+
+    for (i = 0; i < SPIBUS_DEV_COUNT; i++) {
+        if ((devices[i].flags & FLAG_LATCH) != 0
+                && i != released
+                && devices[i].csPort == devices[released].csPort
+                && devices[i].csMask == devices[released].csMask)
+        {
+            configure((spibus_dev_t)i);
+            csOn((spibus_dev_t)i);
+            SSP_WriteStream(SSPDEV, &latchValue, 1);
+            markDisturbed((spibus_dev_t)i, latchValue);
+            csOff((spibus_dev_t)i);
+            disturbed[i] = FALSE;
+        }
+    }
+}
+
+/******************************************************************************
+ * Public Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ *
+ * Description:
+ *    Initialize SSP1 and the chip selects of all devices on the bus
+ *
+ *    P0.7 - SCK, P0.8 - MISO, P0.9 - MOSI, P0.6 and P2.2 - chip selects
+ *    (GPIO)
+ *
+ *****************************************************************************/
+void spibus_init (void)
+{
+    SSP_CFG_Type sspCfg;
+    PINSEL_CFG_Type PinCfg;
+    uint32_t i = 0;
+
+    PinCfg.Funcnum = 2;
+    PinCfg.OpenDrain = 0;
+    PinCfg.Pinmode = 0;
+    PinCfg.Portnum = 0;
+    PinCfg.Pinnum = 7;
+    PINSEL_ConfigPin(&PinCfg);
+    PinCfg.Pinnum = 8;
+    PINSEL_ConfigPin(&PinCfg);
+    PinCfg.Pinnum = 9;
+    PINSEL_ConfigPin(&PinCfg);
+    PinCfg.Funcnum = 0;
+    PinCfg.Pinnum = 6;
+    PINSEL_ConfigPin(&PinCfg);
+    PinCfg.Portnum = 2;
+    PinCfg.Pinnum = 2;
+    PINSEL_ConfigPin(&PinCfg);
+
+    for (i = 0; i < SPIBUS_DEV_COUNT; i++) {
+        GPIO_SetDir(devices[i].csPort, devices[i].csMask, 1);
+        csOff((spibus_dev_t)i);
+        disturbed[i] = FALSE;
+
+        /* let the driver work out the clock dividers, keep the result */
+        SSP_ConfigStructInit(&sspCfg);
+        sspCfg.ClockRate = devices[i].clockRate;
+        sspCfg.CPOL = devices[i].cpol;
+        sspCfg.CPHA = devices[i].cpha;
+        SSP_Init(SSPDEV, &sspCfg);
+        devCr0[i] = SSPDEV->CR0;
+        devCpsr[i] = SSPDEV->CPSR;
+    }
+
+    configured = (spibus_dev_t)(SPIBUS_DEV_COUNT - 1);
+    owner = SPIBUS_DEV_NONE;
+    parked = SPIBUS_DEV_NONE;
+
+    SSP_Cmd(SSPDEV, ENABLE);
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Try to take the bus for a device and assert its chip select
+ *
+ * Params:
+ *   [in] dev - the device
+ *
+ * Returns:
+ *   TRUE if the bus was free, FALSE if another transaction is in progress
+ *
+ *****************************************************************************/
+Bool spibus_acquire(spibus_dev_t dev)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (owner != SPIBUS_DEV_NONE) {
+        __set_PRIMASK(primask);
+        return FALSE;
+    }
+    owner = dev;
+    __set_PRIMASK(primask);
+
+    if (parked != SPIBUS_DEV_NONE && parked != dev) {
+        csOff(parked);
+        parked = SPIBUS_DEV_NONE;
+    }
+
+    configure(dev);
+
+    if (parked == dev) {
+        /* chip select still asserted from the previous transaction */
+        parked = SPIBUS_DEV_NONE;
+    }
+    else {
+        csOn(dev);
+    }
+
+    return TRUE;
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Wait for the bus and take it for a device. Not for use in interrupt
+ *    handlers.
+ *
+ * Params:
+ *   [in] dev - the device
+ *
+ *****************************************************************************/
+void spibus_lock(spibus_dev_t dev)
+{
+    while (!spibus_acquire(dev));
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Polled transfer with the current owner. Either buffer may be NULL
+ *    (0xFF is sent when txbuf is NULL). Without rxbuf the data is streamed
+ *    with the TX FIFO kept full, close to the SPI line rate.
+ *
+ * Params:
+ *   [in] txbuf - data to send
+ *   [in] rxbuf - received data
+ *   [in] length - number of bytes
+ *
+ *****************************************************************************/
+void spibus_transfer(const uint8_t *txbuf, uint8_t *rxbuf, uint32_t length)
+{
+    SSP_DATA_SETUP_Type xferConfig;
+
+    if (owner == SPIBUS_DEV_NONE || length == 0) {
+        return;
+    }
+
+    if (commandStart) {
+        markDisturbed(owner, (txbuf != NULL) ? txbuf[0] : 0xFF);
+        commandStart = FALSE;
+    }
+
+    if (rxbuf == NULL && txbuf != NULL) {
+        SSP_WriteStream(SSPDEV, txbuf, length);
+    }
+    else {
+        xferConfig.tx_data = (void*)txbuf;
+        xferConfig.rx_data = rxbuf;
+        xferConfig.length  = length;
+
+        SSP_ReadWrite(SSPDEV, &xferConfig, SSP_TRANSFER_POLLING);
+    }
+
+    if ((devices[owner].flags & FLAG_LATCH) != 0 && txbuf != NULL) {
+        latchValue = txbuf[length - 1];
+        latchValid = TRUE;
+    }
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    End the transaction of the current owner and free the bus. May be
+ *    called from an interrupt handler.
+ *
+ *****************************************************************************/
+void spibus_release(void)
+{
+    spibus_dev_t dev = owner;
+
+    if (dev == SPIBUS_DEV_NONE) {
+        return;
+    }
+
+    while ((SSPDEV->SR & SSP_SR_BSY) != 0);
+
+    if ((devices[dev].flags & FLAG_KEEP_CS) != 0) {
+        parked = dev;
+    }
+    else {
+        csOff(dev);
+        restoreLatch(dev);
+    }
+
+    owner = SPIBUS_DEV_NONE;
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Deassert a chip select left asserted by a FLAG_KEEP_CS device, e.g. at
+ *    the end of a display refresh
+ *
+ *****************************************************************************/
+void spibus_flush(void)
+{
+    spibus_dev_t dev = parked;
+
+    if (dev == SPIBUS_DEV_NONE || !spibus_acquire(dev)) {
+        return;
+    }
+
+    csOff(dev);
+    owner = SPIBUS_DEV_NONE;
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Check (and clear) whether another device on the same chip select has
+ *    started a transaction with the sleep command of the current owner
+ *    since it last checked. The owner can then bring itself back to a
+ *    known state; other foreign traffic is ignored by the device.
+ *
+ * Returns:
+ *   TRUE if the sleep command was sent in the meantime
+ *
+ *****************************************************************************/
+Bool spibus_disturbed(void)
+{
+    Bool result = FALSE;
+
+    if (owner == SPIBUS_DEV_NONE) {
+        return FALSE;
+    }
+
+    result = disturbed[owner];
+    disturbed[owner] = FALSE;
+
+    return result;
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Pulse the chip select of the current owner to terminate a command
+ *    without giving up the bus
+ *
+ *****************************************************************************/
+void spibus_restart(void)
+{
+    if (owner == SPIBUS_DEV_NONE) {
+        return;
+    }
+
+    while ((SSPDEV->SR & SSP_SR_BSY) != 0);
+
+    csOff(owner);
+    csOn(owner);
+}
+
+/******************************************************************************
+ *
+ * Description:
+ *    Get the current owner of the bus
+ *
+ * Returns:
+ *   The device or SPIBUS_DEV_NONE
+ *
+ *****************************************************************************/
+spibus_dev_t spibus_owner(void)
+{
+    return owner;
+}
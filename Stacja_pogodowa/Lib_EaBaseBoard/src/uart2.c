@@ -15,6 +15,8 @@
  * Includes
  *****************************************************************************/
 
+#include <string.h>
+
 #include "lpc17xx_i2c.h"
 #include "lpc17xx_uart.h"
 #include "lpc17xx_gpio.h"
@@ -38,6 +40,9 @@
 #define R_LSR 0x05
 #define R_MSR 0x06
 
+#define R_TXLVL  0x08
+#define R_RXLVL  0x09
+
 #define R_IOCTRL 0x0E
 #define R_EFCR   0x0F
 
@@ -51,6 +56,13 @@
 #define LSR_THRE	0x20
 #define LSR_RDR		0x01
 
+#define FCR_FIFO_EN     0x01
+#define FCR_RX_RESET    0x02
+#define FCR_TX_RESET    0x04
+
+/* TX and RX FIFO depth of the SC16IS752 */
+#define FIFO_SIZE 64
+
 /******************************************************************************
  * External global variables
  *****************************************************************************/
@@ -65,24 +77,6 @@ static uint8_t channel = 0;
  * Local Functions
  *****************************************************************************/
 
-static int I2CRead(uint8_t addr, uint8_t* buf, uint32_t len)
-{
-	I2C_M_SETUP_Type rxsetup;
-
-	rxsetup.sl_addr7bit = addr;
-	rxsetup.tx_data = NULL;	// Get address to read at writing address
-	rxsetup.tx_length = 0;
-	rxsetup.rx_data = buf;
-	rxsetup.rx_length = len;
-	rxsetup.retransmissions_max = 3;
-
-	if (I2C_MasterTransferData(I2CDEV, &rxsetup, I2C_TRANSFER_POLLING) == SUCCESS){
-		return (0);
-	} else {
-		return (-1);
-	}
-}
-
 static int I2CWrite(uint8_t addr, uint8_t* buf, uint32_t len)
 {
 	I2C_M_SETUP_Type txsetup;
@@ -101,6 +95,29 @@ static int I2CWrite(uint8_t addr, uint8_t* buf, uint32_t len)
 	}
 }
 
+/*
+ * Write the register address and read back len bytes in a single transfer
+ * (repeated start).
+ */
+static int I2CWriteRead(uint8_t addr, uint8_t* txbuf, uint32_t txlen,
+        uint8_t* rxbuf, uint32_t rxlen)
+{
+	I2C_M_SETUP_Type setup;
+
+	setup.sl_addr7bit = addr;
+	setup.tx_data = txbuf;
+	setup.tx_length = txlen;
+	setup.rx_data = rxbuf;
+	setup.rx_length = rxlen;
+	setup.retransmissions_max = 3;
+
+	if (I2C_MasterTransferData(I2CDEV, &setup, I2C_TRANSFER_POLLING) == SUCCESS){
+		return (0);
+	} else {
+		return (-1);
+	}
+}
+
 static void writeReg(uint8_t reg, uint8_t data)
 {
     uint8_t buf[2];
@@ -115,12 +132,38 @@ static uint8_t readReg(uint8_t reg)
     uint8_t buf[1];
 
     buf[0] = SUB_ADDR(channel, reg);
-    I2CWrite(UART2_ADDR, buf, 1);
-    I2CRead(UART2_ADDR, buf, 1);
+    I2CWriteRead(UART2_ADDR, buf, 1, buf, 1);
 
     return buf[0];
 }
 
+/*
+ * Write len (at most FIFO_SIZE) bytes to THR in one I2C transaction. The
+ * sub-address does not auto-increment for THR, every data byte goes into
+ * the TX FIFO.
+ */
+static void writeFifo(uint8_t* data, uint32_t len)
+{
+    uint8_t buf[FIFO_SIZE + 1];
+    uint32_t i = 0;
+
+    buf[0] = SUB_ADDR(channel, R_THR);
+    for (i = 0; i < len; i++) {
+        buf[i + 1] = data[i];
+    }
+    I2CWrite(UART2_ADDR, buf, len + 1);
+}
+
+/*
+ * Read len (at most FIFO_SIZE) bytes from RHR in one I2C transaction.
+ */
+static void readFifo(uint8_t* data, uint32_t len)
+{
+    uint8_t reg = SUB_ADDR(channel, R_RHR);
+
+    I2CWriteRead(UART2_ADDR, &reg, 1, data, len);
+}
+
 
 /******************************************************************************
  * Public Functions
@@ -148,6 +191,9 @@ void uart2_init (uint32_t baudRate, uart2_channel_t chan)
 
     channel = chan;
     uart2_setBaudRate(baudRate);
+
+    /* enable and reset the 64 byte FIFOs, used by the burst transfers */
+    writeReg(R_FCR, FCR_FIFO_EN | FCR_RX_RESET | FCR_TX_RESET);
 }
 
 /******************************************************************************
@@ -197,6 +243,8 @@ void uart2_setBaudRate(uint32_t baudRate)
  *****************************************************************************/
 void uart2_send(uint8_t *buffer, uint32_t length)
 {
+    uint32_t space = 0;
+
     if (!buffer) {
         /* error */
         return;
@@ -204,13 +252,26 @@ void uart2_send(uint8_t *buffer, uint32_t length)
 
     while ( length != 0 )
     {
-        /* THRE status, contain valid data */
-        while ( !(readReg(R_LSR) & LSR_THRE) );
+        /*
+         * One TXLVL read tells how much space is left in the FIFO, then
+         * that many bytes are written in a single burst.
+         */
+        space = readReg(R_TXLVL);
+        if (space == 0) {
+            continue;
+        }
 
-        writeReg(R_THR, *buffer);
+        if (space > length) {
+            space = length;
+        }
+        if (space > FIFO_SIZE) {
+            space = FIFO_SIZE;
+        }
 
-        buffer++;
-        length--;
+        writeFifo(buffer, space);
+
+        buffer += space;
+        length -= space;
     }
     return;
 }
@@ -231,14 +292,7 @@ void uart2_sendString(uint8_t *string)
         return;
     }
 
-    while ( *string != '\0' )
-    {
-        /* THRE status, contain valid data */
-        while ( !(readReg(R_LSR) & LSR_THRE) );
-        writeReg(R_THR, *string);
-
-        string++;
-    }
+    uart2_send(string, strlen((char*)string));
 
     return;
 }
@@ -258,33 +312,31 @@ uint32_t uart2_receive(uint8_t *buffer, uint32_t length, uint32_t blocking)
 {
     uint32_t recvd = 0;
     uint32_t toRecv = length;
-
-    if (blocking) {
-
-        while (toRecv) {
-            /* wait for data */
-            while (!(readReg(R_LSR) & LSR_RDR));
-
-            *buffer++ = readReg(R_RHR);
-
-            recvd++;
-            toRecv--;
+    uint32_t level = 0;
+
+    while (toRecv) {
+        /* one RXLVL read, then everything available in a single burst */
+        level = readReg(R_RXLVL);
+        if (level == 0) {
+            if (blocking) {
+                continue;
+            }
+            /* break if no data */
+            break;
         }
 
-    }
-    else {
-
-        while (toRecv) {
-            /* break if no data */
-            if (!(readReg(R_LSR) & LSR_RDR)) {
-                break;
-            }
+        if (level > toRecv) {
+            level = toRecv;
+        }
+        if (level > FIFO_SIZE) {
+            level = FIFO_SIZE;
+        }
 
-            *buffer++ = readReg(R_RHR);
+        readFifo(buffer, level);
 
-            recvd++;
-            toRecv--;
-        }
+        buffer += level;
+        recvd += level;
+        toRecv -= level;
     }
 
     return recvd;
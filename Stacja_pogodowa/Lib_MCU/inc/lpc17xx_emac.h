@@ -63,6 +63,7 @@ extern "C"
 #define EMAC_MODE_10M_HALF			(2)		/**< 10Mbps HalfDuplex mode */
 #define EMAC_MODE_100M_FULL			(3)		/**< 100Mbps FullDuplex mode */
 #define EMAC_MODE_100M_HALF			(4)		/**< 100Mbps HalfDuplex mode */
+#define EMAC_MODE_AUTO_NOWAIT		(5)		/**< Auto-negotiation mode, link is checked later by EMAC_PollPHYLink() */
 
 /**
  * @}
@@ -485,6 +486,12 @@ EMAC_RINFO_LEN_ERR   | EMAC_RINFO_ALIGN_ERR | EMAC_RINFO_OVERRUN)
 
 #define EMAC_DEF_ADR    0x0100      /**< Default PHY device address        */
 #define EMAC_DP83848C_ID         0x20005C90  /**< PHY Identifier                    */
+#define EMAC_LAN8720_ID          0x0007C0F0  /**< LAN8720 PHY Identifier (LPCXpresso) */
+
+/** LAN8720 PHY Special Control/Status Register and its speed indication field */
+#define EMAC_PHY_REG_LAN_SCSR    0x1F
+#define EMAC_PHY_LAN_SCSR_100    (1<<3)
+#define EMAC_PHY_LAN_SCSR_FD     (1<<4)
 
 #define EMAC_PHY_SR_100_SPEED		((1<<14)|(1<<13))
 #define EMAC_PHY_SR_FULL_DUP		((1<<14)|(1<<12))
@@ -641,6 +648,7 @@ typedef struct {
 											- EMAC_MODE_10M_HALF
 											- EMAC_MODE_100M_FULL
 											- EMAC_MODE_100M_HALF
+											- EMAC_MODE_AUTO_NOWAIT
 											*/
 	uint8_t 	*pbEMAC_Addr;				/**< Pointer to EMAC Station address that contains 6-bytes
 											of MAC address, it must be sorted in order (bEMAC_Addr[0]..[5])
@@ -665,6 +673,7 @@ void EMAC_DeInit(void);
 int32_t EMAC_CheckPHYStatus(uint32_t ulPHYState);
 int32_t EMAC_SetPHYMode(uint32_t ulPHYMode);
 int32_t EMAC_UpdatePHYStatus(void);
+int32_t EMAC_PollPHYLink(void);
 
 /* Filter functions ----------*/
 void EMAC_SetHashFilter(uint8_t dstMAC_addr[], FunctionalState NewState);
@@ -673,6 +682,9 @@ void EMAC_SetFilterMode(uint32_t ulFilterMode, FunctionalState NewState);
 /* EMAC Packet Buffer functions */
 void EMAC_WritePacketBuffer(EMAC_PACKETBUF_Type *pDataStruct);
 void EMAC_ReadPacketBuffer(EMAC_PACKETBUF_Type *pDataStruct);
+uint8_t *EMAC_GetTxBuffer(void);
+void EMAC_CommitTxBuffer(uint32_t ulDataLen);
+uint8_t *EMAC_GetRxBuffer(void);
 
 /* EMAC Interrupt functions -------*/
 void EMAC_IntCmd(uint32_t ulIntType, FunctionalState NewState);
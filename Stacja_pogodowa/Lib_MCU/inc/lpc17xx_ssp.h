@@ -443,6 +443,7 @@ void SSP_SendData(LPC_SSP_TypeDef* SSPx, uint16_t Data);
 uint16_t SSP_ReceiveData(LPC_SSP_TypeDef* SSPx);
 int32_t SSP_ReadWrite (LPC_SSP_TypeDef *SSPx, SSP_DATA_SETUP_Type *dataCfg, \
 						SSP_TRANSFER_Type xfType);
+uint32_t SSP_WriteStream (LPC_SSP_TypeDef *SSPx, const void *txbuf, uint32_t length);
 
 /* SSP IRQ function ------------------------------------------------------------*/
 void SSP_IntConfig(LPC_SSP_TypeDef *SSPx, uint32_t IntType, FunctionalState NewState);
@@ -1340,6 +1340,9 @@ CAN_ERROR CAN_RemoveEntry(AFLUT_ENTRY_Type EntryType, uint16_t position)
 Status CAN_SendMsg (LPC_CAN_TypeDef *CANx, CAN_MSG_Type *CAN_Msg)
 {
 	uint32_t data;
+	/* In Self Test mode the frame must be sent with Self Reception Request,
+	 * otherwise it is not received back by the own controller */
+	uint32_t txCmd = (CANx->MOD & CAN_MOD_STM) ? CAN_CMR_SRR : CAN_CMR_TR;
 	CHECK_PARAM(PARAM_CANx(CANx));
 	CHECK_PARAM(PARAM_ID_FORMAT(CAN_Msg->format));
 	if(CAN_Msg->format==STD_ID_FORMAT)
@@ -1390,7 +1393,7 @@ Status CAN_SendMsg (LPC_CAN_TypeDef *CANx, CAN_MSG_Type *CAN_Msg)
 		CANx->TDB1 = data;
 
 		 /*Write transmission request*/
-		 CANx->CMR = 0x21;
+		 CANx->CMR = txCmd | CAN_CMR_STB1;
 		 return SUCCESS;
 	}
 	//check status of Transmit Buffer 2
@@ -1430,7 +1433,7 @@ Status CAN_SendMsg (LPC_CAN_TypeDef *CANx, CAN_MSG_Type *CAN_Msg)
 		CANx->TDB2 = data;
 
 		/*Write transmission request*/
-		CANx->CMR = 0x41;
+		CANx->CMR = txCmd | CAN_CMR_STB2;
 		return SUCCESS;
 	}
 	//check status of Transmit Buffer 3
@@ -1470,7 +1473,7 @@ Status CAN_SendMsg (LPC_CAN_TypeDef *CANx, CAN_MSG_Type *CAN_Msg)
 		CANx->TDB3 = data;
 
 		/*Write transmission request*/
-		CANx->CMR = 0x81;
+		CANx->CMR = txCmd | CAN_CMR_STB3;
 		return SUCCESS;
 	}
 	else
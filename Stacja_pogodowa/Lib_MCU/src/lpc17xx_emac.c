@@ -80,6 +80,9 @@ static uint32_t rx_buf[EMAC_NUM_RX_FRAG][EMAC_ETH_MAX_FLEN>>2];
 /** Tx buffer data */
 static uint32_t tx_buf[EMAC_NUM_TX_FRAG][EMAC_ETH_MAX_FLEN>>2];
 
+/** Identifier of the detected PHY device */
+static uint32_t phy_id;
+
 /**
  * @}
  */
@@ -465,7 +468,12 @@ int32_t EMAC_CheckPHYStatus(uint32_t ulPHYState)
  * 							- EMAC_MODE_10M_HALF
  * 							- EMAC_MODE_100M_FULL
  * 							- EMAC_MODE_100M_HALF
+ * 							- EMAC_MODE_AUTO_NOWAIT
  * @return		Return (0) if no error, otherwise return (-1)
+ *
+ * Note: EMAC_MODE_AUTO_NOWAIT only starts auto-negotiation and returns
+ * without waiting for the link, the EMAC is configured by EMAC_PollPHYLink()
+ * once the link comes up.
  **********************************************************************/
 int32_t EMAC_SetPHYMode(uint32_t ulPHYMode)
 {
@@ -476,7 +484,8 @@ int32_t EMAC_SetPHYMode(uint32_t ulPHYMode)
 	id2 = read_PHY (EMAC_PHY_REG_IDR2);
 
 #ifdef MCB_LPC_1768
-	if (((id1 << 16) | (id2 & 0xFFF0)) == EMAC_DP83848C_ID) {
+	phy_id = (id1 << 16) | (id2 & 0xFFF0);
+	if ((phy_id == EMAC_DP83848C_ID) || (phy_id == EMAC_LAN8720_ID)) {
 		switch(ulPHYMode){
 		case EMAC_MODE_AUTO:
 			write_PHY (EMAC_PHY_REG_BMCR, EMAC_PHY_AUTO_NEG);
@@ -502,6 +511,10 @@ int32_t EMAC_SetPHYMode(uint32_t ulPHYMode)
 				}
 			}
 			break;
+		case EMAC_MODE_AUTO_NOWAIT:
+			/* Start Auto_Negotiation, do not wait for the link */
+			write_PHY (EMAC_PHY_REG_BMCR, EMAC_PHY_AUTO_NEG);
+			return (0);
 		case EMAC_MODE_10M_FULL:
 			/* Connect at 10MBit full-duplex */
 			write_PHY (EMAC_PHY_REG_BMCR, EMAC_PHY_FULLD_10M);
@@ -554,6 +567,28 @@ int32_t EMAC_UpdatePHYStatus(void)
 
 	/* Check the link status. */
 #ifdef MCB_LPC_1768
+	if (phy_id == EMAC_LAN8720_ID) {
+		/* LAN8720 has no DP83848C Status Register, use BMSR and SCSR */
+		for (tout = EMAC_PHY_RESP_TOUT; tout; tout--) {
+			if (read_PHY (EMAC_PHY_REG_BMSR) & EMAC_PHY_BMSR_LINK_STATUS) {
+				break;
+			}
+			if (tout == 1){
+				return (-1);
+			}
+		}
+		regv = read_PHY (EMAC_PHY_REG_LAN_SCSR);
+		if (regv & EMAC_PHY_LAN_SCSR_FD) {
+			LPC_EMAC->MAC2    |= EMAC_MAC2_FULL_DUP;
+			LPC_EMAC->Command |= EMAC_CR_FULL_DUP;
+			LPC_EMAC->IPGT     = EMAC_IPGT_FULL_DUP;
+		} else {
+			LPC_EMAC->IPGT = EMAC_IPGT_HALF_DUP;
+		}
+		LPC_EMAC->SUPP = (regv & EMAC_PHY_LAN_SCSR_100) ? EMAC_SUPP_SPEED : 0;
+		return (0);
+	}
+
 	for (tout = EMAC_PHY_RESP_TOUT; tout; tout--) {
 		regv = read_PHY (EMAC_PHY_REG_STS);
 		if (regv & EMAC_PHY_SR_LINK) {
@@ -620,6 +655,37 @@ int32_t EMAC_UpdatePHYStatus(void)
 }
 
 
+/*********************************************************************//**
+ * @brief		Check the PHY link without waiting and configure the EMAC
+ * 				speed and duplex mode when the link is up
+ * @param[in]	None
+ * @return		1 if link is up, 0 if link is down or auto-negotiation is
+ * 				not complete, (-1) if the PHY does not respond
+ *
+ * Note: Reads BMSR once, so it can be called periodically from the main
+ * loop after EMAC_Init() with EMAC_MODE_AUTO_NOWAIT.
+ **********************************************************************/
+int32_t EMAC_PollPHYLink(void)
+{
+	int32_t regv;
+
+	regv = read_PHY (EMAC_PHY_REG_BMSR);
+	if (regv < 0) {
+		return (-1);
+	}
+	if (!(regv & EMAC_PHY_BMSR_LINK_STATUS) || !(regv & EMAC_PHY_BMSR_AUTO_DONE)) {
+		return (0);
+	}
+
+	/* Link is on, status read by EMAC_UpdatePHYStatus() returns at once */
+	if (EMAC_UpdatePHYStatus() < 0) {
+		return (-1);
+	}
+
+	return (1);
+}
+
+
 /*********************************************************************//**
  * @brief		Enable/Disable hash filter functionality for specified destination
  * 				MAC address in EMAC module
@@ -773,6 +839,44 @@ void EMAC_ReadPacketBuffer(EMAC_PACKETBUF_Type *pDataStruct)
 	}
 }
 
+/*********************************************************************//**
+ * @brief		Get pointer to Tx packet data buffer at current index due to
+ * 				TxProduceIndex, so that a frame can be built in place without
+ * 				copying. Caller must check EMAC_CheckTransmitIndex() first.
+ * @param[in]	None
+ * @return		Pointer to word-aligned buffer of EMAC_ETH_MAX_FLEN bytes
+ **********************************************************************/
+uint8_t *EMAC_GetTxBuffer(void)
+{
+	return (uint8_t *)Tx_Desc[LPC_EMAC->TxProduceIndex].Packet;
+}
+
+/*********************************************************************//**
+ * @brief		Set length of frame built in Tx packet data buffer returned by
+ * 				EMAC_GetTxBuffer() and start its transmission
+ * @param[in]	ulDataLen	Frame length in bytes (without FCS)
+ * @return		None
+ **********************************************************************/
+void EMAC_CommitTxBuffer(uint32_t ulDataLen)
+{
+	uint32_t idx = LPC_EMAC->TxProduceIndex;
+
+	Tx_Desc[idx].Ctrl = (ulDataLen - 1) | (EMAC_TCTRL_INT | EMAC_TCTRL_LAST);
+	EMAC_UpdateTxProduceIndex();
+}
+
+/*********************************************************************//**
+ * @brief		Get pointer to Rx packet data buffer at current index due to
+ * 				RxConsumeIndex. The buffer stays valid until
+ * 				EMAC_UpdateRxConsumeIndex() is called.
+ * @param[in]	None
+ * @return		Pointer to word-aligned received frame
+ **********************************************************************/
+uint8_t *EMAC_GetRxBuffer(void)
+{
+	return (uint8_t *)Rx_Desc[LPC_EMAC->RxConsumeIndex].Packet;
+}
+
 /*********************************************************************//**
  * @brief 		Enable/Disable interrupt for each type in EMAC
  * @param[in]	ulIntType	Interrupt Type, should be:
@@ -860,8 +964,10 @@ Bool EMAC_CheckReceiveIndex(void)
  **********************************************************************/
 Bool EMAC_CheckTransmitIndex(void)
 {
-	uint32_t tmp = LPC_EMAC->TxConsumeIndex -1;
-	if (LPC_EMAC->TxProduceIndex == tmp) {
+	/* Ring is full when the next produce index reaches the consume index */
+	uint32_t tmp = LPC_EMAC->TxProduceIndex + 1;
+	if (tmp == EMAC_NUM_TX_FRAG) tmp = 0;
+	if (LPC_EMAC->TxConsumeIndex == tmp) {
 		return FALSE;
 	} else {
 		return TRUE;
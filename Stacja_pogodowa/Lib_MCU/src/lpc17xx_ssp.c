@@ -513,6 +513,61 @@ int32_t SSP_ReadWrite (LPC_SSP_TypeDef *SSPx, SSP_DATA_SETUP_Type *dataCfg, \
 	return (-1);
 }
 
+/*********************************************************************//**
+ * @brief 		SSP transmit-only data function (polling). Keeps the TX FIFO
+ * 				topped up and does not read back every frame: frames received
+ * 				meanwhile are dropped once the RX FIFO is full (receive overrun
+ * 				is expected here) and the RX FIFO is cleared in bulk at the end.
+ * @param[in]	SSPx 	Pointer to SSP peripheral, should be
+ * 						- LPC_SSP0: SSP0 peripheral
+ * 						- LPC_SSP1: SSP1 peripheral
+ * @param[in]	txbuf	Pointer to transmit data, 8-bit or 16-bit frames
+ * 						depending on the configured data size
+ * @param[in]	length	Length of transmit data in bytes
+ * @return 		Number of bytes transmitted
+ * Note: Only for master mode. Returns when the last frame has left the
+ * shift register.
+ ***********************************************************************/
+uint32_t SSP_WriteStream (LPC_SSP_TypeDef *SSPx, const void *txbuf, uint32_t length)
+{
+	const uint8_t *wdata8 = (const uint8_t *)txbuf;
+	const uint16_t *wdata16 = (const uint16_t *)txbuf;
+	uint32_t tx_cnt = 0;
+	uint32_t tmp;
+
+	CHECK_PARAM(PARAM_SSPx(SSPx));
+
+	if (SSP_GetDataSize(SSPx) > 8){
+		while (tx_cnt < length){
+			if (SSPx->SR & SSP_SR_TNF){
+				SSPx->DR = SSP_DR_BITMASK(*wdata16);
+				wdata16++;
+				tx_cnt += 2;
+			}
+		}
+	} else {
+		while (tx_cnt < length){
+			if (SSPx->SR & SSP_SR_TNF){
+				SSPx->DR = *wdata8;
+				wdata8++;
+				tx_cnt++;
+			}
+		}
+	}
+
+	// Wait until the last frame is shifted out
+	while (SSPx->SR & SSP_SR_BSY);
+
+	// Clear all received data and the overrun status
+	while (SSPx->SR & SSP_SR_RNE){
+		tmp = SSPx->DR;
+	}
+	(void)tmp;
+	SSPx->ICR = SSP_ICR_BITMASK;
+
+	return tx_cnt;
+}
+
 /*********************************************************************//**
  * @brief		Checks whether the specified SSP status flag is set or not
  * @param[in]	SSPx	SSP peripheral selected, should be:
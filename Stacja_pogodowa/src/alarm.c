@@ -0,0 +1,379 @@
+#include "lpc_types.h"
+#include "pca9532.h"
+#include "rgb.h"
+
+#include "alarm.h"
+#include "config.h"
+#include "console.h"
+#include "telemetry.h"
+
+/* Okres migania diod PCA9532 (151 - 1 Hz) i wypelnienie (50 %) */
+#define ALARM_BLINK_PERIOD 151
+#define ALARM_BLINK_DUTY   128
+
+/* Dioda PCA9532 pierwszej reguly, kolejne reguly na kolejnych diodach */
+#define ALARM_LED_FIRST    LED12
+
+/* Stan reguly miedzy kolejnymi odczytami */
+typedef struct
+{
+    Bool active;
+    Bool pending;                /* Warunek zmiany stanu jest spelniony */
+    uint32_t pendingSince;       /* Poczatek spelnienia warunku [ms] */
+} alarm_state_t;
+
+static alarm_rule_t rules[ALARM_MAX_RULES];
+static alarm_state_t states[ALARM_MAX_RULES];
+
+/* Stan wyjsc, zapisywany do ukladow tylko przy zmianie */
+static uint16_t ledMask = 0;
+static Bool rgbOn = FALSE;
+
+/*!
+ *  @brief    Procedura zglaszajaca zmiane stanu alarmu na UART0: ramka
+ *            telemetrii, a przy wylaczonym strumieniu linia tekstu
+ *  @param    index
+ *              Numer reguly
+ *  @param    value
+ *              Wartosc wielkosci w chwili zmiany
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do bufora nadawczego UART0
+ */
+static void reportEvent(uint8_t index, int32_t value)
+{
+    if (telemetry_sendAlarm(index, states[index].active, rules[index].metric, value) == TRUE)
+    {
+        return;
+    }
+
+    console_print("alarm ");
+    console_printInt(index);
+    console_print(states[index].active ? " on " : " off ");
+    console_print(metric_getName(rules[index].metric));
+    console_print(" ");
+    console_printInt(value);
+    console_print("\r\n");
+}
+
+/*!
+ *  @brief    Procedura ustawiajaca diody PCA9532 i RGB wedlug aktywnych
+ *            alarmow
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do PCA9532 przez I2C i zmiana stanu pinu diody RGB
+ */
+static void updateOutputs(void)
+{
+    uint16_t newMask = 0;
+    Bool newRgb = FALSE;
+    uint32_t i = 0;
+
+    for (i = 0; i < ALARM_MAX_RULES; i++)
+    {
+        if (states[i].active == FALSE)
+        {
+            continue;
+        }
+        if ((rules[i].actions & ALARM_ACT_LEDS) != 0)
+        {
+            newMask |= (uint16_t)(ALARM_LED_FIRST << i);
+        }
+        if ((rules[i].actions & ALARM_ACT_RGB) != 0)
+        {
+            newRgb = TRUE;
+        }
+    }
+
+    if ((ledMask & ~newMask) != 0)
+    {
+        pca9532_setLeds(0, (uint16_t)(ledMask & ~newMask));
+    }
+    if ((newMask & ~ledMask) != 0)
+    {
+        pca9532_setBlink0Leds((uint16_t)(newMask & ~ledMask));
+    }
+    ledMask = newMask;
+
+    if (newRgb != rgbOn)
+    {
+        rgb_setLeds(newRgb ? RGB_BLUE : 0);
+        rgbOn = newRgb;
+    }
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca modul alarmow: wyjscia i reguly
+ *            domyslne
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Konfiguracja PCA9532 i pinu diody RGB
+ */
+void alarm_init(void)
+{
+    /*
+     * Czerwona dioda RGB (P2.0) jest linia TXD1 Modbus, a zielona (P2.1)
+     * zasila wyswietlacz OLED, dlatego alarm uzywa tylko niebieskiej.
+     */
+    rgb_initLeds(RGB_BLUE);
+    rgb_setLeds(0);
+
+    pca9532_init();
+    pca9532_setBlink0Period(ALARM_BLINK_PERIOD);
+    pca9532_setBlink0Duty(ALARM_BLINK_DUTY);
+    pca9532_setLeds(0, 0xFFFF);
+
+    ledMask = 0;
+    rgbOn = FALSE;
+
+    alarm_loadDefaults();
+}
+
+/*!
+ *  @brief    Procedura ustawiajaca reguly domyslne z progami z konfiguracji,
+ *            pozostale reguly sa wylaczane
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyzerowanie stanu wszystkich regul
+ */
+void alarm_loadDefaults(void)
+{
+    const config_t* pConfig = config_get();
+    alarm_rule_t rule;
+    uint32_t i = 0;
+
+    rule.metric = METRIC_NONE;
+    rule.direction = ALARM_ABOVE;
+    rule.actions = 0;
+    rule.code = 'A';
+    rule.threshold = 0;
+    rule.hysteresis = 0;
+    rule.holdS = 0;
+
+    for (i = 0; i < ALARM_MAX_RULES; i++)
+    {
+        alarm_setRule((uint8_t)i, &rule);
+    }
+
+    rule.actions = ALARM_ACT_7SEG | ALARM_ACT_LEDS | ALARM_ACT_RGB | ALARM_ACT_UART;
+    rule.holdS = 60;
+
+    rule.metric = METRIC_TEMPERATURE;
+    rule.direction = ALARM_ABOVE;
+    rule.threshold = pConfig->tempAlarmHigh;
+    rule.hysteresis = 5;
+    rule.code = 'H';
+    alarm_setRule(0, &rule);
+
+    rule.direction = ALARM_BELOW;
+    rule.threshold = pConfig->tempAlarmLow;
+    rule.code = 'L';
+    alarm_setRule(1, &rule);
+
+    rule.metric = METRIC_HUMIDITY;
+    rule.direction = ALARM_ABOVE;
+    rule.threshold = pConfig->humidityAlarmHigh;
+    rule.hysteresis = 3;
+    rule.code = 'U';
+    alarm_setRule(2, &rule);
+
+    rule.metric = METRIC_PRESSURE;
+    rule.direction = ALARM_BELOW;
+    rule.threshold = pConfig->pressureAlarmLow;
+    rule.hysteresis = 100;
+    rule.code = 'P';
+    alarm_setRule(3, &rule);
+
+    /* Wartosc jest trzymana przez VIBRATION_HOLD_MS po zdarzeniu */
+    rule.metric = METRIC_VIBRATION;
+    rule.direction = ALARM_ABOVE;
+    rule.threshold = pConfig->tamperPeak;
+    rule.hysteresis = 0;
+    rule.holdS = 0;
+    rule.code = 'T';
+    alarm_setRule(4, &rule);
+}
+
+/*!
+ *  @brief    Procedura sprawdzajaca wszystkie reguly dla nowego odczytu,
+ *            koszt proporcjonalny do liczby regul
+ *  @param    now
+ *              Czas odczytu [ms]
+ *  @param    pValues
+ *              Wartosci wielkosci, METRIC_COUNT elementow
+ *  @param    invalid
+ *              Maska METRIC_BIT wielkosci bez poprawnej wartosci. Regula
+ *              takiej wielkosci zachowuje stan, a odliczanie czasu
+ *              utrzymania warunku zaczyna sie od nowa.
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana stanu alarmow i wyjsc
+ */
+void alarm_evaluate(uint32_t now, const int32_t* pValues, uint8_t invalid)
+{
+    const alarm_rule_t* pRule = NULL;
+    alarm_state_t* pState = NULL;
+    int32_t value = 0;
+    Bool change = FALSE;
+    Bool changed = FALSE;
+    uint32_t i = 0;
+
+    for (i = 0; i < ALARM_MAX_RULES; i++)
+    {
+        pRule = &rules[i];
+        pState = &states[i];
+
+        if (pRule->metric == METRIC_NONE)
+        {
+            continue;
+        }
+
+        if ((invalid & METRIC_BIT(pRule->metric)) != 0)
+        {
+            pState->pending = FALSE;
+            continue;
+        }
+
+        value = pValues[pRule->metric];
+
+        /* Warunek przeciwny do biezacego stanu, przy wylaczaniu z histereza */
+        if (pState->active == FALSE)
+        {
+            change = (pRule->direction == ALARM_ABOVE)
+                    ? (value > pRule->threshold) : (value < pRule->threshold);
+        }
+        else
+        {
+            change = (pRule->direction == ALARM_ABOVE)
+                    ? (value <= (pRule->threshold - pRule->hysteresis))
+                    : (value >= (pRule->threshold + pRule->hysteresis));
+        }
+
+        if (change == FALSE)
+        {
+            pState->pending = FALSE;
+            continue;
+        }
+
+        if (pState->pending == FALSE)
+        {
+            pState->pending = TRUE;
+            pState->pendingSince = now;
+        }
+
+        if ((now - pState->pendingSince) < ((uint32_t)pRule->holdS * 1000))
+        {
+            continue;
+        }
+
+        pState->active = (pState->active == FALSE) ? TRUE : FALSE;
+        pState->pending = FALSE;
+        changed = TRUE;
+
+        if ((pRule->actions & ALARM_ACT_UART) != 0)
+        {
+            reportEvent((uint8_t)i, value);
+        }
+    }
+
+    if (changed == TRUE)
+    {
+        updateOutputs();
+    }
+}
+
+/*!
+ *  @brief    Funkcja zmieniajaca regule, stan reguly jest zerowany
+ *  @param    index
+ *              Numer reguly
+ *  @param    pRule
+ *              Nowa regula
+ *  @returns  FALSE dla niepoprawnego numeru, wielkosci lub kierunku
+ *  @side_effects:
+ *            Zmiana wyjsc, jesli regula byla aktywna
+ */
+Bool alarm_setRule(uint8_t index, const alarm_rule_t* pRule)
+{
+    Bool wasActive = FALSE;
+
+    if ((index >= ALARM_MAX_RULES) || (pRule->metric >= METRIC_COUNT)
+            || (pRule->direction > ALARM_BELOW))
+    {
+        return FALSE;
+    }
+
+    wasActive = states[index].active;
+
+    rules[index] = *pRule;
+    states[index].active = FALSE;
+    states[index].pending = FALSE;
+
+    if (wasActive == TRUE)
+    {
+        updateOutputs();
+    }
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Getter reguly
+ *  @param    index
+ *              Numer reguly
+ *  @returns  Wskaznik na regule lub NULL dla niepoprawnego numeru
+ *  @side_effects:
+ *            Brak
+ */
+const alarm_rule_t* alarm_getRule(uint8_t index)
+{
+    if (index >= ALARM_MAX_RULES)
+    {
+        return NULL;
+    }
+
+    return &rules[index];
+}
+
+/*!
+ *  @brief    Funkcja sprawdzajaca stan reguly
+ *  @param    index
+ *              Numer reguly
+ *  @returns  TRUE jesli alarm jest aktywny
+ *  @side_effects:
+ *            Brak
+ */
+Bool alarm_isActive(uint8_t index)
+{
+    if (index >= ALARM_MAX_RULES)
+    {
+        return FALSE;
+    }
+
+    return states[index].active;
+}
+
+/*!
+ *  @brief    Funkcja zwracajaca znak dla wyswietlacza 7-segmentowego
+ *  @param    Brak
+ *  @returns  Kod aktywnej reguly z akcja ALARM_ACT_7SEG o najnizszym
+ *            numerze lub 0, gdy zadna nie jest aktywna
+ *  @side_effects:
+ *            Brak
+ */
+char alarm_getDisplayCode(void)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < ALARM_MAX_RULES; i++)
+    {
+        if ((states[i].active == TRUE) && ((rules[i].actions & ALARM_ACT_7SEG) != 0))
+        {
+            return rules[i].code;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+#ifndef ALARM_H_
+#define ALARM_H_
+
+#include "lpc_types.h"
+#include "metric.h"
+
+#define ALARM_MAX_RULES 8
+
+/* Kierunek przekroczenia progu */
+#define ALARM_ABOVE 0
+#define ALARM_BELOW 1
+
+/* Akcje aktywnego alarmu (maska bitowa) */
+#define ALARM_ACT_7SEG  0x01         /* Kod na wyswietlaczu 7-segmentowym */
+#define ALARM_ACT_LEDS  0x02         /* Miganie diody PCA9532 (LED12 + numer reguly) */
+#define ALARM_ACT_RGB   0x04         /* Niebieska dioda RGB */
+#define ALARM_ACT_UART  0x08         /* Zdarzenie na UART0 przy zmianie stanu */
+
+/*
+ * Regula alarmu. Alarm wlacza sie, gdy wartosc przekracza prog, i wylacza,
+ * gdy wroci za prog o histereze. Kazda zmiana stanu wymaga utrzymania
+ * warunku przez holdS sekund.
+ */
+typedef struct
+{
+    uint8_t metric;              /* METRIC_xxx, METRIC_NONE - regula wylaczona */
+    uint8_t direction;           /* ALARM_ABOVE lub ALARM_BELOW */
+    uint8_t actions;             /* ALARM_ACT_xxx */
+    char code;                   /* Znak na wyswietlaczu 7-segmentowym */
+    int32_t threshold;           /* Prog w jednostkach wielkosci */
+    uint16_t hysteresis;         /* Histereza w jednostkach wielkosci */
+    uint16_t holdS;              /* Czas utrzymania warunku [s] */
+} alarm_rule_t;
+
+void alarm_init(void);
+void alarm_loadDefaults(void);
+void alarm_evaluate(uint32_t now, const int32_t* pValues, uint8_t invalid);
+Bool alarm_setRule(uint8_t index, const alarm_rule_t* pRule);
+const alarm_rule_t* alarm_getRule(uint8_t index);
+Bool alarm_isActive(uint8_t index);
+char alarm_getDisplayCode(void);
+
+#endif /* ALARM_H_ */
@@ -0,0 +1,421 @@
+#include <string.h>
+
+#include "lpc17xx_gpio.h"
+#include "lpc17xx_pinsel.h"
+#include "light.h"
+
+#include "ambient.h"
+#include "config.h"
+#include "gpioint.h"
+
+/* Wyjscie przerwania ISL29003 (otwarty dren, aktywne niskim stanem) */
+#define AMBIENT_INT_PORT 2
+#define AMBIENT_INT_PIN  5
+
+/* Liczba zakresow czujnika */
+#define AMBIENT_RANGES 4
+
+/* Najwiecej zmian zakresu w jednym odczycie */
+#define AMBIENT_MAX_STEPS (AMBIENT_RANGES - 1)
+
+/* Etap odczytu */
+#define STATE_IDLE   0
+#define STATE_READ   1
+#define STATE_CACHED 2
+
+/* Gorna granica zakresow LIGHT_RANGE_xxx przy Rext = 100k [lx] */
+static const uint32_t fullScale[AMBIENT_RANGES] = { 973, 3892, 15568, 62272 };
+
+/* Kontrast ekranu dla natezenia ponizej kolejnych progow [lx] */
+#define AMBIENT_CONTRAST_LEVELS 5
+static const uint32_t contrastLux[AMBIENT_CONTRAST_LEVELS - 1] = { 10, 100, 1000, 10000 };
+static const uint8_t contrastLevel[AMBIENT_CONTRAST_LEVELS] = { 0x08, 0x20, 0x50, 0xA0, 0xFF };
+
+static Bool ready = FALSE;
+static uint8_t range = LIGHT_RANGE_1000;
+static uint8_t threshold = 0;
+static uint8_t armedThreshold = 0xFF;   /* Prog ustawiony w czujniku, 0xFF - brak */
+static volatile Bool irqPending = FALSE;
+
+/* Stan trwajacego odczytu */
+static uint8_t state = STATE_IDLE;
+static uint8_t steps = 0;
+static Bool settling = FALSE;
+static uint32_t rangeTime = 0;
+
+/* Wynik ostatniego odczytu */
+static Bool valid = FALSE;
+static uint32_t lux = 0;
+static uint32_t lastRead = 0;
+
+static ambient_stats_t stats;
+
+const sensor_ops_t ambient_sensor =
+{
+    "light", "lx", SENSOR_SCALE, ambient_start, ambient_poll, ambient_getLux
+};
+
+/*!
+ *  @brief    Procedura obslugi przerwania czujnika: natezenie wyszlo poza
+ *            okno progow, nastepny cykl pomiarowy odczyta czujnik
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana flagi przerwania
+ */
+static void onInterrupt(void)
+{
+    irqPending = TRUE;
+    stats.interrupts++;
+}
+
+/*!
+ *  @brief    Funkcja wlaczajaca czujnik w trybie 16-bitowym i najnizszym
+ *            zakresie
+ *  @param    Brak
+ *  @returns  FALSE, gdy czujnik nie odpowiada
+ *  @side_effects:
+ *            Komunikacja z czujnikiem przez I2C
+ */
+static Bool setup(void)
+{
+    uint32_t value = 0;
+
+    light_enable();
+    if (light_readLux(&value) != 0)
+    {
+        return FALSE;
+    }
+
+    light_setWidth(LIGHT_WIDTH_16BITS);
+    light_setRange(LIGHT_RANGE_1000);
+    light_setIrqInCycles(LIGHT_CYCLE_4);
+    range = LIGHT_RANGE_1000;
+    settling = FALSE;
+    armedThreshold = 0xFF;
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Funkcja wybierajaca zakres dla odczytu. Odczyt blisko gornej
+ *            granicy moze byc nasycony, wiec zakres rosnie o jeden; w dol
+ *            zakres jest zmieniany od razu na najnizszy, w ktorym odczyt
+ *            ma zapas 20 %. Granice sa od siebie 4 razy dalej, wiec zakres
+ *            nie oscyluje.
+ *  @param    value
+ *              Odczyt w biezacym zakresie [lx]
+ *  @returns  Zakres LIGHT_RANGE_xxx
+ *  @side_effects:
+ *            Brak
+ */
+static uint8_t selectRange(uint32_t value)
+{
+    uint8_t next = range;
+
+    if ((value >= (fullScale[range] / 10) * 9) && (range < (AMBIENT_RANGES - 1)))
+    {
+        return (uint8_t)(range + 1);
+    }
+
+    while ((next > 0) && (value < (fullScale[next - 1] / 10) * 8))
+    {
+        next--;
+    }
+
+    return next;
+}
+
+/*!
+ *  @brief    Procedura ustawiajaca okno progow przerwania wokol ostatniego
+ *            odczytu. Progi maja rozdzielczosc 1/256 zakresu. Gorny prog
+ *            nie przekracza granicy zmiany zakresu, zeby wzrost natezenia
+ *            do nasycenia takze zglosil przerwanie. Prog rowny granicy
+ *            zakresu nie miesci sie w 8-bitowym rejestrze progu.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Komunikacja z czujnikiem, skasowanie przerwania
+ */
+static void arm(void)
+{
+    uint32_t delta = 0;
+    uint32_t high = fullScale[range] - 1;
+    uint32_t low = 0;
+
+    /* Okno na caly zakres nie zalezy od zakresu, wystarczy ustawic je raz */
+    if ((threshold == 0) && (armedThreshold == 0))
+    {
+        irqPending = FALSE;
+        return;
+    }
+
+    if (threshold != 0)
+    {
+        delta = (lux * threshold) / 100;
+        if (delta < ((fullScale[range] / 256) + 1))
+        {
+            delta = (fullScale[range] / 256) + 1;
+        }
+        if (range < (AMBIENT_RANGES - 1))
+        {
+            high = (fullScale[range] / 10) * 9;
+        }
+        if ((lux + delta) < high)
+        {
+            high = lux + delta;
+        }
+        low = (lux > delta) ? (lux - delta) : 0;
+    }
+
+    /* Bez progu okno obejmuje caly zakres i przerwanie nie jest zglaszane */
+    light_setHiThreshold(high);
+    light_setLoThreshold(low);
+    armedThreshold = threshold;
+
+    /* Flaga jest kasowana przed czujnikiem, zeby nie zgubic nowego zbocza */
+    irqPending = FALSE;
+    light_clearIrqStatus();
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca czujnik natezenia swiatla i przerwanie
+ *            progowe z konfiguracji
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Komunikacja z czujnikiem przez I2C, konfiguracja pinu P2.5
+ */
+void ambient_init(void)
+{
+    PINSEL_CFG_Type PinCfg;
+
+    memset(&stats, 0, sizeof(stats));
+
+    if (ambient_setThreshold(config_get()->lightThreshold) == FALSE)
+    {
+        ambient_setThreshold(0);
+    }
+
+    PinCfg.Funcnum = 0;
+    PinCfg.OpenDrain = 0;
+    PinCfg.Pinmode = 0;
+    PinCfg.Portnum = AMBIENT_INT_PORT;
+    PinCfg.Pinnum = AMBIENT_INT_PIN;
+    PINSEL_ConfigPin(&PinCfg);
+    GPIO_SetDir(AMBIENT_INT_PORT, (1 << AMBIENT_INT_PIN), 0);
+
+    light_init();
+    ready = setup();
+    if (ready == TRUE)
+    {
+        arm();
+    }
+
+    gpioint_register(AMBIENT_INT_PORT, AMBIENT_INT_PIN, GPIOINT_EDGE_FALLING, onInterrupt);
+}
+
+/*!
+ *  @brief    Funkcja ustawiajaca prog zmiany natezenia, po ktorym czujnik
+ *            zglasza przerwanie. Wartosc jest przeliczana na progi przy
+ *            nastepnym odczycie.
+ *  @param    percent
+ *              Prog wzgledem ostatniego odczytu [%], 0 - odczyt w kazdym
+ *              cyklu pomiarowym
+ *  @returns  FALSE dla progu wiekszego niz AMBIENT_THRESHOLD_MAX
+ *  @side_effects:
+ *            Wymuszenie odczytu w nastepnym cyklu
+ */
+Bool ambient_setThreshold(uint8_t percent)
+{
+    if (percent > AMBIENT_THRESHOLD_MAX)
+    {
+        return FALSE;
+    }
+
+    threshold = percent;
+    irqPending = TRUE;
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Getter progu zmiany natezenia
+ *  @param    Brak
+ *  @returns  Prog [%], 0 - tryb przerwan wylaczony
+ *  @side_effects:
+ *            Brak
+ */
+uint8_t ambient_getThreshold(void)
+{
+    return threshold;
+}
+
+/*!
+ *  @brief    Getter biezacego zakresu czujnika
+ *  @param    Brak
+ *  @returns  Zakres LIGHT_RANGE_xxx
+ *  @side_effects:
+ *            Brak
+ */
+uint8_t ambient_getRange(void)
+{
+    return range;
+}
+
+/*!
+ *  @brief    Getter gornej granicy biezacego zakresu
+ *  @param    Brak
+ *  @returns  Granica zakresu [lx]
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t ambient_getFullScale(void)
+{
+    return fullScale[range];
+}
+
+/*!
+ *  @brief    Funkcja uruchamiajaca odczyt. W trybie przerwan czujnik jest
+ *            odczytywany tylko po przerwaniu progowym lub co
+ *            AMBIENT_REFRESH_MS, w pozostalych cyklach wynikiem jest
+ *            ostatni odczyt.
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  FALSE, gdy czujnik nie odpowiada
+ *  @side_effects:
+ *            Przerwanie poprzedniego odczytu
+ */
+Bool ambient_start(uint32_t now)
+{
+    state = STATE_IDLE;
+
+    /* Czujnik podlaczony po starcie */
+    if (ready == FALSE)
+    {
+        ready = setup();
+        if (ready == FALSE)
+        {
+            return FALSE;
+        }
+        irqPending = TRUE;
+    }
+
+    if ((threshold != 0) && (irqPending == FALSE) && (valid == TRUE)
+            && ((now - lastRead) < AMBIENT_REFRESH_MS))
+    {
+        stats.skipped++;
+        state = STATE_CACHED;
+        return TRUE;
+    }
+
+    steps = 0;
+    state = STATE_READ;
+    return TRUE;
+}
+
+/*!
+ *  @brief    Funkcja prowadzaca odczyt: po odczycie blisko granicy zakresu
+ *            zmienia zakres i czeka na nowy wynik integracji
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  SENSOR_BUSY, SENSOR_READY lub SENSOR_ERROR
+ *  @side_effects:
+ *            Komunikacja z czujnikiem, po zakonczeniu zmiana wyniku i progow
+ *            przerwania
+ */
+int32_t ambient_poll(uint32_t now)
+{
+    uint32_t value = 0;
+    uint8_t next = 0;
+
+    if (state == STATE_CACHED)
+    {
+        state = STATE_IDLE;
+        return SENSOR_READY;
+    }
+    if (state != STATE_READ)
+    {
+        return SENSOR_ERROR;
+    }
+
+    /* Rejestr danych zawiera wynik w nowym zakresie dopiero po pelnej integracji */
+    if ((settling == TRUE) && ((now - rangeTime) <= AMBIENT_SETTLE_MS))
+    {
+        return SENSOR_BUSY;
+    }
+
+    if (light_readLux(&value) != 0)
+    {
+        stats.busErrors++;
+        ready = FALSE;
+        valid = FALSE;
+        state = STATE_IDLE;
+        return SENSOR_ERROR;
+    }
+    stats.reads++;
+    settling = FALSE;
+
+    next = selectRange(value);
+    if ((next != range) && (steps < AMBIENT_MAX_STEPS))
+    {
+        light_setRange((light_range_t)next);
+        range = next;
+        rangeTime = now;
+        settling = TRUE;
+        steps++;
+        stats.rangeChanges++;
+        return SENSOR_BUSY;
+    }
+
+    lux = value;
+    valid = TRUE;
+    lastRead = now;
+    arm();
+
+    state = STATE_IDLE;
+    return SENSOR_READY;
+}
+
+/*!
+ *  @brief    Getter natezenia swiatla z ostatniego odczytu
+ *  @param    Brak
+ *  @returns  Natezenie swiatla [lx]
+ *  @side_effects:
+ *            Brak
+ */
+int32_t ambient_getLux(void)
+{
+    return (int32_t)lux;
+}
+
+/*!
+ *  @brief    Funkcja dobierajaca kontrast ekranu do natezenia swiatla
+ *  @param    Brak
+ *  @returns  Kontrast dla oled_setContrast
+ *  @side_effects:
+ *            Brak
+ */
+uint8_t ambient_getContrast(void)
+{
+    uint8_t i = 0;
+
+    while ((i < (AMBIENT_CONTRAST_LEVELS - 1)) && (lux >= contrastLux[i]))
+    {
+        i++;
+    }
+
+    return contrastLevel[i];
+}
+
+/*!
+ *  @brief    Getter licznikow diagnostycznych
+ *  @param    Brak
+ *  @returns  Wskaznik na liczniki
+ *  @side_effects:
+ *            Brak
+ */
+const ambient_stats_t* ambient_getStats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,40 @@
+#ifndef AMBIENT_H_
+#define AMBIENT_H_
+
+#include "lpc_types.h"
+#include "sensor.h"
+
+/* Najwiekszy prog zmiany natezenia swiatla [%] */
+#define AMBIENT_THRESHOLD_MAX 100
+
+/* Czas integracji po zmianie zakresu, 16 bit przy Rext = 100k to ok. 90 ms [ms] */
+#define AMBIENT_SETTLE_MS 100
+
+/* Okres wymuszonego odczytu w trybie przerwan [ms] */
+#define AMBIENT_REFRESH_MS (60UL * 1000UL)
+
+/* Liczniki diagnostyczne */
+typedef struct
+{
+    uint32_t reads;              /* Odczyty przez I2C */
+    uint32_t skipped;            /* Cykle bez odczytu, brak zmiany natezenia */
+    uint32_t interrupts;         /* Przerwania progowe czujnika */
+    uint32_t rangeChanges;
+    uint32_t busErrors;
+} ambient_stats_t;
+
+void ambient_init(void);
+Bool ambient_setThreshold(uint8_t percent);
+uint8_t ambient_getThreshold(void);
+uint8_t ambient_getRange(void);
+uint32_t ambient_getFullScale(void);
+Bool ambient_start(uint32_t now);
+int32_t ambient_poll(uint32_t now);
+int32_t ambient_getLux(void);
+uint8_t ambient_getContrast(void);
+const ambient_stats_t* ambient_getStats(void);
+
+/* Czujnik natezenia swiatla dla sensor_register, wynik w lx */
+extern const sensor_ops_t ambient_sensor;
+
+#endif /* AMBIENT_H_ */
@@ -0,0 +1,179 @@
+#include "baro.h"
+
+/*
+ * Wzor barometryczny atmosfery standardowej:
+ *   p = p0 * (1 - h / 44330.77) ^ 5.25588
+ * Potegi sa odczytywane z tablic z interpolacja liniowa, bez liczb
+ * zmiennoprzecinkowych.
+ */
+
+/* Krok tablicy wspolczynnikow redukcji [m] */
+#define SEA_LEVEL_STEP 100
+
+/*
+ * Wspolczynnik redukcji (1 - h / 44330.77) ^ -5.25588 w formacie Q20 dla
+ * h = BARO_ALTITUDE_MIN .. BARO_ALTITUDE_MAX co SEA_LEVEL_STEP. Funkcja jest
+ * wypukla, wiec cieciwa lezy nad nia - wartosci w wezlach sa obnizone o
+ * polowe bledu interpolacji na sasiednim odcinku, co dzieli blad po rowno
+ * miedzy wezly i srodki odcinkow. Blad wzgledny wyniku ponizej 3.5e-5
+ * (okolo 0.04 hPa) razem z zaokragleniem do 1 Pa.
+ */
+static const uint32_t seaLevelFactors[] =
+{
+    988541, 1000211, 1012046, 1024049, 1036220, 1048565,
+    1061085, 1073783, 1086663, 1099727, 1112978, 1126420,
+    1140055, 1153888, 1167920, 1182157, 1196600, 1211253,
+    1226121, 1241207, 1256514, 1272046, 1287807, 1303802,
+    1320033, 1336505, 1353223, 1370190, 1387411, 1404890,
+    1422632, 1440641, 1458922, 1477480, 1496320, 1515446,
+    1534864, 1554579, 1574596, 1594920, 1615558, 1636514,
+    1657795, 1679405, 1701352, 1723641, 1746279, 1769271,
+    1792625, 1816346, 1840442, 1864919, 1889785, 1915047,
+    1940711, 1966786, 1993279, 2020197, 2047550, 2075345,
+    2103589, 2132293, 2161464, 2191111, 2221243, 2251870
+};
+
+/* Zakres i krok tablicy potegi w formacie Q15 (0.25 .. 1.25, krok 1/64) */
+#define RATIO_MIN   8192
+#define RATIO_MAX   40960
+#define RATIO_SHIFT 9
+
+/*
+ * Potega x ^ (1 / 5.25588) w formacie Q16 dla x = 0.25 .. 1.25 co 1/64.
+ * Blad wysokosci ponizej 2.5 m do 3000 m nad poziomem odniesienia i
+ * ponizej 5 m w calym zakresie tablicy.
+ */
+static const uint32_t ratioPowers[] =
+{
+    50342, 50926, 51483, 52015, 52525, 53015, 53486, 53941,
+    54379, 54803, 55214, 55612, 55998, 56373, 56738, 57093,
+    57439, 57776, 58105, 58426, 58740, 59047, 59348, 59642,
+    59930, 60212, 60489, 60760, 61027, 61288, 61545, 61797,
+    62045, 62289, 62529, 62765, 62997, 63226, 63451, 63673,
+    63892, 64107, 64320, 64530, 64736, 64940, 65141, 65340,
+    65536, 65730, 65921, 66110, 66296, 66481, 66663, 66843,
+    67021, 67197, 67372, 67544, 67714, 67883, 68050, 68215,
+    68378
+};
+
+/* Wspolczynnik dla ostatnio uzytej wysokosci, liczony tylko przy jej zmianie */
+static int16_t cachedAltitude = 0;
+static uint32_t cachedFactor = 0;
+
+/*!
+ *  @brief    Funkcja wyznaczajaca wspolczynnik redukcji do poziomu morza
+ *  @param    altitude
+ *              Wysokosc stacji [m]
+ *  @returns  Wspolczynnik w formacie Q20
+ *  @side_effects:
+ *            Brak
+ */
+static uint32_t seaLevelFactor(int32_t altitude)
+{
+    uint32_t index = 0;
+    uint32_t frac = 0;
+    uint32_t low = 0;
+
+    if (altitude < BARO_ALTITUDE_MIN)
+    {
+        altitude = BARO_ALTITUDE_MIN;
+    }
+    if (altitude >= BARO_ALTITUDE_MAX)
+    {
+        return seaLevelFactors[(BARO_ALTITUDE_MAX - BARO_ALTITUDE_MIN) / SEA_LEVEL_STEP];
+    }
+
+    index = (uint32_t)(altitude - BARO_ALTITUDE_MIN) / SEA_LEVEL_STEP;
+    frac = (uint32_t)(altitude - BARO_ALTITUDE_MIN) - index * SEA_LEVEL_STEP;
+    low = seaLevelFactors[index];
+
+    return low + ((seaLevelFactors[index + 1] - low) * frac + SEA_LEVEL_STEP / 2) / SEA_LEVEL_STEP;
+}
+
+/*!
+ *  @brief    Funkcja redukujaca cisnienie na stacji do poziomu morza (QNH)
+ *  @param    pressure
+ *              Cisnienie na stacji [Pa]
+ *  @param    altitude
+ *              Wysokosc stacji [m], BARO_ALTITUDE_MIN .. BARO_ALTITUDE_MAX
+ *  @returns  Cisnienie zredukowane do poziomu morza [Pa]
+ *  @side_effects:
+ *            Zapamietanie wspolczynnika dla podanej wysokosci
+ */
+int32_t baro_seaLevel(int32_t pressure, int16_t altitude)
+{
+    if ((cachedFactor == 0) || (altitude != cachedAltitude))
+    {
+        cachedFactor = seaLevelFactor(altitude);
+        cachedAltitude = altitude;
+    }
+
+    if (pressure <= 0)
+    {
+        return 0;
+    }
+
+    return (int32_t)(((uint64_t)(uint32_t)pressure * cachedFactor + (1UL << 19)) >> 20);
+}
+
+/*!
+ *  @brief    Funkcja wyznaczajaca wysokosc z cisnienia wzgledem cisnienia
+ *            odniesienia, h = 44330.77 * (1 - (p / p0) ^ (1 / 5.25588))
+ *  @param    pressure
+ *              Cisnienie [Pa]
+ *  @param    reference
+ *              Cisnienie odniesienia, np. QNH lub BARO_STANDARD_PA [Pa]
+ *  @returns  Wysokosc nad poziomem odniesienia [m], ograniczona do zakresu
+ *            stosunku cisnien 0.25 .. 1.25
+ *  @side_effects:
+ *            Brak
+ */
+int32_t baro_altitude(int32_t pressure, int32_t reference)
+{
+    uint32_t ratio = 0;
+    uint32_t index = 0;
+    uint32_t frac = 0;
+    int32_t power = 0;
+
+    if ((pressure <= 0) || (reference <= 0))
+    {
+        return 0;
+    }
+
+    /*
+     * p / p0 w formacie Q15 zaokraglone do najblizszej wartosci, dla p < 2^17
+     * przesuniecie miesci sie w 32 bitach
+     */
+    if (pressure >= (1L << 17))
+    {
+        ratio = RATIO_MAX;
+    }
+    else
+    {
+        ratio = ((uint32_t)pressure << 15) / (uint32_t)reference;
+        if ((((uint32_t)pressure << 15) - ratio * (uint32_t)reference) >= ((uint32_t)reference + 1) / 2)
+        {
+            ratio++;
+        }
+    }
+    if (ratio < RATIO_MIN)
+    {
+        ratio = RATIO_MIN;
+    }
+    if (ratio > RATIO_MAX)
+    {
+        ratio = RATIO_MAX;
+    }
+
+    index = (ratio - RATIO_MIN) >> RATIO_SHIFT;
+    frac = (ratio - RATIO_MIN) & ((1UL << RATIO_SHIFT) - 1);
+    power = (int32_t)ratioPowers[index];
+    if (frac != 0)
+    {
+        power += (int32_t)(((ratioPowers[index + 1] - ratioPowers[index]) * frac + (1UL << (RATIO_SHIFT - 1)))
+                >> RATIO_SHIFT);
+    }
+
+    /* 44330.77 * (1 - power / 65536), zaokraglone do metra */
+    return ((65536 - power) * 44331 + 32768) >> 16;
+}
@@ -0,0 +1,16 @@
+#ifndef BARO_H_
+#define BARO_H_
+
+#include "lpc_types.h"
+
+/* Zakres wysokosci stacji obslugiwany przy redukcji do poziomu morza [m] */
+#define BARO_ALTITUDE_MIN  (-500)
+#define BARO_ALTITUDE_MAX  6000
+
+/* Cisnienie standardowe na poziomie morza [Pa] */
+#define BARO_STANDARD_PA   101325
+
+int32_t baro_seaLevel(int32_t pressure, int16_t altitude);
+int32_t baro_altitude(int32_t pressure, int32_t reference);
+
+#endif /* BARO_H_ */
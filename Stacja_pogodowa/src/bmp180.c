@@ -0,0 +1,361 @@
+#include "lpc_types.h"
+#include "light.h"
+
+#include "bmp180.h"
+#include "config.h"
+
+#define BMP180_ADDRESS     0x77
+#define BMP180_CHIP_ID     0x55
+
+/* Rejestry */
+#define BMP180_REG_CALIB   0xAA
+#define BMP180_REG_ID      0xD0
+#define BMP180_REG_CTRL    0xF4
+#define BMP180_REG_DATA    0xF6
+
+/* Polecenia rejestru sterujacego */
+#define BMP180_CMD_TEMP    0x2E
+#define BMP180_CMD_PRESS   0x34     /* | (oss << 6) */
+
+#define BMP180_CALIB_SIZE  22
+
+/* Czas pomiaru temperatury i cisnienia w kolejnych trybach [ms], z zapasem */
+#define BMP180_TEMP_WAIT   5
+static const uint8_t pressureWait[4] = { 5, 8, 14, 26 };
+
+/* Wspolczynniki kalibracyjne z pamieci EEPROM czujnika */
+typedef struct
+{
+    int16_t ac1;
+    int16_t ac2;
+    int16_t ac3;
+    uint16_t ac4;
+    uint16_t ac5;
+    uint16_t ac6;
+    int16_t b1;
+    int16_t b2;
+    int16_t mb;
+    int16_t mc;
+    int16_t md;
+} bmp180_calib_t;
+
+/* Etap odczytu */
+#define STATE_IDLE  0
+#define STATE_TEMP  1
+#define STATE_PRESS 2
+
+static bmp180_calib_t calib;
+static Bool calibLoaded = FALSE;
+static uint8_t mode = BMP180_OSS_HIGH_RES;
+static uint8_t averageCount = 1;
+
+/* Stan trwajacego odczytu, tryb jest ustalany przy starcie */
+static uint8_t state = STATE_IDLE;
+static uint8_t readMode = BMP180_OSS_HIGH_RES;
+static uint8_t readAverage = 1;
+static uint8_t conversions = 0;
+static uint32_t stepStart = 0;
+static int32_t ut = 0;
+static int32_t upSum = 0;
+
+/* Wynik ostatniego odczytu */
+static int32_t pressure = 0;
+static int32_t temperature = 0;
+
+const sensor_ops_t bmp180_sensor =
+{
+    "press", "Pa", SENSOR_SCALE, bmp180_start, bmp180_poll, bmp180_getPressure
+};
+
+/*!
+ *  @brief    Funkcja odczytujaca rejestry czujnika
+ *  @param    reg
+ *              Adres pierwszego rejestru
+ *  @param    pData
+ *              Bufor na dane
+ *  @param    len
+ *              Liczba bajtow
+ *  @returns  FALSE w przypadku bledu komunikacji
+ *  @side_effects:
+ *            Brak
+ */
+static Bool readRegisters(uint8_t reg, uint8_t* pData, uint32_t len)
+{
+    if (I2CWrite(BMP180_ADDRESS, &reg, 1) != 0)
+    {
+        return FALSE;
+    }
+
+    return (I2CRead(BMP180_ADDRESS, pData, len) == 0) ? TRUE : FALSE;
+}
+
+/*!
+ *  @brief    Funkcja uruchamiajaca pomiar
+ *  @param    command
+ *              Polecenie BMP180_CMD_xxx
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  FALSE w przypadku bledu komunikacji
+ *  @side_effects:
+ *            Zapamietanie czasu startu pomiaru
+ */
+static Bool startConversion(uint8_t command, uint32_t now)
+{
+    uint8_t buffer[2];
+
+    buffer[0] = BMP180_REG_CTRL;
+    buffer[1] = command;
+    stepStart = now;
+
+    return (I2CWrite(BMP180_ADDRESS, buffer, 2) == 0) ? TRUE : FALSE;
+}
+
+/*!
+ *  @brief    Procedura wyznaczajaca cisnienie i temperature z usrednionych
+ *            wartosci surowych, wedlug noty katalogowej BMP180
+ *  @param    up
+ *              Usredniona wartosc surowa cisnienia
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana wyniku ostatniego odczytu
+ */
+static void compensate(int32_t up)
+{
+    int32_t x1 = 0;
+    int32_t x2 = 0;
+    int32_t x3 = 0;
+    int32_t b3 = 0;
+    int32_t b5 = 0;
+    int32_t b6 = 0;
+    uint32_t b4 = 0;
+    uint32_t b7 = 0;
+    int32_t p = 0;
+
+    x1 = ((ut - calib.ac6) * calib.ac5) >> 15;
+    x2 = ((int32_t)calib.mc << 11) / (x1 + calib.md);
+    b5 = x1 + x2;
+    temperature = (b5 + 8) >> 4;
+
+    b6 = b5 - 4000;
+    x1 = ((int32_t)calib.b2 * ((b6 * b6) >> 12)) >> 11;
+    x2 = ((int32_t)calib.ac2 * b6) >> 11;
+    x3 = x1 + x2;
+    b3 = ((((int32_t)calib.ac1 * 4 + x3) << readMode) + 2) >> 2;
+    x1 = ((int32_t)calib.ac3 * b6) >> 13;
+    x2 = ((int32_t)calib.b1 * ((b6 * b6) >> 12)) >> 16;
+    x3 = ((x1 + x2) + 2) >> 2;
+    b4 = ((uint32_t)calib.ac4 * (uint32_t)(x3 + 32768)) >> 15;
+    b7 = ((uint32_t)up - (uint32_t)b3) * (50000UL >> readMode);
+    if (b7 < 0x80000000UL)
+    {
+        p = (int32_t)((b7 * 2) / b4);
+    }
+    else
+    {
+        p = (int32_t)((b7 / b4) * 2);
+    }
+    x1 = (p >> 8) * (p >> 8);
+    x1 = (x1 * 3038) >> 16;
+    x2 = (-7357 * p) >> 16;
+    pressure = p + ((x1 + x2 + 3791) >> 4);
+}
+
+/*!
+ *  @brief    Funkcja sprawdzajaca obecnosc czujnika i odczytujaca wszystkie
+ *            wspolczynniki kalibracyjne jednym odczytem
+ *  @param    Brak
+ *  @returns  FALSE, gdy czujnik nie odpowiada
+ *  @side_effects:
+ *            Zmiana wspolczynnikow kalibracyjnych
+ */
+static Bool loadCalibration(void)
+{
+    uint8_t data[BMP180_CALIB_SIZE];
+
+    if ((readRegisters(BMP180_REG_ID, data, 1) == FALSE) || (data[0] != BMP180_CHIP_ID)
+            || (readRegisters(BMP180_REG_CALIB, data, BMP180_CALIB_SIZE) == FALSE))
+    {
+        return FALSE;
+    }
+
+    calib.ac1 = (int16_t)((data[0] << 8) | data[1]);
+    calib.ac2 = (int16_t)((data[2] << 8) | data[3]);
+    calib.ac3 = (int16_t)((data[4] << 8) | data[5]);
+    calib.ac4 = (uint16_t)((data[6] << 8) | data[7]);
+    calib.ac5 = (uint16_t)((data[8] << 8) | data[9]);
+    calib.ac6 = (uint16_t)((data[10] << 8) | data[11]);
+    calib.b1 = (int16_t)((data[12] << 8) | data[13]);
+    calib.b2 = (int16_t)((data[14] << 8) | data[15]);
+    calib.mb = (int16_t)((data[16] << 8) | data[17]);
+    calib.mc = (int16_t)((data[18] << 8) | data[19]);
+    calib.md = (int16_t)((data[20] << 8) | data[21]);
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca czujnik: odczyt kalibracji i tryb z
+ *            konfiguracji
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Komunikacja z czujnikiem przez I2C
+ */
+void bmp180_init(void)
+{
+    calibLoaded = loadCalibration();
+
+    if (bmp180_setMode(config_get()->pressureOss, config_get()->pressureAverage) == FALSE)
+    {
+        bmp180_setMode(BMP180_OSS_HIGH_RES, 1);
+    }
+}
+
+/*!
+ *  @brief    Funkcja ustawiajaca tryb pomiaru cisnienia
+ *  @param    oss
+ *              Tryb nadprobkowania BMP180_OSS_xxx
+ *  @param    average
+ *              Liczba pomiarow usrednianych w jednym odczycie,
+ *              1 - BMP180_AVERAGE_MAX
+ *  @returns  FALSE dla niepoprawnych parametrow
+ *  @side_effects:
+ *            Brak
+ */
+Bool bmp180_setMode(uint8_t oss, uint8_t average)
+{
+    if ((oss > BMP180_OSS_ULTRA_HIGH_RES) || (average == 0) || (average > BMP180_AVERAGE_MAX))
+    {
+        return FALSE;
+    }
+
+    mode = oss;
+    averageCount = average;
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Funkcja uruchamiajaca odczyt: pomiar temperatury, a po nim
+ *            kolejne pomiary cisnienia w biezacym trybie. Czas odczytu to
+ *            okolo 5 ms + average * czas pomiaru trybu oss.
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  FALSE, gdy czujnik nie odpowiada
+ *  @side_effects:
+ *            Przerwanie poprzedniego odczytu
+ */
+Bool bmp180_start(uint32_t now)
+{
+    state = STATE_IDLE;
+
+    /* Czujnik podlaczony po starcie */
+    if (calibLoaded == FALSE)
+    {
+        calibLoaded = loadCalibration();
+        if (calibLoaded == FALSE)
+        {
+            return FALSE;
+        }
+    }
+
+    if (startConversion(BMP180_CMD_TEMP, now) == FALSE)
+    {
+        return FALSE;
+    }
+
+    readMode = mode;
+    readAverage = averageCount;
+    state = STATE_TEMP;
+    return TRUE;
+}
+
+/*!
+ *  @brief    Funkcja prowadzaca odczyt: po uplywie czasu pomiaru odczytuje
+ *            wynik i uruchamia nastepny pomiar. Pomiary cisnienia sa
+ *            wykonywane jeden po drugim, a usredniana jest wartosc surowa
+ *            przed kompensacja.
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  SENSOR_BUSY, SENSOR_READY lub SENSOR_ERROR
+ *  @side_effects:
+ *            Komunikacja z czujnikiem, po zakonczeniu zmiana wyniku
+ */
+int32_t bmp180_poll(uint32_t now)
+{
+    uint8_t data[3];
+    uint8_t command = (uint8_t)(BMP180_CMD_PRESS | (readMode << 6));
+
+    /* Pomiar trwa co najmniej pelny czas oczekiwania niezaleznie od fazy zegara */
+    if ((state == STATE_TEMP) && ((now - stepStart) > BMP180_TEMP_WAIT))
+    {
+        if (readRegisters(BMP180_REG_DATA, data, 2) == FALSE)
+        {
+            state = STATE_IDLE;
+            return SENSOR_ERROR;
+        }
+        ut = (data[0] << 8) | data[1];
+        upSum = 0;
+        conversions = 0;
+
+        if (startConversion(command, now) == FALSE)
+        {
+            state = STATE_IDLE;
+            return SENSOR_ERROR;
+        }
+        state = STATE_PRESS;
+    }
+    else if ((state == STATE_PRESS) && ((now - stepStart) > pressureWait[readMode]))
+    {
+        if (readRegisters(BMP180_REG_DATA, data, 3) == FALSE)
+        {
+            state = STATE_IDLE;
+            return SENSOR_ERROR;
+        }
+        upSum += ((data[0] << 16) | (data[1] << 8) | data[2]) >> (8 - readMode);
+        conversions++;
+
+        if (conversions >= readAverage)
+        {
+            compensate((upSum + (int32_t)(conversions / 2)) / (int32_t)conversions);
+            state = STATE_IDLE;
+            return SENSOR_READY;
+        }
+
+        if (startConversion(command, now) == FALSE)
+        {
+            state = STATE_IDLE;
+            return SENSOR_ERROR;
+        }
+    }
+    else if (state == STATE_IDLE)
+    {
+        return SENSOR_ERROR;
+    }
+
+    return SENSOR_BUSY;
+}
+
+/*!
+ *  @brief    Getter cisnienia z ostatniego odczytu
+ *  @param    Brak
+ *  @returns  Cisnienie [Pa]
+ *  @side_effects:
+ *            Brak
+ */
+int32_t bmp180_getPressure(void)
+{
+    return pressure;
+}
+
+/*!
+ *  @brief    Getter temperatury czujnika cisnienia z ostatniego odczytu
+ *  @param    Brak
+ *  @returns  Temperatura [0.1 C]
+ *  @side_effects:
+ *            Brak
+ */
+int32_t bmp180_getTemperature(void)
+{
+    return temperature;
+}
@@ -0,0 +1,33 @@
+#ifndef BMP180_H_
+#define BMP180_H_
+
+#include "lpc_types.h"
+#include "sensor.h"
+
+/*
+ * Tryby nadprobkowania BMP180 (oss). Wyzszy tryb to mniejszy szum kosztem
+ * dluzszego pomiaru i wiekszego poboru pradu:
+ *   0 - ultra low power     4.5 ms, szum 6 Pa
+ *   1 - standard            7.5 ms, szum 5 Pa
+ *   2 - high resolution    13.5 ms, szum 4 Pa
+ *   3 - ultra high res.    25.5 ms, szum 3 Pa
+ */
+#define BMP180_OSS_ULTRA_LOW_POWER 0
+#define BMP180_OSS_STANDARD        1
+#define BMP180_OSS_HIGH_RES        2
+#define BMP180_OSS_ULTRA_HIGH_RES  3
+
+/* Najwieksza liczba usrednianych pomiarow cisnienia w jednym odczycie */
+#define BMP180_AVERAGE_MAX 8
+
+void bmp180_init(void);
+Bool bmp180_setMode(uint8_t oss, uint8_t average);
+Bool bmp180_start(uint32_t now);
+int32_t bmp180_poll(uint32_t now);
+int32_t bmp180_getPressure(void);
+int32_t bmp180_getTemperature(void);
+
+/* Czujnik cisnienia dla sensor_register, wynik w Pa */
+extern const sensor_ops_t bmp180_sensor;
+
+#endif /* BMP180_H_ */
@@ -0,0 +1,325 @@
+#include <string.h>
+
+#include "lpc17xx_can.h"
+#include "lpc17xx_pinsel.h"
+
+#include "canbus.h"
+#include "config.h"
+
+/* Bufor odebranych ramek (potega dwojki) */
+#define CANBUS_RX_RING_SIZE 8
+#define CANBUS_RX_RING_MASK (CANBUS_RX_RING_SIZE - 1)
+
+/* Limit oczekiwania na wlasna ramke w trybie testu (iteracje petli) */
+#define CANBUS_SELFTEST_TIMEOUT 200000
+
+static CAN_MSG_Type rxRing[CANBUS_RX_RING_SIZE];
+static volatile uint32_t rxHead = 0;
+static volatile uint32_t rxTail = 0;
+
+static uint8_t mode = CANBUS_MODE_OFF;
+static uint8_t nodeId = 0;
+static uint8_t sequence = 0;
+static CAN_MSG_Type lastFrame;
+static Bool lastValid = FALSE;
+
+static canbus_node_t nodes[CANBUS_MAX_NODES];
+static canbus_stats_t stats;
+
+/*!
+ *  @brief    Procedura obslugi przerwania CAN. Odebrane ramki (juz
+ *            przefiltrowane sprzetowo przez tablice AF) trafiaja do bufora.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana bufora odbiorczego
+ */
+void CAN_IRQHandler(void)
+{
+    /* Odczyt rejestru ICR kasuje flagi przerwania */
+    CAN_IntGetStatus(LPC_CAN1);
+
+    while ((LPC_CAN1->SR & CAN_SR_RBS) != 0)
+    {
+        if ((rxHead - rxTail) >= CANBUS_RX_RING_SIZE)
+        {
+            CAN_SetCommand(LPC_CAN1, CAN_CMR_RRB);
+            stats.rxOverruns++;
+            continue;
+        }
+
+        CAN_ReceiveMsg(LPC_CAN1, &rxRing[rxHead & CANBUS_RX_RING_MASK]);
+        rxHead++;
+    }
+}
+
+/*!
+ *  @brief    Procedura wysylajaca ramke, gdy wszystkie bufory nadawcze sa
+ *            zajete ramka jest odrzucana
+ *  @param    pMsg
+ *              Ramka
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana licznikow
+ */
+static void send(CAN_MSG_Type* pMsg)
+{
+    if (CAN_SendMsg(LPC_CAN1, pMsg) == SUCCESS)
+    {
+        stats.txFrames++;
+    }
+    else
+    {
+        stats.txDropped++;
+    }
+}
+
+/*!
+ *  @brief    Procedura ladujaca tablice filtru akceptacji. Wezel przyjmuje
+ *            tylko wlasny identyfikator (zapytania RTR), brama caly zakres
+ *            identyfikatorow odczytow.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis tablicy AF
+ */
+static void setupFilter(void)
+{
+    /* Wpisy standardowe sa parami, drugi (wylaczony) dopelnia pare */
+    static SFF_Entry ownEntry[2];
+    static SFF_GPR_Entry groupEntry;
+    AF_SectionDef section;
+
+    memset(&section, 0, sizeof(section));
+
+    if (mode == CANBUS_MODE_GATEWAY)
+    {
+        groupEntry.controller1 = CAN1_CTRL;
+        groupEntry.disable1 = MSG_ENABLE;
+        groupEntry.lowerID = CANBUS_ID_SAMPLE;
+        groupEntry.controller2 = CAN1_CTRL;
+        groupEntry.disable2 = MSG_ENABLE;
+        groupEntry.upperID = CANBUS_ID_SAMPLE + CANBUS_MAX_NODES - 1;
+        section.SFF_GPR_Sec = &groupEntry;
+        section.SFF_GPR_NumEntry = 1;
+    }
+    else
+    {
+        ownEntry[0].controller = CAN1_CTRL;
+        ownEntry[0].disable = MSG_ENABLE;
+        ownEntry[0].id_11 = CANBUS_ID_SAMPLE + nodeId;
+        ownEntry[1].controller = CAN1_CTRL;
+        ownEntry[1].disable = MSG_DISABLE;
+        ownEntry[1].id_11 = 0x7FF;
+        section.SFF_Sec = ownEntry;
+        section.SFF_NumEntry = 2;
+    }
+
+    CAN_SetupAFLUT(LPC_CANAF, &section);
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca kontroler CAN1 (P0.0 - RD, P0.1 - TD)
+ *            w trybie z konfiguracji
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Konfiguracja pinow, CAN1, filtru akceptacji i kontrolera NVIC
+ */
+void canbus_init(void)
+{
+    PINSEL_CFG_Type PinCfg;
+
+    mode = config_get()->canMode;
+    nodeId = config_get()->canNodeId % CANBUS_MAX_NODES;
+    memset(nodes, 0, sizeof(nodes));
+    memset(&stats, 0, sizeof(stats));
+
+    if (mode == CANBUS_MODE_OFF)
+    {
+        return;
+    }
+
+    PinCfg.Funcnum = 1;
+    PinCfg.OpenDrain = 0;
+    PinCfg.Pinmode = 0;
+    PinCfg.Portnum = 0;
+    PinCfg.Pinnum = 0;
+    PINSEL_ConfigPin(&PinCfg);
+    PinCfg.Pinnum = 1;
+    PINSEL_ConfigPin(&PinCfg);
+
+    CAN_Init(LPC_CAN1, CANBUS_BAUD_RATE);
+    setupFilter();
+
+    CAN_IRQCmd(LPC_CAN1, CANINT_RIE, ENABLE);
+    NVIC_SetPriority(CAN_IRQn, 3);
+    NVIC_EnableIRQ(CAN_IRQn);
+}
+
+/*!
+ *  @brief    Procedura obslugujaca odebrane ramki, wywolywana w petli glownej.
+ *            Odpowiada na zapytania RTR i w trybie bramy zapamietuje odczyty
+ *            innych wezlow.
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wysylanie ramek
+ */
+void canbus_poll(uint32_t now)
+{
+    CAN_MSG_Type* pMsg = NULL;
+    canbus_node_t* pNode = NULL;
+    uint32_t node = 0;
+
+    while (rxTail != rxHead)
+    {
+        pMsg = &rxRing[rxTail & CANBUS_RX_RING_MASK];
+        node = pMsg->id - CANBUS_ID_SAMPLE;
+        stats.rxFrames++;
+
+        if ((pMsg->format == STD_ID_FORMAT) && (node < CANBUS_MAX_NODES))
+        {
+            if (pMsg->type == REMOTE_FRAME)
+            {
+                if ((node == nodeId) && (lastValid == TRUE))
+                {
+                    stats.remoteRequests++;
+                    send(&lastFrame);
+                }
+            }
+            else if ((mode == CANBUS_MODE_GATEWAY) && (node != nodeId) && (pMsg->len >= 8))
+            {
+                pNode = &nodes[node];
+                pNode->temperature = (int16_t)(pMsg->dataA[0] | (pMsg->dataA[1] << 8));
+                pNode->pressure = pMsg->dataA[2] | (pMsg->dataA[3] << 8) | ((int32_t)pMsg->dataB[0] << 16);
+                pNode->humidity = pMsg->dataB[1];
+                pNode->sequence = pMsg->dataB[2];
+                pNode->invalid = pMsg->dataB[3];
+                pNode->received = (now != 0) ? now : 1;
+            }
+        }
+
+        rxTail++;
+    }
+}
+
+/*!
+ *  @brief    Procedura publikujaca odczyt jako 8-bajtowa ramke danych.
+ *            Ramka jest zapamietywana jako odpowiedz na zapytania RTR.
+ *  @param    temperature
+ *              Temperatura [0.1 C]
+ *  @param    pressure
+ *              Cisnienie [Pa]
+ *  @param    humidity
+ *              Wilgotnosc [%]
+ *  @param    invalid
+ *              Maska METRIC_BIT wielkosci bez poprawnej wartosci
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyslanie ramki
+ */
+void canbus_publish(int32_t temperature, int32_t pressure, int16_t humidity, uint8_t invalid)
+{
+    if (mode == CANBUS_MODE_OFF)
+    {
+        return;
+    }
+
+    lastFrame.id = CANBUS_ID_SAMPLE + nodeId;
+    lastFrame.format = STD_ID_FORMAT;
+    lastFrame.type = DATA_FRAME;
+    lastFrame.len = 8;
+    lastFrame.dataA[0] = (uint8_t)temperature;
+    lastFrame.dataA[1] = (uint8_t)((uint16_t)temperature >> 8);
+    lastFrame.dataA[2] = (uint8_t)pressure;
+    lastFrame.dataA[3] = (uint8_t)(pressure >> 8);
+    lastFrame.dataB[0] = (uint8_t)(pressure >> 16);
+    lastFrame.dataB[1] = (uint8_t)humidity;
+    lastFrame.dataB[2] = sequence++;
+    lastFrame.dataB[3] = invalid;
+    lastValid = TRUE;
+
+    send(&lastFrame);
+}
+
+/*!
+ *  @brief    Funkcja sprawdzajaca kontroler i filtr akceptacji bez magistrali.
+ *            Kontroler jest przelaczany w tryb testu (odbior wlasnych ramek
+ *            bez potwierdzenia), wysyla ramke z wlasnym identyfikatorem i
+ *            czeka na jej odbior przez filtr.
+ *  @param    Brak
+ *  @returns  TRUE jesli ramka wrocila niezmieniona
+ *  @side_effects:
+ *            Chwilowe wstrzymanie obslugi magistrali
+ */
+Bool canbus_selfTest(void)
+{
+    CAN_MSG_Type tx;
+    CAN_MSG_Type rx;
+    uint32_t timeout = CANBUS_SELFTEST_TIMEOUT;
+    Bool result = FALSE;
+
+    if (mode == CANBUS_MODE_OFF)
+    {
+        return FALSE;
+    }
+
+    NVIC_DisableIRQ(CAN_IRQn);
+    CAN_ModeConfig(LPC_CAN1, CAN_SELFTEST_MODE, ENABLE);
+
+    memset(&tx, 0, sizeof(tx));
+    tx.id = CANBUS_ID_SAMPLE + nodeId;
+    tx.format = STD_ID_FORMAT;
+    tx.type = DATA_FRAME;
+    tx.len = 8;
+    tx.dataA[0] = 0x55;
+    tx.dataA[3] = 0xAA;
+    tx.dataB[0] = 0x5A;
+    tx.dataB[3] = 0xA5;
+
+    if (CAN_SendMsg(LPC_CAN1, &tx) == SUCCESS)
+    {
+        while ((timeout > 0) && ((LPC_CAN1->SR & CAN_SR_RBS) == 0))
+        {
+            timeout--;
+        }
+
+        if ((CAN_ReceiveMsg(LPC_CAN1, &rx) == SUCCESS) && (rx.id == tx.id) && (rx.len == tx.len)
+                && (memcmp(rx.dataA, tx.dataA, 4) == 0) && (memcmp(rx.dataB, tx.dataB, 4) == 0))
+        {
+            result = TRUE;
+        }
+    }
+
+    CAN_ModeConfig(LPC_CAN1, CAN_SELFTEST_MODE, DISABLE);
+    NVIC_EnableIRQ(CAN_IRQn);
+
+    return result;
+}
+
+/*!
+ *  @brief    Getter ostatniego odczytu innego wezla (tryb bramy)
+ *  @param    node
+ *              Numer wezla
+ *  @returns  Wskaznik na odczyt lub NULL dla blednego numeru
+ *  @side_effects:
+ *            Brak
+ */
+const canbus_node_t* canbus_getNode(uint8_t node)
+{
+    return (node < CANBUS_MAX_NODES) ? &nodes[node] : NULL;
+}
+
+/*!
+ *  @brief    Getter licznikow diagnostycznych
+ *  @param    Brak
+ *  @returns  Wskaznik na liczniki
+ *  @side_effects:
+ *            Brak
+ */
+const canbus_stats_t* canbus_getStats(void)
+{
+    return &stats;
+}
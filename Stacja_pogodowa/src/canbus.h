@@ -0,0 +1,51 @@
+#ifndef CANBUS_H_
+#define CANBUS_H_
+
+#include "lpc_types.h"
+
+#define CANBUS_BAUD_RATE 125000
+
+/* Tryby pracy magistrali CAN */
+#define CANBUS_MODE_OFF     0
+#define CANBUS_MODE_NODE    1   /* Publikowanie odczytow i odpowiedzi na RTR */
+#define CANBUS_MODE_GATEWAY 2   /* Jak wezel, dodatkowo zbieranie odczytow innych wezlow */
+
+/*
+ * Identyfikatory 11-bitowe: CANBUS_ID_SAMPLE + numer wezla. Ramka danych
+ * (8 bajtow, little-endian): temperatura [0.1 C] (int16), cisnienie [Pa]
+ * (uint24), wilgotnosc [%] (uint8), numer sekwencyjny (uint8), maska pol
+ * bez poprawnej wartosci (uint8, bity METRIC_BIT).
+ * Ramka RTR z tym identyfikatorem jest zapytaniem o ostatni odczyt wezla.
+ */
+#define CANBUS_ID_SAMPLE    0x100
+#define CANBUS_MAX_NODES    16
+
+/* Ostatni odczyt innego wezla zebrany w trybie bramy */
+typedef struct
+{
+    int16_t temperature;
+    int32_t pressure;
+    uint8_t humidity;
+    uint8_t sequence;
+    uint8_t invalid;             /* Maska METRIC_BIT pol bez poprawnej wartosci */
+    uint32_t received;           /* Czas odbioru [ms], 0 - brak odczytu */
+} canbus_node_t;
+
+/* Liczniki diagnostyczne */
+typedef struct
+{
+    uint32_t txFrames;
+    uint32_t txDropped;
+    uint32_t rxFrames;
+    uint32_t rxOverruns;
+    uint32_t remoteRequests;
+} canbus_stats_t;
+
+void canbus_init(void);
+void canbus_poll(uint32_t now);
+void canbus_publish(int32_t temperature, int32_t pressure, int16_t humidity, uint8_t invalid);
+Bool canbus_selfTest(void);
+const canbus_node_t* canbus_getNode(uint8_t node);
+const canbus_stats_t* canbus_getStats(void);
+
+#endif /* CANBUS_H_ */
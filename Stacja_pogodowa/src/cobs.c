@@ -0,0 +1,47 @@
+#include "cobs.h"
+
+/*!
+ *  @brief    Funkcja kodujaca blok danych algorytmem COBS. Wynik nie zawiera
+ *            bajtow 0x00, ogranicznik ramki nie jest dopisywany.
+ *  @param    pIn
+ *              Dane wejsciowe
+ *  @param    len
+ *              Liczba bajtow danych
+ *  @param    pOut
+ *              Bufor wyjsciowy o rozmiarze COBS_MAX_ENCODED_SIZE(len)
+ *  @returns  Liczba bajtow zakodowanych danych
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t cobs_encode(const uint8_t* pIn, uint32_t len, uint8_t* pOut)
+{
+    uint32_t codePos = 0;
+    uint32_t out = 1;
+    uint8_t code = 1;
+    uint32_t i = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        if (pIn[i] == 0)
+        {
+            pOut[codePos] = code;
+            codePos = out++;
+            code = 1;
+            continue;
+        }
+
+        pOut[out++] = pIn[i];
+        code++;
+
+        if (code == 0xFF)
+        {
+            pOut[codePos] = code;
+            codePos = out++;
+            code = 1;
+        }
+    }
+
+    pOut[codePos] = code;
+
+    return out;
+}
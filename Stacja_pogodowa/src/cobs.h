@@ -0,0 +1,11 @@
+#ifndef COBS_H_
+#define COBS_H_
+
+#include "lpc_types.h"
+
+/* Maksymalny rozmiar danych po zakodowaniu (bez ogranicznika) */
+#define COBS_MAX_ENCODED_SIZE(len) ((len) + ((len) / 254) + 1)
+
+uint32_t cobs_encode(const uint8_t* pIn, uint32_t len, uint8_t* pOut);
+
+#endif /* COBS_H_ */
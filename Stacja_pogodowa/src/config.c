@@ -0,0 +1,251 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "lpc17xx_rtc.h"
+
+#include "eeprom.h"
+
+#include "config.h"
+#include "crc.h"
+#include "baro.h"
+
+#define CONFIG_MAGIC 0x5743
+
+/* Naglowek slotu konfiguracji w pamieci EEPROM */
+typedef struct
+{
+    uint16_t magic;
+    uint8_t version;
+    uint8_t size;
+    uint32_t sequence;
+    config_t config;
+    uint16_t crc;
+} config_slot_t;
+
+/* Slot musi sie miescic w przydzielonym obszarze pamieci EEPROM */
+typedef char config_slot_size_check[(sizeof(config_slot_t) <= CONFIG_SLOT_SIZE) ? 1 : -1];
+
+/* Ustawienia domyslne, uzywane gdy zaden slot nie jest poprawny */
+static const config_t defaultConfig =
+{
+    200,                        /* samplePeriodMs */
+    200,                        /* displayPeriodMs */
+    1,                          /* startScreen */
+    RTC_CALIB_DIR_FORWARD,      /* rtcCalibDir */
+    0,                          /* rtcCalibValue */
+    210,                        /* altitude */
+    350,                        /* tempAlarmHigh */
+    -100,                       /* tempAlarmLow */
+    90,                         /* humidityAlarmHigh */
+    97000,                      /* pressureAlarmLow */
+    60,                         /* logPeriodS */
+    NET_IP(192, 168, 1, 50),    /* netIp */
+    NET_IP(255, 255, 255, 0),   /* netMask */
+    NET_IP(192, 168, 1, 1),     /* netGateway */
+    NET_IP(192, 168, 1, 10),    /* collectorIp */
+    5005,                       /* collectorPort */
+    0,                          /* canMode */
+    0,                          /* canNodeId */
+    0,                          /* modbusAddress */
+    101325,                     /* altitudeReference */
+    {
+        { 3, FILTER_SMOOTH_EMA, 2, 0, 0, 0 },           /* filters[FILTER_TEMPERATURE] */
+        { 5, FILTER_SMOOTH_KALMAN, 0, 0, 64, 4096 },    /* filters[FILTER_PRESSURE] */
+        { 3, FILTER_SMOOTH_EMA, 1, 0, 0, 0 }            /* filters[FILTER_HUMIDITY] */
+    },
+    2,                          /* pressureOss (BMP180_OSS_HIGH_RES) */
+    1,                          /* pressureAverage */
+    3,                          /* humidityResolution (HTU21D_RES_RH11_T11) */
+    10,                         /* lightThreshold */
+    0,                          /* displayDimming */
+    8,                          /* vibrationLevel (0.5 g) */
+    1000                        /* tamperPeak */
+};
+
+/* Kopia aktualnej konfiguracji w pamieci RAM */
+static config_t config;
+static uint32_t sequence = 0;
+static uint8_t activeSlot = 0;
+
+/*!
+ *  @brief    Funkcja sprawdzajaca poprawnosc slotu konfiguracji
+ *  @param    pSlot
+ *              Slot odczytany z pamieci EEPROM
+ *  @returns  TRUE jesli slot zawiera poprawny rekord w aktualnej wersji z
+ *            wartosciami w dozwolonych zakresach
+ *  @side_effects:
+ *            Brak
+ */
+static Bool isSlotValid(const config_slot_t* pSlot)
+{
+    if ((pSlot->magic != CONFIG_MAGIC) || (pSlot->version != CONFIG_VERSION)
+            || (pSlot->size != sizeof(config_t)))
+    {
+        return FALSE;
+    }
+
+    if (crc16((const uint8_t*)pSlot, offsetof(config_slot_t, crc)) != pSlot->crc)
+    {
+        return FALSE;
+    }
+
+    return config_validate(&pSlot->config);
+}
+
+/*!
+ *  @brief    Procedura ustawiajaca kalibracje zegara RTC z konfiguracji
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiany w rejestrach RTC
+ */
+static void applyRtcCalibration(void)
+{
+    if (config.rtcCalibValue != 0)
+    {
+        RTC_CalibConfig(LPC_RTC, config.rtcCalibValue, config.rtcCalibDir);
+        RTC_CalibCounterCmd(LPC_RTC, ENABLE);
+    }
+    else
+    {
+        RTC_CalibCounterCmd(LPC_RTC, DISABLE);
+    }
+}
+
+/*!
+ *  @brief    Procedura wczytujaca konfiguracje z pamieci EEPROM. Oba sloty sa
+ *            czytane jednym odczytem, wybierany jest poprawny slot o wyzszym
+ *            numerze sekwencyjnym. Gdy zaden nie jest poprawny, uzywane sa
+ *            ustawienia domyslne.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana kopii konfiguracji w pamieci RAM, kalibracja RTC
+ */
+void config_init(void)
+{
+    static uint8_t slots[CONFIG_EEPROM_SIZE];
+    config_slot_t slot[2];
+    Bool valid[2];
+    int i = 0;
+
+    config = defaultConfig;
+    sequence = 0;
+    activeSlot = 1;
+
+    if (eeprom_read(slots, CONFIG_EEPROM_OFFSET, CONFIG_EEPROM_SIZE) == CONFIG_EEPROM_SIZE)
+    {
+        for (i = 0; i < 2; i++)
+        {
+            memcpy(&slot[i], &slots[i * CONFIG_SLOT_SIZE], sizeof(config_slot_t));
+            valid[i] = isSlotValid(&slot[i]);
+        }
+
+        if ((valid[0] == TRUE) && ((valid[1] == FALSE)
+                || ((int32_t)(slot[0].sequence - slot[1].sequence) > 0)))
+        {
+            activeSlot = 0;
+        }
+        else if (valid[1] == TRUE)
+        {
+            activeSlot = 1;
+        }
+
+        if (valid[activeSlot] == TRUE)
+        {
+            config = slot[activeSlot].config;
+            sequence = slot[activeSlot].sequence;
+        }
+    }
+
+    applyRtcCalibration();
+}
+
+/*!
+ *  @brief    Getter aktualnej konfiguracji
+ *  @param    Brak
+ *  @returns  Wskaznik na kopie konfiguracji w pamieci RAM
+ *  @side_effects:
+ *            Brak
+ */
+const config_t* config_get(void)
+{
+    return &config;
+}
+
+/*!
+ *  @brief    Funkcja sprawdzajaca zakresy ustawien zmienianych z konsoli i
+ *            przez Modbus, wspolna dla obu interfejsow
+ *  @param    pConfig
+ *              Konfiguracja
+ *  @returns  TRUE jesli konfiguracja jest poprawna
+ *  @side_effects:
+ *            Brak
+ */
+Bool config_validate(const config_t* pConfig)
+{
+    if ((pConfig->samplePeriodMs < CONFIG_PERIOD_MIN_MS) || (pConfig->samplePeriodMs > CONFIG_PERIOD_MAX_MS)
+            || (pConfig->displayPeriodMs < CONFIG_PERIOD_MIN_MS)
+            || (pConfig->displayPeriodMs > CONFIG_PERIOD_MAX_MS))
+    {
+        return FALSE;
+    }
+
+    if ((pConfig->altitude < BARO_ALTITUDE_MIN) || (pConfig->altitude > BARO_ALTITUDE_MAX))
+    {
+        return FALSE;
+    }
+
+    if (pConfig->logPeriodS > CONFIG_LOG_PERIOD_MAX_S)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Funkcja zapisujaca nowa konfiguracje. Rekord jest zapisywany do
+ *            slotu nieaktywnego, wiec przerwany zapis nie niszczy poprzednich
+ *            ustawien.
+ *  @param    pConfig
+ *              Nowa konfiguracja
+ *  @returns  0 w przypadku powodzenia, -1 w przypadku bledu zapisu
+ *  @side_effects:
+ *            Zapis do pamieci EEPROM, zmiana kopii konfiguracji w pamieci RAM
+ */
+int32_t config_save(const config_t* pConfig)
+{
+    config_slot_t slot;
+    uint8_t nextSlot = activeSlot ^ 1;
+
+    memset(&slot, 0, sizeof(slot));
+    slot.magic = CONFIG_MAGIC;
+    slot.version = CONFIG_VERSION;
+    slot.size = sizeof(config_t);
+    slot.sequence = sequence + 1;
+    slot.config = *pConfig;
+    slot.crc = crc16((const uint8_t*)&slot, offsetof(config_slot_t, crc));
+
+    /* Slot miesci sie w buforze wsadowym (8 stron po 16 bajtow), wiec kazda
+     * strona jest zapisywana jednym cyklem, a eeprom_sync czeka na koniec
+     * ostatniego z nich przed aktywacja nowego slotu */
+    if (eeprom_batchWrite((uint8_t*)&slot, CONFIG_EEPROM_OFFSET + nextSlot * CONFIG_SLOT_SIZE,
+            sizeof(slot)) != sizeof(slot))
+    {
+        return -1;
+    }
+
+    if ((eeprom_batchFlush() < 0) || (eeprom_sync() != 0))
+    {
+        return -1;
+    }
+
+    config = *pConfig;
+    sequence = slot.sequence;
+    activeSlot = nextSlot;
+
+    applyRtcCalibration();
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include "lpc_types.h"
+#include "filter.h"
+
+/* Wersja ukladu rekordu konfiguracji, zmieniana przy kazdej zmianie struktury */
+#define CONFIG_VERSION 11
+
+/* Obszar pamieci EEPROM zajmowany przez konfiguracje (dwa sloty) */
+#define CONFIG_EEPROM_OFFSET 0
+#define CONFIG_SLOT_SIZE     128
+#define CONFIG_EEPROM_SIZE   (2 * CONFIG_SLOT_SIZE)
+
+/* Zakres okresow odczytu i odswiezania ekranu [ms] */
+#define CONFIG_PERIOD_MIN_MS     10
+#define CONFIG_PERIOD_MAX_MS     3600000
+
+/* Najdluzszy okres zapisu do dziennika [s], petla glowna liczy go w ms na 32 bitach */
+#define CONFIG_LOG_PERIOD_MAX_S  86400
+
+/* Adres IPv4 zapisany jako liczba, np. NET_IP(192, 168, 1, 50) */
+#define NET_IP(a, b, c, d) (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+
+/* Ustawienia stacji przechowywane w pamieci EEPROM */
+typedef struct
+{
+    uint32_t samplePeriodMs;     /* Okres odczytu czujnikow [ms] */
+    uint32_t displayPeriodMs;    /* Okres odswiezania ekranu [ms] */
+    uint8_t startScreen;         /* Ekran wyswietlany po starcie (1 - dane, 2 - czas, 3 - statystyki) */
+    uint8_t rtcCalibDir;         /* Kierunek kalibracji RTC (RTC_CALIB_DIR_xxx) */
+    uint16_t rtcCalibValue;      /* Wartosc kalibracji RTC, 0 - wylaczona */
+    int16_t altitude;            /* Wysokosc stacji nad poziomem morza [m] */
+    int16_t tempAlarmHigh;       /* Gorny prog alarmu temperatury [0.1 C] */
+    int16_t tempAlarmLow;        /* Dolny prog alarmu temperatury [0.1 C] */
+    int16_t humidityAlarmHigh;   /* Gorny prog alarmu wilgotnosci [%] */
+    int32_t pressureAlarmLow;    /* Dolny prog alarmu cisnienia [Pa] */
+    uint32_t logPeriodS;         /* Okres zapisu do dziennika [s], 0 - wylaczony */
+    uint32_t netIp;              /* Adres IPv4 stacji (NET_IP), 0 - Ethernet wylaczony */
+    uint32_t netMask;            /* Maska podsieci */
+    uint32_t netGateway;         /* Brama domyslna */
+    uint32_t collectorIp;        /* Adres odbiorcy telemetrii UDP, 0 - wylaczona */
+    uint16_t collectorPort;      /* Port odbiorcy telemetrii UDP */
+    uint8_t canMode;             /* Tryb magistrali CAN (CANBUS_MODE_xxx) */
+    uint8_t canNodeId;           /* Numer wezla CAN (0 - CANBUS_MAX_NODES-1) */
+    uint8_t modbusAddress;       /* Adres Modbus RTU (1 - 247), 0 - wylaczony */
+    int32_t altitudeReference;   /* Cisnienie odniesienia wysokosci barometrycznej [Pa] */
+    filter_config_t filters[FILTER_SENSORS]; /* Filtry odczytow czujnikow (FILTER_xxx) */
+    uint8_t pressureOss;         /* Tryb nadprobkowania BMP180 (BMP180_OSS_xxx) */
+    uint8_t pressureAverage;     /* Liczba usrednianych pomiarow cisnienia (1 - BMP180_AVERAGE_MAX) */
+    uint8_t humidityResolution;  /* Rozdzielczosc czujnika wilgotnosci (HTU21D_RES_xxx) */
+    uint8_t lightThreshold;      /* Prog zmiany natezenia swiatla zglaszajacy przerwanie [%], 0 - odczyt w kazdym cyklu */
+    uint8_t displayDimming;      /* Kontrast ekranu zalezny od natezenia swiatla, 0 - wylaczony */
+    uint8_t vibrationLevel;      /* Prog przyspieszenia budzacy analize drgan [1/16 g], 0 - wylaczona */
+    uint16_t tamperPeak;         /* Odchylenie od polozenia spoczynkowego oznaczajace sabotaz [mg] */
+} config_t;
+
+void config_init(void);
+const config_t* config_get(void);
+int32_t config_save(const config_t* pConfig);
+Bool config_validate(const config_t* pConfig);
+
+#endif /* CONFIG_H_ */
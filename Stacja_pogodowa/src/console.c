@@ -0,0 +1,309 @@
+#include <string.h>
+
+#include "console.h"
+#include "uart0.h"
+#include "fmt.h"
+
+/* Maksymalna liczba bajtow pobieranych z bufora odbiorczego w jednym wywolaniu */
+#define CONSOLE_POLL_BYTES 16
+
+static const console_cmd_t* pTable = NULL;
+static uint32_t tableSize = 0;
+
+static char line[CONSOLE_LINE_SIZE];
+static uint32_t lineLen = 0;
+static Bool overflow = FALSE;
+
+/*!
+ *  @brief    Procedura wypisujaca liste polecen
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do bufora nadawczego UART0
+ */
+static void printHelp(void)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < tableSize; i++)
+    {
+        console_print(pTable[i].pName);
+        console_print(" - ");
+        console_print(pTable[i].pHelp);
+        console_print("\r\n");
+    }
+}
+
+/*!
+ *  @brief    Procedura dzielaca linie na argumenty i wywolujaca polecenie
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana zawartosci bufora linii
+ */
+static void dispatch(void)
+{
+    char* argv[CONSOLE_MAX_ARGS];
+    uint32_t argc = 0;
+    uint32_t i = 0;
+    char* p = line;
+
+    while ((*p != '\0') && (argc < CONSOLE_MAX_ARGS))
+    {
+        while (*p == ' ')
+        {
+            *p++ = '\0';
+        }
+        if (*p == '\0')
+        {
+            break;
+        }
+        argv[argc++] = p;
+        while ((*p != ' ') && (*p != '\0'))
+        {
+            p++;
+        }
+    }
+
+    if (argc == 0)
+    {
+        return;
+    }
+
+    if (strcmp(argv[0], "help") == 0)
+    {
+        printHelp();
+        return;
+    }
+
+    for (i = 0; i < tableSize; i++)
+    {
+        if (strcmp(argv[0], pTable[i].pName) == 0)
+        {
+            pTable[i].handler(argc, argv);
+            return;
+        }
+    }
+
+    console_print("unknown command\r\n");
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca konsole
+ *  @param    pCommands
+ *              Tablica polecen
+ *  @param    count
+ *              Liczba polecen
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void console_init(const console_cmd_t* pCommands, uint32_t count)
+{
+    pTable = pCommands;
+    tableSize = count;
+    lineLen = 0;
+    overflow = FALSE;
+}
+
+/*!
+ *  @brief    Procedura przetwarzajaca odebrane znaki. Pobiera z bufora
+ *            odbiorczego co najwyzej CONSOLE_POLL_BYTES bajtow, wiec jej czas
+ *            wykonania jest ograniczony. Polecenie jest wykonywane po
+ *            odebraniu konca linii.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wywolanie procedury obslugi polecenia
+ */
+void console_poll(void)
+{
+    uint8_t rx[CONSOLE_POLL_BYTES];
+    uint32_t count = uart0_read(rx, sizeof(rx));
+    uint32_t i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        if ((rx[i] == '\r') || (rx[i] == '\n'))
+        {
+            line[lineLen] = '\0';
+            if (overflow == TRUE)
+            {
+                console_print("line too long\r\n");
+            }
+            else
+            {
+                dispatch();
+            }
+            lineLen = 0;
+            overflow = FALSE;
+        }
+        else if (lineLen < (CONSOLE_LINE_SIZE - 1))
+        {
+            line[lineLen++] = (char)rx[i];
+        }
+        else
+        {
+            overflow = TRUE;
+        }
+    }
+}
+
+/*!
+ *  @brief    Procedura wysylajaca tekst. Nie czeka na nadajnik.
+ *  @param    pText
+ *              Lancuch znakow zakonczony zerem
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do bufora nadawczego UART0
+ */
+void console_print(const char* pText)
+{
+    uart0_write((const uint8_t*)pText, strlen(pText));
+}
+
+/*!
+ *  @brief    Procedura wysylajaca liczbe dziesietna ze znakiem
+ *  @param    value
+ *              Wartosc
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do bufora nadawczego UART0
+ */
+void console_printInt(int32_t value)
+{
+    char text[FMT_MAX_LEN + 1];
+
+    uart0_write((const uint8_t*)text, fmt_int(text, value, 0, ' '));
+}
+
+/*!
+ *  @brief    Procedura wysylajaca liczbe dziesietna uzupelniona zerami z lewej
+ *  @param    value
+ *              Wartosc
+ *  @param    width
+ *              Minimalna liczba cyfr
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do bufora nadawczego UART0
+ */
+void console_printPadded(uint32_t value, uint32_t width)
+{
+    char text[FMT_MAX_LEN + 1];
+
+    if (width > FMT_MAX_LEN)
+    {
+        width = FMT_MAX_LEN;
+    }
+
+    uart0_write((const uint8_t*)text, fmt_uint(text, value, (uint8_t)width, '0'));
+}
+
+/*!
+ *  @brief    Funkcja zamieniajaca lancuch znakow na liczbe bez znaku
+ *  @param    pText
+ *              Lancuch znakow zawierajacy tylko cyfry
+ *  @param    pValue
+ *              Wynik
+ *  @returns  TRUE jesli lancuch jest poprawna liczba
+ *  @side_effects:
+ *            Brak
+ */
+Bool console_parseUInt(const char* pText, uint32_t* pValue)
+{
+    uint32_t value = 0;
+
+    if (*pText == '\0')
+    {
+        return FALSE;
+    }
+
+    while (*pText != '\0')
+    {
+        if ((*pText < '0') || (*pText > '9') || (value > 429496728))
+        {
+            return FALSE;
+        }
+        value = value * 10 + (*pText - '0');
+        pText++;
+    }
+
+    *pValue = value;
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Funkcja zamieniajaca lancuch znakow na liczbe ze znakiem
+ *  @param    pText
+ *              Lancuch znakow: opcjonalny znak '-' i cyfry
+ *  @param    pValue
+ *              Wynik
+ *  @returns  TRUE jesli lancuch jest poprawna liczba
+ *  @side_effects:
+ *            Brak
+ */
+Bool console_parseInt(const char* pText, int32_t* pValue)
+{
+    uint32_t value = 0;
+    Bool negative = (*pText == '-') ? TRUE : FALSE;
+
+    if ((console_parseUInt(negative ? &pText[1] : pText, &value) == FALSE)
+            || (value > 0x7FFFFFFF))
+    {
+        return FALSE;
+    }
+
+    *pValue = negative ? -(int32_t)value : (int32_t)value;
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Funkcja dzielaca lancuch znakow na liczby rozdzielone separatorem
+ *            (np. "12:30:00" lub "13.06.2024")
+ *  @param    pText
+ *              Lancuch znakow, jest modyfikowany
+ *  @param    separator
+ *              Znak separatora
+ *  @param    pValues
+ *              Tablica na wyniki
+ *  @param    count
+ *              Oczekiwana liczba pol
+ *  @returns  TRUE jesli lancuch zawiera dokladnie count poprawnych liczb
+ *  @side_effects:
+ *            Brak
+ */
+Bool console_parseFields(char* pText, char separator, uint32_t* pValues, uint32_t count)
+{
+    uint32_t i = 0;
+    char* pField = pText;
+
+    for (i = 0; i < count; i++)
+    {
+        char* pEnd = pField;
+
+        while ((*pEnd != separator) && (*pEnd != '\0'))
+        {
+            pEnd++;
+        }
+
+        if ((i < (count - 1)) && (*pEnd != separator))
+        {
+            return FALSE;
+        }
+        if ((i == (count - 1)) && (*pEnd != '\0'))
+        {
+            return FALSE;
+        }
+
+        *pEnd = '\0';
+        if (console_parseUInt(pField, &pValues[i]) == FALSE)
+        {
+            return FALSE;
+        }
+        pField = pEnd + 1;
+    }
+
+    return TRUE;
+}
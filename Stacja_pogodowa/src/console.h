@@ -0,0 +1,26 @@
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+#include "lpc_types.h"
+
+#define CONSOLE_LINE_SIZE 64
+#define CONSOLE_MAX_ARGS  8
+
+/* Polecenie konsoli: nazwa, opis wyswietlany przez "help" i procedura obslugi */
+typedef struct
+{
+    const char* pName;
+    const char* pHelp;
+    void (*handler)(uint32_t argc, char* argv[]);
+} console_cmd_t;
+
+void console_init(const console_cmd_t* pCommands, uint32_t count);
+void console_poll(void);
+void console_print(const char* pText);
+void console_printInt(int32_t value);
+void console_printPadded(uint32_t value, uint32_t width);
+Bool console_parseUInt(const char* pText, uint32_t* pValue);
+Bool console_parseInt(const char* pText, int32_t* pValue);
+Bool console_parseFields(char* pText, char separator, uint32_t* pValues, uint32_t count);
+
+#endif /* CONSOLE_H_ */
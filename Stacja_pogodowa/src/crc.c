@@ -0,0 +1,108 @@
+#include "crc.h"
+
+/*!
+ *  @brief    Funkcja aktualizujaca sume kontrolna CRC-16/CCITT (wielomian 0x1021)
+ *            o kolejne bajty. Liczona bez tablicy, kilka operacji na bajt.
+ *  @param    crc
+ *              Dotychczasowa wartosc sumy kontrolnej
+ *  @param    pData
+ *              Dane
+ *  @param    len
+ *              Liczba bajtow danych
+ *  @returns  Zaktualizowana suma kontrolna
+ *  @side_effects:
+ *            Brak
+ */
+uint16_t crc16_update(uint16_t crc, const uint8_t* pData, uint32_t len)
+{
+    while (len > 0)
+    {
+        crc = (uint16_t)((crc >> 8) | (crc << 8));
+        crc ^= *pData;
+        crc ^= (crc & 0xFF) >> 4;
+        crc ^= (uint16_t)(crc << 12);
+        crc ^= (uint16_t)((crc & 0xFF) << 5);
+
+        pData++;
+        len--;
+    }
+
+    return crc;
+}
+
+/*!
+ *  @brief    Funkcja obliczajaca sume kontrolna CRC-16/CCITT bloku danych
+ *  @param    pData
+ *              Dane
+ *  @param    len
+ *              Liczba bajtow danych
+ *  @returns  Suma kontrolna
+ *  @side_effects:
+ *            Brak
+ */
+uint16_t crc16(const uint8_t* pData, uint32_t len)
+{
+    return crc16_update(CRC16_INIT, pData, len);
+}
+
+/*!
+ *  @brief    Funkcja obliczajaca sume kontrolna CRC-16/MODBUS (wielomian 0xA001
+ *            w odwroconej kolejnosci bitow) bloku danych
+ *  @param    pData
+ *              Dane
+ *  @param    len
+ *              Liczba bajtow danych
+ *  @returns  Suma kontrolna, wysylana mlodszym bajtem naprzod
+ *  @side_effects:
+ *            Brak
+ */
+uint16_t crc16_modbus(const uint8_t* pData, uint32_t len)
+{
+    uint16_t crc = CRC16_MODBUS_INIT;
+    uint8_t bit = 0;
+
+    while (len > 0)
+    {
+        crc ^= *pData;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x0001) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+        }
+
+        pData++;
+        len--;
+    }
+
+    return crc;
+}
+
+/*!
+ *  @brief    Funkcja obliczajaca sume kontrolna CRC-8 czujnikow wilgotnosci
+ *            HTU21D/SHT2x (wielomian 0x31, wartosc poczatkowa 0)
+ *  @param    pData
+ *              Dane
+ *  @param    len
+ *              Liczba bajtow danych
+ *  @returns  Suma kontrolna
+ *  @side_effects:
+ *            Brak
+ */
+uint8_t crc8_sensirion(const uint8_t* pData, uint32_t len)
+{
+    uint8_t crc = 0;
+    uint8_t bit = 0;
+
+    while (len > 0)
+    {
+        crc ^= *pData;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+
+        pData++;
+        len--;
+    }
+
+    return crc;
+}
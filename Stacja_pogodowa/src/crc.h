@@ -0,0 +1,17 @@
+#ifndef CRC_H_
+#define CRC_H_
+
+#include "lpc_types.h"
+
+/* Wartosc poczatkowa CRC-16/CCITT */
+#define CRC16_INIT 0xFFFF
+
+/* Wartosc poczatkowa CRC-16/MODBUS */
+#define CRC16_MODBUS_INIT 0xFFFF
+
+uint16_t crc16_update(uint16_t crc, const uint8_t* pData, uint32_t len);
+uint16_t crc16(const uint8_t* pData, uint32_t len);
+uint16_t crc16_modbus(const uint8_t* pData, uint32_t len);
+uint8_t crc8_sensirion(const uint8_t* pData, uint32_t len);
+
+#endif /* CRC_H_ */
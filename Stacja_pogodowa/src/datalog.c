@@ -0,0 +1,408 @@
+#include <string.h>
+
+#include "lpc_types.h"
+
+#include "flash.h"
+
+#include "datalog.h"
+#include "crc.h"
+
+/* Liczba stron pamieci AT45DB081D */
+#define DATALOG_PAGES 4096
+
+#define DATALOG_EMPTY 0xFFFFFFFF
+
+#define HEADER_SIZE sizeof(datalog_page_header_t)
+#define RECORD_SIZE sizeof(datalog_record_t)
+
+static Bool ready = FALSE;
+static uint16_t pageSize = 0;
+static uint32_t recordsPerPage = 0;
+
+/* Strona, ktora zostanie zapisana jako nastepna i jej numer kolejny */
+static uint32_t headPage = 0;
+static uint32_t nextSequence = 0;
+static Bool wrapped = FALSE;
+
+/* Biezaca, jeszcze niezapisana strona */
+static uint8_t page[DATALOG_MAX_PAGE_SIZE];
+static uint32_t pageRecords = 0;
+
+/*
+ * Poczatek najnowszego odcinka dziennika z niemalejacym czasem rekordow i
+ * czas ostatniego rekordu. Cofniecie zegara (np. po utracie zasilania RTC)
+ * zaczyna nowy odcinek.
+ */
+static uint32_t segmentStart = 0;
+static uint32_t lastTime = 0;
+
+/* Liczba rekordow usunietych przez nadpisanie najstarszych stron od inicjalizacji */
+static uint32_t dropped = 0;
+
+/*!
+ *  @brief    Funkcja odczytujaca numer kolejny strony
+ *  @param    index
+ *              Numer strony w pamieci
+ *  @returns  Numer kolejny lub DATALOG_EMPTY dla strony pustej
+ *  @side_effects:
+ *            Brak
+ */
+static uint32_t readSequence(uint32_t index)
+{
+    datalog_page_header_t header;
+
+    if (flash_read((uint8_t*)&header, index * pageSize, HEADER_SIZE) != HEADER_SIZE)
+    {
+        return DATALOG_EMPTY;
+    }
+    if (header.version != DATALOG_VERSION)
+    {
+        return DATALOG_EMPTY;
+    }
+
+    return header.sequence;
+}
+
+/*!
+ *  @brief    Procedura zapisujaca biezaca strone do pamieci DataFlash
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do pamieci DataFlash, przesuniecie poczatku dziennika
+ */
+static void writePage(void)
+{
+    datalog_page_header_t* pHeader = (datalog_page_header_t*)page;
+
+    pHeader->sequence = nextSequence;
+    pHeader->version = DATALOG_VERSION;
+    pHeader->count = (uint8_t)pageRecords;
+    pHeader->crc = crc16(&page[HEADER_SIZE], pageRecords * RECORD_SIZE);
+
+    flash_write(page, headPage * pageSize, pageSize);
+
+    /* Nadpisanie najstarszej strony przesuwa numery rekordow */
+    if (wrapped == TRUE)
+    {
+        segmentStart = (segmentStart > recordsPerPage) ? (segmentStart - recordsPerPage) : 0;
+        dropped += recordsPerPage;
+    }
+
+    nextSequence++;
+    headPage++;
+    if (headPage == DATALOG_PAGES)
+    {
+        headPage = 0;
+        wrapped = TRUE;
+    }
+
+    pageRecords = 0;
+    memset(page, 0xFF, sizeof(page));
+}
+
+/*!
+ *  @brief    Procedura wyznaczajaca poczatek najnowszego odcinka dziennika z
+ *            niemalejacym czasem. Strony sa sprawdzane od najnowszej, po dwa
+ *            rekordy na strone: cofniecie czasu miedzy stronami lub miedzy
+ *            pierwszym i ostatnim rekordem strony konczy szukanie.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Odczyt pamieci DataFlash
+ */
+static void findSegment(void)
+{
+    datalog_record_t first;
+    datalog_record_t last;
+    uint32_t pages = datalog_getPageCount();
+    uint32_t nextTime = 0xFFFFFFFF;
+    uint32_t index = 0;
+    uint32_t slot = 0;
+
+    segmentStart = 0;
+    lastTime = 0;
+
+    for (index = pages; index > 0; index--)
+    {
+        if ((datalog_readRecord((index - 1) * recordsPerPage, &first) == FALSE)
+                || (datalog_readRecord(index * recordsPerPage - 1, &last) == FALSE)
+                || (last.time > nextTime))
+        {
+            segmentStart = index * recordsPerPage;
+            break;
+        }
+        if (index == pages)
+        {
+            lastTime = last.time;
+        }
+
+        if (first.time > last.time)
+        {
+            /* Cofniecie czasu wewnatrz strony - szukanie dokladnego miejsca */
+            for (slot = recordsPerPage - 1; slot > 0; slot--)
+            {
+                if ((datalog_readRecord((index - 1) * recordsPerPage + slot - 1, &first) == FALSE)
+                        || (first.time > last.time))
+                {
+                    break;
+                }
+                last.time = first.time;
+            }
+            segmentStart = (index - 1) * recordsPerPage + slot;
+            break;
+        }
+
+        nextTime = first.time;
+    }
+}
+
+/*!
+ *  @brief    Funkcja inicjalizujaca dziennik. Koniec dziennika jest szukany
+ *            binarnie: numery kolejne stron rosna az do ostatniej zapisanej
+ *            strony, za nia sa strony puste albo starsze od strony 0.
+ *  @param    Brak
+ *  @returns  TRUE jesli pamiec DataFlash jest dostepna
+ *  @side_effects:
+ *            Odczyt pamieci DataFlash
+ */
+Bool datalog_init(void)
+{
+    uint32_t first = 0;
+    uint32_t low = 1;
+    uint32_t high = DATALOG_PAGES;
+
+    ready = FALSE;
+    memset(page, 0xFF, sizeof(page));
+    pageRecords = 0;
+    segmentStart = 0;
+    lastTime = 0;
+    dropped = 0;
+
+    if (flash_init() == FALSE)
+    {
+        return FALSE;
+    }
+
+    pageSize = flash_getPageSize();
+    if (pageSize > DATALOG_MAX_PAGE_SIZE)
+    {
+        return FALSE;
+    }
+    recordsPerPage = (pageSize - HEADER_SIZE) / RECORD_SIZE;
+
+    first = readSequence(0);
+    if (first == DATALOG_EMPTY)
+    {
+        headPage = 0;
+        nextSequence = 0;
+        wrapped = FALSE;
+        ready = TRUE;
+        return TRUE;
+    }
+
+    /* szukanie pierwszej strony, ktora nie jest kontynuacja strony 0 */
+    while (low < high)
+    {
+        uint32_t mid = (low + high) / 2;
+        uint32_t sequence = readSequence(mid);
+
+        if ((sequence == DATALOG_EMPTY) || (sequence < first))
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1;
+        }
+    }
+
+    headPage = low % DATALOG_PAGES;
+    nextSequence = readSequence(low - 1) + 1;
+    wrapped = (readSequence(headPage) != DATALOG_EMPTY) ? TRUE : FALSE;
+    ready = TRUE;
+    findSegment();
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Procedura dopisujaca rekord do dziennika. Rekordy sa zbierane w
+ *            pamieci RAM i zapisywane cala strona naraz.
+ *  @param    pRecord
+ *              Rekord
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do pamieci DataFlash po zapelnieniu strony
+ */
+void datalog_append(const datalog_record_t* pRecord)
+{
+    if (ready == FALSE)
+    {
+        return;
+    }
+
+    if (pRecord->time < lastTime)
+    {
+        segmentStart = datalog_getRecordCount();
+    }
+    lastTime = pRecord->time;
+
+    memcpy(&page[HEADER_SIZE + pageRecords * RECORD_SIZE], pRecord, RECORD_SIZE);
+    pageRecords++;
+
+    if (pageRecords == recordsPerPage)
+    {
+        writePage();
+    }
+}
+
+/*!
+ *  @brief    Funkcja zwracajaca liczbe stron zapisanych w pamieci DataFlash
+ *  @param    Brak
+ *  @returns  Liczba stron
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t datalog_getPageCount(void)
+{
+    return (wrapped == TRUE) ? DATALOG_PAGES : headPage;
+}
+
+/*!
+ *  @brief    Getter rozmiaru strony dziennika
+ *  @param    Brak
+ *  @returns  Rozmiar strony w bajtach
+ *  @side_effects:
+ *            Brak
+ */
+uint16_t datalog_getPageSize(void)
+{
+    return pageSize;
+}
+
+/*!
+ *  @brief    Funkcja odczytujaca strone dziennika w postaci surowej
+ *  @param    index
+ *              Numer strony liczony od najstarszej
+ *  @param    pBuf
+ *              Bufor o rozmiarze co najmniej datalog_getPageSize()
+ *  @returns  TRUE w przypadku powodzenia
+ *  @side_effects:
+ *            Odczyt pamieci DataFlash
+ */
+Bool datalog_readPage(uint32_t index, uint8_t* pBuf)
+{
+    uint32_t physical = 0;
+
+    if ((ready == FALSE) || (index >= datalog_getPageCount()))
+    {
+        return FALSE;
+    }
+
+    physical = (wrapped == TRUE) ? ((headPage + index) % DATALOG_PAGES) : index;
+
+    return (flash_read(pBuf, physical * pageSize, pageSize) == pageSize) ? TRUE : FALSE;
+}
+
+/*!
+ *  @brief    Funkcja zwracajaca liczbe rekordow w dzienniku, lacznie z
+ *            rekordami jeszcze niezapisanymi w pamieci DataFlash
+ *  @param    Brak
+ *  @returns  Liczba rekordow
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t datalog_getRecordCount(void)
+{
+    return datalog_getPageCount() * recordsPerPage + pageRecords;
+}
+
+/*!
+ *  @brief    Funkcja zwracajaca poczatek najnowszego odcinka dziennika, w
+ *            ktorym czas rekordow nie maleje. Rekordy od tego indeksu do
+ *            konca dziennika mozna przeszukiwac binarnie po czasie.
+ *  @param    Brak
+ *  @returns  Indeks rekordu liczony od najstarszego
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t datalog_getSegmentStart(void)
+{
+    return segmentStart;
+}
+
+/*!
+ *  @brief    Funkcja zwracajaca liczbe rekordow usunietych z poczatku
+ *            dziennika od inicjalizacji. Suma indeksu rekordu i tej liczby
+ *            nie zmienia sie przy nadpisywaniu najstarszych stron.
+ *  @param    Brak
+ *  @returns  Liczba usunietych rekordow
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t datalog_getDroppedCount(void)
+{
+    return dropped;
+}
+
+/*!
+ *  @brief    Funkcja odczytujaca pojedynczy rekord dziennika
+ *  @param    index
+ *              Numer rekordu liczony od najstarszego
+ *  @param    pRecord
+ *              Wynik
+ *  @returns  TRUE w przypadku powodzenia
+ *  @side_effects:
+ *            Odczyt pamieci DataFlash
+ */
+Bool datalog_readRecord(uint32_t index, datalog_record_t* pRecord)
+{
+    uint32_t pageIndex = 0;
+    uint32_t physical = 0;
+    uint32_t slot = 0;
+
+    if ((ready == FALSE) || (index >= datalog_getRecordCount()))
+    {
+        return FALSE;
+    }
+
+    pageIndex = index / recordsPerPage;
+    slot = index % recordsPerPage;
+
+    if (pageIndex == datalog_getPageCount())
+    {
+        memcpy(pRecord, &page[HEADER_SIZE + slot * RECORD_SIZE], RECORD_SIZE);
+        return TRUE;
+    }
+
+    physical = (wrapped == TRUE) ? ((headPage + pageIndex) % DATALOG_PAGES) : pageIndex;
+
+    return (flash_read((uint8_t*)pRecord, physical * pageSize + HEADER_SIZE + slot * RECORD_SIZE,
+            RECORD_SIZE) == RECORD_SIZE) ? TRUE : FALSE;
+}
+
+/*!
+ *  @brief    Funkcja zamieniajaca czas z zegara RTC na czas UNIX
+ *  @param    pRtc
+ *              Czas odczytany z zegara RTC
+ *  @returns  Liczba sekund od 1.01.1970
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t datalog_rtcToTime(const RTC_TIME_Type* pRtc)
+{
+    uint32_t year = pRtc->YEAR;
+    uint32_t month = pRtc->MONTH;
+    uint32_t days = 0;
+
+    /* liczba dni od 1.03.0000, rok zaczyna sie od marca */
+    if (month <= 2)
+    {
+        year--;
+        month += 12;
+    }
+    days = 365 * year + year / 4 - year / 100 + year / 400 + (153 * (month - 3) + 2) / 5 + pRtc->DOM - 1;
+
+    /* 719468 - liczba dni od 1.03.0000 do 1.01.1970 */
+    return (days - 719468) * 86400 + pRtc->HOUR * 3600 + pRtc->MIN * 60 + pRtc->SEC;
+}
@@ -0,0 +1,50 @@
+#ifndef DATALOG_H_
+#define DATALOG_H_
+
+#include "lpc_types.h"
+#include "lpc17xx_rtc.h"
+
+#define DATALOG_VERSION 2
+
+/* Najwieksza obslugiwana strona pamieci DataFlash */
+#define DATALOG_MAX_PAGE_SIZE 528
+
+/* Naglowek strony dziennika w pamieci DataFlash */
+typedef struct
+{
+    uint32_t sequence;           /* Numer kolejny strony, 0xFFFFFFFF - strona pusta */
+    uint8_t version;
+    uint8_t count;               /* Liczba rekordow na stronie */
+    uint16_t crc;                /* CRC-16 rekordow */
+} datalog_page_header_t;
+
+/*
+ * Rekord dziennika (20 bajtow). Strony innych wersji (wersja 1 miala rekordy
+ * 16-bajtowe) sa traktowane jak puste i nadpisywane, wiec zmiana wersji
+ * oznacza utrate wczesniejszej historii.
+ */
+typedef struct
+{
+    uint32_t time;               /* Czas UNIX [s] */
+    int32_t pressure;            /* Cisnienie [Pa] */
+    int16_t temperature;         /* Temperatura [0.1 C] */
+    int16_t humidity;            /* Wilgotnosc [%] */
+    int16_t dewPoint;            /* Punkt rosy [0.1 C], 0 w starszych rekordach */
+    uint16_t absHumidity;        /* Wilgotnosc bezwzgledna [0.01 g/m3], 0 w starszych rekordach */
+    uint16_t light;              /* Natezenie swiatla [lx] */
+    uint8_t invalid;             /* Maska METRIC_BIT pol bez poprawnej wartosci, 0 w starszych rekordach */
+    uint8_t reserved;
+} datalog_record_t;
+
+Bool datalog_init(void);
+void datalog_append(const datalog_record_t* pRecord);
+uint32_t datalog_getPageCount(void);
+uint16_t datalog_getPageSize(void);
+Bool datalog_readPage(uint32_t index, uint8_t* pBuf);
+uint32_t datalog_getRecordCount(void);
+uint32_t datalog_getSegmentStart(void);
+uint32_t datalog_getDroppedCount(void);
+Bool datalog_readRecord(uint32_t index, datalog_record_t* pRecord);
+uint32_t datalog_rtcToTime(const RTC_TIME_Type* pRtc);
+
+#endif /* DATALOG_H_ */
@@ -0,0 +1,202 @@
+#include "derived.h"
+
+/*
+ * Punkt rosy ze wzoru Magnusa (b = 17.62, c = 243.12 C):
+ *   gamma = ln(RH / 100) + b * T / (c + T),  Td = c * gamma / (b - gamma)
+ * Oba skladniki gamma sa odczytywane z tablic w formacie Q12, wynik wymaga
+ * jednego dzielenia 32-bitowego.
+ */
+#define MAGNUS_B_Q12   72172   /* 17.62 * 4096 */
+#define MAGNUS_C_X100  24312   /* 243.12 C w 0.01 C */
+
+/* ln(RH / 100) w formacie Q12 dla RH = 0..100 % (dla 0 jak dla 1 %) */
+static const int16_t lnHumidity[101] =
+{
+    -18863, -18863, -16024, -14363, -13185, -12271, -11524, -10892, -10345, -9863,
+    -9431, -9041, -8685, -8357, -8053, -7771, -7506, -7258, -7024, -6802,
+    -6592, -6392, -6202, -6020, -5845, -5678, -5518, -5363, -5214, -5070,
+    -4931, -4797, -4667, -4541, -4419, -4300, -4185, -4072, -3963, -3857,
+    -3753, -3652, -3553, -3457, -3363, -3271, -3181, -3093, -3006, -2922,
+    -2839, -2758, -2678, -2600, -2524, -2449, -2375, -2302, -2231, -2161,
+    -2092, -2025, -1958, -1892, -1828, -1764, -1702, -1640, -1580, -1520,
+    -1461, -1403, -1346, -1289, -1233, -1178, -1124, -1071, -1018, -966,
+    -914, -863, -813, -763, -714, -666, -618, -570, -524, -477,
+    -432, -386, -342, -297, -253, -210, -167, -125, -83, -41,
+    0
+};
+
+/* b * T / (c + T) w formacie Q12 dla T = -40..60 C co 1 C */
+static const int16_t magnusTemp[101] =
+{
+    -14213, -13789, -13370, -12955, -12544, -12137, -11734, -11335, -10939, -10547,
+    -10159, -9775, -9394, -9016, -8642, -8272, -7905, -7541, -7181, -6823,
+    -6469, -6118, -5771, -5426, -5084, -4746, -4410, -4077, -3747, -3420,
+    -3096, -2774, -2456, -2140, -1826, -1515, -1207, -902, -599, -298,
+    0, 296, 589, 880, 1168, 1454, 1738, 2020, 2299, 2576,
+    2851, 3124, 3395, 3663, 3930, 4194, 4456, 4717, 4975, 5231,
+    5486, 5738, 5989, 6238, 6484, 6729, 6973, 7214, 7454, 7691,
+    7927, 8162, 8394, 8625, 8855, 9082, 9308, 9533, 9756, 9977,
+    10197, 10415, 10631, 10846, 11060, 11272, 11483, 11692, 11900, 12106,
+    12311, 12514, 12717, 12917, 13117, 13315, 13512, 13707, 13901, 14094,
+    14286
+};
+
+/*
+ * Gestosc pary wodnej w stanie nasycenia [0.001 g/m3] dla T = -40..60 C co
+ * 1 C: 216.7 * es(T) / (273.15 + T), es z tego samego wzoru Magnusa [hPa].
+ */
+static const uint32_t saturationDensity[101] =
+{
+    177, 195, 215, 237, 261, 287, 316, 347,
+    380, 417, 456, 499, 545, 595, 650, 708,
+    772, 840, 914, 993, 1078, 1170, 1269, 1375,
+    1489, 1611, 1741, 1882, 2032, 2192, 2364, 2547,
+    2743, 2952, 3174, 3412, 3665, 3934, 4220, 4525,
+    4849, 5193, 5558, 5945, 6356, 6792, 7253, 7741,
+    8258, 8805, 9383, 9994, 10639, 11320, 12039, 12797,
+    13597, 14439, 15326, 16260, 17243, 18277, 19364, 20507,
+    21707, 22968, 24291, 25680, 27136, 28663, 30264, 31941,
+    33697, 35535, 37459, 39471, 41576, 43775, 46074, 48475,
+    50983, 53600, 56332, 59181, 62152, 65250, 68478, 71841,
+    75343, 78990, 82785, 86734, 90842, 95113, 99553, 104168,
+    108962, 113941, 119111, 124478, 130048
+};
+
+/* Siatka wskaznika upalu: temperatura co 2 C, wilgotnosc co 10 % */
+#define HEAT_ROWS     13
+#define HEAT_COLS     11
+#define HEAT_T_STEP   20
+
+/* Wskaznik upalu NOAA (Rothfusz z poprawkami) [0.1 C] */
+static const int16_t heatIndex[HEAT_ROWS][HEAT_COLS] =
+{
+    {  247,  249,  252,  254,  257,  260,  262,  265,  267,  270,  273 }, /* 26 C */
+    {  258,  264,  267,  271,  277,  284,  294,  307,  321,  340,  364 }, /* 28 C */
+    {  272,  279,  282,  288,  297,  310,  328,  350,  377,  408,  444 }, /* 30 C */
+    {  287,  294,  300,  308,  323,  344,  371,  404,  444,  490,  542 }, /* 32 C */
+    {  301,  311,  320,  333,  354,  384,  422,  468,  522,  584,  655 }, /* 34 C */
+    {  316,  328,  342,  362,  391,  431,  481,  542,  612,  692,  782 }, /* 36 C */
+    {  332,  347,  367,  394,  434,  486,  550,  625,  713,  812,  924 }, /* 38 C */
+    {  347,  367,  394,  431,  483,  548,  626,  719,  825,  945, 1079 }, /* 40 C */
+    {  363,  388,  423,  472,  537,  617,  712,  823,  949, 1090, 1248 }, /* 42 C */
+    {  379,  410,  455,  517,  596,  693,  806,  936, 1084, 1249, 1430 }, /* 44 C */
+    {  393,  432,  490,  566,  662,  776,  909, 1060, 1230, 1419, 1627 }, /* 46 C */
+    {  402,  454,  527,  620,  733,  866, 1020, 1194, 1388, 1602, 1837 }, /* 48 C */
+    {  410,  477,  566,  677,  809,  964, 1140, 1337, 1557, 1798, 2062 }  /* 50 C */
+};
+
+/*!
+ *  @brief    Funkcja wyznaczajaca wskaznik upalu interpolacja dwuliniowa
+ *  @param    temperature
+ *              Temperatura [0.1 C]
+ *  @param    humidity
+ *              Wilgotnosc [%], 0..100
+ *  @returns  Wskaznik upalu [0.1 C]
+ *  @side_effects:
+ *            Brak
+ */
+static int32_t heatIndexLookup(int32_t temperature, int32_t humidity)
+{
+    int32_t row = 0;
+    int32_t fracT = 0;
+    int32_t col = 0;
+    int32_t fracH = 0;
+    int32_t low = 0;
+    int32_t high = 0;
+
+    if (temperature < DERIVED_HEAT_INDEX_MIN)
+    {
+        return temperature;
+    }
+
+    row = (temperature - DERIVED_HEAT_INDEX_MIN) / HEAT_T_STEP;
+    fracT = (temperature - DERIVED_HEAT_INDEX_MIN) - row * HEAT_T_STEP;
+    if (row >= (HEAT_ROWS - 1))
+    {
+        row = HEAT_ROWS - 2;
+        fracT = HEAT_T_STEP;
+    }
+
+    col = humidity / 10;
+    fracH = humidity - col * 10;
+    if (col >= (HEAT_COLS - 1))
+    {
+        col = HEAT_COLS - 2;
+        fracH = 10;
+    }
+
+    low = heatIndex[row][col] * (10 - fracH) + heatIndex[row][col + 1] * fracH;
+    high = heatIndex[row + 1][col] * (10 - fracH) + heatIndex[row + 1][col + 1] * fracH;
+
+    return (low * (HEAT_T_STEP - fracT) + high * fracT + (10 * HEAT_T_STEP) / 2) / (10 * HEAT_T_STEP);
+}
+
+/*!
+ *  @brief    Procedura wyznaczajaca punkt rosy, wilgotnosc bezwzgledna i
+ *            wskaznik upalu z jednego odczytu. Tablice co 1 C z interpolacja
+ *            liniowa, tylko arytmetyka calkowitoliczbowa.
+ *  @param    temperature
+ *              Temperatura [0.1 C]
+ *  @param    humidity
+ *              Wilgotnosc wzgledna [%]
+ *  @param    pResult
+ *              Wynik
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void derived_compute(int32_t temperature, int16_t humidity, derived_t* pResult)
+{
+    int32_t rh = humidity;
+    int32_t offset = 0;
+    int32_t index = 0;
+    int32_t frac = 0;
+    int32_t gamma = 0;
+    int32_t num = 0;
+    int32_t den = 0;
+    uint32_t density = 0;
+
+    if (rh < 0)
+    {
+        rh = 0;
+    }
+    if (rh > 100)
+    {
+        rh = 100;
+    }
+
+    /* Indeks tablic temperatury i czesc ulamkowa w 0.1 C */
+    offset = temperature;
+    if (offset < DERIVED_TEMP_MIN)
+    {
+        offset = DERIVED_TEMP_MIN;
+    }
+    if (offset > DERIVED_TEMP_MAX)
+    {
+        offset = DERIVED_TEMP_MAX;
+    }
+    offset -= DERIVED_TEMP_MIN;
+    index = offset / 10;
+    frac = offset - index * 10;
+    if (index == 100)
+    {
+        index = 99;
+        frac = 10;
+    }
+
+    gamma = lnHumidity[rh] + magnusTemp[index]
+            + ((magnusTemp[index + 1] - magnusTemp[index]) * frac) / 10;
+
+    /* Td = c * gamma / (b - gamma) w 0.1 C, zaokraglone */
+    num = gamma * MAGNUS_C_X100;
+    den = (MAGNUS_B_Q12 - gamma) * 10;
+    pResult->dewPoint = (int16_t)((num + ((num >= 0) ? (den / 2) : -(den / 2))) / den);
+
+    density = saturationDensity[index]
+            + ((saturationDensity[index + 1] - saturationDensity[index]) * (uint32_t)frac) / 10;
+    pResult->absHumidity = (uint16_t)(((uint32_t)rh * density + 500) / 1000);
+
+    pResult->heatIndex = (int16_t)heatIndexLookup(temperature, rh);
+
+    pResult->frostRisk = ((temperature <= DERIVED_FROST_TEMP) && (pResult->dewPoint < 0)) ? TRUE : FALSE;
+}
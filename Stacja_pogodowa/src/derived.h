@@ -0,0 +1,27 @@
+#ifndef DERIVED_H_
+#define DERIVED_H_
+
+#include "lpc_types.h"
+
+/* Zakres temperatur tablic [0.1 C], poza nim wynik dla wartosci granicznej */
+#define DERIVED_TEMP_MIN  (-400)
+#define DERIVED_TEMP_MAX  600
+
+/* Ponizej tej temperatury [0.1 C] wskaznik upalu jest rowny temperaturze */
+#define DERIVED_HEAT_INDEX_MIN 260
+
+/* Ryzyko przymrozku: temperatura najwyzej 3.0 C i punkt rosy ponizej zera */
+#define DERIVED_FROST_TEMP 30
+
+/* Wielkosci wyznaczane z pary odczytow temperatury i wilgotnosci */
+typedef struct
+{
+    int16_t dewPoint;            /* Punkt rosy [0.1 C] */
+    uint16_t absHumidity;        /* Wilgotnosc bezwzgledna [0.01 g/m3] */
+    int16_t heatIndex;           /* Wskaznik upalu (NOAA) [0.1 C] */
+    Bool frostRisk;              /* TRUE - ryzyko przymrozku */
+} derived_t;
+
+void derived_compute(int32_t temperature, int16_t humidity, derived_t* pResult);
+
+#endif /* DERIVED_H_ */
@@ -0,0 +1,291 @@
+#include "lpc17xx_gpdma.h"
+
+#include "export.h"
+#include "datalog.h"
+#include "telemetry_frame.h"
+#include "uart0.h"
+#include "cobs.h"
+#include "crc.h"
+
+/* Kanal GPDMA o najnizszym priorytecie */
+#define EXPORT_DMA_CHANNEL 7
+
+#define EXPORT_RAW_SIZE (TELEMETRY_HEADER_SIZE + TELEMETRY_EXPORT_SIZE + DATALOG_MAX_PAGE_SIZE + TELEMETRY_CRC_SIZE)
+#define EXPORT_BUFFER_SIZE (COBS_MAX_ENCODED_SIZE(EXPORT_RAW_SIZE) + 1)
+
+/* Stan eksportu */
+enum exportState
+{
+    EXPORT_IDLE,
+    EXPORT_DRAIN,
+    EXPORT_RUN
+};
+
+/* Bufor z zakodowana ramka gotowa do wyslania przez GPDMA */
+typedef struct
+{
+    uint8_t data[EXPORT_BUFFER_SIZE];
+    uint32_t len;
+    volatile Bool ready;
+} export_buffer_t;
+
+static enum exportState state = EXPORT_IDLE;
+
+/*
+ * Dwa bufory: jeden jest wysylany przez GPDMA, w tym czasie do drugiego
+ * czytana jest kolejna strona z pamieci DataFlash.
+ */
+static export_buffer_t buffers[2];
+static uint8_t raw[EXPORT_RAW_SIZE];
+static uint8_t fillIndex = 0;
+static volatile uint8_t sendIndex = 0;
+static volatile Bool dmaBusy = FALSE;
+
+static uint32_t nextPage = 0;
+static uint32_t pageCount = 0;
+static Bool endSent = FALSE;
+
+/*!
+ *  @brief    Procedura uruchamiajaca wysylanie bufora przez GPDMA do FIFO
+ *            nadajnika UART0
+ *  @param    pBuffer
+ *              Bufor
+ *  @returns  Nic
+ *  @side_effects:
+ *            Konfiguracja kanalu GPDMA
+ */
+static void startDma(export_buffer_t* pBuffer)
+{
+    GPDMA_Channel_CFG_Type dmaCfg;
+
+    dmaCfg.ChannelNum = EXPORT_DMA_CHANNEL;
+    dmaCfg.SrcMemAddr = (uint32_t)pBuffer->data;
+    dmaCfg.DstMemAddr = 0;
+    dmaCfg.TransferSize = pBuffer->len;
+    dmaCfg.TransferWidth = 0;
+    dmaCfg.TransferType = GPDMA_TRANSFERTYPE_M2P;
+    dmaCfg.SrcConn = 0;
+    dmaCfg.DstConn = GPDMA_CONN_UART0_Tx;
+    dmaCfg.DMALLI = 0;
+
+    dmaBusy = TRUE;
+    GPDMA_Setup(&dmaCfg);
+    GPDMA_ChannelCmd(EXPORT_DMA_CHANNEL, ENABLE);
+}
+
+/*!
+ *  @brief    Procedura obslugi przerwania GPDMA. Po wyslaniu bufora od razu
+ *            uruchamia wysylanie nastepnego, jesli jest gotowy.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana stanu buforow
+ */
+void DMA_IRQHandler(void)
+{
+    if (GPDMA_IntGetStatus(GPDMA_STAT_INT, EXPORT_DMA_CHANNEL) == RESET)
+    {
+        return;
+    }
+
+    GPDMA_ClearIntPending(GPDMA_STATCLR_INTTC, EXPORT_DMA_CHANNEL);
+    GPDMA_ClearIntPending(GPDMA_STATCLR_INTERR, EXPORT_DMA_CHANNEL);
+    GPDMA_ChannelCmd(EXPORT_DMA_CHANNEL, DISABLE);
+
+    buffers[sendIndex].ready = FALSE;
+    sendIndex ^= 1;
+    dmaBusy = FALSE;
+
+    if (buffers[sendIndex].ready == TRUE)
+    {
+        startDma(&buffers[sendIndex]);
+    }
+}
+
+/*!
+ *  @brief    Procedura wpisujaca liczbe 32-bitowa (little-endian)
+ *  @param    pBuf
+ *              Bufor
+ *  @param    value
+ *              Wartosc
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void putU32(uint8_t* pBuf, uint32_t value)
+{
+    pBuf[0] = (uint8_t)value;
+    pBuf[1] = (uint8_t)(value >> 8);
+    pBuf[2] = (uint8_t)(value >> 16);
+    pBuf[3] = (uint8_t)(value >> 24);
+}
+
+/*!
+ *  @brief    Procedura przygotowujaca ramke TELEMETRY_REC_EXPORT z kolejna
+ *            strona dziennika. Strona jest czytana wprost na swoje miejsce w
+ *            ramce. Po ostatniej stronie wysylana jest ramka konczaca.
+ *  @param    pBuffer
+ *              Bufor na zakodowana ramke
+ *  @returns  Nic
+ *  @side_effects:
+ *            Odczyt pamieci DataFlash, zmiana numeru kolejnej strony
+ */
+static void fillBuffer(export_buffer_t* pBuffer)
+{
+    uint8_t* pData = &raw[TELEMETRY_HEADER_SIZE + TELEMETRY_EXPORT_SIZE];
+    uint16_t len = 0;
+    uint16_t crc = 0;
+    uint32_t rawLen = 0;
+
+    if ((nextPage < pageCount) && (datalog_readPage(nextPage, pData) == TRUE))
+    {
+        len = datalog_getPageSize();
+    }
+
+    raw[0] = TELEMETRY_REC_EXPORT;
+    raw[1] = (uint8_t)nextPage;
+    putU32(&raw[2], (len != 0) ? nextPage : pageCount);
+    putU32(&raw[6], pageCount);
+    raw[10] = (uint8_t)len;
+    raw[11] = (uint8_t)(len >> 8);
+
+    rawLen = TELEMETRY_HEADER_SIZE + TELEMETRY_EXPORT_SIZE + len;
+    crc = crc16(raw, rawLen);
+    raw[rawLen++] = (uint8_t)crc;
+    raw[rawLen++] = (uint8_t)(crc >> 8);
+
+    pBuffer->len = cobs_encode(raw, rawLen, pBuffer->data);
+    pBuffer->data[pBuffer->len++] = 0;
+    pBuffer->ready = TRUE;
+
+    if (len != 0)
+    {
+        nextPage++;
+    }
+    else
+    {
+        endSent = TRUE;
+    }
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca kontroler GPDMA dla eksportu
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Konfiguracja GPDMA i kontrolera NVIC
+ */
+void export_init(void)
+{
+    GPDMA_Init();
+
+    NVIC_SetPriority(DMA_IRQn, 3);
+    NVIC_EnableIRQ(DMA_IRQn);
+}
+
+/*!
+ *  @brief    Funkcja rozpoczynajaca eksport dziennika przez UART0. Eksport
+ *            mozna wznowic od dowolnej strony, np. po przerwaniu transmisji.
+ *  @param    fromPage
+ *              Pierwsza wysylana strona liczona od najstarszej
+ *  @returns  TRUE jesli eksport zostal rozpoczety
+ *  @side_effects:
+ *            Brak
+ */
+Bool export_start(uint32_t fromPage)
+{
+    if (state != EXPORT_IDLE)
+    {
+        return FALSE;
+    }
+
+    pageCount = datalog_getPageCount();
+    nextPage = (fromPage < pageCount) ? fromPage : pageCount;
+    endSent = FALSE;
+    fillIndex = 0;
+    sendIndex = 0;
+    buffers[0].ready = FALSE;
+    buffers[1].ready = FALSE;
+    state = EXPORT_DRAIN;
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Procedura przerywajaca eksport. Ramki juz przygotowane sa
+ *            wysylane, po nich wysylana jest ramka konczaca.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void export_stop(void)
+{
+    pageCount = nextPage;
+}
+
+/*!
+ *  @brief    Procedura prowadzaca eksport, wywolywana w petli glownej.
+ *            Czeka az bufor nadawczy UART0 sie oprozni, przelacza nadajnik na
+ *            GPDMA i uzupelnia wolne bufory kolejnymi stronami.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Odczyt pamieci DataFlash, zmiana trybu nadajnika UART0
+ */
+void export_poll(void)
+{
+    switch (state)
+    {
+        case EXPORT_DRAIN:
+        {
+            if (uart0_txIdle() == TRUE)
+            {
+                uart0_setTxDma(TRUE);
+                state = EXPORT_RUN;
+            }
+            break;
+        }
+        case EXPORT_RUN:
+        {
+            while ((buffers[fillIndex].ready == FALSE) && (endSent == FALSE))
+            {
+                fillBuffer(&buffers[fillIndex]);
+                fillIndex ^= 1;
+            }
+
+            NVIC_DisableIRQ(DMA_IRQn);
+            if ((dmaBusy == FALSE) && (buffers[sendIndex].ready == TRUE))
+            {
+                startDma(&buffers[sendIndex]);
+            }
+            NVIC_EnableIRQ(DMA_IRQn);
+
+            if ((endSent == TRUE) && (dmaBusy == FALSE) && (buffers[sendIndex].ready == FALSE))
+            {
+                if (uart0_txIdle() == TRUE)
+                {
+                    uart0_setTxDma(FALSE);
+                    state = EXPORT_IDLE;
+                }
+            }
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/*!
+ *  @brief    Funkcja sprawdzajaca czy trwa eksport
+ *  @param    Brak
+ *  @returns  TRUE jesli trwa eksport
+ *  @side_effects:
+ *            Brak
+ */
+Bool export_isActive(void)
+{
+    return (state != EXPORT_IDLE) ? TRUE : FALSE;
+}
@@ -0,0 +1,12 @@
+#ifndef EXPORT_H_
+#define EXPORT_H_
+
+#include "lpc_types.h"
+
+void export_init(void);
+Bool export_start(uint32_t fromPage);
+void export_stop(void);
+void export_poll(void);
+Bool export_isActive(void);
+
+#endif /* EXPORT_H_ */
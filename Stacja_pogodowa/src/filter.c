@@ -0,0 +1,242 @@
+#include "filter.h"
+#include "config.h"
+
+/* Zakres poprawnych odczytow czujnikow, odczyt spoza zakresu jest bledny */
+static const int32_t validMin[FILTER_SENSORS] = { -400, 30000, 0 };
+static const int32_t validMax[FILTER_SENSORS] = { 1250, 110000, 100 };
+
+static filter_t filters[FILTER_SENSORS];
+
+/*!
+ *  @brief    Funkcja wyznaczajaca mediane ostatnich odczytow przez sortowanie
+ *            przez wstawianie kopii, co najwyzej FILTER_MEDIAN_MAX elementow
+ *  @param    pFilter
+ *              Filtr
+ *  @returns  Mediana ostatnich config.median odczytow
+ *  @side_effects:
+ *            Brak
+ */
+static int32_t median(const filter_t* pFilter)
+{
+    int32_t sorted[FILTER_MEDIAN_MAX];
+    uint32_t count = pFilter->config.median;
+    uint32_t index = pFilter->next;
+    int32_t value = 0;
+    uint32_t i = 0;
+    uint32_t j = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        index = (index == 0) ? (FILTER_MEDIAN_MAX - 1) : (index - 1);
+        value = pFilter->history[index];
+
+        for (j = i; (j > 0) && (sorted[j - 1] > value); j--)
+        {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = value;
+    }
+
+    return sorted[count / 2];
+}
+
+/*!
+ *  @brief    Funkcja wygladzajaca wynik filtru medianowego
+ *  @param    pFilter
+ *              Filtr
+ *  @param    value
+ *              Wynik filtru medianowego
+ *  @returns  Wartosc wygladzona
+ *  @side_effects:
+ *            Zmiana estymaty i wariancji filtru
+ */
+static int32_t smooth(filter_t* pFilter, int32_t value)
+{
+    int32_t measured = value << 8;
+    uint32_t gain = 0;
+    uint32_t sum = 0;
+
+    switch (pFilter->config.smoother)
+    {
+        case FILTER_SMOOTH_EMA:
+        {
+            pFilter->estimate += (measured - pFilter->estimate) >> pFilter->config.shift;
+            break;
+        }
+        case FILTER_SMOOTH_KALMAN:
+        {
+            /*
+             * Predykcja: wartosc stala, wariancja rosnie o q. Korekta:
+             * wzmocnienie K = P / (P + r) w formacie Q12. Po korekcie P < r,
+             * wiec P + q < 2^17 i przesuniecie miesci sie w 32 bitach.
+             */
+            pFilter->variance += pFilter->config.processNoise;
+            sum = pFilter->variance + pFilter->config.measurementNoise;
+            gain = (sum == 0) ? 4096 : ((pFilter->variance << 12) / sum);
+
+            pFilter->estimate += (int32_t)(((int64_t)gain * (measured - pFilter->estimate)) >> 12);
+            pFilter->variance -= (gain * pFilter->variance) >> 12;
+            break;
+        }
+        default:
+        {
+            pFilter->estimate = measured;
+            break;
+        }
+    }
+
+    return (pFilter->estimate + 128) >> 8;
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca filtry wszystkich czujnikow ustawieniami
+ *            z konfiguracji
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyzerowanie stanu filtrow
+ */
+void filter_init(void)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < FILTER_SENSORS; i++)
+    {
+        if (filter_configure((uint8_t)i, &config_get()->filters[i]) == FALSE)
+        {
+            filters[i].config.median = 1;
+            filters[i].config.smoother = FILTER_SMOOTH_NONE;
+            filters[i].started = FALSE;
+        }
+        filters[i].rejected = 0;
+    }
+}
+
+/*!
+ *  @brief    Funkcja zmieniajaca ustawienia filtru czujnika. Filtr startuje
+ *            od nastepnego poprawnego odczytu.
+ *  @param    sensor
+ *              FILTER_xxx
+ *  @param    pConfig
+ *              Ustawienia
+ *  @returns  FALSE dla niepoprawnego czujnika lub ustawien
+ *  @side_effects:
+ *            Wyzerowanie stanu filtru
+ */
+Bool filter_configure(uint8_t sensor, const filter_config_t* pConfig)
+{
+    if ((sensor >= FILTER_SENSORS)
+            || ((pConfig->median != 1) && (pConfig->median != 3) && (pConfig->median != 5))
+            || (pConfig->smoother > FILTER_SMOOTH_KALMAN) || (pConfig->shift > 7))
+    {
+        return FALSE;
+    }
+
+    filters[sensor].config = *pConfig;
+    filters[sensor].started = FALSE;
+    filters[sensor].invalidRun = 0;
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Getter ustawien filtru
+ *  @param    sensor
+ *              FILTER_xxx
+ *  @returns  Wskaznik na ustawienia lub NULL dla niepoprawnego czujnika
+ *  @side_effects:
+ *            Brak
+ */
+const filter_config_t* filter_getConfig(uint8_t sensor)
+{
+    if (sensor >= FILTER_SENSORS)
+    {
+        return NULL;
+    }
+
+    return &filters[sensor].config;
+}
+
+/*!
+ *  @brief    Funkcja przepuszczajaca odczyt surowy przez filtr czujnika:
+ *            odrzucenie odczytow blednych i spoza zakresu, filtr medianowy
+ *            (usuwa pojedyncze skoki) i wygladzanie. Koszt staly.
+ *  @param    sensor
+ *              FILTER_xxx
+ *  @param    raw
+ *              Odczyt surowy
+ *  @param    valid
+ *              FALSE, gdy odczyt zakonczyl sie bledem komunikacji
+ *  @param    pOutput
+ *              Wynik filtru. Po blednym odczycie poprzedni wynik, jesli
+ *              bledow bylo mniej niz FILTER_HOLD_LIMIT.
+ *  @returns  FALSE, gdy wynik jest niewazny (brak poprawnego odczytu)
+ *  @side_effects:
+ *            Zmiana stanu filtru
+ */
+Bool filter_update(uint8_t sensor, int32_t raw, Bool valid, int32_t* pOutput)
+{
+    filter_t* pFilter = NULL;
+    uint32_t i = 0;
+
+    if (sensor >= FILTER_SENSORS)
+    {
+        return FALSE;
+    }
+
+    pFilter = &filters[sensor];
+
+    if ((valid == FALSE) || (raw < validMin[sensor]) || (raw > validMax[sensor]))
+    {
+        pFilter->rejected++;
+        if (pFilter->invalidRun < FILTER_HOLD_LIMIT)
+        {
+            pFilter->invalidRun++;
+        }
+        if ((pFilter->started == FALSE) || (pFilter->invalidRun >= FILTER_HOLD_LIMIT))
+        {
+            return FALSE;
+        }
+
+        *pOutput = (pFilter->estimate + 128) >> 8;
+        return TRUE;
+    }
+
+    /* Po dluzszej serii bledow filtr startuje od nowa */
+    if ((pFilter->started == FALSE) || (pFilter->invalidRun >= FILTER_HOLD_LIMIT))
+    {
+        for (i = 0; i < FILTER_MEDIAN_MAX; i++)
+        {
+            pFilter->history[i] = raw;
+        }
+        pFilter->next = 0;
+        pFilter->estimate = raw << 8;
+        pFilter->variance = pFilter->config.measurementNoise;
+        pFilter->started = TRUE;
+    }
+    pFilter->invalidRun = 0;
+
+    pFilter->history[pFilter->next] = raw;
+    pFilter->next = (uint8_t)((pFilter->next + 1) % FILTER_MEDIAN_MAX);
+
+    *pOutput = smooth(pFilter, median(pFilter));
+    return TRUE;
+}
+
+/*!
+ *  @brief    Getter licznika odrzuconych odczytow
+ *  @param    sensor
+ *              FILTER_xxx
+ *  @returns  Liczba odczytow blednych lub spoza zakresu od startu
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t filter_getRejected(uint8_t sensor)
+{
+    if (sensor >= FILTER_SENSORS)
+    {
+        return 0;
+    }
+
+    return filters[sensor].rejected;
+}
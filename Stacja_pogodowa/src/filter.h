@@ -0,0 +1,56 @@
+#ifndef FILTER_H_
+#define FILTER_H_
+
+#include "lpc_types.h"
+
+/* Czujniki z filtrem odczytow surowych */
+#define FILTER_TEMPERATURE 0     /* [0.1 C] */
+#define FILTER_PRESSURE    1     /* Cisnienie na stacji [Pa] */
+#define FILTER_HUMIDITY    2     /* [%] */
+#define FILTER_SENSORS     3
+
+/* Najdluzszy filtr medianowy */
+#define FILTER_MEDIAN_MAX  5
+
+/* Filtr wygladzajacy po filtrze medianowym */
+#define FILTER_SMOOTH_NONE   0
+#define FILTER_SMOOTH_EMA    1   /* Srednia wykladnicza, alfa = 1 / 2^shift */
+#define FILTER_SMOOTH_KALMAN 2   /* Jednowymiarowy filtr Kalmana, model stalej wartosci */
+
+/* Liczba kolejnych blednych odczytow, po ktorej wynik filtru jest niewazny */
+#define FILTER_HOLD_LIMIT  5
+
+/* Ustawienia filtru jednego czujnika, przechowywane w konfiguracji */
+typedef struct
+{
+    uint8_t median;              /* Dlugosc filtru medianowego: 1 (wylaczony), 3 lub 5 */
+    uint8_t smoother;            /* FILTER_SMOOTH_xxx */
+    uint8_t shift;               /* EMA: alfa = 1 / 2^shift, 0 - 7 */
+    uint8_t reserved;
+    uint16_t processNoise;       /* Kalman: wariancja zmian wartosci q [jednostka^2 / 256] */
+    uint16_t measurementNoise;   /* Kalman: wariancja pomiaru r [jednostka^2 / 256] */
+} filter_config_t;
+
+/*
+ * Stan filtru jednego czujnika, staly rozmiar niezalezny od ustawien.
+ * Wartosc wygladzona i wariancja sa przechowywane w formacie Q8.
+ */
+typedef struct
+{
+    filter_config_t config;
+    int32_t history[FILTER_MEDIAN_MAX];
+    uint8_t next;                /* Indeks nastepnego odczytu w history */
+    uint8_t invalidRun;          /* Liczba kolejnych blednych odczytow */
+    Bool started;                /* Przyjeto co najmniej jeden poprawny odczyt */
+    int32_t estimate;            /* Wynik wygladzania [jednostka / 256] */
+    uint32_t variance;           /* Kalman: wariancja estymaty [jednostka^2 / 256] */
+    uint32_t rejected;           /* Licznik odrzuconych odczytow */
+} filter_t;
+
+void filter_init(void);
+Bool filter_configure(uint8_t sensor, const filter_config_t* pConfig);
+const filter_config_t* filter_getConfig(uint8_t sensor);
+Bool filter_update(uint8_t sensor, int32_t raw, Bool valid, int32_t* pOutput);
+uint32_t filter_getRejected(uint8_t sensor);
+
+#endif /* FILTER_H_ */
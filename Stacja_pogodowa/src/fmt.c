@@ -0,0 +1,214 @@
+#include "fmt.h"
+
+/*
+ * Pary cyfr "00".."99". Liczba jest dzielona przez 100 (kompilator zamienia
+ * dzielenie przez stala na mnozenie), kazdy krok daje od razu dwie cyfry.
+ */
+static const char digitPairs[200] =
+{
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+/* Potegi dziesieciu dla czesci ulamkowej */
+static const uint32_t powers10[] = { 1, 10, 100, 1000, 10000, 100000 };
+
+/*!
+ *  @brief    Funkcja zapisujaca cyfry liczby bez znaku od konca bufora
+ *  @param    pEnd
+ *              Wskaznik za ostatnia cyfra
+ *  @param    value
+ *              Wartosc
+ *  @param    minDigits
+ *              Minimalna liczba cyfr (uzupelnienie zerami)
+ *  @returns  Liczba zapisanych cyfr
+ *  @side_effects:
+ *            Brak
+ */
+static uint32_t putDigits(char* pEnd, uint32_t value, uint32_t minDigits)
+{
+    char* p = pEnd;
+    uint32_t quotient = 0;
+    uint32_t pair = 0;
+
+    while (value >= 100)
+    {
+        quotient = value / 100;
+        pair = (value - quotient * 100) * 2;
+        *--p = digitPairs[pair + 1];
+        *--p = digitPairs[pair];
+        value = quotient;
+    }
+
+    if (value >= 10)
+    {
+        pair = value * 2;
+        *--p = digitPairs[pair + 1];
+        *--p = digitPairs[pair];
+    }
+    else
+    {
+        *--p = (char)('0' + value);
+    }
+
+    while ((uint32_t)(pEnd - p) < minDigits)
+    {
+        *--p = '0';
+    }
+
+    return (uint32_t)(pEnd - p);
+}
+
+/*!
+ *  @brief    Funkcja skladajaca tekst liczby: znak, czesc calkowita i
+ *            opcjonalnie czesc ulamkowa, wyrownany do prawej
+ *  @param    pBuf
+ *              Bufor (co najmniej max(width, FMT_MAX_LEN) + 1 bajtow)
+ *  @param    negative
+ *              TRUE jesli liczba jest ujemna
+ *  @param    integer
+ *              Czesc calkowita
+ *  @param    fraction
+ *              Czesc ulamkowa
+ *  @param    decimals
+ *              Liczba cyfr czesci ulamkowej, 0 - bez kropki
+ *  @param    width
+ *              Minimalna szerokosc pola
+ *  @param    pad
+ *              Znak wypelnienia: '0' (po znaku minus) lub ' ' (przed nim)
+ *  @returns  Dlugosc tekstu bez terminatora
+ *  @side_effects:
+ *            Brak
+ */
+static uint32_t build(char* pBuf, Bool negative, uint32_t integer, uint32_t fraction,
+        uint8_t decimals, uint8_t width, char pad)
+{
+    char digits[FMT_MAX_LEN];
+    char* pEnd = &digits[FMT_MAX_LEN];
+    uint32_t count = 0;
+    uint32_t len = 0;
+    uint32_t fill = 0;
+    uint32_t i = 0;
+
+    if (decimals > 0)
+    {
+        count = putDigits(pEnd, fraction, decimals);
+        digits[FMT_MAX_LEN - count - 1] = '.';
+        count++;
+    }
+    count += putDigits(pEnd - count, integer, 1);
+
+    len = count + ((negative == TRUE) ? 1 : 0);
+    fill = (width > len) ? (width - len) : 0;
+
+    if ((negative == TRUE) && (pad == '0'))
+    {
+        pBuf[i++] = '-';
+    }
+    while (fill > 0)
+    {
+        pBuf[i++] = pad;
+        fill--;
+    }
+    if ((negative == TRUE) && (pad != '0'))
+    {
+        pBuf[i++] = '-';
+    }
+
+    pEnd -= count;
+    while (count > 0)
+    {
+        pBuf[i++] = *pEnd++;
+        count--;
+    }
+
+    pBuf[i] = '\0';
+
+    return i;
+}
+
+/*!
+ *  @brief    Funkcja zamieniajaca liczbe bez znaku na tekst dziesietny
+ *  @param    pBuf
+ *              Bufor (co najmniej max(width, FMT_MAX_LEN) + 1 bajtow)
+ *  @param    value
+ *              Wartosc
+ *  @param    width
+ *              Minimalna szerokosc pola, 0 - bez wyrownania
+ *  @param    pad
+ *              Znak wypelnienia ('0' lub ' ')
+ *  @returns  Dlugosc tekstu bez terminatora
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t fmt_uint(char* pBuf, uint32_t value, uint8_t width, char pad)
+{
+    return build(pBuf, FALSE, value, 0, 0, width, pad);
+}
+
+/*!
+ *  @brief    Funkcja zamieniajaca liczbe ze znakiem na tekst dziesietny
+ *  @param    pBuf
+ *              Bufor (co najmniej max(width, FMT_MAX_LEN) + 1 bajtow)
+ *  @param    value
+ *              Wartosc
+ *  @param    width
+ *              Minimalna szerokosc pola (razem ze znakiem), 0 - bez wyrownania
+ *  @param    pad
+ *              Znak wypelnienia ('0' lub ' ')
+ *  @returns  Dlugosc tekstu bez terminatora
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t fmt_int(char* pBuf, int32_t value, uint8_t width, char pad)
+{
+    if (value < 0)
+    {
+        return build(pBuf, TRUE, 0U - (uint32_t)value, 0, 0, width, pad);
+    }
+
+    return build(pBuf, FALSE, (uint32_t)value, 0, 0, width, pad);
+}
+
+/*!
+ *  @brief    Funkcja zamieniajaca liczbe stalopozycyjna na tekst dziesietny,
+ *            np. 215 z jednym miejscem po przecinku -> "21.5", -5 -> "-0.5"
+ *  @param    pBuf
+ *              Bufor (co najmniej max(width, FMT_MAX_LEN) + 1 bajtow)
+ *  @param    value
+ *              Wartosc pomnozona przez 10^decimals
+ *  @param    decimals
+ *              Liczba miejsc po przecinku (0 - 5)
+ *  @param    width
+ *              Minimalna szerokosc pola (razem ze znakiem i kropka)
+ *  @param    pad
+ *              Znak wypelnienia ('0' lub ' ')
+ *  @returns  Dlugosc tekstu bez terminatora
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t fmt_fixed(char* pBuf, int32_t value, uint8_t decimals, uint8_t width, char pad)
+{
+    uint32_t magnitude = (value < 0) ? (0U - (uint32_t)value) : (uint32_t)value;
+    uint32_t scale = 0;
+    uint32_t integer = 0;
+
+    if (decimals >= (sizeof(powers10) / sizeof(powers10[0])))
+    {
+        decimals = (sizeof(powers10) / sizeof(powers10[0])) - 1;
+    }
+
+    scale = powers10[decimals];
+    integer = magnitude / scale;
+
+    return build(pBuf, (value < 0) ? TRUE : FALSE, integer, magnitude - integer * scale,
+            decimals, width, pad);
+}
@@ -0,0 +1,13 @@
+#ifndef FMT_H_
+#define FMT_H_
+
+#include "lpc_types.h"
+
+/* Najdluzszy tekst liczby 32-bitowej: znak, 10 cyfr, kropka, terminator */
+#define FMT_MAX_LEN 13
+
+uint32_t fmt_uint(char* pBuf, uint32_t value, uint8_t width, char pad);
+uint32_t fmt_int(char* pBuf, int32_t value, uint8_t width, char pad);
+uint32_t fmt_fixed(char* pBuf, int32_t value, uint8_t decimals, uint8_t width, char pad);
+
+#endif /* FMT_H_ */
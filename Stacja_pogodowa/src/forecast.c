@@ -0,0 +1,295 @@
+#include "forecast.h"
+
+/*
+ * Punkty historii sa przechowywane jako odchylenie od cisnienia wzorcowego,
+ * dzieki temu sumy regresji mieszcza sie w 32 bitach.
+ */
+#define FORECAST_BASE_PA 101325
+
+/*
+ * Prognozy Zambrettiego dla kolejnych numerow Z: 1-9 przy spadku cisnienia,
+ * 10-19 przy stalym, 20-32 przy wzroscie.
+ */
+static const char zambrettiCodes[32] =
+{
+    'A', 'B', 'D', 'H', 'O', 'R', 'U', 'X', 'Z',
+    'A', 'B', 'E', 'K', 'N', 'P', 'S', 'W', 'X', 'Z',
+    'A', 'B', 'C', 'F', 'G', 'I', 'J', 'L', 'M', 'Q', 'T', 'Y', 'Z'
+};
+
+/* Opisy prognoz 'A'-'Z', najwyzej 16 znakow (szerokosc ekranu OLED) */
+static const char* const zambrettiTexts[26] =
+{
+    "Settled fine",
+    "Fine weather",
+    "Becoming fine",
+    "Fine,less settl",
+    "Fine,poss.shower",
+    "Fair,improving",
+    "Fair,showers",
+    "Fair,showers lat",
+    "Showery,improve",
+    "Changeable,mend",
+    "Fair,showers lkl",
+    "Unsettled,clear",
+    "Unsettl,improve",
+    "Showery,bright",
+    "Showery,unsettl",
+    "Changeable,rain",
+    "Unsettl,fine int",
+    "Unsettled,rain",
+    "Rain at times",
+    "V.unsettl,finer",
+    "Rain,worse later",
+    "Rain,v.unsettled",
+    "Frequent rain",
+    "Very unsettled",
+    "Stormy,improving",
+    "Stormy,much rain"
+};
+
+static int32_t history[FORECAST_SLOTS];
+static uint32_t head = 0;
+static uint32_t count = 0;
+
+/* Sumy regresji: y oraz x * y, x = 0 dla najstarszego punktu */
+static int32_t sumY = 0;
+static int32_t sumXY = 0;
+
+/* Srednia odczytow z biezacego przedzialu */
+static int64_t accSum = 0;
+static uint32_t accCount = 0;
+static uint32_t intervalStart = 0;
+static Bool started = FALSE;
+
+static forecast_t result;
+
+/*!
+ *  @brief    Procedura dopisujaca punkt do historii i aktualizujaca sumy
+ *            regresji w stalym czasie
+ *  @param    y
+ *              Punkt [Pa] wzgledem FORECAST_BASE_PA
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana historii i sum
+ */
+static void push(int32_t y)
+{
+    int32_t oldest = 0;
+
+    if (count < FORECAST_SLOTS)
+    {
+        history[(head + count) % FORECAST_SLOTS] = y;
+        sumXY += (int32_t)count * y;
+        sumY += y;
+        count++;
+        return;
+    }
+
+    /*
+     * Okno przesuwa sie o jeden punkt: pozostale punkty maja x mniejsze o 1,
+     * wiec suma x * y maleje o ich sume, nowy punkt dostaje x = N - 1.
+     */
+    oldest = history[head];
+    history[head] = y;
+    head = (head + 1) % FORECAST_SLOTS;
+
+    sumXY -= sumY - oldest;
+    sumXY += (FORECAST_SLOTS - 1) * y;
+    sumY += y - oldest;
+}
+
+/*!
+ *  @brief    Funkcja wyznaczajaca numer prognozy Zambrettiego
+ *  @param    pressure
+ *              Cisnienie zredukowane do poziomu morza [Pa]
+ *  @param    trend
+ *              Tendencja FORECAST_TREND_xxx
+ *  @returns  Kod prognozy 'A'-'Z'
+ *  @side_effects:
+ *            Brak
+ */
+static char zambretti(int32_t pressure, int8_t trend)
+{
+    int32_t z = 0;
+    int32_t zMin = 0;
+    int32_t zMax = 0;
+
+    /* Z = 127 - 0.12 P, 144 - 0.13 P, 185 - 0.16 P (P w hPa), zaokraglone */
+    if (trend == FORECAST_TREND_FALLING)
+    {
+        z = (1270000 - 12 * pressure + 5000) / 10000;
+        zMin = 1;
+        zMax = 9;
+    }
+    else if (trend == FORECAST_TREND_STEADY)
+    {
+        z = (1440000 - 13 * pressure + 5000) / 10000;
+        zMin = 10;
+        zMax = 19;
+    }
+    else
+    {
+        z = (1850000 - 16 * pressure + 5000) / 10000;
+        zMin = 20;
+        zMax = 32;
+    }
+
+    if (z < zMin)
+    {
+        z = zMin;
+    }
+    if (z > zMax)
+    {
+        z = zMax;
+    }
+
+    return zambrettiCodes[z - 1];
+}
+
+/*!
+ *  @brief    Procedura wyznaczajaca tendencje z prostej regresji liniowej
+ *            po punktach historii i aktualizujaca prognoze
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana wyniku
+ */
+static void update(void)
+{
+    int32_t n = (int32_t)count;
+    int32_t sumX = n * (n - 1) / 2;
+    int32_t sumXX = (n - 1) * n * (2 * n - 1) / 6;
+    int64_t num = 0;
+    int32_t den = 0;
+
+    result.slots = (uint8_t)count;
+    result.pressure = history[(head + count - 1) % FORECAST_SLOTS] + FORECAST_BASE_PA;
+    result.change = 0;
+
+    if (n >= 2)
+    {
+        /* Nachylenie [Pa/przedzial] = num / den, przeliczone na 3 godziny */
+        num = (int64_t)n * sumXY - (int64_t)sumX * sumY;
+        den = n * sumXX - sumX * sumX;
+        result.change = (int32_t)((num * (FORECAST_SLOTS - 1)) / den);
+    }
+
+    if (result.change <= -FORECAST_TREND_THRESHOLD)
+    {
+        result.trend = FORECAST_TREND_FALLING;
+    }
+    else if (result.change >= FORECAST_TREND_THRESHOLD)
+    {
+        result.trend = FORECAST_TREND_RISING;
+    }
+    else
+    {
+        result.trend = FORECAST_TREND_STEADY;
+    }
+
+    if (count >= FORECAST_MIN_SLOTS)
+    {
+        result.code = zambretti(result.pressure, result.trend);
+    }
+    else
+    {
+        result.code = 0;
+    }
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca modul prognozy, historia jest pusta
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyzerowanie historii i wyniku
+ */
+void forecast_init(void)
+{
+    head = 0;
+    count = 0;
+    sumY = 0;
+    sumXY = 0;
+    accSum = 0;
+    accCount = 0;
+    started = FALSE;
+
+    result.slots = 0;
+    result.pressure = 0;
+    result.change = 0;
+    result.trend = FORECAST_TREND_STEADY;
+    result.code = 0;
+}
+
+/*!
+ *  @brief    Procedura przyjmujaca odczyt cisnienia. Odczyty sa usredniane w
+ *            przedziale FORECAST_INTERVAL_MS, po jego uplywie srednia trafia
+ *            do historii i prognoza jest aktualizowana. Koszt staly.
+ *  @param    now
+ *              Czas odczytu [ms]
+ *  @param    pressure
+ *              Cisnienie zredukowane do poziomu morza [Pa]
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana historii i wyniku
+ */
+void forecast_addSample(uint32_t now, int32_t pressure)
+{
+    if (started == FALSE)
+    {
+        intervalStart = now;
+        started = TRUE;
+    }
+
+    accSum += pressure - FORECAST_BASE_PA;
+    accCount++;
+
+    if ((now - intervalStart) < FORECAST_INTERVAL_MS)
+    {
+        return;
+    }
+
+    /* Po dlugiej przerwie w odczytach przedzialy liczone sa od nowa */
+    intervalStart += FORECAST_INTERVAL_MS;
+    if ((now - intervalStart) >= FORECAST_INTERVAL_MS)
+    {
+        intervalStart = now;
+    }
+
+    push((int32_t)(accSum / (int32_t)accCount));
+    accSum = 0;
+    accCount = 0;
+
+    update();
+}
+
+/*!
+ *  @brief    Getter wyniku prognozy
+ *  @param    Brak
+ *  @returns  Wskaznik na tendencje i prognoze
+ *  @side_effects:
+ *            Brak
+ */
+const forecast_t* forecast_get(void)
+{
+    return &result;
+}
+
+/*!
+ *  @brief    Funkcja zwracajaca opis prognozy
+ *  @param    code
+ *              Kod prognozy 'A'-'Z'
+ *  @returns  Opis, pusty tekst dla nieznanego kodu
+ *  @side_effects:
+ *            Brak
+ */
+const char* forecast_getText(char code)
+{
+    if ((code < 'A') || (code > 'Z'))
+    {
+        return "";
+    }
+
+    return zambrettiTexts[code - 'A'];
+}
@@ -0,0 +1,38 @@
+#ifndef FORECAST_H_
+#define FORECAST_H_
+
+#include "lpc_types.h"
+
+/*
+ * Historia cisnienia: jeden punkt (srednia odczytow) co FORECAST_INTERVAL_MS,
+ * FORECAST_SLOTS punktow obejmuje 3 godziny.
+ */
+#define FORECAST_INTERVAL_MS  (10UL * 60UL * 1000UL)
+#define FORECAST_SLOTS        19
+
+/* Najkrotsza historia, dla ktorej wyznaczana jest prognoza (1 godzina) */
+#define FORECAST_MIN_SLOTS    7
+
+/* Tendencja cisnienia wedlug zmiany w ciagu 3 godzin */
+#define FORECAST_TREND_FALLING  (-1)
+#define FORECAST_TREND_STEADY   0
+#define FORECAST_TREND_RISING   1
+
+/* Zmiana cisnienia [Pa/3h], powyzej ktorej tendencja nie jest stala */
+#define FORECAST_TREND_THRESHOLD 160
+
+typedef struct
+{
+    uint8_t slots;               /* Liczba punktow historii */
+    int32_t pressure;            /* Ostatni punkt historii [Pa] */
+    int32_t change;              /* Zmiana cisnienia z prostej regresji [Pa/3h] */
+    int8_t trend;                /* FORECAST_TREND_xxx */
+    char code;                   /* Prognoza Zambrettiego 'A'-'Z', 0 - brak */
+} forecast_t;
+
+void forecast_init(void);
+void forecast_addSample(uint32_t now, int32_t pressure);
+const forecast_t* forecast_get(void);
+const char* forecast_getText(char code);
+
+#endif /* FORECAST_H_ */
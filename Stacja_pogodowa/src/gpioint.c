@@ -0,0 +1,90 @@
+#include "LPC17xx.h"
+
+#include "gpioint.h"
+
+/* Pin z przypisana procedura obslugi przerwania */
+typedef struct
+{
+    uint8_t port;
+    uint32_t mask;
+    gpioint_handler_t handler;
+} gpioint_entry_t;
+
+static gpioint_entry_t entries[GPIOINT_MAX];
+static uint32_t entryCount = 0;
+
+/*!
+ *  @brief    Procedura obslugi przerwania EINT3, wspolnego dla pinow portow
+ *            0 i 2. Kasuje flagi zgloszonych pinow i wywoluje ich procedury.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wywolanie procedur zarejestrowanych pinow
+ */
+void EINT3_IRQHandler(void)
+{
+    uint32_t status0 = LPC_GPIOINT->IO0IntStatR | LPC_GPIOINT->IO0IntStatF;
+    uint32_t status2 = LPC_GPIOINT->IO2IntStatR | LPC_GPIOINT->IO2IntStatF;
+    uint32_t i = 0;
+
+    LPC_GPIOINT->IO0IntClr = status0;
+    LPC_GPIOINT->IO2IntClr = status2;
+
+    for (i = 0; i < entryCount; i++)
+    {
+        if ((((entries[i].port == 0) ? status0 : status2) & entries[i].mask) != 0)
+        {
+            entries[i].handler();
+        }
+    }
+}
+
+/*!
+ *  @brief    Funkcja przypisujaca procedure do przerwania pinu. Pin musi byc
+ *            skonfigurowany jako wejscie GPIO.
+ *  @param    port
+ *              Port 0 lub 2 (tylko te porty zglaszaja przerwania)
+ *  @param    pin
+ *              Numer pinu
+ *  @param    edge
+ *              GPIOINT_EDGE_xxx
+ *  @param    handler
+ *              Procedura wywolywana z przerwania
+ *  @returns  FALSE dla niepoprawnego pinu lub pelnej tablicy
+ *  @side_effects:
+ *            Wlaczenie przerwania pinu i EINT3 w kontrolerze NVIC
+ */
+Bool gpioint_register(uint8_t port, uint8_t pin, uint8_t edge, gpioint_handler_t handler)
+{
+    uint32_t mask = 1UL << pin;
+    volatile uint32_t* pEnable = NULL;
+
+    if (((port != 0) && (port != 2)) || (pin > 31) || (handler == NULL) || (entryCount >= GPIOINT_MAX))
+    {
+        return FALSE;
+    }
+
+    NVIC_DisableIRQ(EINT3_IRQn);
+    entries[entryCount].port = port;
+    entries[entryCount].mask = mask;
+    entries[entryCount].handler = handler;
+    entryCount++;
+
+    /* GPIO_IntCmd nadpisuje caly rejestr, wiec bit jest dopisywany bezposrednio */
+    if (port == 0)
+    {
+        pEnable = (edge == GPIOINT_EDGE_RISING) ? &LPC_GPIOINT->IO0IntEnR : &LPC_GPIOINT->IO0IntEnF;
+        LPC_GPIOINT->IO0IntClr = mask;
+    }
+    else
+    {
+        pEnable = (edge == GPIOINT_EDGE_RISING) ? &LPC_GPIOINT->IO2IntEnR : &LPC_GPIOINT->IO2IntEnF;
+        LPC_GPIOINT->IO2IntClr = mask;
+    }
+    *pEnable |= mask;
+
+    NVIC_SetPriority(EINT3_IRQn, 4);
+    NVIC_EnableIRQ(EINT3_IRQn);
+
+    return TRUE;
+}
@@ -0,0 +1,18 @@
+#ifndef GPIOINT_H_
+#define GPIOINT_H_
+
+#include "lpc_types.h"
+
+/* Najwieksza liczba obslugiwanych pinow */
+#define GPIOINT_MAX 4
+
+/* Zbocze wyzwalajace przerwanie */
+#define GPIOINT_EDGE_RISING  0
+#define GPIOINT_EDGE_FALLING 1
+
+/* Procedura wywolywana z przerwania EINT3 */
+typedef void (*gpioint_handler_t)(void);
+
+Bool gpioint_register(uint8_t port, uint8_t pin, uint8_t edge, gpioint_handler_t handler);
+
+#endif /* GPIOINT_H_ */
@@ -0,0 +1,934 @@
+#include <string.h>
+
+#include "http.h"
+#include "net.h"
+#include "datalog.h"
+#include "fmt.h"
+#include "metric.h"
+
+/*
+ * Serwer HTTP/1.0 obslugujacy jedno polaczenie TCP i jedno zapytanie naraz.
+ * Odpowiedz jest generowana w locie do bufora nadawczego EMAC, po jednym
+ * segmencie. Kolejny segment jest wysylany po potwierdzeniu poprzedniego, a
+ * retransmisja generuje segment ponownie z zapamietanego stanu generatora,
+ * wiec zuzycie pamieci nie zalezy od dlugosci odpowiedzi.
+ */
+
+#define TCP_HEADER_SIZE 20
+#define TCP_FIN 0x01
+#define TCP_SYN 0x02
+#define TCP_RST 0x04
+#define TCP_PSH 0x08
+#define TCP_ACK 0x10
+
+/* Najwiekszy segment wysylany i domyslny gdy klient nie podal opcji MSS */
+#define HTTP_MSS          1024
+#define HTTP_DEFAULT_MSS  536
+#define HTTP_WINDOW       512
+
+/*
+ * Najmniejszy segment wysylany nawet przy mniejszej opcji MSS klienta:
+ * naglowek odpowiedzi z odczytem /now i kazdy rekord musza sie w nim
+ * zmiescic w calosci, inaczej odpowiedz nie posuwalaby sie naprzod
+ */
+#define HTTP_MIN_MSS      256
+
+#define HTTP_RETRY_MS     500
+#define HTTP_RETRIES      8
+#define HTTP_IDLE_MS      5000
+
+/* Bufor na pierwsza linie zapytania i na jeden rekord JSON */
+#define HTTP_REQUEST_SIZE 96
+#define HTTP_RECORD_SIZE  80
+
+/* Stan polaczenia TCP */
+enum tcpState
+{
+    TCP_LISTEN,
+    TCP_SYN_RCVD,
+    TCP_ESTABLISHED,
+    TCP_SENDING,
+    TCP_LAST_ACK,
+    TCP_FIN_WAIT
+};
+
+/* Zasob wskazany w zapytaniu */
+enum httpPage
+{
+    PAGE_NOW,
+    PAGE_HISTORY,
+    PAGE_NOT_FOUND,
+    PAGE_BAD_REQUEST
+};
+
+/* Etap generowania odpowiedzi */
+enum httpPhase
+{
+    PHASE_HEADER,
+    PHASE_RECORDS,
+    PHASE_CLOSE,
+    PHASE_DONE,
+    PHASE_ABORT                  /* Rekord do wyslania zostal nadpisany w dzienniku */
+};
+
+/* Stan generatora odpowiedzi - wystarcza do odtworzenia dowolnego segmentu */
+typedef struct
+{
+    uint8_t phase;
+    Bool first;
+    uint32_t record;             /* Indeks rekordu plus datalog_getDroppedCount() */
+} http_gen_t;
+
+/* Odczyt udostepniany pod adresem /now */
+typedef struct
+{
+    uint32_t time;
+    int32_t temperature;
+    int32_t pressure;
+    int16_t humidity;
+    uint8_t invalid;             /* Maska METRIC_BIT pol bez poprawnej wartosci */
+    Bool valid;
+} http_sample_t;
+
+static struct
+{
+    enum tcpState state;
+    uint32_t ip;
+    uint8_t mac[6];
+    uint16_t port;
+    uint32_t rcvNxt;
+    uint32_t sndUna;
+    uint32_t sndNxt;
+    uint16_t mss;
+    uint32_t lastActivity;
+    uint8_t retries;
+    Bool finReceived;
+
+    char request[HTTP_REQUEST_SIZE];
+    uint8_t requestLen;
+
+    enum httpPage page;
+    uint32_t to;
+    uint32_t endRecord;          /* Koniec dziennika w chwili zapytania, jak gen.record */
+    http_sample_t sample;
+    http_gen_t gen;              /* Stan po ostatnim potwierdzonym segmencie */
+    http_gen_t genNext;          /* Stan po segmencie w drodze */
+} conn;
+
+static http_sample_t latest;
+static uint32_t ticks = 0;
+
+/*!
+ *  @brief    Procedury zapisu i odczytu liczb w kolejnosci sieciowej
+ */
+static void put16(uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+}
+
+static void put32(uint8_t* p, uint32_t value)
+{
+    put16(p, (uint16_t)(value >> 16));
+    put16(&p[2], (uint16_t)value);
+}
+
+static uint16_t get16(const uint8_t* p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t get32(const uint8_t* p)
+{
+    return ((uint32_t)get16(p) << 16) | get16(&p[2]);
+}
+
+/*!
+ *  @brief    Funkcje dopisujace tekst i liczby do bufora odpowiedzi
+ *  @returns  Nowa dlugosc danych w buforze
+ */
+static uint32_t putStr(uint8_t* pBuf, uint32_t pos, const char* pStr)
+{
+    while (*pStr != '\0')
+    {
+        pBuf[pos++] = (uint8_t)*pStr++;
+    }
+    return pos;
+}
+
+static uint32_t putUInt(uint8_t* pBuf, uint32_t pos, uint32_t value)
+{
+    return pos + fmt_uint((char*)&pBuf[pos], value, 0, ' ');
+}
+
+static uint32_t putInt(uint8_t* pBuf, uint32_t pos, int32_t value)
+{
+    return pos + fmt_int((char*)&pBuf[pos], value, 0, ' ');
+}
+
+/* Wartosc w dziesiatych czesciach jednostki, np. 215 -> "21.5" */
+static uint32_t putTenths(uint8_t* pBuf, uint32_t pos, int32_t value)
+{
+    return pos + fmt_fixed((char*)&pBuf[pos], value, 1, 0, ' ');
+}
+
+/*!
+ *  @brief    Funkcja zapisujaca jeden odczyt jako obiekt JSON
+ *  @param    pBuf
+ *              Bufor (co najmniej HTTP_RECORD_SIZE bajtow)
+ *  @param    time
+ *              Czas UNIX [s]
+ *  @param    temperature
+ *              Temperatura [0.1 C]
+ *  @param    pressure
+ *              Cisnienie [Pa]
+ *  @param    humidity
+ *              Wilgotnosc [%]
+ *  @param    invalid
+ *              Maska METRIC_BIT pol bez poprawnej wartosci, zapisywanych
+ *              jako null
+ *  @returns  Dlugosc tekstu
+ *  @side_effects:
+ *            Brak
+ */
+static uint32_t putSample(uint8_t* pBuf, uint32_t time, int32_t temperature, int32_t pressure, int16_t humidity,
+        uint8_t invalid)
+{
+    uint32_t pos = 0;
+
+    pos = putStr(pBuf, pos, "{\"t\":");
+    pos = putUInt(pBuf, pos, time);
+    pos = putStr(pBuf, pos, ",\"temp\":");
+    pos = ((invalid & METRIC_BIT(METRIC_TEMPERATURE)) != 0)
+            ? putStr(pBuf, pos, "null") : putTenths(pBuf, pos, temperature);
+    pos = putStr(pBuf, pos, ",\"press\":");
+    pos = ((invalid & METRIC_BIT(METRIC_PRESSURE)) != 0) ? putStr(pBuf, pos, "null") : putInt(pBuf, pos, pressure);
+    pos = putStr(pBuf, pos, ",\"hum\":");
+    pos = ((invalid & METRIC_BIT(METRIC_HUMIDITY)) != 0) ? putStr(pBuf, pos, "null") : putInt(pBuf, pos, humidity);
+    return putStr(pBuf, pos, "}");
+}
+
+/*!
+ *  @brief    Funkcja generujaca kolejny fragment odpowiedzi. Rekordy nie sa
+ *            dzielone miedzy segmenty. Wysylane sa tylko rekordy zapisane
+ *            przed zapytaniem. Numery rekordow w stanie generatora nie
+ *            zmieniaja sie przy nadpisywaniu najstarszych stron dziennika;
+ *            gdy nadpisany zostanie rekord jeszcze niewyslany, generator
+ *            przechodzi do PHASE_ABORT.
+ *  @param    pGen
+ *              Stan generatora, aktualizowany
+ *  @param    pBuf
+ *              Miejsce na dane segmentu
+ *  @param    max
+ *              Maksymalna dlugosc danych
+ *  @returns  Dlugosc wygenerowanych danych
+ *  @side_effects:
+ *            Odczyt dziennika z pamieci DataFlash
+ */
+static uint32_t generate(http_gen_t* pGen, uint8_t* pBuf, uint32_t max)
+{
+    uint8_t text[HTTP_RECORD_SIZE];
+    datalog_record_t record;
+    uint32_t len = 0;
+    uint32_t n = 0;
+
+    while (pGen->phase != PHASE_DONE)
+    {
+        switch (pGen->phase)
+        {
+            case PHASE_HEADER:
+            {
+                /* Naglowek zawsze miesci sie w pierwszym segmencie */
+                if (conn.page == PAGE_NOT_FOUND)
+                {
+                    len = putStr(pBuf, len, "HTTP/1.0 404 Not Found\r\nConnection: close\r\n\r\n");
+                    pGen->phase = PHASE_DONE;
+                    break;
+                }
+                if (conn.page == PAGE_BAD_REQUEST)
+                {
+                    len = putStr(pBuf, len, "HTTP/1.0 400 Bad Request\r\nConnection: close\r\n\r\n");
+                    pGen->phase = PHASE_DONE;
+                    break;
+                }
+
+                len = putStr(pBuf, len, "HTTP/1.0 200 OK\r\nContent-Type: application/json\r\n"
+                        "Connection: close\r\n\r\n");
+                if (conn.page == PAGE_NOW)
+                {
+                    if (conn.sample.valid == TRUE)
+                    {
+                        len += putSample(&pBuf[len], conn.sample.time, conn.sample.temperature,
+                                conn.sample.pressure, conn.sample.humidity, conn.sample.invalid);
+                    }
+                    else
+                    {
+                        len = putStr(pBuf, len, "null");
+                    }
+                    len = putStr(pBuf, len, "\n");
+                    pGen->phase = PHASE_DONE;
+                }
+                else
+                {
+                    len = putStr(pBuf, len, "[");
+                    pGen->phase = PHASE_RECORDS;
+                }
+                break;
+            }
+            case PHASE_RECORDS:
+            {
+                if ((pGen->record < conn.endRecord) && (pGen->record < datalog_getDroppedCount()))
+                {
+                    pGen->phase = PHASE_ABORT;
+                    return 0;
+                }
+                if ((pGen->record >= conn.endRecord)
+                        || (datalog_readRecord(pGen->record - datalog_getDroppedCount(), &record) == FALSE)
+                        || (record.time > conn.to))
+                {
+                    pGen->phase = PHASE_CLOSE;
+                    break;
+                }
+
+                n = 0;
+                if (pGen->first == FALSE)
+                {
+                    text[n++] = ',';
+                }
+                n += putSample(&text[n], record.time, record.temperature, record.pressure, record.humidity,
+                        record.invalid);
+
+                if ((len + n) > max)
+                {
+                    return len;
+                }
+                memcpy(&pBuf[len], text, n);
+                len += n;
+                pGen->record++;
+                pGen->first = FALSE;
+                break;
+            }
+            case PHASE_CLOSE:
+            {
+                if ((len + 2) > max)
+                {
+                    return len;
+                }
+                len = putStr(pBuf, len, "]\n");
+                pGen->phase = PHASE_DONE;
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+
+    return len;
+}
+
+/*!
+ *  @brief    Funkcja wyszukujaca pierwszy rekord dziennika nie starszy niz
+ *            podany czas. Przeszukiwany jest tylko najnowszy odcinek
+ *            dziennika z niemalejacym czasem - rekordy sprzed cofniecia
+ *            zegara nie sa udostepniane, bo czas calego dziennika nie jest
+ *            uporzadkowany.
+ *  @param    from
+ *              Czas UNIX [s]
+ *  @returns  Indeks rekordu
+ *  @side_effects:
+ *            Odczyt dziennika z pamieci DataFlash
+ */
+static uint32_t findRecord(uint32_t from)
+{
+    datalog_record_t record;
+    uint32_t lo = datalog_getSegmentStart();
+    uint32_t hi = datalog_getRecordCount();
+    uint32_t mid = 0;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if ((datalog_readRecord(mid, &record) == FALSE) || (record.time < from))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/*!
+ *  @brief    Funkcja odczytujaca parametr liczbowy z zapytania (np. from=123)
+ *  @param    pQuery
+ *              Tekst zapytania za znakiem '?'
+ *  @param    pName
+ *              Nazwa parametru
+ *  @param    pValue
+ *              Odczytana wartosc, bez zmian gdy parametru nie ma
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void parseParam(const char* pQuery, const char* pName, uint32_t* pValue)
+{
+    uint32_t nameLen = strlen(pName);
+    uint32_t value = 0;
+
+    while (*pQuery != '\0')
+    {
+        if ((strncmp(pQuery, pName, nameLen) == 0) && (pQuery[nameLen] == '='))
+        {
+            pQuery += nameLen + 1;
+            while ((*pQuery >= '0') && (*pQuery <= '9'))
+            {
+                value = value * 10 + (uint32_t)(*pQuery - '0');
+                pQuery++;
+            }
+            *pValue = value;
+            return;
+        }
+
+        while ((*pQuery != '\0') && (*pQuery != '&'))
+        {
+            pQuery++;
+        }
+        if (*pQuery == '&')
+        {
+            pQuery++;
+        }
+    }
+}
+
+/*!
+ *  @brief    Procedura analizujaca pierwsza linie zapytania i przygotowujaca
+ *            generator odpowiedzi
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Odczyt dziennika z pamieci DataFlash
+ */
+static void parseRequest(void)
+{
+    char* pPath = &conn.request[4];
+    char* pEnd = NULL;
+    char* pQuery = NULL;
+    uint32_t from = 0;
+
+    conn.page = PAGE_BAD_REQUEST;
+    conn.to = 0xFFFFFFFF;
+    conn.endRecord = datalog_getRecordCount() + datalog_getDroppedCount();
+    conn.gen.phase = PHASE_HEADER;
+    conn.gen.first = TRUE;
+    conn.gen.record = 0;
+
+    if (strncmp(conn.request, "GET ", 4) != 0)
+    {
+        return;
+    }
+
+    pEnd = strchr(pPath, ' ');
+    if (pEnd != NULL)
+    {
+        *pEnd = '\0';
+    }
+    pQuery = strchr(pPath, '?');
+    if (pQuery != NULL)
+    {
+        *pQuery++ = '\0';
+    }
+
+    if (strcmp(pPath, "/now") == 0)
+    {
+        conn.page = PAGE_NOW;
+        conn.sample = latest;
+    }
+    else if (strcmp(pPath, "/history") == 0)
+    {
+        if (pQuery != NULL)
+        {
+            parseParam(pQuery, "from", &from);
+            parseParam(pQuery, "to", &conn.to);
+        }
+        conn.page = PAGE_HISTORY;
+        conn.gen.record = findRecord(from) + datalog_getDroppedCount();
+    }
+    else
+    {
+        conn.page = PAGE_NOT_FOUND;
+    }
+}
+
+/*!
+ *  @brief    Procedura wysylajaca segment TCP do klienta
+ *  @param    flags
+ *              Flagi TCP
+ *  @param    withData
+ *              TRUE - segment zawiera kolejny fragment odpowiedzi
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyslanie ramki, zmiana stanu polaczenia
+ */
+static void sendSegment(uint8_t flags, Bool withData)
+{
+    uint8_t* pTcp = net_ipBegin();
+    uint32_t headerLen = TCP_HEADER_SIZE;
+    uint32_t dataLen = 0;
+    uint32_t seq = conn.sndNxt;
+    uint32_t sum = 0;
+
+    conn.lastActivity = ticks;
+
+    if (pTcp == NULL)
+    {
+        return;
+    }
+
+    /* Segmenty z danymi, SYN i FIN (takze retransmisje) zaczynaja sie od sndUna */
+    if ((withData == TRUE) || ((flags & (TCP_SYN | TCP_FIN)) != 0))
+    {
+        seq = conn.sndUna;
+    }
+
+    if ((flags & TCP_SYN) != 0)
+    {
+        /* Opcja MSS */
+        pTcp[20] = 2;
+        pTcp[21] = 4;
+        put16(&pTcp[22], HTTP_DEFAULT_MSS);
+        headerLen += 4;
+    }
+
+    if (withData == TRUE)
+    {
+        conn.genNext = conn.gen;
+        dataLen = generate(&conn.genNext, &pTcp[headerLen], conn.mss);
+        if (dataLen > 0)
+        {
+            flags |= TCP_PSH;
+        }
+        if (conn.genNext.phase == PHASE_ABORT)
+        {
+            /* Dalszej czesci odpowiedzi nie da sie odtworzyc - zerwanie polaczenia */
+            flags = TCP_RST | TCP_ACK;
+            conn.state = TCP_LISTEN;
+        }
+    }
+
+    put16(&pTcp[0], HTTP_PORT);
+    put16(&pTcp[2], conn.port);
+    put32(&pTcp[4], seq);
+    put32(&pTcp[8], conn.rcvNxt);
+    pTcp[12] = (uint8_t)((headerLen / 4) << 4);
+    pTcp[13] = flags;
+    put16(&pTcp[14], HTTP_WINDOW);
+    put16(&pTcp[16], 0);
+    put16(&pTcp[18], 0);
+
+    sum = net_pseudoHeaderSum(conn.ip, NET_PROTO_TCP, headerLen + dataLen);
+    put16(&pTcp[16], net_checksumFold(net_checksumAdd(sum, pTcp, headerLen + dataLen)));
+
+    net_ipSend(conn.mac, conn.ip, NET_PROTO_TCP, headerLen + dataLen);
+
+    if (seq == conn.sndUna)
+    {
+        conn.sndNxt = conn.sndUna + dataLen + (((flags & TCP_SYN) != 0) ? 1 : 0)
+                + (((flags & TCP_FIN) != 0) ? 1 : 0);
+    }
+}
+
+/*!
+ *  @brief    Procedura odpowiadajaca segmentem RST na segment spoza polaczenia
+ *  @param    srcIp
+ *              Adres nadawcy
+ *  @param    pSrcMac
+ *              Adres MAC nadawcy
+ *  @param    pTcp
+ *              Odebrany segment
+ *  @param    segLen
+ *              Dlugosc danych segmentu (z flagami SYN i FIN)
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyslanie ramki
+ */
+static void sendReset(uint32_t srcIp, const uint8_t* pSrcMac, const uint8_t* pTcp, uint32_t segLen)
+{
+    uint8_t* pOut = NULL;
+    uint32_t sum = 0;
+
+    if (((pTcp[13] & TCP_RST) != 0) || ((pOut = net_ipBegin()) == NULL))
+    {
+        return;
+    }
+
+    put16(&pOut[0], get16(&pTcp[2]));
+    put16(&pOut[2], get16(&pTcp[0]));
+    if ((pTcp[13] & TCP_ACK) != 0)
+    {
+        put32(&pOut[4], get32(&pTcp[8]));
+        put32(&pOut[8], 0);
+        pOut[13] = TCP_RST;
+    }
+    else
+    {
+        put32(&pOut[4], 0);
+        put32(&pOut[8], get32(&pTcp[4]) + segLen);
+        pOut[13] = TCP_RST | TCP_ACK;
+    }
+    pOut[12] = (TCP_HEADER_SIZE / 4) << 4;
+    put16(&pOut[14], 0);
+    put16(&pOut[16], 0);
+    put16(&pOut[18], 0);
+
+    sum = net_pseudoHeaderSum(srcIp, NET_PROTO_TCP, TCP_HEADER_SIZE);
+    put16(&pOut[16], net_checksumFold(net_checksumAdd(sum, pOut, TCP_HEADER_SIZE)));
+
+    net_ipSend(pSrcMac, srcIp, NET_PROTO_TCP, TCP_HEADER_SIZE);
+}
+
+/*!
+ *  @brief    Funkcja odczytujaca opcje MSS z segmentu SYN
+ *  @param    pTcp
+ *              Segment
+ *  @param    headerLen
+ *              Dlugosc naglowka z opcjami
+ *  @returns  Rozmiar segmentu do wysylania z zakresu HTTP_MIN_MSS..HTTP_MSS
+ *  @side_effects:
+ *            Brak
+ */
+static uint16_t parseMss(const uint8_t* pTcp, uint32_t headerLen)
+{
+    uint32_t pos = TCP_HEADER_SIZE;
+    uint16_t mss = HTTP_DEFAULT_MSS;
+
+    while (pos < headerLen)
+    {
+        if (pTcp[pos] == 0)
+        {
+            break;
+        }
+        if (pTcp[pos] == 1)
+        {
+            pos++;
+            continue;
+        }
+        if ((pos + 1 >= headerLen) || (pTcp[pos + 1] < 2))
+        {
+            break;
+        }
+        if ((pTcp[pos] == 2) && (pTcp[pos + 1] == 4) && (pos + 4 <= headerLen))
+        {
+            mss = get16(&pTcp[pos + 2]);
+        }
+        pos += pTcp[pos + 1];
+    }
+
+    if (mss < HTTP_MIN_MSS)
+    {
+        return HTTP_MIN_MSS;
+    }
+    return (mss > HTTP_MSS) ? HTTP_MSS : mss;
+}
+
+/*!
+ *  @brief    Procedura obslugujaca dane zapytania. Po odebraniu pierwszej
+ *            linii zapytania rozpoczyna wysylanie odpowiedzi.
+ *  @param    pData
+ *              Dane
+ *  @param    len
+ *              Dlugosc danych
+ *  @returns  TRUE jesli rozpoczeto wysylanie odpowiedzi
+ *  @side_effects:
+ *            Brak
+ */
+static Bool handleRequest(const uint8_t* pData, uint32_t len)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        if ((pData[i] == '\r') || (pData[i] == '\n')
+                || (conn.requestLen >= (HTTP_REQUEST_SIZE - 1)))
+        {
+            conn.request[conn.requestLen] = '\0';
+            parseRequest();
+            conn.state = TCP_SENDING;
+            return TRUE;
+        }
+        conn.request[conn.requestLen++] = (char)pData[i];
+    }
+
+    if (conn.finReceived == TRUE)
+    {
+        conn.request[conn.requestLen] = '\0';
+        parseRequest();
+        conn.state = TCP_SENDING;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/*!
+ *  @brief    Procedura obslugujaca segment TCP odebrany przez warstwe IP
+ *  @param    srcIp
+ *              Adres nadawcy
+ *  @param    pSrcMac
+ *              Adres MAC nadawcy
+ *  @param    pTcp
+ *              Segment
+ *  @param    len
+ *              Dlugosc segmentu
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana stanu polaczenia, wyslanie odpowiedzi
+ */
+static void tcpInput(uint32_t srcIp, const uint8_t* pSrcMac, const uint8_t* pTcp, uint32_t len)
+{
+    uint32_t headerLen = 0;
+    uint32_t dataLen = 0;
+    uint32_t seq = 0;
+    uint8_t flags = 0;
+    Bool respond = FALSE;
+
+    if (len < TCP_HEADER_SIZE)
+    {
+        return;
+    }
+
+    headerLen = (pTcp[12] >> 4) * 4;
+    if ((headerLen < TCP_HEADER_SIZE) || (headerLen > len) || (get16(&pTcp[2]) != HTTP_PORT)
+            || (net_checksumFold(net_checksumAdd(net_pseudoHeaderSum(srcIp, NET_PROTO_TCP, len), pTcp, len)) != 0))
+    {
+        return;
+    }
+
+    flags = pTcp[13];
+    seq = get32(&pTcp[4]);
+    dataLen = len - headerLen;
+
+    if ((conn.state == TCP_LISTEN) || (srcIp != conn.ip) || (get16(&pTcp[0]) != conn.port))
+    {
+        if ((conn.state == TCP_LISTEN) && ((flags & (TCP_SYN | TCP_ACK | TCP_RST)) == TCP_SYN))
+        {
+            conn.ip = srcIp;
+            memcpy(conn.mac, pSrcMac, 6);
+            conn.port = get16(&pTcp[0]);
+            conn.rcvNxt = seq + 1;
+            conn.sndUna = (ticks << 8) ^ conn.port;
+            conn.sndNxt = conn.sndUna;
+            conn.mss = parseMss(pTcp, headerLen);
+            conn.retries = 0;
+            conn.finReceived = FALSE;
+            conn.requestLen = 0;
+            conn.state = TCP_SYN_RCVD;
+            sendSegment(TCP_SYN | TCP_ACK, FALSE);
+        }
+        else
+        {
+            sendReset(srcIp, pSrcMac, pTcp, dataLen + (((flags & TCP_SYN) != 0) ? 1 : 0)
+                    + (((flags & TCP_FIN) != 0) ? 1 : 0));
+        }
+        return;
+    }
+
+    if ((flags & TCP_RST) != 0)
+    {
+        conn.state = TCP_LISTEN;
+        return;
+    }
+
+    if ((flags & TCP_SYN) != 0)
+    {
+        /* Powtorzony SYN - odpowiedz zostala zgubiona */
+        if (conn.state == TCP_SYN_RCVD)
+        {
+            sendSegment(TCP_SYN | TCP_ACK, FALSE);
+        }
+        return;
+    }
+
+    conn.lastActivity = ticks;
+
+    if (((flags & TCP_ACK) != 0) && (get32(&pTcp[8]) == conn.sndNxt) && (conn.sndNxt != conn.sndUna))
+    {
+        conn.sndUna = conn.sndNxt;
+        conn.retries = 0;
+
+        switch (conn.state)
+        {
+            case TCP_SYN_RCVD:
+            {
+                conn.state = TCP_ESTABLISHED;
+                break;
+            }
+            case TCP_SENDING:
+            {
+                conn.gen = conn.genNext;
+                respond = TRUE;
+                break;
+            }
+            case TCP_LAST_ACK:
+            {
+                conn.state = (conn.finReceived == TRUE) ? TCP_LISTEN : TCP_FIN_WAIT;
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+
+    if ((dataLen > 0) || ((flags & TCP_FIN) != 0))
+    {
+        if (seq != conn.rcvNxt)
+        {
+            /* Segment poza kolejnoscia - potwierdzenie tego co odebrano */
+            sendSegment(TCP_ACK, FALSE);
+            return;
+        }
+
+        conn.rcvNxt += dataLen;
+        if ((flags & TCP_FIN) != 0)
+        {
+            conn.rcvNxt++;
+            conn.finReceived = TRUE;
+        }
+
+        if ((conn.state == TCP_ESTABLISHED) && (handleRequest(&pTcp[headerLen], dataLen) == TRUE))
+        {
+            respond = TRUE;
+        }
+        else if (conn.state == TCP_FIN_WAIT)
+        {
+            sendSegment(TCP_ACK, FALSE);
+            conn.state = TCP_LISTEN;
+            return;
+        }
+        else if (respond == FALSE)
+        {
+            sendSegment(TCP_ACK, FALSE);
+        }
+    }
+
+    if (respond == TRUE)
+    {
+        if (conn.gen.phase == PHASE_DONE)
+        {
+            conn.state = TCP_LAST_ACK;
+            sendSegment(TCP_FIN | TCP_ACK, FALSE);
+        }
+        else
+        {
+            sendSegment(TCP_ACK, TRUE);
+        }
+    }
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca serwer HTTP
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Rejestracja obslugi TCP w warstwie sieciowej
+ */
+void http_init(void)
+{
+    memset(&conn, 0, sizeof(conn));
+    conn.state = TCP_LISTEN;
+    latest.valid = FALSE;
+
+    net_setTcpHandler(tcpInput);
+}
+
+/*!
+ *  @brief    Procedura obslugujaca retransmisje i zamykanie bezczynnego
+ *            polaczenia, wywolywana w petli glownej po net_poll
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyslanie ramek, zmiana stanu polaczenia
+ */
+void http_poll(uint32_t now)
+{
+    ticks = now;
+
+    switch (conn.state)
+    {
+        case TCP_SYN_RCVD:
+        case TCP_SENDING:
+        case TCP_LAST_ACK:
+        {
+            if ((now - conn.lastActivity) < HTTP_RETRY_MS)
+            {
+                break;
+            }
+
+            if (++conn.retries > HTTP_RETRIES)
+            {
+                conn.state = TCP_LISTEN;
+                break;
+            }
+
+            if (conn.state == TCP_SYN_RCVD)
+            {
+                sendSegment(TCP_SYN | TCP_ACK, FALSE);
+            }
+            else if (conn.state == TCP_SENDING)
+            {
+                sendSegment(TCP_ACK, TRUE);
+            }
+            else
+            {
+                sendSegment(TCP_FIN | TCP_ACK, FALSE);
+            }
+            break;
+        }
+        case TCP_ESTABLISHED:
+        case TCP_FIN_WAIT:
+        {
+            if ((now - conn.lastActivity) >= HTTP_IDLE_MS)
+            {
+                conn.state = TCP_LISTEN;
+            }
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/*!
+ *  @brief    Setter ostatniego odczytu udostepnianego pod adresem /now
+ *  @param    time
+ *              Czas UNIX [s]
+ *  @param    temperature
+ *              Temperatura [0.1 C]
+ *  @param    pressure
+ *              Cisnienie [Pa]
+ *  @param    humidity
+ *              Wilgotnosc [%]
+ *  @param    invalid
+ *              Maska METRIC_BIT wielkosci bez poprawnej wartosci
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void http_setSample(uint32_t time, int32_t temperature, int32_t pressure, int16_t humidity, uint8_t invalid)
+{
+    latest.time = time;
+    latest.temperature = temperature;
+    latest.pressure = pressure;
+    latest.humidity = humidity;
+    latest.invalid = invalid;
+    latest.valid = TRUE;
+}
@@ -0,0 +1,12 @@
+#ifndef HTTP_H_
+#define HTTP_H_
+
+#include "lpc_types.h"
+
+#define HTTP_PORT 80
+
+void http_init(void);
+void http_poll(uint32_t now);
+void http_setSample(uint32_t time, int32_t temperature, int32_t pressure, int16_t humidity, uint8_t invalid);
+
+#endif /* HTTP_H_ */
@@ -0,0 +1,327 @@
+#include "lpc_types.h"
+#include "light.h"
+
+#include "htu21d.h"
+#include "config.h"
+#include "crc.h"
+
+#define HTU21D_ADDRESS        0x40
+
+/* Polecenia */
+#define HTU21D_CMD_TEMP_NOHOLD 0xF3
+#define HTU21D_CMD_RH_NOHOLD   0xF5
+#define HTU21D_CMD_WRITE_USER  0xE6
+#define HTU21D_CMD_READ_USER   0xE7
+
+/* Bity rozdzielczosci w rejestrze uzytkownika */
+#define HTU21D_USER_RES_MASK  0x81
+
+/* Bit statusu w mlodszym bajcie wyniku: 1 - wilgotnosc, 0 - temperatura */
+#define HTU21D_STATUS_RH      0x02
+
+/*
+ * Typowy czas pomiaru dla kolejnych rozdzielczosci [ms]. Przed jego
+ * uplywem czujnik nie jest odpytywany, potem co 1 ms do potwierdzenia adresu.
+ */
+static const uint8_t humidityWait[4] = { 14, 2, 4, 7 };
+static const uint8_t temperatureWait[4] = { 44, 11, 22, 6 };
+
+static uint8_t resolution = HTU21D_RES_RH12_T14;
+static uint8_t channel = HTU21D_CHANNEL_HUMIDITY;
+static uint32_t startTime = 0;
+static Bool pending = FALSE;
+static htu21d_stats_t stats;
+
+/* Wynik ostatniego odczytu */
+static int16_t humidity = 0;
+static int32_t temperature = 0;
+
+const sensor_ops_t htu21d_sensor =
+{
+    "hum", "%", SENSOR_SCALE, htu21d_startReading, htu21d_pollReading, htu21d_getHumidity
+};
+
+/*!
+ *  @brief    Procedura inicjalizujaca czujnik: rozdzielczosc z konfiguracji
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis rejestru uzytkownika czujnika przez I2C
+ */
+void htu21d_init(void)
+{
+    pending = FALSE;
+
+    if (htu21d_setResolution(config_get()->humidityResolution) == FALSE)
+    {
+        resolution = HTU21D_RES_RH12_T14;
+    }
+}
+
+/*!
+ *  @brief    Funkcja zmieniajaca rozdzielczosc pomiarow. Pozostale bity
+ *            rejestru uzytkownika (grzalka, OTP) nie sa zmieniane.
+ *  @param    newResolution
+ *              HTU21D_RES_xxx
+ *  @returns  FALSE dla niepoprawnej rozdzielczosci lub bledu komunikacji
+ *  @side_effects:
+ *            Zapis rejestru uzytkownika czujnika przez I2C
+ */
+Bool htu21d_setResolution(uint8_t newResolution)
+{
+    uint8_t buffer[2];
+
+    if (newResolution > HTU21D_RES_RH11_T11)
+    {
+        return FALSE;
+    }
+
+    buffer[0] = HTU21D_CMD_READ_USER;
+    if ((I2CWrite(HTU21D_ADDRESS, buffer, 1) != 0) || (I2CRead(HTU21D_ADDRESS, &buffer[1], 1) != 0))
+    {
+        stats.busErrors++;
+        return FALSE;
+    }
+
+    buffer[0] = HTU21D_CMD_WRITE_USER;
+    buffer[1] = (uint8_t)((buffer[1] & ~HTU21D_USER_RES_MASK)
+            | ((newResolution & 0x02) << 6) | (newResolution & 0x01));
+    if (I2CWrite(HTU21D_ADDRESS, buffer, 2) != 0)
+    {
+        stats.busErrors++;
+        return FALSE;
+    }
+
+    resolution = newResolution;
+    return TRUE;
+}
+
+/*!
+ *  @brief    Funkcja uruchamiajaca pomiar bez wstrzymywania zegara magistrali
+ *            (no hold master), magistrala jest wolna do konca pomiaru
+ *  @param    newChannel
+ *              HTU21D_CHANNEL_xxx
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  FALSE w przypadku bledu komunikacji
+ *  @side_effects:
+ *            Przerwanie poprzedniego pomiaru
+ */
+Bool htu21d_start(uint8_t newChannel, uint32_t now)
+{
+    uint8_t command = (newChannel == HTU21D_CHANNEL_TEMPERATURE)
+            ? HTU21D_CMD_TEMP_NOHOLD : HTU21D_CMD_RH_NOHOLD;
+
+    pending = FALSE;
+
+    if (I2CWrite(HTU21D_ADDRESS, &command, 1) != 0)
+    {
+        stats.busErrors++;
+        return FALSE;
+    }
+
+    channel = newChannel;
+    startTime = now;
+    pending = TRUE;
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Funkcja odpytujaca czujnik o wynik pomiaru. W trakcie pomiaru
+ *            czujnik nie potwierdza adresu (NACK).
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @param    pRaw
+ *              Wynik surowy bez bitow statusu
+ *  @returns  HTU21D_BUSY w trakcie pomiaru, HTU21D_READY po odczycie wyniku
+ *            z poprawna suma kontrolna, HTU21D_ERROR po bledzie CRC, statusu
+ *            lub przekroczeniu czasu
+ *  @side_effects:
+ *            Zakonczenie pomiaru po odczycie lub bledzie
+ */
+int32_t htu21d_poll(uint32_t now, uint16_t* pRaw)
+{
+    uint8_t data[3];
+    uint8_t wait = 0;
+
+    if (pending == FALSE)
+    {
+        return HTU21D_ERROR;
+    }
+
+    wait = (channel == HTU21D_CHANNEL_TEMPERATURE) ? temperatureWait[resolution] : humidityWait[resolution];
+    if ((now - startTime) < wait)
+    {
+        return HTU21D_BUSY;
+    }
+
+    if (I2CRead(HTU21D_ADDRESS, data, 3) != 0)
+    {
+        if ((now - startTime) < HTU21D_TIMEOUT_MS)
+        {
+            return HTU21D_BUSY;
+        }
+        stats.timeouts++;
+        pending = FALSE;
+        return HTU21D_ERROR;
+    }
+
+    pending = FALSE;
+
+    if (crc8_sensirion(data, 2) != data[2])
+    {
+        stats.crcErrors++;
+        return HTU21D_ERROR;
+    }
+
+    /* Bit statusu musi odpowiadac uruchomionemu pomiarowi */
+    if (((data[1] & HTU21D_STATUS_RH) != 0) != (channel == HTU21D_CHANNEL_HUMIDITY))
+    {
+        stats.busErrors++;
+        return HTU21D_ERROR;
+    }
+
+    *pRaw = (uint16_t)(((data[0] << 8) | data[1]) & 0xFFFC);
+    return HTU21D_READY;
+}
+
+/*!
+ *  @brief    Funkcja przeliczajaca wynik surowy na temperature,
+ *            T = -46.85 + 175.72 * S / 2^16
+ *  @param    raw
+ *              Wynik surowy
+ *  @returns  Temperatura [0.1 C]
+ *  @side_effects:
+ *            Brak
+ */
+int32_t htu21d_toTemperature(uint16_t raw)
+{
+    int32_t temperature = ((17572 * (int32_t)raw + 32768) >> 16) - 4685;
+
+    /* Z 0.01 C do 0.1 C, zaokraglone od zera */
+    return (temperature + ((temperature >= 0) ? 5 : -5)) / 10;
+}
+
+/*!
+ *  @brief    Funkcja przeliczajaca wynik surowy na wilgotnosc,
+ *            RH = -6 + 125 * S / 2^16, z kompensacja temperatury
+ *            -0.15 %/C wzgledem 25 C
+ *  @param    raw
+ *              Wynik surowy
+ *  @param    temperature
+ *              Temperatura czujnika [0.1 C]
+ *  @returns  Wilgotnosc [%], 0 - 100
+ *  @side_effects:
+ *            Brak
+ */
+int16_t htu21d_toHumidity(uint16_t raw, int32_t temperature)
+{
+    int32_t rh = ((12500 * (int32_t)raw + 32768) >> 16) - 600;
+
+    /* Kompensacja w zakresie 0 - 80 C, w 0.01 % na 0.1 C: 1.5 */
+    if (temperature < 0)
+    {
+        temperature = 0;
+    }
+    if (temperature > 800)
+    {
+        temperature = 800;
+    }
+    rh += ((250 - temperature) * -3) / 2;
+
+    if (rh < 0)
+    {
+        return 0;
+    }
+    if (rh > 10000)
+    {
+        return 100;
+    }
+
+    return (int16_t)((rh + 50) / 100);
+}
+
+/*!
+ *  @brief    Funkcja uruchamiajaca odczyt temperatury i wilgotnosci.
+ *            Najpierw mierzona jest temperatura, potrzebna do kompensacji
+ *            wilgotnosci.
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  FALSE w przypadku bledu komunikacji
+ *  @side_effects:
+ *            Przerwanie poprzedniego pomiaru
+ */
+Bool htu21d_startReading(uint32_t now)
+{
+    return htu21d_start(HTU21D_CHANNEL_TEMPERATURE, now);
+}
+
+/*!
+ *  @brief    Funkcja prowadzaca odczyt temperatury i wilgotnosci, po
+ *            pomiarze temperatury uruchamia pomiar wilgotnosci
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  SENSOR_BUSY, SENSOR_READY lub SENSOR_ERROR
+ *  @side_effects:
+ *            Komunikacja z czujnikiem, po zakonczeniu zmiana wyniku
+ */
+int32_t htu21d_pollReading(uint32_t now)
+{
+    uint16_t raw = 0;
+    int32_t status = htu21d_poll(now, &raw);
+
+    if (status == HTU21D_BUSY)
+    {
+        return SENSOR_BUSY;
+    }
+    if (status != HTU21D_READY)
+    {
+        return SENSOR_ERROR;
+    }
+
+    if (channel == HTU21D_CHANNEL_TEMPERATURE)
+    {
+        temperature = htu21d_toTemperature(raw);
+        return (htu21d_start(HTU21D_CHANNEL_HUMIDITY, now) == TRUE) ? SENSOR_BUSY : SENSOR_ERROR;
+    }
+
+    humidity = htu21d_toHumidity(raw, temperature);
+    return SENSOR_READY;
+}
+
+/*!
+ *  @brief    Getter wilgotnosci z ostatniego odczytu
+ *  @param    Brak
+ *  @returns  Wilgotnosc skompensowana [%]
+ *  @side_effects:
+ *            Brak
+ */
+int32_t htu21d_getHumidity(void)
+{
+    return humidity;
+}
+
+/*!
+ *  @brief    Getter temperatury czujnika wilgotnosci z ostatniego odczytu
+ *  @param    Brak
+ *  @returns  Temperatura [0.1 C]
+ *  @side_effects:
+ *            Brak
+ */
+int32_t htu21d_getTemperature(void)
+{
+    return temperature;
+}
+
+/*!
+ *  @brief    Getter licznikow bledow
+ *  @param    Brak
+ *  @returns  Wskaznik na liczniki
+ *  @side_effects:
+ *            Brak
+ */
+const htu21d_stats_t* htu21d_getStats(void)
+{
+    return &stats;
+}
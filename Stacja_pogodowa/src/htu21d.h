@@ -0,0 +1,55 @@
+#ifndef HTU21D_H_
+#define HTU21D_H_
+
+#include "lpc_types.h"
+#include "sensor.h"
+
+/* Kanaly pomiarowe */
+#define HTU21D_CHANNEL_HUMIDITY    0
+#define HTU21D_CHANNEL_TEMPERATURE 1
+
+/*
+ * Rozdzielczosc wilgotnosci i temperatury (bity 7 i 0 rejestru uzytkownika)
+ * i najdluzszy czas pomiaru RH + T:
+ *   0 - RH 12 bit, T 14 bit   16 + 50 ms (ustawienie po wlaczeniu zasilania)
+ *   1 - RH  8 bit, T 12 bit    3 + 13 ms
+ *   2 - RH 10 bit, T 13 bit    5 + 25 ms
+ *   3 - RH 11 bit, T 11 bit    8 +  7 ms
+ */
+#define HTU21D_RES_RH12_T14 0
+#define HTU21D_RES_RH8_T12  1
+#define HTU21D_RES_RH10_T13 2
+#define HTU21D_RES_RH11_T11 3
+
+/* Wynik odpytania pomiaru */
+#define HTU21D_BUSY  0
+#define HTU21D_READY 1
+#define HTU21D_ERROR 2
+
+/* Czas, po ktorym pomiar bez odpowiedzi czujnika jest bledny [ms] */
+#define HTU21D_TIMEOUT_MS 100
+
+/* Liczniki bledow */
+typedef struct
+{
+    uint32_t crcErrors;
+    uint32_t timeouts;
+    uint32_t busErrors;
+} htu21d_stats_t;
+
+void htu21d_init(void);
+Bool htu21d_setResolution(uint8_t resolution);
+Bool htu21d_start(uint8_t channel, uint32_t now);
+int32_t htu21d_poll(uint32_t now, uint16_t* pRaw);
+int32_t htu21d_toTemperature(uint16_t raw);
+int16_t htu21d_toHumidity(uint16_t raw, int32_t temperature);
+Bool htu21d_startReading(uint32_t now);
+int32_t htu21d_pollReading(uint32_t now);
+int32_t htu21d_getHumidity(void);
+int32_t htu21d_getTemperature(void);
+const htu21d_stats_t* htu21d_getStats(void);
+
+/* Czujnik wilgotnosci dla sensor_register, wynik w % */
+extern const sensor_ops_t htu21d_sensor;
+
+#endif /* HTU21D_H_ */
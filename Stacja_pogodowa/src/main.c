@@ -1,20 +1,69 @@
+#include <string.h>
+
 #include "lpc17xx_pinsel.h"
 #include "lpc17xx_i2c.h"
 #include "lpc17xx_gpio.h"
-#include "lpc17xx_ssp.h"
 #include "lpc17xx_timer.h"
 #include "lpc17xx_rtc.h"
 
 #include "oled.h"
 #include "temp.h"
 #include "light.h"
+#include "acc.h"
 #include "joystick.h"
 #include "led7seg.h"
+#include "eeprom.h"
+#include "spibus.h"
+
+#include "config.h"
+#include "telemetry.h"
+#include "console.h"
+#include "uart0.h"
+#include "datalog.h"
+#include "export.h"
+#include "net.h"
+#include "http.h"
+#include "canbus.h"
+#include "modbus.h"
+#include "fmt.h"
+#include "forecast.h"
+#include "baro.h"
+#include "derived.h"
+#include "alarm.h"
+#include "window.h"
+#include "filter.h"
+#include "bmp180.h"
+#include "htu21d.h"
+#include "sensor.h"
+#include "ambient.h"
+#include "vibration.h"
+
+/*
+ * Numery czujnikow w tablicy czujnikow, zgodne z kolejnoscia rejestracji.
+ * Kolejne czujniki mozna dopisywac bez zmian w petli glownej.
+ */
+#define SENSOR_ID_TEMPERATURE 0
+#define SENSOR_ID_PRESSURE    1
+#define SENSOR_ID_HUMIDITY    2
+#define SENSOR_ID_LIGHT       3
+
+/* Kontrast ekranu ustawiany przez oled_init */
+#define DISPLAY_CONTRAST 0x32
+
+/* Najwczesniejszy poprawny rok zegara RTC, uzywany tez w dacie domyslnej */
+#define RTC_DEFAULT_YEAR 2024
 
 /* Zmienne na dane odczytane z czujnikow */
 static int32_t temperature = 0;
 static int32_t pressure = 0;
+static int32_t seaLevelPressure = 0;
 static int16_t humidity = 0;
+static int32_t humidityTemperature = 0;
+static int32_t light = 0;
+static derived_t derived;
+/* Maska METRIC_BIT wielkosci bez poprawnej wartosci w ostatnim odczycie, na poczatku wszystkie */
+static uint8_t invalidMetrics = (uint8_t)~METRIC_BIT(METRIC_VIBRATION);
+static uint8_t displayContrast = DISPLAY_CONTRAST;
 
 /* Typ wyliczeniowy do wybrania konkretnej cyfry w dacie i godzinie */
 enum joystickMovement
@@ -34,69 +83,16 @@ enum dateOrTime
 
 /* Zmienne pomocnicze/sterujace */
 static uint32_t msTicks = 0;
-static uint8_t buf[10];
+static char buf[FMT_MAX_LEN + 1];
 static enum dateOrTime dateTime = DATE;
 static enum joystickMovement jMov = LEFT;
 static RTC_TIME_Type rtc;
 
-/*!
- *  @brief    Procedura zamienia wartosc calkowita na lancuch znakow
- *  @param 	  value
- *              Wartosc zmieniana na lancuch znakow
- *  @param 	  pBuf
- *              Bufor
- *  @param 	  len
- *              Dlugosc bufora
- *  @param 	  base
- *              System liczbowy (np. 2 - binarny, 10 - dziesietny)
- *  @returns  Nic
- *  @side_effects:
- *            Brak
- */
-static void intToString(int value, uint8_t* pBuf, uint32_t len, uint32_t base)
-{
-    static const char* pAscii = "0123456789abcdefghijklmnopqrstuvwxyz";
-    int pos = 0;
-    int tmpValue = value;
-
-    if (pBuf == NULL || len < 2)
-    {
-        return;
-    }
-
-    if (base < 2 || base > 36)
-    {
-        return;
-    }
-
-    if (value < 0)
-    {
-        tmpValue = -tmpValue;
-        value = -value;
-        pBuf[pos] = '-';
-        pos++;
-    }
-
-    do {
-        pos++;
-        tmpValue /= base;
-    } while(tmpValue > 0);
-
-
-    if (pos > len)
-    {
-        return;
-    }
-
-    pBuf[pos] = '\0';
-
-    do {
-        pBuf[--pos] = pAscii[value % base];
-        value = value / base;
-    } while(value > 0);
-
-    return;
-}
+/* Liczniki czasu wykonania petli glownej [ms] */
+static uint32_t loopCount = 0;
+static uint32_t sampleTimeLast = 0;
+static uint32_t sampleTimeMax = 0;
+static uint32_t loopTimeMax = 0;
 
 /*!
  *  @brief    Procedura do obslugi tickow systemowych
@@ -121,48 +117,6 @@ static uint32_t getTicks(void)
     return msTicks;
 }
 
-/*!
- *  @brief    Procedura sluzaca do inicjalizacji kontrolera SSP
- *  @param 	  Brak
- *  @returns  Nic
- *  @side_effects:
- *            Konfiguracja pinow i zmiany w rejestrze SSP
- */
-static void init_ssp(void)
-{
-	SSP_CFG_Type SSP_ConfigStruct;
-	PINSEL_CFG_Type PinCfg;
-
-	/*
-	 * Initialize SPI pin connect
-	 * P0.7 - SCK;
-	 * P0.8 - MISO
-	 * P0.9 - MOSI
-	 * P2.2 - SSEL - used as GPIO
-	 */
-	PinCfg.Funcnum = 2;
-	PinCfg.OpenDrain = 0;
-	PinCfg.Pinmode = 0;
-	PinCfg.Portnum = 0;
-	PinCfg.Pinnum = 7;
-	PINSEL_ConfigPin(&PinCfg);
-	PinCfg.Pinnum = 8;
-	PINSEL_ConfigPin(&PinCfg);
-	PinCfg.Pinnum = 9;
-	PINSEL_ConfigPin(&PinCfg);
-	PinCfg.Funcnum = 0;
-	PinCfg.Portnum = 2;
-	PinCfg.Pinnum = 2;
-	PINSEL_ConfigPin(&PinCfg);
-
-	SSP_ConfigStructInit(&SSP_ConfigStruct);
-
-	SSP_Init(LPC_SSP1, &SSP_ConfigStruct);
-
-	SSP_Cmd(LPC_SSP1, ENABLE);
-
-}
-
 /*!
  *  @brief    Procedura sluzaca do inicjalizacji interfejsu I2C2
  *  @param 	  Brak
@@ -187,210 +141,174 @@ static void init_i2c(void)
 }
 
 /*!
- *  @brief    Funkcja obliczajaca aktualne cisnienie atmosferyczne
- *  @param 	  Brak
- *  @returns  32-bitowa liczba calkowita oznaczajaca cisnienie
- *            W przypadku problemow z komunikacja z czujnikiem zwraca 0.
+ *  @brief    Funkcja uruchamiajaca pomiar temperatury. Czujnik MAX6576 mierzy
+ *            caly czas, okres przebiegu jest mierzony dopiero w temp_read.
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  TRUE
  *  @side_effects:
  *            Brak
  */
-int32_t calculatePressure(void)
-{
-	uint8_t communicationBuffer[3];
-
-	uint8_t deviceAddress = 0x77;
-
-    int16_t ac1;
-    int16_t ac2;
-    int16_t ac3;
-    int16_t b1;
-    int16_t b2;
-    int16_t mb;
-    int16_t mc;
-    int16_t md;
-
-    uint16_t ac4;
-    uint16_t ac5;
-    uint16_t ac6;
-
-    int32_t b6;
-    int32_t x3;
-    int32_t b3;
-    int32_t p = 0;
-    uint32_t b4;
-    uint32_t b7;
-
-	communicationBuffer[0] = 0xAA;
-
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-	I2CRead(deviceAddress, communicationBuffer, 2);
-	ac1 = (communicationBuffer[0] << 8) | communicationBuffer[1];
-
-	communicationBuffer[0] = 0xAC;
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-	I2CRead(deviceAddress, communicationBuffer, 2);
-	ac2 = (communicationBuffer[0] << 8) | communicationBuffer[1];
-
-	communicationBuffer[0] = 0xAE;
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-	I2CRead(deviceAddress, communicationBuffer, 2);
-	ac3 = (communicationBuffer[0] << 8) | communicationBuffer[1];
-
-	communicationBuffer[0] = 0xB0;
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-	I2CRead(deviceAddress, communicationBuffer, 2);
-	ac4 = (communicationBuffer[0] << 8) | communicationBuffer[1];
-
-	communicationBuffer[0] = 0xB2;
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-	I2CRead(deviceAddress, communicationBuffer, 2);
-	ac5 = (communicationBuffer[0] << 8) | communicationBuffer[1];
-
-	communicationBuffer[0] = 0xB4;
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-	I2CRead(deviceAddress, communicationBuffer, 2);
-	ac6 = (communicationBuffer[0] << 8) | communicationBuffer[1];
-
-	communicationBuffer[0] = 0xB6;
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-	I2CRead(deviceAddress, communicationBuffer, 2);
-	b1 = (communicationBuffer[0] << 8) | communicationBuffer[1];
-
-	communicationBuffer[0] = 0xB8;
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-	I2CRead(deviceAddress, communicationBuffer, 2);
-	b2 = (communicationBuffer[0] << 8) | communicationBuffer[1];
-
-	communicationBuffer[0] = 0xBA;
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-	I2CRead(deviceAddress, communicationBuffer, 2);
-	mb = (communicationBuffer[0] << 8) | communicationBuffer[1];
-	mb++;
-
-	communicationBuffer[0] = 0xBC;
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-	I2CRead(deviceAddress, communicationBuffer, 2);
-	mc = (communicationBuffer[0] << 8) | communicationBuffer[1];
-
-	communicationBuffer[0] = 0xBE;
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-	I2CRead(deviceAddress, communicationBuffer, 2);
-	md = (communicationBuffer[0] << 8) | communicationBuffer[1];
-
-	communicationBuffer[0] = 0xD0;
-
-	I2CWrite(deviceAddress, communicationBuffer, 1);
-
-    if ((I2CRead(deviceAddress, communicationBuffer, 1) == 0) && (communicationBuffer[0] == (uint8_t)0x55))
-	{
-		int32_t ut;
-
-		communicationBuffer[0] = 0xF4;
-		communicationBuffer[1] = 0x2E;
-		I2CWrite(deviceAddress, communicationBuffer, 2);
-		Timer0_Wait(5);
-
-		communicationBuffer[0] = 0xF6;
-		I2CWrite(deviceAddress, communicationBuffer, 1);
-		I2CRead(deviceAddress, communicationBuffer, 2);
-
-		ut = (communicationBuffer[0] << 8) | communicationBuffer[1];
-
-		int16_t oss = 2;
-		int32_t up;
-
-		communicationBuffer[0] = 0xF4;
-		communicationBuffer[1] = 0xB4;
-
-		I2CWrite(deviceAddress, communicationBuffer, 2);
-		Timer0_Wait(14);
-		communicationBuffer[0] = 0xF6;
-		I2CWrite(deviceAddress, communicationBuffer, 1);
-		I2CRead(deviceAddress, communicationBuffer, 3);
-
-		up = ((communicationBuffer[0] << 16) | (communicationBuffer[1] << 8) | communicationBuffer[2]) >> (8 - oss);
-
-        int32_t x1;
-        int32_t x2;
-        int32_t b5;
-
-		x1 = ((ut - ac6) * ac5) >> 15;
-		x2 = (mc << 11) / (x1 + md);
-		b5 = x1 + x2;
-
-		b6 = b5 - 4000;
-		x1 = ((int32_t)b2 * (b6 * b6 >> 12)) >> 11;
-		x2 = (int32_t)ac2 * b6 >> 11;
-		x3 = x1 + x2;
-        b3 = ((((int32_t)ac1 * 4 + x3) << oss) + 2) >> 2;
-		x1 = (int32_t)ac3 * b6 >> 13;
-		x2 = ((int32_t)b1 * (b6 * b6 >> 12)) >> 16;
-		x3 = ((x1 + x2) + 2) >> 2;
-		b4 = (int32_t)ac4 * (uint32_t)(x3 + 32768) >> 15;
-		b7 = ((uint32_t)up - b3) * (int32_t)(50000 >> oss);
-        if (b7 < 0x80000000U)
-		{
-			p = (b7 * 2) / b4;
-		}
-		else
-		{
-			p = (b7 / b4) * 2;
-		}
-		x1 = (p >> 8) * (p >> 8);
-		x1 = (x1 * 3038) >> 16;
-		x2 = (-7357 * p) >> 16;
-		p = p + ((x1 + x2 + (int32_t)3791) >> 4);
-	}
-	else
-	{
-        led7seg_setChar('3', FALSE);
-	}
-    return p;
+static Bool tempStart(uint32_t now)
+{
+    return TRUE;
 }
 
 /*!
- *  @brief    Funkcja obliczajaca wilgotnosc powietrza
- *  @param    Brak
- *  @returns  Liczba calkowita 16-bitowa oznaczajaca obliczona wilgotnosc powietrza.
- *            W przypadku problemow z komunikacja z czujnikiem zwraca 0.
+ *  @brief    Funkcja odpytujaca pomiar temperatury, wynik jest zawsze gotowy
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  SENSOR_READY
  *  @side_effects:
  *            Brak
  */
-int16_t calculateHumidity(void)
+static int32_t tempPoll(uint32_t now)
 {
-	uint8_t deviceAddress = 0x40;
-	uint16_t srh = 0;
-	int16_t rh = 0;
-    int16_t result = 0;
+    return SENSOR_READY;
+}
 
-	uint8_t communicationBuffer[3];
+/* Czujnik temperatury dla sensor_register, wynik w 0.1 C */
+static const sensor_ops_t tempSensor =
+{
+    "temp", "C", SENSOR_SCALE / 10, tempStart, tempPoll, temp_read
+};
 
-	communicationBuffer[0] = 0xF5;
+/*!
+ *  @brief    Procedura przepisujaca odczyt czujnika do zmiennej w skali
+ *            uzywanej przez wyswietlacz, dziennik i telemetrie. Gdy czujnik
+ *            nie ma poprawnej wartosci, zmienna zachowuje poprzednia, a
+ *            zalezne od niego wielkosci sa oznaczane w invalidMetrics.
+ *  @param    id
+ *              Numer czujnika SENSOR_ID_xxx
+ *  @param    scale
+ *              Skala wyniku, dzielnik SENSOR_SCALE
+ *  @param    pValue
+ *              Zmienna odczytu
+ *  @param    metrics
+ *              Maska METRIC_BIT wielkosci zaleznych od czujnika
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana maski invalidMetrics
+ */
+static void readSensor(uint32_t id, int32_t scale, int32_t* pValue, uint8_t metrics)
+{
+    if (sensor_getValue(id, scale, pValue) == FALSE)
+    {
+        invalidMetrics |= metrics;
+    }
+}
 
-	if (I2CWrite(deviceAddress, communicationBuffer, 1) == 0)
-	{
-		Timer0_Wait(13);
-		I2CRead(deviceAddress, communicationBuffer, 2);
-		srh = ((communicationBuffer[0] << 8) | communicationBuffer[1]) & 0xFFFC;
-        rh = -6 + 125 * (long)srh / 65536;
+/*!
+ *  @brief    Procedura przepisujaca odczyty czujnikow po zakonczonym cyklu
+ *            pomiarow. Punkt rosy i wskaznik upalu wymagaja poprawnej
+ *            temperatury i wilgotnosci.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana zmiennych temperature, pressure, humidity,
+ *            humidityTemperature, light i maski invalidMetrics
+ */
+static void updateReadings(void)
+{
+    int32_t value = humidity;
+
+    invalidMetrics = 0;
+    readSensor(SENSOR_ID_TEMPERATURE, 10, &temperature,
+            METRIC_BIT(METRIC_TEMPERATURE) | METRIC_BIT(METRIC_DEW_POINT) | METRIC_BIT(METRIC_HEAT_INDEX));
+    readSensor(SENSOR_ID_PRESSURE, 1, &pressure, METRIC_BIT(METRIC_PRESSURE));
+    readSensor(SENSOR_ID_HUMIDITY, 1, &value,
+            METRIC_BIT(METRIC_HUMIDITY) | METRIC_BIT(METRIC_DEW_POINT) | METRIC_BIT(METRIC_HEAT_INDEX));
+    humidity = (int16_t)value;
+    humidityTemperature = htu21d_getTemperature();
+    readSensor(SENSOR_ID_LIGHT, 1, &light, METRIC_BIT(METRIC_LIGHT));
+}
 
-        result = rh;
+/*!
+ *  @brief    Funkcja wybierajaca znak wyswietlacza 7-segmentowego. Blad
+ *            czujnika ma pierwszenstwo przed kodem alarmu.
+ *  @param    Brak
+ *  @returns  '3' gdy ktorys czujnik nie ma nowego poprawnego odczytu, kod
+ *            aktywnego alarmu lub '0'
+ *  @side_effects:
+ *            Brak
+ */
+static char getDisplayChar(void)
+{
+    char alarmCode = 0;
+    uint32_t i = 0;
 
-		if (rh < 0)
-        {
-            result = 0;
-        }
-        if (rh > 100)
+    for (i = 0; i < sensor_getCount(); i++)
+    {
+        if (sensor_getSample(i)->status != SENSOR_STATUS_OK)
         {
-            result = 100;
+            return '3';
         }
+    }
 
-	}
-	else
-	{
-		led7seg_setChar('3', FALSE);
-	}
-    return result;
+    alarmCode = alarm_getDisplayCode();
+    return (alarmCode != 0) ? alarmCode : '0';
+}
+
+/*!
+ *  @brief    Procedura dopasowujaca kontrast ekranu do natezenia swiatla,
+ *            gdy przyciemnianie jest wlaczone. Bez poprawnego odczytu
+ *            czujnika wraca kontrast domyslny.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana kontrastu ekranu
+ */
+static void updateContrast(void)
+{
+    uint8_t contrast = DISPLAY_CONTRAST;
+
+    if ((config_get()->displayDimming != 0)
+            && (sensor_getSample(SENSOR_ID_LIGHT)->status == SENSOR_STATUS_OK))
+    {
+        contrast = ambient_getContrast();
+    }
+
+    if (contrast != displayContrast)
+    {
+        oled_setContrast(contrast);
+        displayContrast = contrast;
+    }
+}
+
+/*!
+ *  @brief    Procedura rysujaca strzalke tendencji cisnienia w polu 9x9
+ *  @param    x
+ *              Lewa krawedz pola
+ *  @param    y
+ *              Gorna krawedz pola
+ *  @param    trend
+ *              Tendencja FORECAST_TREND_xxx
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void printTrendArrow(uint8_t x, uint8_t y, int8_t trend)
+{
+    oled_fillRect(x, y, x + 8, y + 8, OLED_COLOR_BLACK);
+
+    if (trend == FORECAST_TREND_RISING)
+    {
+        oled_line(x + 4, y, x + 4, y + 8, OLED_COLOR_WHITE);
+        oled_line(x + 1, y + 3, x + 4, y, OLED_COLOR_WHITE);
+        oled_line(x + 4, y, x + 7, y + 3, OLED_COLOR_WHITE);
+    }
+    else if (trend == FORECAST_TREND_FALLING)
+    {
+        oled_line(x + 4, y, x + 4, y + 8, OLED_COLOR_WHITE);
+        oled_line(x + 1, y + 5, x + 4, y + 8, OLED_COLOR_WHITE);
+        oled_line(x + 4, y + 8, x + 7, y + 5, OLED_COLOR_WHITE);
+    }
+    else
+    {
+        oled_line(x, y + 4, x + 8, y + 4, OLED_COLOR_WHITE);
+        oled_line(x + 5, y + 1, x + 8, y + 4, OLED_COLOR_WHITE);
+        oled_line(x + 8, y + 4, x + 5, y + 7, OLED_COLOR_WHITE);
+    }
 }
 
 /*!
@@ -402,22 +320,17 @@ int16_t calculateHumidity(void)
  */
 void printData(void)
 {
+    const forecast_t* pForecast = forecast_get();
+    const char* pText = NULL;
+    char line[17];
+
     oled_putString(1,1, (uint8_t*)"Temp: ", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
     oled_putString(1,12, (uint8_t*)"Press: ", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
     oled_putString(1,23, (uint8_t*)"Humidity: ", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
 
-	int32_t integerPart = 0;
-	int32_t fractionPart = 0;
-	integerPart = temperature / 10;
-	fractionPart = temperature % 10;
-
-	intToString((uint32_t)integerPart, buf, 10, 10);
-	oled_putString(48, 1, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-
-	oled_putString(60, 1, (uint8_t *)".", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-
-	intToString((uint32_t)fractionPart, buf, 10, 10);
-	oled_putString(64, 1, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+	/* Temperatura wyrownana do prawej, kropka zawsze w tym samym miejscu */
+	fmt_fixed(buf, temperature, 1, 5, ' ');
+	oled_putString(42, 1, (uint8_t*)buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
 
 	oled_putPixel(73, 1, OLED_COLOR_WHITE);
 	oled_putPixel(73, 2, OLED_COLOR_WHITE);
@@ -425,17 +338,106 @@ void printData(void)
 	oled_putPixel(74, 2, OLED_COLOR_WHITE);
 	oled_putString(76, 1, (uint8_t *)"C", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
 
-	intToString((uint32_t)((pressure / 100) + 25), buf, 10, 10);
-	oled_putString(48, 12, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+	fmt_uint(buf, (uint32_t)((seaLevelPressure + 50) / 100), 4, ' ');
+	oled_putString(48, 12, (uint8_t*)buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
 	oled_putString(72, 12, (uint8_t *)"hPa", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
 
-	intToString(humidity, buf, 10, 10);
-	oled_putString(58, 23, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+	fmt_int(buf, humidity, 3, ' ');
+	oled_putString(58, 23, (uint8_t*)buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
 	oled_putString(80, 23, (uint8_t *)"%", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-	if (humidity < 100)
+
+	/* Zmiana cisnienia w ciagu 3 godzin [hPa] i prognoza (16 znakow) */
+	oled_putString(1, 34, (uint8_t*)"Trend: ", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+	if (pForecast->slots >= 2)
+	{
+		fmt_fixed(buf, pForecast->change / 10, 1, 5, ' ');
+		oled_putString(42, 34, (uint8_t*)buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+		printTrendArrow(76, 34, pForecast->trend);
+	}
+	else
+	{
+		oled_putString(42, 34, (uint8_t*)"   --", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+	}
+
+	memset(line, ' ', sizeof(line) - 1);
+	line[sizeof(line) - 1] = '\0';
+	if (pForecast->code != 0)
 	{
-		oled_putString(70, 23, (uint8_t *)" ", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+		pText = forecast_getText(pForecast->code);
+		memcpy(line, pText, strlen(pText));
 	}
+	oled_putString(1, 45, (uint8_t*)line, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+
+	/* Punkt rosy, przy ryzyku przymrozku zamiast etykiety ostrzezenie */
+	oled_putString(1, 56, (uint8_t*)(derived.frostRisk ? "Frost:" : "Dew:  "),
+			OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+	fmt_fixed(buf, derived.dewPoint, 1, 5, ' ');
+	oled_putString(42, 56, (uint8_t*)buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+	oled_putPixel(73, 56, OLED_COLOR_WHITE);
+	oled_putPixel(73, 57, OLED_COLOR_WHITE);
+	oled_putPixel(74, 56, OLED_COLOR_WHITE);
+	oled_putPixel(74, 57, OLED_COLOR_WHITE);
+	oled_putString(76, 56, (uint8_t *)"C", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+}
+
+/*!
+ *  @brief    Procedura wyswietlajaca jeden wiersz statystyk ostatniej godziny:
+ *            minimum, maksimum i srednia, po 5 znakow
+ *  @param    y
+ *              Wiersz
+ *  @param    pLabel
+ *              Jednoznakowa etykieta
+ *  @param    metric
+ *              METRIC_xxx
+ *  @param    decimals
+ *              Liczba miejsc po przecinku
+ *  @param    divisor
+ *              Dzielnik wartosci (np. 100 dla Pa -> hPa)
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana zmiennej globalnej buf
+ */
+static void printWindowRow(uint8_t y, const char* pLabel, uint8_t metric, uint8_t decimals, int32_t divisor)
+{
+    window_result_t result;
+    int32_t values[3];
+    uint32_t i = 0;
+
+    window_getMetric(metric, &result);
+    values[0] = result.min;
+    values[1] = result.max;
+    values[2] = result.mean;
+
+    oled_putString(0, y, (uint8_t*)pLabel, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+
+    for (i = 0; i < 3; i++)
+    {
+        if (result.count == 0)
+        {
+            oled_putString((uint8_t)(6 + i * 30), y, (uint8_t*)"   --", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+            continue;
+        }
+
+        fmt_fixed(buf, (values[i] + divisor / 2) / divisor, decimals, 5, ' ');
+        oled_putString((uint8_t)(6 + i * 30), y, (uint8_t*)buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+    }
+}
+
+/*!
+ *  @brief    Procedura wyswietlajaca minimum, maksimum i srednia z ostatniej
+ *            godziny
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana zmiennej globalnej buf
+ */
+static void printWindow(void)
+{
+    oled_putString(0, 1, (uint8_t*)"1h min  max  avg", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+    printWindowRow(12, "T", METRIC_TEMPERATURE, 1, 1);
+    printWindowRow(23, "P", METRIC_PRESSURE, 0, 100);
+    printWindowRow(34, "H", METRIC_HUMIDITY, 0, 1);
+    printWindowRow(45, "D", METRIC_DEW_POINT, 1, 1);
 }
 
 /*!
@@ -480,6 +482,40 @@ void setDate(uint32_t d, uint32_t m, uint32_t y)
 	RTC_SetFullTime(LPC_RTC, &rtc);
 }
 
+/*!
+ *  @brief    Procedura uruchamiajaca zegar RTC. Zegar podtrzymywany bateria
+ *            dziala dalej po resecie, wiec data i godzina domyslna sa ustawiane
+ *            tylko wtedy, gdy zegar byl zatrzymany lub zawiera niepoprawna date.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana zmiennej globalnej rtc, uruchomienie zegara RTC
+ */
+static void initRtc(void)
+{
+	Bool valid = FALSE;
+
+	if (LPC_RTC->CCR & RTC_CCR_CLKEN)
+	{
+		RTC_GetFullTime(LPC_RTC, &rtc);
+
+		valid = (rtc.YEAR >= RTC_DEFAULT_YEAR) && (rtc.YEAR <= RTC_YEAR_MAX)
+				&& (rtc.MONTH >= 1) && (rtc.MONTH <= RTC_MONTH_MAX)
+				&& (rtc.DOM >= 1) && (rtc.DOM <= RTC_DAYOFMONTH_MAX)
+				&& (rtc.HOUR <= RTC_HOUR_MAX) && (rtc.MIN <= RTC_MINUTE_MAX)
+				&& (rtc.SEC <= RTC_SECOND_MAX);
+	}
+
+	if (!valid)
+	{
+		RTC_Init(LPC_RTC);
+		setTime(12, 0, 0);
+		setDate(13, 6, RTC_DEFAULT_YEAR);
+	}
+
+	RTC_Cmd(LPC_RTC, ENABLE);
+}
+
 /*!
  *  @brief    Procedura ustawia linie podkreslajaca na konkretnej pozycji na ekranie
  *  @param 	  Brak
@@ -631,6 +667,26 @@ void modifyDateOrTime(int joyMove)
     }
 }
 
+/*!
+ *  @brief    Procedura wyswietlajaca liczbe uzupelniona zerami z lewej
+ *  @param    x
+ *              Polozenie na ekranie
+ *  @param    y
+ *              Polozenie na ekranie
+ *  @param    value
+ *              Wartosc
+ *  @param    width
+ *              Liczba cyfr
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana zmiennej globalnej buf
+ */
+static void printPadded(uint8_t x, uint8_t y, uint32_t value, uint8_t width)
+{
+	fmt_uint(buf, value, width, '0');
+	oled_putString(x, y, (uint8_t*)buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+}
+
 /*!
  *  @brief    Procedura wyswietlajaca date i godzine
  *  @param    Brak
@@ -642,85 +698,26 @@ static void printTime(void)
 {
 	RTC_GetFullTime(LPC_RTC, &rtc);
 
-    if ((rtc.DOM >= 0) && (rtc.DOM <= 9))
-	{
-		intToString((uint32_t)0, buf, 10, 10);
-		oled_putString((8), 2, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-		intToString((uint32_t)rtc.DOM, buf, 10, 10);
-		oled_putString((14), 2, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-	}
-	else
-	{
-		intToString((uint32_t)rtc.DOM, buf, 10, 10);
-		oled_putString((8), 2, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-	}
-
+	printPadded(8, 2, rtc.DOM, 2);
 	oled_putString((20), 2, (uint8_t *)".", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-
-    if ((rtc.MONTH >= 0) && (rtc.MONTH <= 9))
-	{
-		intToString((uint32_t)0, buf, 10, 10);
-		oled_putString((26), 2, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-		intToString((uint32_t)rtc.MONTH, buf, 10, 10);
-		oled_putString((32), 2, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-	}
-	else
-	{
-		intToString((uint32_t)rtc.MONTH, buf, 10, 10);
-		oled_putString((26), 2, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-	}
-
+	printPadded(26, 2, rtc.MONTH, 2);
 	oled_putString((38), 2, (uint8_t *)".", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
+	printPadded(44, 2, rtc.YEAR, 4);
 
-	intToString((uint32_t)rtc.YEAR, buf, 10, 10);
-	oled_putString((44), 2, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-
-    if ((rtc.HOUR >= 0) && (rtc.HOUR <= 9))
-	{
-		intToString((uint32_t)0, buf, 10, 10);
-		oled_putString((8), 18, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-		intToString((uint32_t)rtc.HOUR, buf, 10, 10);
-		oled_putString((14), 18, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-	}
-	else
-	{
-		intToString((uint32_t)rtc.HOUR, buf, 10, 10);
-		oled_putString((8), 18, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-	}
-
+	printPadded(8, 18, rtc.HOUR, 2);
 	oled_putString((20), 18, (uint8_t *)":", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-
-    if ((rtc.MIN >= 0) && (rtc.MIN <= 9))
-	{
-		intToString((uint32_t)0, buf, 10, 10);
-		oled_putString((26), 18, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-		intToString((uint32_t)rtc.MIN, buf, 10, 10);
-		oled_putString((32), 18, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-	}
-	else
-	{
-		intToString((uint32_t)rtc.MIN, buf, 10, 10);
-		oled_putString((26), 18, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-	}
-
+	printPadded(26, 18, rtc.MIN, 2);
 	oled_putString((38), 18, (uint8_t *)":", OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-
-    if ((rtc.SEC >= 0) && (rtc.SEC <= 9))
-	{
-		intToString((uint32_t)0, buf, 10, 10);
-		oled_putString((44), 18, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-		intToString((uint32_t)rtc.SEC, buf, 10, 10);
-		oled_putString((50), 18, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-	}
-	else
-	{
-		intToString((uint32_t)rtc.SEC, buf, 10, 10);
-		oled_putString((44), 18, buf, OLED_COLOR_WHITE, OLED_COLOR_BLACK);
-	}
+	printPadded(44, 18, rtc.SEC, 2);
 
 	uint8_t joy = 0;
 	underline();
 	joy = joystick_read();
+	/* Pin P0.16 (prawo) jest linia RXD portu Modbus, gdy ten jest wlaczony */
+	if (config_get()->modbusAddress != 0)
+	{
+		joy &= ~JOYSTICK_RIGHT;
+	}
 	if ((joy & JOYSTICK_CENTER) != 0)
 	{
 		refreshLine();
@@ -747,77 +744,1441 @@ static void printTime(void)
 	}
 }
 
-int main (void)
+/*!
+ *  @brief    Polecenie konsoli "time" - odczyt lub ustawienie godziny (hh:mm:ss)
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana czasu RTC
+ */
+static void cmdTime(uint32_t argc, char* argv[])
 {
-    int16_t currentSite = 1;
+    uint32_t value[3];
 
-    init_i2c();
-    init_ssp();
-    oled_init();
-    joystick_init();
-    RTC_Init(LPC_RTC);
-    setTime(12, 0, 0);
-	setDate(13, 6, 2024);
-	RTC_Cmd(LPC_RTC, ENABLE);
-
-	led7seg_init();
-
-    temp_init (&getTicks);
-
-    if (SysTick_Config(SystemCoreClock / 1000))
-    {
-        while (1) { }
-	}
-
-    oled_clearScreen(OLED_COLOR_BLACK);
-
-    uint8_t leftButton = ((GPIO_ReadValue(0) >> 4) & 0x01);
+    RTC_GetFullTime(LPC_RTC, &rtc);
 
-    while(1)
+    if (argc > 1)
     {
+        if ((console_parseFields(argv[1], ':', value, 3) == FALSE)
+                || (value[0] > 23) || (value[1] > 59) || (value[2] > 59))
+        {
+            console_print("usage: time hh:mm:ss\r\n");
+            return;
+        }
+        setTime(value[0], value[1], value[2]);
+    }
 
-    	led7seg_setChar('0', FALSE);
+    console_printPadded(rtc.HOUR, 2);
+    console_print(":");
+    console_printPadded(rtc.MIN, 2);
+    console_print(":");
+    console_printPadded(rtc.SEC, 2);
+    console_print("\r\n");
+}
 
-        temperature = temp_read();
-        pressure = calculatePressure();
-        humidity = calculateHumidity();
+/*!
+ *  @brief    Polecenie konsoli "date" - odczyt lub ustawienie daty (dd.mm.rrrr)
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana daty RTC
+ */
+static void cmdDate(uint32_t argc, char* argv[])
+{
+    uint32_t value[3];
 
-        leftButton = ((GPIO_ReadValue(0) >> 4) & 0x01);
+    RTC_GetFullTime(LPC_RTC, &rtc);
 
-        if(leftButton == 0)
+    if (argc > 1)
+    {
+        if ((console_parseFields(argv[1], '.', value, 3) == FALSE)
+                || (value[0] < 1) || (value[0] > 31) || (value[1] < 1) || (value[1] > 12)
+                || (value[2] < 1000) || (value[2] > 3000))
         {
-        	switch(currentSite)
-        	{
-        		case 1:
-				{
-					currentSite = 2;
-					oled_clearScreen(OLED_COLOR_BLACK);
-					break;
-				}
-        		case 2:
-				{
-        			currentSite = 1;
-        			oled_clearScreen(OLED_COLOR_BLACK);
-        			break;
-				}
-                default:
-                {
-                    break;
-                }
-        	}
+            console_print("usage: date dd.mm.yyyy\r\n");
+            return;
         }
+        setDate(value[0], value[1], value[2]);
+    }
 
-        if(currentSite == 1)
-        {
-            printData();
+    console_printPadded(rtc.DOM, 2);
+    console_print(".");
+    console_printPadded(rtc.MONTH, 2);
+    console_print(".");
+    console_printPadded(rtc.YEAR, 4);
+    console_print("\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "read" - wypisanie ostatnich odczytow
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void cmdRead(uint32_t argc, char* argv[])
+{
+    char text[FMT_MAX_LEN + 1];
+
+    fmt_fixed(text, temperature, 1, 0, ' ');
+    console_print("temp ");
+    console_print(text);
+    console_print(" C\r\npress ");
+    console_printInt(pressure);
+    console_print(" Pa\r\nqnh ");
+    console_printInt(seaLevelPressure);
+    console_print(" Pa\r\nhum ");
+    console_printInt(humidity);
+    console_print(" % at ");
+    fmt_fixed(text, humidityTemperature, 1, 0, ' ');
+    console_print(text);
+    console_print(" C\r\ndew ");
+    fmt_fixed(text, derived.dewPoint, 1, 0, ' ');
+    console_print(text);
+    console_print(" C\r\nabs ");
+    fmt_fixed(text, derived.absHumidity, 2, 0, ' ');
+    console_print(text);
+    console_print(" g/m3\r\nheat ");
+    fmt_fixed(text, derived.heatIndex, 1, 0, ' ');
+    console_print(text);
+    console_print(derived.frostRisk ? " C\r\nfrost risk\r\n" : " C\r\n");
+    console_print("light ");
+    console_printInt(light);
+    console_print(" lx\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "stats" - wypisanie licznikow diagnostycznych
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void cmdStats(uint32_t argc, char* argv[])
+{
+    const uart0_stats_t* pStats = uart0_getStats();
+
+    console_print("loops ");
+    console_printInt(loopCount);
+    console_print("\r\nloop max ms ");
+    console_printInt(loopTimeMax);
+    console_print("\r\nsample ms ");
+    console_printInt(sampleTimeLast);
+    console_print("\r\nsample max ms ");
+    console_printInt(sampleTimeMax);
+    console_print("\r\nuart tx ");
+    console_printInt(pStats->txBytes);
+    console_print(" dropped ");
+    console_printInt(pStats->txDropped);
+    console_print("\r\nuart rx ");
+    console_printInt(pStats->rxBytes);
+    console_print(" dropped ");
+    console_printInt(pStats->rxDropped);
+    console_print(" errors ");
+    console_printInt(pStats->rxErrors);
+    console_print("\r\ntelemetry dropped ");
+    console_printInt(telemetry_getDropped());
+    console_print("\r\nlog pages ");
+    console_printInt(datalog_getPageCount());
+    console_print(" records ");
+    console_printInt(datalog_getRecordCount());
+    console_print("\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "period" - zmiana okresu odczytu czujnikow lub
+ *            odswiezania ekranu. Nowa wartosc jest zapisywana w konfiguracji.
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis konfiguracji do pamieci EEPROM
+ */
+static void cmdPeriod(uint32_t argc, char* argv[])
+{
+    config_t newConfig = *config_get();
+    uint32_t value = 0;
+
+    if ((argc < 3) || (console_parseUInt(argv[2], &value) == FALSE))
+    {
+        console_print("usage: period sample|display <ms>\r\n");
+        return;
+    }
+
+    if (strcmp(argv[1], "sample") == 0)
+    {
+        newConfig.samplePeriodMs = value;
+    }
+    else if (strcmp(argv[1], "display") == 0)
+    {
+        newConfig.displayPeriodMs = value;
+    }
+    else
+    {
+        console_print("usage: period sample|display <ms>\r\n");
+        return;
+    }
+
+    if (config_validate(&newConfig) == FALSE)
+    {
+        console_print("period out of range\r\n");
+        return;
+    }
+
+    if (config_save(&newConfig) != 0)
+    {
+        console_print("config save failed\r\n");
+        return;
+    }
+
+    console_print("ok\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "stream" - wlaczenie lub wylaczenie telemetrii
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void cmdStream(uint32_t argc, char* argv[])
+{
+    if ((argc > 1) && (strcmp(argv[1], "on") == 0))
+    {
+        telemetry_setEnabled(TRUE);
+    }
+    else if ((argc > 1) && (strcmp(argv[1], "off") == 0))
+    {
+        telemetry_setEnabled(FALSE);
+    }
+    else
+    {
+        console_print("usage: stream on|off\r\n");
+        return;
+    }
+
+    console_print("ok\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "export" - wyslanie dziennika w ramkach binarnych.
+ *            Argument pozwala wznowic przerwany eksport od podanej strony.
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void cmdExport(uint32_t argc, char* argv[])
+{
+    uint32_t fromPage = 0;
+
+    if ((argc > 1) && (strcmp(argv[1], "stop") == 0))
+    {
+        export_stop();
+        return;
+    }
+
+    if ((argc > 1) && (console_parseUInt(argv[1], &fromPage) == FALSE))
+    {
+        console_print("usage: export [page]|stop\r\n");
+        return;
+    }
+
+    if (export_start(fromPage) == FALSE)
+    {
+        console_print("export busy\r\n");
+    }
+}
+
+/*!
+ *  @brief    Procedura wypisujaca adres IPv4 na konsoli
+ *  @param    ip
+ *              Adres
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void printIp(uint32_t ip)
+{
+    console_printInt((ip >> 24) & 0xFF);
+    console_print(".");
+    console_printInt((ip >> 16) & 0xFF);
+    console_print(".");
+    console_printInt((ip >> 8) & 0xFF);
+    console_print(".");
+    console_printInt(ip & 0xFF);
+}
+
+/*!
+ *  @brief    Polecenie konsoli "net" - stan interfejsu Ethernet lub zmiana
+ *            adresu stacji i odbiorcy telemetrii UDP. Zmiana adresu stacji
+ *            obowiazuje po ponownym uruchomieniu.
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis konfiguracji do pamieci EEPROM
+ */
+static void cmdNet(uint32_t argc, char* argv[])
+{
+    config_t newConfig = *config_get();
+    const net_stats_t* pStats = net_getStats();
+    uint32_t value[4];
+    uint32_t port = 0;
+
+    if (argc == 1)
+    {
+        console_print((net_isUp() == TRUE) ? "up " : "down ");
+        printIp(newConfig.netIp);
+        console_print("\r\ncollector ");
+        printIp(newConfig.collectorIp);
+        console_print(":");
+        console_printInt(newConfig.collectorPort);
+        console_print("\r\nrx ");
+        console_printInt(pStats->rxFrames);
+        console_print(" errors ");
+        console_printInt(pStats->rxErrors);
+        console_print("\r\ntx ");
+        console_printInt(pStats->txFrames);
+        console_print(" dropped ");
+        console_printInt(pStats->txDropped);
+        console_print("\r\n");
+        return;
+    }
+
+    if ((argc < 3) || (console_parseFields(argv[2], '.', value, 4) == FALSE)
+            || (value[0] > 255) || (value[1] > 255) || (value[2] > 255) || (value[3] > 255))
+    {
+        console_print("usage: net [ip|mask|gw <a.b.c.d>] [collector <a.b.c.d> <port>]\r\n");
+        return;
+    }
+
+    if (strcmp(argv[1], "ip") == 0)
+    {
+        newConfig.netIp = NET_IP(value[0], value[1], value[2], value[3]);
+    }
+    else if (strcmp(argv[1], "mask") == 0)
+    {
+        newConfig.netMask = NET_IP(value[0], value[1], value[2], value[3]);
+    }
+    else if (strcmp(argv[1], "gw") == 0)
+    {
+        newConfig.netGateway = NET_IP(value[0], value[1], value[2], value[3]);
+    }
+    else if ((strcmp(argv[1], "collector") == 0) && (argc > 3)
+            && (console_parseUInt(argv[3], &port) == TRUE) && (port <= 65535))
+    {
+        newConfig.collectorIp = NET_IP(value[0], value[1], value[2], value[3]);
+        newConfig.collectorPort = (uint16_t)port;
+    }
+    else
+    {
+        console_print("usage: net [ip|mask|gw <a.b.c.d>] [collector <a.b.c.d> <port>]\r\n");
+        return;
+    }
+
+    if (config_save(&newConfig) != 0)
+    {
+        console_print("config save failed\r\n");
+        return;
+    }
+
+    console_print("ok\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "can" - stan magistrali CAN i odczyty innych
+ *            wezlow, zmiana trybu (obowiazuje po ponownym uruchomieniu) lub
+ *            test kontrolera bez magistrali
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis konfiguracji do pamieci EEPROM
+ */
+static void cmdCan(uint32_t argc, char* argv[])
+{
+    static const char* modeNames[] = { "off", "node", "gateway" };
+    config_t newConfig = *config_get();
+    const canbus_stats_t* pStats = canbus_getStats();
+    const canbus_node_t* pNode = NULL;
+    uint32_t id = newConfig.canNodeId;
+    uint8_t i = 0;
+
+    if (argc == 1)
+    {
+        console_print(modeNames[newConfig.canMode % 3]);
+        console_print(" id ");
+        console_printInt(newConfig.canNodeId);
+        console_print("\r\ntx ");
+        console_printInt(pStats->txFrames);
+        console_print(" dropped ");
+        console_printInt(pStats->txDropped);
+        console_print("\r\nrx ");
+        console_printInt(pStats->rxFrames);
+        console_print(" overruns ");
+        console_printInt(pStats->rxOverruns);
+        console_print(" rtr ");
+        console_printInt(pStats->remoteRequests);
+        console_print("\r\n");
+
+        for (i = 0; i < CANBUS_MAX_NODES; i++)
+        {
+            pNode = canbus_getNode(i);
+            if (pNode->received == 0)
+            {
+                continue;
+            }
+            console_print("node ");
+            console_printInt(i);
+            console_print(" temp ");
+            console_printInt(pNode->temperature);
+            console_print(" press ");
+            console_printInt(pNode->pressure);
+            console_print(" hum ");
+            console_printInt(pNode->humidity);
+            if (pNode->invalid != 0)
+            {
+                console_print(" invalid ");
+                console_printInt(pNode->invalid);
+            }
+            console_print(" age ms ");
+            console_printInt(getTicks() - pNode->received);
+            console_print("\r\n");
+        }
+        return;
+    }
+
+    if (strcmp(argv[1], "test") == 0)
+    {
+        console_print((canbus_selfTest() == TRUE) ? "ok\r\n" : "fail\r\n");
+        return;
+    }
+
+    if ((strcmp(argv[1], "mode") != 0) || (argc < 3)
+            || ((argc > 3) && ((console_parseUInt(argv[3], &id) == FALSE) || (id >= CANBUS_MAX_NODES))))
+    {
+        console_print("usage: can [test] [mode off|node|gateway [id]]\r\n");
+        return;
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+        if (strcmp(argv[2], modeNames[i]) == 0)
+        {
+            break;
+        }
+    }
+    if (i == 3)
+    {
+        console_print("usage: can [test] [mode off|node|gateway [id]]\r\n");
+        return;
+    }
+
+    newConfig.canMode = i;
+    newConfig.canNodeId = (uint8_t)id;
+
+    if (config_save(&newConfig) != 0)
+    {
+        console_print("config save failed\r\n");
+        return;
+    }
+
+    console_print("ok, restart to apply\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "modbus" - liczniki portu RS485 lub zmiana
+ *            adresu urzadzenia (obowiazuje po ponownym uruchomieniu)
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis konfiguracji do pamieci EEPROM
+ */
+static void cmdModbus(uint32_t argc, char* argv[])
+{
+    config_t newConfig = *config_get();
+    const modbus_stats_t* pStats = modbus_getStats();
+    uint32_t value = 0;
+
+    if (argc == 1)
+    {
+        console_print("address ");
+        console_printInt(newConfig.modbusAddress);
+        console_print("\r\nframes ");
+        console_printInt(pStats->rxFrames);
+        console_print(" responses ");
+        console_printInt(pStats->responses);
+        console_print(" exceptions ");
+        console_printInt(pStats->exceptions);
+        console_print("\r\ncrc errors ");
+        console_printInt(pStats->crcErrors);
+        console_print(" overruns ");
+        console_printInt(pStats->overruns);
+        console_print(" config writes ");
+        console_printInt(pStats->configWrites);
+        console_print("\r\n");
+        return;
+    }
+
+    if ((strcmp(argv[1], "addr") != 0) || (argc < 3)
+            || (console_parseUInt(argv[2], &value) == FALSE) || (value > MODBUS_MAX_ADDRESS))
+    {
+        console_print("usage: modbus [addr <0-247>]\r\n");
+        return;
+    }
+
+    newConfig.modbusAddress = (uint8_t)value;
+
+    if (config_save(&newConfig) != 0)
+    {
+        console_print("config save failed\r\n");
+        return;
+    }
+
+    console_print("ok, restart to apply\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "baro" - wysokosc stacji, cisnienie
+ *            odniesienia dla wysokosci barometrycznej i tryb pomiaru
+ *            cisnienia
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis konfiguracji
+ */
+static void cmdBaro(uint32_t argc, char* argv[])
+{
+    config_t newConfig = *config_get();
+    uint32_t value = 0;
+    int32_t altitude = 0;
+
+    if (argc == 1)
+    {
+        console_print("station ");
+        console_printInt(pressure);
+        console_print(" Pa at ");
+        console_printInt(newConfig.altitude);
+        console_print(" m\r\nqnh ");
+        console_printInt(seaLevelPressure);
+        console_print(" Pa\r\naltitude ");
+        console_printInt(baro_altitude(pressure, newConfig.altitudeReference));
+        console_print(" m (ref ");
+        console_printInt(newConfig.altitudeReference);
+        console_print(" Pa)\r\noss ");
+        console_printInt(newConfig.pressureOss);
+        console_print(" avg ");
+        console_printInt(newConfig.pressureAverage);
+        console_print("\r\n");
+        return;
+    }
+
+    if ((argc == 3) && (strcmp(argv[1], "alt") == 0))
+    {
+        /* Wysokosc moze byc ujemna (depresje), zakres sprawdza config_validate */
+        if ((console_parseInt(argv[2], &altitude) == FALSE) || (altitude != (int16_t)altitude))
+        {
+            console_print("altitude out of range\r\n");
+            return;
+        }
+        newConfig.altitude = (int16_t)altitude;
+        if (config_validate(&newConfig) == FALSE)
+        {
+            console_print("altitude out of range\r\n");
+            return;
+        }
+    }
+    else if ((argc == 3) && (strcmp(argv[1], "ref") == 0)
+            && (console_parseUInt(argv[2], &value) == TRUE)
+            && (value >= 30000) && (value <= 110000))
+    {
+        newConfig.altitudeReference = (int32_t)value;
+    }
+    else if ((argc == 3) && (strcmp(argv[1], "oss") == 0)
+            && (console_parseUInt(argv[2], &value) == TRUE) && (value <= BMP180_OSS_ULTRA_HIGH_RES)
+            && (bmp180_setMode((uint8_t)value, newConfig.pressureAverage) == TRUE))
+    {
+        newConfig.pressureOss = (uint8_t)value;
+    }
+    else if ((argc == 3) && (strcmp(argv[1], "avg") == 0)
+            && (console_parseUInt(argv[2], &value) == TRUE) && (value <= BMP180_AVERAGE_MAX)
+            && (bmp180_setMode(newConfig.pressureOss, (uint8_t)value) == TRUE))
+    {
+        newConfig.pressureAverage = (uint8_t)value;
+    }
+    else
+    {
+        console_print("usage: baro [alt <m>|ref <Pa>|oss <0-3>|avg <1-8>]\r\n");
+        return;
+    }
+
+    if (config_save(&newConfig) != 0)
+    {
+        console_print("config save failed\r\n");
+        return;
+    }
+
+    console_print("ok\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "alarm" - lista i zmiana regul alarmow.
+ *            Akcje podaje sie literami: s - 7seg, l - diody, r - RGB,
+ *            u - UART, np. "slu".
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana regul alarmow
+ */
+static void cmdAlarm(uint32_t argc, char* argv[])
+{
+    static const char actionLetters[] = "slru";
+    const alarm_rule_t* pRule = NULL;
+    alarm_rule_t rule;
+    uint32_t index = 0;
+    uint32_t value = 0;
+    uint32_t i = 0;
+    uint8_t metric = METRIC_NONE;
+    const char* p = NULL;
+
+    if (argc == 1)
+    {
+        for (i = 0; i < ALARM_MAX_RULES; i++)
+        {
+            pRule = alarm_getRule((uint8_t)i);
+            console_printInt(i);
+            console_print(" ");
+            console_print(metric_getName(pRule->metric));
+            if (pRule->metric != METRIC_NONE)
+            {
+                console_print((pRule->direction == ALARM_ABOVE) ? " above " : " below ");
+                console_printInt(pRule->threshold);
+                console_print(" hyst ");
+                console_printInt(pRule->hysteresis);
+                console_print(" hold ");
+                console_printInt(pRule->holdS);
+                console_print(" act ");
+                for (p = actionLetters; *p != '\0'; p++)
+                {
+                    buf[0] = ((pRule->actions & (1 << (p - actionLetters))) != 0) ? *p : '-';
+                    buf[1] = '\0';
+                    console_print(buf);
+                }
+                buf[0] = pRule->code;
+                console_print(" code ");
+                console_print(buf);
+                console_print(alarm_isActive((uint8_t)i) ? " ACTIVE" : "");
+            }
+            console_print("\r\n");
+        }
+        return;
+    }
+
+    if ((argc == 2) && (strcmp(argv[1], "reset") == 0))
+    {
+        alarm_loadDefaults();
+        console_print("ok\r\n");
+        return;
+    }
+
+    if ((console_parseUInt(argv[1], &index) == FALSE) || (index >= ALARM_MAX_RULES))
+    {
+        console_print("usage: alarm [reset|<n> off|<n> <metric> above|below <thr> [hyst] [hold] [act]]\r\n");
+        return;
+    }
+
+    rule = *alarm_getRule((uint8_t)index);
+
+    if ((argc == 3) && (strcmp(argv[2], "off") == 0))
+    {
+        rule.metric = METRIC_NONE;
+        alarm_setRule((uint8_t)index, &rule);
+        console_print("ok\r\n");
+        return;
+    }
+
+    if (argc < 5)
+    {
+        console_print("usage: alarm <n> temp|press|hum|dew|heat above|below <thr> [hyst] [hold] [act]\r\n");
+        return;
+    }
+
+    if (metric_parseName(argv[2], &metric) == FALSE)
+    {
+        console_print("unknown metric\r\n");
+        return;
+    }
+    if (rule.metric == METRIC_NONE)
+    {
+        rule.actions = ALARM_ACT_7SEG | ALARM_ACT_UART;
+    }
+    rule.metric = metric;
+
+    if (strcmp(argv[3], "above") == 0)
+    {
+        rule.direction = ALARM_ABOVE;
+    }
+    else if (strcmp(argv[3], "below") == 0)
+    {
+        rule.direction = ALARM_BELOW;
+    }
+    else
+    {
+        console_print("direction must be above or below\r\n");
+        return;
+    }
+
+    if ((console_parseInt(argv[4], &rule.threshold) == FALSE)
+            || ((argc > 5) && ((console_parseUInt(argv[5], &value) == FALSE) || (value > 0xFFFF))))
+    {
+        console_print("bad threshold or hysteresis\r\n");
+        return;
+    }
+    if (argc > 5)
+    {
+        rule.hysteresis = (uint16_t)value;
+    }
+
+    if (argc > 6)
+    {
+        if ((console_parseUInt(argv[6], &value) == FALSE) || (value > 0xFFFF))
+        {
+            console_print("bad hold time\r\n");
+            return;
+        }
+        rule.holdS = (uint16_t)value;
+    }
+
+    if (argc > 7)
+    {
+        rule.actions = 0;
+        for (p = argv[7]; *p != '\0'; p++)
+        {
+            for (i = 0; actionLetters[i] != '\0'; i++)
+            {
+                if (*p == actionLetters[i])
+                {
+                    rule.actions |= (uint8_t)(1 << i);
+                }
+            }
+        }
+    }
+
+    alarm_setRule((uint8_t)index, &rule);
+    console_print("ok\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "range" - minimum, maksimum i srednia
+ *            wszystkich wielkosci z ostatniej godziny
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void cmdRange(uint32_t argc, char* argv[])
+{
+    window_result_t result;
+    uint8_t metric = 0;
+
+    for (metric = METRIC_NONE + 1; metric < METRIC_COUNT; metric++)
+    {
+        window_getMetric(metric, &result);
+        console_print(metric_getName(metric));
+        if (result.count == 0)
+        {
+            console_print(" -\r\n");
+            continue;
+        }
+        console_print(" min ");
+        console_printInt(result.min);
+        console_print(" max ");
+        console_printInt(result.max);
+        console_print(" mean ");
+        console_printInt(result.mean);
+        console_print(" (");
+        console_printInt(result.count);
+        console_print(" x ");
+        console_printInt(WINDOW_INTERVAL_MS / 1000);
+        console_print(" s)\r\n");
+    }
+}
+
+/*!
+ *  @brief    Procedura wypisujaca ustawienia filtru czujnika
+ *  @param    sensor
+ *              FILTER_xxx
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void printFilter(uint8_t sensor)
+{
+    const filter_config_t* pFilter = filter_getConfig(sensor);
+
+    console_print(metric_getName((uint8_t)(METRIC_TEMPERATURE + sensor)));
+    console_print(" median ");
+    console_printInt(pFilter->median);
+    switch (pFilter->smoother)
+    {
+        case FILTER_SMOOTH_EMA:
+        {
+            console_print(" ema ");
+            console_printInt(pFilter->shift);
+            break;
+        }
+        case FILTER_SMOOTH_KALMAN:
+        {
+            console_print(" kalman ");
+            console_printInt(pFilter->processNoise);
+            console_print(" ");
+            console_printInt(pFilter->measurementNoise);
+            break;
+        }
+        default:
+        {
+            console_print(" off");
+            break;
+        }
+    }
+    console_print(" rejected ");
+    console_printInt(filter_getRejected(sensor));
+    console_print("\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "filter" - ustawienia filtrow odczytow
+ *            temperatury, cisnienia i wilgotnosci. Nowe ustawienia sa
+ *            zapisywane w konfiguracji.
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis konfiguracji do pamieci EEPROM
+ */
+static void cmdFilter(uint32_t argc, char* argv[])
+{
+    config_t newConfig = *config_get();
+    filter_config_t* pFilter = NULL;
+    uint8_t metric = 0;
+    uint8_t sensor = 0;
+    uint32_t value = 0;
+    uint32_t noise = 0;
+    Bool ok = FALSE;
+
+    if (argc == 1)
+    {
+        for (sensor = 0; sensor < FILTER_SENSORS; sensor++)
+        {
+            printFilter(sensor);
+        }
+        return;
+    }
+
+    if ((argc >= 3) && (metric_parseName(argv[1], &metric) == TRUE)
+            && (metric >= METRIC_TEMPERATURE) && (metric < (METRIC_TEMPERATURE + FILTER_SENSORS)))
+    {
+        sensor = (uint8_t)(metric - METRIC_TEMPERATURE);
+        pFilter = &newConfig.filters[sensor];
+
+        if ((argc == 4) && (strcmp(argv[2], "median") == 0)
+                && (console_parseUInt(argv[3], &value) == TRUE) && (value <= FILTER_MEDIAN_MAX))
+        {
+            pFilter->median = (uint8_t)value;
+            ok = TRUE;
+        }
+        else if ((argc == 3) && (strcmp(argv[2], "off") == 0))
+        {
+            pFilter->smoother = FILTER_SMOOTH_NONE;
+            ok = TRUE;
+        }
+        else if ((argc == 4) && (strcmp(argv[2], "ema") == 0)
+                && (console_parseUInt(argv[3], &value) == TRUE) && (value <= 7))
+        {
+            pFilter->smoother = FILTER_SMOOTH_EMA;
+            pFilter->shift = (uint8_t)value;
+            ok = TRUE;
+        }
+        else if ((argc == 5) && (strcmp(argv[2], "kalman") == 0)
+                && (console_parseUInt(argv[3], &value) == TRUE) && (value <= 0xFFFF)
+                && (console_parseUInt(argv[4], &noise) == TRUE) && (noise <= 0xFFFF))
+        {
+            pFilter->smoother = FILTER_SMOOTH_KALMAN;
+            pFilter->processNoise = (uint16_t)value;
+            pFilter->measurementNoise = (uint16_t)noise;
+            ok = TRUE;
+        }
+    }
+
+    /* Poprawnosc ustawien sprawdza filtr */
+    if ((ok == FALSE) || (filter_configure(sensor, pFilter) == FALSE))
+    {
+        console_print("usage: filter [temp|press|hum median 1|3|5|off|ema <shift>|kalman <q> <r>]\r\n");
+        return;
+    }
+
+    if (config_save(&newConfig) != 0)
+    {
+        console_print("config save failed\r\n");
+        return;
+    }
+
+    printFilter(sensor);
+}
+
+/*!
+ *  @brief    Polecenie konsoli "forecast" - tendencja cisnienia i prognoza
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void cmdForecast(uint32_t argc, char* argv[])
+{
+    const forecast_t* pForecast = forecast_get();
+    char text[FMT_MAX_LEN + 1];
+
+    console_print("history ");
+    console_printInt(pForecast->slots);
+    console_print("/");
+    console_printInt(FORECAST_SLOTS);
+    console_print(" pressure ");
+    console_printInt(pForecast->pressure);
+    console_print(" Pa\r\nchange ");
+    fmt_fixed(text, pForecast->change / 10, 1, 0, ' ');
+    console_print(text);
+    console_print(" hPa/3h\r\nforecast ");
+
+    if (pForecast->code == 0)
+    {
+        console_print("-\r\n");
+        return;
+    }
+
+    text[0] = pForecast->code;
+    text[1] = '\0';
+    console_print(text);
+    console_print(" ");
+    console_print(forecast_getText(pForecast->code));
+    console_print("\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "htu" - rozdzielczosc czujnika wilgotnosci i
+ *            liczniki bledow. Nowa rozdzielczosc jest zapisywana w
+ *            konfiguracji.
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis rejestru czujnika i konfiguracji
+ */
+static void cmdHtu(uint32_t argc, char* argv[])
+{
+    config_t newConfig = *config_get();
+    const htu21d_stats_t* pStats = htu21d_getStats();
+    uint32_t value = 0;
+
+    if (argc == 1)
+    {
+        console_print("res ");
+        console_printInt(newConfig.humidityResolution);
+        console_print("\r\ncrc errors ");
+        console_printInt(pStats->crcErrors);
+        console_print("\r\ntimeouts ");
+        console_printInt(pStats->timeouts);
+        console_print("\r\nbus errors ");
+        console_printInt(pStats->busErrors);
+        console_print("\r\n");
+        return;
+    }
+
+    if ((argc != 3) || (strcmp(argv[1], "res") != 0)
+            || (console_parseUInt(argv[2], &value) == FALSE) || (value > HTU21D_RES_RH11_T11))
+    {
+        console_print("usage: htu [res <0-3>]\r\n");
+        return;
+    }
+
+    if (htu21d_setResolution((uint8_t)value) == FALSE)
+    {
+        console_print("sensor error\r\n");
+        return;
+    }
+
+    newConfig.humidityResolution = (uint8_t)value;
+    if (config_save(&newConfig) != 0)
+    {
+        console_print("config save failed\r\n");
+        return;
+    }
+
+    console_print("ok\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "sensors" - ostatnie odczyty wszystkich
+ *            zarejestrowanych czujnikow we wspolnej skali
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void cmdSensors(uint32_t argc, char* argv[])
+{
+    static const char* const statusNames[] = { "none", "ok", "held", "error" };
+    char text[FMT_MAX_LEN + 1];
+    const sensor_ops_t* pOps = NULL;
+    const sensor_sample_t* pSample = NULL;
+    uint32_t i = 0;
+
+    for (i = 0; i < sensor_getCount(); i++)
+    {
+        pOps = sensor_getOps(i);
+        pSample = sensor_getSample(i);
+
+        fmt_fixed(text, pSample->value, 3, 0, ' ');
+        console_print(pOps->pName);
+        console_print(" ");
+        console_print(text);
+        console_print(" ");
+        console_print(pOps->pUnit);
+        console_print(" ");
+        console_print(statusNames[pSample->status]);
+        console_print(" at ");
+        console_printInt(pSample->time);
+        console_print(" ms\r\n");
+    }
+}
+
+/*!
+ *  @brief    Polecenie konsoli "light" - stan czujnika natezenia swiatla,
+ *            prog przerwania i przyciemnianie ekranu
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis konfiguracji
+ */
+static void cmdLight(uint32_t argc, char* argv[])
+{
+    config_t newConfig = *config_get();
+    const ambient_stats_t* pStats = ambient_getStats();
+    uint32_t value = 0;
+
+    if (argc == 1)
+    {
+        console_print("light ");
+        console_printInt(ambient_getLux());
+        console_print(" lx of ");
+        console_printInt(ambient_getFullScale());
+        console_print("\r\nth ");
+        console_printInt(ambient_getThreshold());
+        console_print(" %\r\ndim ");
+        console_print((newConfig.displayDimming != 0) ? "on" : "off");
+        console_print("\r\nreads ");
+        console_printInt(pStats->reads);
+        console_print("\r\nskipped ");
+        console_printInt(pStats->skipped);
+        console_print("\r\ninterrupts ");
+        console_printInt(pStats->interrupts);
+        console_print("\r\nrange changes ");
+        console_printInt(pStats->rangeChanges);
+        console_print("\r\nbus errors ");
+        console_printInt(pStats->busErrors);
+        console_print("\r\n");
+        return;
+    }
+
+    if ((argc == 3) && (strcmp(argv[1], "th") == 0)
+            && (console_parseUInt(argv[2], &value) == TRUE) && (value <= AMBIENT_THRESHOLD_MAX))
+    {
+        ambient_setThreshold((uint8_t)value);
+        newConfig.lightThreshold = (uint8_t)value;
+    }
+    else if ((argc == 3) && (strcmp(argv[1], "dim") == 0)
+            && ((strcmp(argv[2], "on") == 0) || (strcmp(argv[2], "off") == 0)))
+    {
+        newConfig.displayDimming = (strcmp(argv[2], "on") == 0) ? 1 : 0;
+    }
+    else
+    {
+        console_print("usage: light [th <0-100>|dim on|off]\r\n");
+        return;
+    }
+
+    if (config_save(&newConfig) != 0)
+    {
+        console_print("config save failed\r\n");
+        return;
+    }
+
+    console_print("ok\r\n");
+}
+
+/*!
+ *  @brief    Polecenie konsoli "vib" - ostatnie zdarzenie drgan, progi
+ *            monitora i ponowny pomiar polozenia spoczynkowego
+ *  @param    argc
+ *              Liczba argumentow
+ *  @param    argv
+ *              Argumenty
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis konfiguracji
+ */
+static void cmdVib(uint32_t argc, char* argv[])
+{
+    config_t newConfig = *config_get();
+    const vibration_result_t* pLast = vibration_getLast();
+    const vibration_stats_t* pStats = vibration_getStats();
+    uint32_t value = 0;
+
+    if (argc == 1)
+    {
+        console_print("level ");
+        console_printInt(newConfig.vibrationLevel);
+        console_print("/16 g\r\npeak ");
+        console_printInt(newConfig.tamperPeak);
+        console_print(" mg\r\n");
+        if (pLast != NULL)
+        {
+            console_print("last rms ");
+            console_printInt(pLast->rms);
+            console_print(" mg peak ");
+            console_printInt(pLast->peak);
+            console_print(" mg tilt ");
+            console_printInt(pLast->tilt);
+            console_print(" mg axes ");
+            console_print(((pLast->axes & ACC_DETECT_X) != 0) ? "x" : "");
+            console_print(((pLast->axes & ACC_DETECT_Y) != 0) ? "y" : "");
+            console_print(((pLast->axes & ACC_DETECT_Z) != 0) ? "z" : "");
+            console_print(pLast->tamper ? " tamper at " : " at ");
+            console_printInt(pLast->time);
+            console_print(" ms\r\n");
+        }
+        console_print("detections ");
+        console_printInt(pStats->detections);
+        console_print("\r\nwindows ");
+        console_printInt(pStats->windows);
+        console_print("\r\ntamper ");
+        console_printInt(pStats->tamperEvents);
+        console_print("\r\nbus errors ");
+        console_printInt(pStats->busErrors);
+        console_print("\r\n");
+        return;
+    }
+
+    if ((argc == 2) && (strcmp(argv[1], "rest") == 0))
+    {
+        vibration_setRest();
+        console_print("ok\r\n");
+        return;
+    }
+
+    if ((argc == 3) && (strcmp(argv[1], "level") == 0)
+            && (console_parseUInt(argv[2], &value) == TRUE) && (value <= VIBRATION_LEVEL_MAX))
+    {
+        newConfig.vibrationLevel = (uint8_t)value;
+    }
+    else if ((argc == 3) && (strcmp(argv[1], "peak") == 0)
+            && (console_parseUInt(argv[2], &value) == TRUE) && (value <= 0xFFFF))
+    {
+        newConfig.tamperPeak = (uint16_t)value;
+    }
+    else
+    {
+        console_print("usage: vib [rest|level <0-127>|peak <mg>]\r\n");
+        return;
+    }
+
+    vibration_configure(newConfig.vibrationLevel, newConfig.tamperPeak);
+    if (config_save(&newConfig) != 0)
+    {
+        console_print("config save failed\r\n");
+        return;
+    }
+
+    console_print("ok\r\n");
+}
+
+/* Tablica polecen konsoli szeregowej */
+static const console_cmd_t commands[] =
+{
+    { "time",   "time [hh:mm:ss]",                cmdTime },
+    { "date",   "date [dd.mm.yyyy]",              cmdDate },
+    { "read",   "current readings",               cmdRead },
+    { "stats",  "profiling counters",             cmdStats },
+    { "period", "period sample|display <ms>",     cmdPeriod },
+    { "stream", "stream on|off - telemetry",      cmdStream },
+    { "export", "export [page]|stop - log dump",  cmdExport },
+    { "net",    "net [ip|mask|gw|collector ...]", cmdNet },
+    { "can",    "can [test] [mode <m> [id]]",     cmdCan },
+    { "modbus", "modbus [addr <0-247>]",          cmdModbus },
+    { "forecast", "pressure trend and forecast",  cmdForecast },
+    { "baro",   "baro [alt|ref|oss|avg <n>]",     cmdBaro },
+    { "alarm",  "alarm [reset|<n> off|<n> ...]",  cmdAlarm },
+    { "range",  "last hour min/max/mean",         cmdRange },
+    { "filter", "filter [<sensor> median|ema|kalman]", cmdFilter },
+    { "htu",    "htu [res <0-3>] - humidity sensor", cmdHtu },
+    { "sensors", "last sample of every sensor",   cmdSensors },
+    { "light",  "light [th <0-100>|dim on|off]",  cmdLight },
+    { "vib",    "vib [rest|level <0-127>|peak <mg>]", cmdVib }
+};
+
+int main (void)
+{
+    int16_t currentSite = 1;
+    uint32_t lastSample = 0;
+    uint32_t lastDisplay = 0;
+    uint32_t lastLog = 0;
+    datalog_record_t record;
+    int32_t metricValues[METRIC_COUNT];
+
+    init_i2c();
+    spibus_init();
+    oled_init();
+    joystick_init();
+    eeprom_init();
+    initRtc();
+    config_init();
+    datalog_init();
+    telemetry_init();
+    export_init();
+    net_init();
+    http_init();
+    canbus_init();
+    modbus_init();
+    bmp180_init();
+    htu21d_init();
+    ambient_init();
+    vibration_init();
+    filter_init();
+    forecast_init();
+    alarm_init();
+    window_reset();
+    console_init(commands, sizeof(commands) / sizeof(commands[0]));
+
+	led7seg_init();
+
+    temp_init (&getTicks);
+
+    /* Kolejnosc zgodna z SENSOR_ID_xxx */
+    sensor_register(&tempSensor, FILTER_TEMPERATURE);
+    sensor_register(&bmp180_sensor, FILTER_PRESSURE);
+    sensor_register(&htu21d_sensor, FILTER_HUMIDITY);
+    sensor_register(&ambient_sensor, SENSOR_NO_FILTER);
+
+    if (SysTick_Config(SystemCoreClock / 1000))
+    {
+        while (1) { }
+	}
+
+    oled_clearScreen(OLED_COLOR_BLACK);
+
+    uint8_t leftButton = ((GPIO_ReadValue(0) >> 4) & 0x01);
+
+    currentSite = config_get()->startScreen;
+    lastSample = getTicks() - config_get()->samplePeriodMs;
+    lastDisplay = getTicks() - config_get()->displayPeriodMs;
+    lastLog = getTicks();
+
+    while(1)
+    {
+        uint32_t loopStart = getTicks();
+
+        vibration_process(loopStart);
+
+        if ((getTicks() - lastSample) >= config_get()->samplePeriodMs)
+        {
+            lastSample = getTicks();
+            sensor_startCycle(lastSample);
+        }
+
+        /* Pomiary trwaja w kolejnych obiegach petli, wynik po zakonczeniu wszystkich */
+        if (sensor_poll(getTicks()) == TRUE)
+        {
+            updateReadings();
+            updateContrast();
+            seaLevelPressure = baro_seaLevel(pressure, config_get()->altitude);
+            derived_compute(temperature, humidity, &derived);
+
+            metricValues[METRIC_NONE] = 0;
+            metricValues[METRIC_TEMPERATURE] = temperature;
+            metricValues[METRIC_PRESSURE] = seaLevelPressure;
+            metricValues[METRIC_HUMIDITY] = humidity;
+            metricValues[METRIC_DEW_POINT] = derived.dewPoint;
+            metricValues[METRIC_HEAT_INDEX] = derived.heatIndex;
+            metricValues[METRIC_LIGHT] = light;
+            metricValues[METRIC_VIBRATION] = vibration_getPeak(lastSample);
+            alarm_evaluate(lastSample, metricValues, invalidMetrics);
+            window_addSample(lastSample, metricValues, invalidMetrics);
+
+            sampleTimeLast = getTicks() - lastSample;
+            if (sampleTimeLast > sampleTimeMax)
+            {
+                sampleTimeMax = sampleTimeLast;
+            }
+
+            if (export_isActive() == FALSE)
+            {
+                telemetry_sendSample(lastSample, temperature, pressure, humidity, &derived, invalidMetrics);
+            }
+            telemetry_sendSampleUdp(lastSample, temperature, pressure, humidity, &derived, invalidMetrics);
+            canbus_publish(temperature, pressure, humidity, invalidMetrics);
+            modbus_setSample(temperature, pressure, humidity, invalidMetrics);
+
+            if ((invalidMetrics & METRIC_BIT(METRIC_PRESSURE)) == 0)
+            {
+                forecast_addSample(lastSample, seaLevelPressure);
+            }
+
+            RTC_GetFullTime(LPC_RTC, &rtc);
+            http_setSample(datalog_rtcToTime(&rtc), temperature, pressure, humidity, invalidMetrics);
+        }
+
+        if ((config_get()->logPeriodS != 0)
+                && ((getTicks() - lastLog) >= (config_get()->logPeriodS * 1000)))
+        {
+            lastLog = getTicks();
+
+            RTC_GetFullTime(LPC_RTC, &rtc);
+            memset(&record, 0, sizeof(record));
+            record.time = datalog_rtcToTime(&rtc);
+            record.pressure = pressure;
+            record.temperature = (int16_t)temperature;
+            record.humidity = humidity;
+            record.dewPoint = derived.dewPoint;
+            record.absHumidity = derived.absHumidity;
+            record.light = (uint16_t)light;
+            record.invalid = invalidMetrics;
+            datalog_append(&record);
+        }
+
+        console_poll();
+        export_poll();
+        net_poll(getTicks());
+        http_poll(getTicks());
+        canbus_poll(getTicks());
+        modbus_poll();
+
+        /*
+         * Ekran jest odswiezany co displayPeriodMs, w pozostalym czasie petla
+         * obsluguje konsole i eksport dziennika.
+         */
+        if ((getTicks() - lastDisplay) >= config_get()->displayPeriodMs)
+        {
+            lastDisplay = getTicks();
+
+            led7seg_setChar(getDisplayChar(), FALSE);
+
+            leftButton = ((GPIO_ReadValue(0) >> 4) & 0x01);
+
+            if(leftButton == 0)
+            {
+                switch(currentSite)
+                {
+                    case 1:
+                    {
+                        currentSite = 2;
+                        oled_clearScreen(OLED_COLOR_BLACK);
+                        break;
+                    }
+                    case 2:
+                    {
+                        currentSite = 3;
+                        oled_clearScreen(OLED_COLOR_BLACK);
+                        break;
+                    }
+                    case 3:
+                    {
+                        currentSite = 1;
+                        oled_clearScreen(OLED_COLOR_BLACK);
+                        break;
+                    }
+                    default:
+                    {
+                        break;
+                    }
+                }
+            }
+
+            if(currentSite == 1)
+            {
+                printData();
+            }
+
+            if(currentSite == 2)
+            {
+                printTime();
+            }
+
+            if(currentSite == 3)
+            {
+                printWindow();
+            }
+
+            /* Koniec serii zapisow do OLED, zwolnienie linii CS */
+            spibus_flush();
         }
 
-        if(currentSite == 2)
+        loopCount++;
+        if ((getTicks() - loopStart) > loopTimeMax)
         {
-    		printTime();
+            loopTimeMax = getTicks() - loopStart;
         }
 
-        Timer0_Wait(200);
+        /* Uspienie do nastepnego przerwania (SysTick co 1 ms, UART, GPDMA) */
+        __WFI();
     }
 
 }
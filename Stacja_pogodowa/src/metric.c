@@ -0,0 +1,53 @@
+#include <string.h>
+
+#include "metric.h"
+
+/* Nazwy wielkosci uzywane w konsoli */
+static const char* const names[METRIC_COUNT] =
+{
+    "none", "temp", "press", "hum", "dew", "heat", "light", "vib"
+};
+
+/*!
+ *  @brief    Funkcja zwracajaca nazwe wielkosci
+ *  @param    metric
+ *              METRIC_xxx
+ *  @returns  Nazwa, NULL dla niepoprawnej wielkosci
+ *  @side_effects:
+ *            Brak
+ */
+const char* metric_getName(uint8_t metric)
+{
+    if (metric >= METRIC_COUNT)
+    {
+        return NULL;
+    }
+
+    return names[metric];
+}
+
+/*!
+ *  @brief    Funkcja wyszukujaca wielkosc po nazwie
+ *  @param    pName
+ *              Nazwa
+ *  @param    pMetric
+ *              Wynik METRIC_xxx
+ *  @returns  TRUE jesli nazwa jest znana (poza "none")
+ *  @side_effects:
+ *            Brak
+ */
+Bool metric_parseName(const char* pName, uint8_t* pMetric)
+{
+    uint8_t i = 0;
+
+    for (i = METRIC_NONE + 1; i < METRIC_COUNT; i++)
+    {
+        if (strcmp(pName, names[i]) == 0)
+        {
+            *pMetric = i;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
@@ -0,0 +1,26 @@
+#ifndef METRIC_H_
+#define METRIC_H_
+
+#include "lpc_types.h"
+
+/*
+ * Wielkosci mierzone i wyznaczane przez stacje. Numery sa indeksami tablicy
+ * wartosci jednego odczytu, przekazywanej do alarmow i statystyk.
+ */
+#define METRIC_NONE        0
+#define METRIC_TEMPERATURE 1   /* [0.1 C] */
+#define METRIC_PRESSURE    2   /* Cisnienie zredukowane do poziomu morza [Pa] */
+#define METRIC_HUMIDITY    3   /* [%] */
+#define METRIC_DEW_POINT   4   /* [0.1 C] */
+#define METRIC_HEAT_INDEX  5   /* [0.1 C] */
+#define METRIC_LIGHT       6   /* Natezenie swiatla [lx] */
+#define METRIC_VIBRATION   7   /* Szczyt ostatniego zdarzenia drgan [mg] */
+#define METRIC_COUNT       8
+
+/* Bit wielkosci w masce wielkosci (np. bez poprawnej wartosci w odczycie) */
+#define METRIC_BIT(metric) ((uint8_t)(1U << (metric)))
+
+const char* metric_getName(uint8_t metric);
+Bool metric_parseName(const char* pName, uint8_t* pMetric);
+
+#endif /* METRIC_H_ */
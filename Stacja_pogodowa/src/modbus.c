@@ -0,0 +1,682 @@
+#include <string.h>
+
+#include "lpc17xx_pinsel.h"
+#include "lpc17xx_timer.h"
+#include "lpc17xx_uart.h"
+
+#include "modbus.h"
+#include "config.h"
+#include "crc.h"
+#include "metric.h"
+
+#define UARTDEV ((LPC_UART_TypeDef *)LPC_UART1)
+
+#define MODBUS_FIFO_SIZE  16
+#define MODBUS_FRAME_SIZE 256
+
+/*
+ * Czas znaku (11 bitow z parzystoscia) i przerwa t3.5 konczaca ramke [us].
+ * Powyzej 19200 bit/s norma przewiduje stala wartosc 1750 us.
+ */
+#define MODBUS_CHAR_US (11UL * 1000000UL / MODBUS_BAUD_RATE)
+#define MODBUS_T35_US  ((MODBUS_BAUD_RATE > 19200) ? 1750UL : (35UL * MODBUS_CHAR_US / 10UL))
+
+/* Kody funkcji */
+#define MODBUS_FC_READ_HOLDING    0x03
+#define MODBUS_FC_READ_INPUT      0x04
+#define MODBUS_FC_WRITE_SINGLE    0x06
+#define MODBUS_FC_WRITE_MULTIPLE  0x10
+
+/* Kody wyjatkow */
+#define MODBUS_EX_ILLEGAL_FUNCTION 0x01
+#define MODBUS_EX_ILLEGAL_ADDRESS  0x02
+#define MODBUS_EX_ILLEGAL_VALUE    0x03
+
+/* Limity liczby rejestrow w jednym zapytaniu wg normy */
+#define MODBUS_MAX_READ  125
+#define MODBUS_MAX_WRITE 123
+
+/* Stany toru transmisji */
+#define STATE_RX    0   /* Odbior ramki, kazdy bajt restartuje odliczanie t3.5 */
+#define STATE_TX    1   /* Nadawanie odpowiedzi z przerwania THRE */
+#define STATE_DRAIN 2   /* Ostatni znak w rejestrze przesuwnym, potem przerwa t3.5 */
+
+/*
+ * Bufory ramek sa obslugiwane wylacznie w przerwaniach UART1 i TIMER1 o tym
+ * samym priorytecie, wiec nie wywlaszczaja sie nawzajem.
+ */
+static uint8_t rxBuf[MODBUS_FRAME_SIZE];
+static uint32_t rxLen = 0;
+static Bool rxOverrun = FALSE;
+static uint8_t txBuf[MODBUS_FRAME_SIZE];
+static uint32_t txLen = 0;
+static uint32_t txPos = 0;
+static uint8_t state = STATE_RX;
+
+static uint8_t address = 0;
+
+/*
+ * Migawka ostatniego odczytu, aktualizowana przy wylaczonym przerwaniu
+ * TIMER1. Przed pierwszym odczytem wszystkie wielkosci sa niepoprawne.
+ */
+static int16_t sampleTemperature = (int16_t)MODBUS_INVALID_VALUE;
+static int32_t samplePressure = (int32_t)((uint32_t)MODBUS_INVALID_VALUE << 16);
+static uint16_t sampleHumidity = MODBUS_INVALID_VALUE;
+static uint16_t sampleSequence = 0;
+static uint8_t sampleInvalid = METRIC_BIT(METRIC_TEMPERATURE) | METRIC_BIT(METRIC_PRESSURE)
+        | METRIC_BIT(METRIC_HUMIDITY);
+
+/* Kopia robocza konfiguracji zmieniona przez zapis rejestrow, czeka na utrwalenie */
+static config_t staged;
+static volatile Bool stagedPending = FALSE;
+
+static modbus_stats_t stats;
+
+/*!
+ *  @brief    Procedura uruchamiajaca od zera odliczanie przerwy na magistrali
+ *  @param    us
+ *              Czas do przerwania [us]
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana rejestrow TIMER1
+ */
+static void startTimer(uint32_t us)
+{
+    TIM_Cmd(LPC_TIM1, DISABLE);
+    TIM_ResetCounter(LPC_TIM1);
+    TIM_UpdateMatchValue(LPC_TIM1, 0, us);
+    TIM_Cmd(LPC_TIM1, ENABLE);
+}
+
+/*!
+ *  @brief    Procedura przepisujaca odpowiedz do kolejki FIFO nadajnika. Po
+ *            przekazaniu ostatniego bajtu czeka jeszcze na wyslanie znaku z
+ *            rejestru przesuwnego i przerwe t3.5 przed ponownym odbiorem.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana stanu toru transmisji
+ */
+static void fillTxFifo(void)
+{
+    uint32_t count = 0;
+
+    while ((txPos < txLen) && (count < MODBUS_FIFO_SIZE))
+    {
+        UARTDEV->THR = txBuf[txPos];
+        txPos++;
+        count++;
+    }
+
+    if ((count == 0) && (txPos >= txLen))
+    {
+        UART_IntConfig(UARTDEV, UART_INTCFG_THRE, DISABLE);
+        state = STATE_DRAIN;
+        startTimer(MODBUS_CHAR_US + MODBUS_T35_US);
+    }
+}
+
+/*!
+ *  @brief    Funkcja odczytujaca rejestr wejsciowy z migawki odczytu
+ *  @param    reg
+ *              Adres rejestru
+ *  @returns  Wartosc rejestru
+ *  @side_effects:
+ *            Brak
+ */
+static uint16_t readInput(uint16_t reg)
+{
+    switch (reg)
+    {
+    case MODBUS_IR_TEMPERATURE:
+        return (uint16_t)sampleTemperature;
+    case MODBUS_IR_PRESSURE:
+        return (uint16_t)((uint32_t)samplePressure >> 16);
+    case MODBUS_IR_PRESSURE + 1:
+        return (uint16_t)samplePressure;
+    case MODBUS_IR_HUMIDITY:
+        return sampleHumidity;
+    case MODBUS_IR_SEQUENCE:
+        return sampleSequence;
+    case MODBUS_IR_INVALID:
+        return sampleInvalid;
+    default:
+        return 0;
+    }
+}
+
+/*!
+ *  @brief    Funkcja odczytujaca rejestr podtrzymujacy z konfiguracji
+ *  @param    pConfig
+ *              Konfiguracja
+ *  @param    reg
+ *              Adres rejestru
+ *  @returns  Wartosc rejestru
+ *  @side_effects:
+ *            Brak
+ */
+static uint16_t readHolding(const config_t* pConfig, uint16_t reg)
+{
+    switch (reg)
+    {
+    case MODBUS_HR_SAMPLE_PERIOD:
+        return (uint16_t)(pConfig->samplePeriodMs >> 16);
+    case MODBUS_HR_SAMPLE_PERIOD + 1:
+        return (uint16_t)pConfig->samplePeriodMs;
+    case MODBUS_HR_DISPLAY_PERIOD:
+        return (uint16_t)(pConfig->displayPeriodMs >> 16);
+    case MODBUS_HR_DISPLAY_PERIOD + 1:
+        return (uint16_t)pConfig->displayPeriodMs;
+    case MODBUS_HR_ALTITUDE:
+        return (uint16_t)pConfig->altitude;
+    case MODBUS_HR_TEMP_ALARM_HIGH:
+        return (uint16_t)pConfig->tempAlarmHigh;
+    case MODBUS_HR_TEMP_ALARM_LOW:
+        return (uint16_t)pConfig->tempAlarmLow;
+    case MODBUS_HR_HUM_ALARM_HIGH:
+        return (uint16_t)pConfig->humidityAlarmHigh;
+    case MODBUS_HR_PRESS_ALARM_LOW:
+        return (uint16_t)((uint32_t)pConfig->pressureAlarmLow >> 16);
+    case MODBUS_HR_PRESS_ALARM_LOW + 1:
+        return (uint16_t)pConfig->pressureAlarmLow;
+    case MODBUS_HR_LOG_PERIOD:
+        return (uint16_t)(pConfig->logPeriodS >> 16);
+    case MODBUS_HR_LOG_PERIOD + 1:
+        return (uint16_t)pConfig->logPeriodS;
+    default:
+        return 0;
+    }
+}
+
+/*!
+ *  @brief    Procedura podmieniajaca jedno slowo wartosci 32-bitowej
+ *  @param    pField
+ *              Wartosc
+ *  @param    high
+ *              TRUE - starsze slowo
+ *  @param    value
+ *              Nowe slowo
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void setHalf(uint32_t* pField, Bool high, uint16_t value)
+{
+    if (high == TRUE)
+    {
+        *pField = (*pField & 0x0000FFFF) | ((uint32_t)value << 16);
+    }
+    else
+    {
+        *pField = (*pField & 0xFFFF0000) | value;
+    }
+}
+
+/*!
+ *  @brief    Procedura zapisujaca rejestr podtrzymujacy do konfiguracji
+ *  @param    pConfig
+ *              Konfiguracja
+ *  @param    reg
+ *              Adres rejestru
+ *  @param    value
+ *              Wartosc rejestru
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void writeHolding(config_t* pConfig, uint16_t reg, uint16_t value)
+{
+    uint32_t pressureAlarm = (uint32_t)pConfig->pressureAlarmLow;
+
+    switch (reg)
+    {
+    case MODBUS_HR_SAMPLE_PERIOD:
+    case MODBUS_HR_SAMPLE_PERIOD + 1:
+        setHalf(&pConfig->samplePeriodMs, (reg == MODBUS_HR_SAMPLE_PERIOD) ? TRUE : FALSE, value);
+        break;
+    case MODBUS_HR_DISPLAY_PERIOD:
+    case MODBUS_HR_DISPLAY_PERIOD + 1:
+        setHalf(&pConfig->displayPeriodMs, (reg == MODBUS_HR_DISPLAY_PERIOD) ? TRUE : FALSE, value);
+        break;
+    case MODBUS_HR_ALTITUDE:
+        pConfig->altitude = (int16_t)value;
+        break;
+    case MODBUS_HR_TEMP_ALARM_HIGH:
+        pConfig->tempAlarmHigh = (int16_t)value;
+        break;
+    case MODBUS_HR_TEMP_ALARM_LOW:
+        pConfig->tempAlarmLow = (int16_t)value;
+        break;
+    case MODBUS_HR_HUM_ALARM_HIGH:
+        pConfig->humidityAlarmHigh = (int16_t)value;
+        break;
+    case MODBUS_HR_PRESS_ALARM_LOW:
+    case MODBUS_HR_PRESS_ALARM_LOW + 1:
+        setHalf(&pressureAlarm, (reg == MODBUS_HR_PRESS_ALARM_LOW) ? TRUE : FALSE, value);
+        pConfig->pressureAlarmLow = (int32_t)pressureAlarm;
+        break;
+    case MODBUS_HR_LOG_PERIOD:
+    case MODBUS_HR_LOG_PERIOD + 1:
+        setHalf(&pConfig->logPeriodS, (reg == MODBUS_HR_LOG_PERIOD) ? TRUE : FALSE, value);
+        break;
+    default:
+        break;
+    }
+}
+
+/*!
+ *  @brief    Funkcja skladajaca odpowiedz z wyjatkiem
+ *  @param    function
+ *              Kod funkcji z zapytania
+ *  @param    code
+ *              Kod wyjatku
+ *  @returns  Dlugosc odpowiedzi bez CRC
+ *  @side_effects:
+ *            Zmiana bufora nadawczego i licznikow
+ */
+static uint32_t exception(uint8_t function, uint8_t code)
+{
+    txBuf[1] = function | 0x80;
+    txBuf[2] = code;
+    stats.exceptions++;
+
+    return 3;
+}
+
+/*!
+ *  @brief    Funkcja wykonujaca zapytanie i skladajaca odpowiedz w buforze
+ *            nadawczym (bez CRC)
+ *  @param    len
+ *              Dlugosc zapytania bez CRC
+ *  @returns  Dlugosc odpowiedzi bez CRC
+ *  @side_effects:
+ *            Zmiana kopii roboczej konfiguracji
+ */
+static uint32_t process(uint32_t len)
+{
+    uint8_t function = rxBuf[1];
+    uint16_t start = (uint16_t)((rxBuf[2] << 8) | rxBuf[3]);
+    uint16_t count = (uint16_t)((rxBuf[4] << 8) | rxBuf[5]);
+    const config_t* pConfig = (stagedPending == TRUE) ? &staged : config_get();
+    config_t newConfig;
+    uint32_t pos = 0;
+    uint16_t value = 0;
+    uint16_t i = 0;
+
+    txBuf[0] = address;
+    txBuf[1] = function;
+
+    switch (function)
+    {
+    case MODBUS_FC_READ_HOLDING:
+    case MODBUS_FC_READ_INPUT:
+        if (len != 6)
+        {
+            return exception(function, MODBUS_EX_ILLEGAL_VALUE);
+        }
+        if ((count == 0) || (count > MODBUS_MAX_READ))
+        {
+            return exception(function, MODBUS_EX_ILLEGAL_VALUE);
+        }
+        if ((uint32_t)start + count > ((function == MODBUS_FC_READ_INPUT) ? MODBUS_IR_COUNT : MODBUS_HR_COUNT))
+        {
+            return exception(function, MODBUS_EX_ILLEGAL_ADDRESS);
+        }
+
+        txBuf[2] = (uint8_t)(count * 2);
+        pos = 3;
+        for (i = 0; i < count; i++)
+        {
+            value = (function == MODBUS_FC_READ_INPUT) ? readInput(start + i) : readHolding(pConfig, start + i);
+            txBuf[pos++] = (uint8_t)(value >> 8);
+            txBuf[pos++] = (uint8_t)value;
+        }
+        return pos;
+
+    case MODBUS_FC_WRITE_SINGLE:
+        if (len != 6)
+        {
+            return exception(function, MODBUS_EX_ILLEGAL_VALUE);
+        }
+        if (start >= MODBUS_HR_COUNT)
+        {
+            return exception(function, MODBUS_EX_ILLEGAL_ADDRESS);
+        }
+
+        newConfig = *pConfig;
+        writeHolding(&newConfig, start, count);
+        break;
+
+    case MODBUS_FC_WRITE_MULTIPLE:
+        if ((count == 0) || (count > MODBUS_MAX_WRITE) || (len < 7)
+                || (rxBuf[6] != count * 2) || (len != 7 + (uint32_t)rxBuf[6]))
+        {
+            return exception(function, MODBUS_EX_ILLEGAL_VALUE);
+        }
+        if ((uint32_t)start + count > MODBUS_HR_COUNT)
+        {
+            return exception(function, MODBUS_EX_ILLEGAL_ADDRESS);
+        }
+
+        newConfig = *pConfig;
+        for (i = 0; i < count; i++)
+        {
+            value = (uint16_t)((rxBuf[7 + 2 * i] << 8) | rxBuf[8 + 2 * i]);
+            writeHolding(&newConfig, start + i, value);
+        }
+        break;
+
+    default:
+        return exception(function, MODBUS_EX_ILLEGAL_FUNCTION);
+    }
+
+    /* Te same ograniczenia co w poleceniach konsoli */
+    if (config_validate(&newConfig) == FALSE)
+    {
+        return exception(function, MODBUS_EX_ILLEGAL_VALUE);
+    }
+
+    staged = newConfig;
+    stagedPending = TRUE;
+
+    /* Odpowiedz na zapis powtarza adres i wartosc (06) lub liczbe rejestrow (16) */
+    memcpy(&txBuf[2], &rxBuf[2], 4);
+
+    return 6;
+}
+
+/*!
+ *  @brief    Procedura obslugi przerwania TIMER1 - uplyw przerwy t3.5. Konczy
+ *            odbior ramki i od razu wysyla odpowiedz, niezaleznie od petli
+ *            glownej, albo po nadaniu odpowiedzi wznawia odbior.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana stanu toru transmisji i licznikow
+ */
+void TIMER1_IRQHandler(void)
+{
+    uint32_t len = rxLen;
+    uint16_t crc = 0;
+
+    TIM_ClearIntPending(LPC_TIM1, TIM_MR0_INT);
+
+    if (state == STATE_DRAIN)
+    {
+        state = STATE_RX;
+        rxLen = 0;
+        rxOverrun = FALSE;
+        UART_RS485ReceiverCmd(LPC_UART1, ENABLE);
+        return;
+    }
+
+    if (state != STATE_RX)
+    {
+        return;
+    }
+
+    rxLen = 0;
+
+    if (rxOverrun == TRUE)
+    {
+        rxOverrun = FALSE;
+        stats.overruns++;
+        return;
+    }
+
+    /* Najkrotsza ramka: adres, funkcja, CRC */
+    if (len < 4)
+    {
+        return;
+    }
+
+    crc = (uint16_t)(rxBuf[len - 2] | (rxBuf[len - 1] << 8));
+    if (crc16_modbus(rxBuf, len - 2) != crc)
+    {
+        stats.crcErrors++;
+        return;
+    }
+
+    if ((rxBuf[0] != address) && (rxBuf[0] != 0))
+    {
+        return;
+    }
+
+    stats.rxFrames++;
+    len = process(len - 2);
+
+    /* Na ramki rozgloszeniowe nie ma odpowiedzi */
+    if (rxBuf[0] == 0)
+    {
+        return;
+    }
+
+    crc = crc16_modbus(txBuf, len);
+    txBuf[len++] = (uint8_t)crc;
+    txBuf[len++] = (uint8_t)(crc >> 8);
+    txLen = len;
+    txPos = 0;
+    stats.responses++;
+
+    /* Odbiornik wylaczony na czas nadawania, pomija echo z magistrali */
+    UART_RS485ReceiverCmd(LPC_UART1, DISABLE);
+    state = STATE_TX;
+    fillTxFifo();
+    UART_IntConfig(UARTDEV, UART_INTCFG_THRE, ENABLE);
+}
+
+/*!
+ *  @brief    Procedura obslugi przerwania UART1. Odebrane bajty sa dopisywane
+ *            do ramki i restartuja odliczanie t3.5, przerwanie THRE zasila
+ *            nadajnik.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana bufora odbiorczego i stanu TIMER1
+ */
+void UART1_IRQHandler(void)
+{
+    uint32_t intId = UART_GetIntId(UARTDEV) & UART_IIR_INTID_MASK;
+    uint8_t lineStatus = 0;
+
+    if (intId == UART_IIR_INTID_RLS)
+    {
+        lineStatus = UART_GetLineStatus(UARTDEV);
+        if (lineStatus & (UART_LSR_OE | UART_LSR_PE | UART_LSR_FE | UART_LSR_BI | UART_LSR_RXFE))
+        {
+            /* Ramka z bledem linii jest odrzucana w calosci */
+            rxOverrun = TRUE;
+        }
+    }
+
+    if ((intId == UART_IIR_INTID_RDA) || (intId == UART_IIR_INTID_CTI) || (intId == UART_IIR_INTID_RLS))
+    {
+        while (UARTDEV->LSR & UART_LSR_RDR)
+        {
+            uint8_t data = UARTDEV->RBR;
+
+            if (state != STATE_RX)
+            {
+                continue;
+            }
+
+            if (rxLen < MODBUS_FRAME_SIZE)
+            {
+                rxBuf[rxLen++] = data;
+            }
+            else
+            {
+                rxOverrun = TRUE;
+            }
+            startTimer(MODBUS_T35_US);
+        }
+    }
+
+    if ((intId == UART_IIR_INTID_THRE) && (state == STATE_TX))
+    {
+        fillTxFifo();
+    }
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca port RS485 na UART1 (P2.0 - TXD, P0.16 -
+ *            RXD, P0.22 - RTS sterujacy kierunkiem nadajnika) i TIMER1 do
+ *            odmierzania przerw miedzy ramkami. P2.1 i P2.7 zajmuje wyswietlacz
+ *            OLED, wiec RXD dzieli pin z joystickiem (prawo). Nic nie robi, gdy
+ *            adres w konfiguracji jest zerowy.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Konfiguracja pinow, UART1, TIMER1 i kontrolera NVIC
+ */
+void modbus_init(void)
+{
+    PINSEL_CFG_Type PinCfg;
+    UART_CFG_Type uartCfg;
+    UART_FIFO_CFG_Type fifoCfg;
+    UART1_RS485_CTRLCFG_Type rs485Cfg;
+    TIM_TIMERCFG_Type timerCfg;
+    TIM_MATCHCFG_Type matchCfg;
+
+    memset(&stats, 0, sizeof(stats));
+    address = config_get()->modbusAddress;
+    if ((address == 0) || (address > MODBUS_MAX_ADDRESS))
+    {
+        address = 0;
+        return;
+    }
+
+    PinCfg.Funcnum = 2;
+    PinCfg.OpenDrain = 0;
+    PinCfg.Pinmode = 0;
+    PinCfg.Portnum = 2;
+    PinCfg.Pinnum = 0;
+    PINSEL_ConfigPin(&PinCfg);
+    PinCfg.Funcnum = 1;
+    PinCfg.Portnum = 0;
+    PinCfg.Pinnum = 16;
+    PINSEL_ConfigPin(&PinCfg);
+    PinCfg.Pinnum = 22;
+    PINSEL_ConfigPin(&PinCfg);
+
+    UART_ConfigStructInit(&uartCfg);
+    uartCfg.Baud_rate = MODBUS_BAUD_RATE;
+    uartCfg.Parity = UART_PARITY_EVEN;
+    UART_Init(UARTDEV, &uartCfg);
+
+    /* Przerwanie po kazdym bajcie, zeby odliczanie t3.5 startowalo od razu */
+    UART_FIFOConfigStructInit(&fifoCfg);
+    fifoCfg.FIFO_Level = UART_FIFO_TRGLEV0;
+    UART_FIFOConfig(UARTDEV, &fifoCfg);
+
+    /* Sprzetowe sterowanie kierunkiem: RTS aktywny do oproznienia nadajnika */
+    rs485Cfg.NormalMultiDropMode_State = DISABLE;
+    rs485Cfg.Rx_State = ENABLE;
+    rs485Cfg.AutoAddrDetect_State = DISABLE;
+    rs485Cfg.AutoDirCtrl_State = ENABLE;
+    rs485Cfg.DirCtrlPin = UART1_RS485_DIRCTRL_RTS;
+    rs485Cfg.DirCtrlPol_Level = SET;
+    rs485Cfg.MatchAddrValue = 0;
+    rs485Cfg.DelayValue = 0;
+    UART_RS485Config(LPC_UART1, &rs485Cfg);
+
+    /* UART_RS485Config wymusza parzystosc "stick 0" trybu 9-bitowego, Modbus RTU uzywa parzystej */
+    LPC_UART1->LCR = UART_LCR_WLEN8 | UART_LCR_PARITY_EN | UART_LCR_PARITY_EVEN;
+
+    UART_TxCmd(UARTDEV, ENABLE);
+
+    timerCfg.PrescaleOption = TIM_PRESCALE_USVAL;
+    timerCfg.PrescaleValue = 1;
+    TIM_Init(LPC_TIM1, TIM_TIMER_MODE, &timerCfg);
+
+    matchCfg.MatchChannel = 0;
+    matchCfg.IntOnMatch = ENABLE;
+    matchCfg.StopOnMatch = ENABLE;
+    matchCfg.ResetOnMatch = ENABLE;
+    matchCfg.ExtMatchOutputType = TIM_EXTMATCH_NOTHING;
+    matchCfg.MatchValue = MODBUS_T35_US;
+    TIM_ConfigMatch(LPC_TIM1, &matchCfg);
+
+    UART_IntConfig(UARTDEV, UART_INTCFG_RBR, ENABLE);
+    UART_IntConfig(UARTDEV, UART_INTCFG_RLS, ENABLE);
+
+    /* Wyzszy priorytet niz pozostale peryferia, odpowiedz nie czeka na petle glowna */
+    NVIC_SetPriority(UART1_IRQn, 1);
+    NVIC_SetPriority(TIMER1_IRQn, 1);
+    NVIC_EnableIRQ(UART1_IRQn);
+    NVIC_EnableIRQ(TIMER1_IRQn);
+}
+
+/*!
+ *  @brief    Procedura utrwalajaca w pamieci EEPROM konfiguracje zmieniona przez
+ *            zapis rejestrow. Wywolywana w petli glownej, bo zapis EEPROM po
+ *            I2C jest za dlugi na przerwanie.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis konfiguracji do pamieci EEPROM
+ */
+void modbus_poll(void)
+{
+    config_t newConfig;
+
+    if (stagedPending == FALSE)
+    {
+        return;
+    }
+
+    NVIC_DisableIRQ(TIMER1_IRQn);
+    newConfig = staged;
+    stagedPending = FALSE;
+    NVIC_EnableIRQ(TIMER1_IRQn);
+
+    if (config_save(&newConfig) == 0)
+    {
+        stats.configWrites++;
+    }
+}
+
+/*!
+ *  @brief    Procedura aktualizujaca migawke odczytu udostepniana w rejestrach
+ *            wejsciowych
+ *  @param    temperature
+ *              Temperatura [0.1 C]
+ *  @param    pressure
+ *              Cisnienie [Pa]
+ *  @param    humidity
+ *              Wilgotnosc [%]
+ *  @param    invalid
+ *              Maska METRIC_BIT wielkosci bez poprawnej wartosci
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void modbus_setSample(int32_t temperature, int32_t pressure, int16_t humidity, uint8_t invalid)
+{
+    if (address == 0)
+    {
+        return;
+    }
+
+    NVIC_DisableIRQ(TIMER1_IRQn);
+    sampleTemperature = ((invalid & METRIC_BIT(METRIC_TEMPERATURE)) != 0)
+            ? (int16_t)MODBUS_INVALID_VALUE : (int16_t)temperature;
+    samplePressure = ((invalid & METRIC_BIT(METRIC_PRESSURE)) != 0)
+            ? (int32_t)((uint32_t)MODBUS_INVALID_VALUE << 16) : pressure;
+    sampleHumidity = ((invalid & METRIC_BIT(METRIC_HUMIDITY)) != 0) ? MODBUS_INVALID_VALUE : (uint16_t)humidity;
+    sampleInvalid = invalid;
+    sampleSequence++;
+    NVIC_EnableIRQ(TIMER1_IRQn);
+}
+
+/*!
+ *  @brief    Getter licznikow diagnostycznych
+ *  @param    Brak
+ *  @returns  Wskaznik na liczniki
+ *  @side_effects:
+ *            Brak
+ */
+const modbus_stats_t* modbus_getStats(void)
+{
+    return &stats;
+}
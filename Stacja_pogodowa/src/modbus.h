@@ -0,0 +1,59 @@
+#ifndef MODBUS_H_
+#define MODBUS_H_
+
+#include "lpc_types.h"
+
+/* Parametry linii RS485: 8 bitow danych, parzystosc parzysta, 1 bit stopu */
+#define MODBUS_BAUD_RATE 19200
+
+/* Najwiekszy adres urzadzenia podrzednego, 0 - ramka rozgloszeniowa */
+#define MODBUS_MAX_ADDRESS 247
+
+/*
+ * Rejestry wejsciowe (funkcja 04), tylko do odczytu, z ostatniego odczytu
+ * czujnikow. Wartosci 32-bitowe zajmuja dwa rejestry, starsze slowo pierwsze.
+ * Wielkosc bez poprawnej wartosci ma w starszym (lub jedynym) rejestrze
+ * MODBUS_INVALID_VALUE, a w mlodszym 0.
+ */
+#define MODBUS_IR_TEMPERATURE      0   /* Temperatura [0.1 C] (int16) */
+#define MODBUS_IR_PRESSURE         1   /* Cisnienie [Pa] (2 rejestry) */
+#define MODBUS_IR_HUMIDITY         3   /* Wilgotnosc [%] */
+#define MODBUS_IR_SEQUENCE         4   /* Licznik odczytow, zmiana = nowy odczyt */
+#define MODBUS_IR_INVALID          5   /* Maska METRIC_BIT wielkosci bez poprawnej wartosci */
+#define MODBUS_IR_COUNT            6
+
+#define MODBUS_INVALID_VALUE       0x8000
+
+/*
+ * Rejestry podtrzymujace (funkcje 03, 06, 16), odwzorowanie konfiguracji.
+ * Zapis trafia od razu do kopii roboczej i jest utrwalany w pamieci EEPROM w
+ * petli glownej. Wartosci 32-bitowe nalezy zapisywac funkcja 16 w calosci.
+ * Zapis poza zakresami config_validate konczy sie wyjatkiem ILLEGAL VALUE.
+ */
+#define MODBUS_HR_SAMPLE_PERIOD    0   /* Okres odczytu [ms] (2 rejestry) */
+#define MODBUS_HR_DISPLAY_PERIOD   2   /* Okres odswiezania ekranu [ms] (2 rejestry) */
+#define MODBUS_HR_ALTITUDE         4   /* Wysokosc stacji [m] (int16) */
+#define MODBUS_HR_TEMP_ALARM_HIGH  5   /* [0.1 C] (int16) */
+#define MODBUS_HR_TEMP_ALARM_LOW   6   /* [0.1 C] (int16) */
+#define MODBUS_HR_HUM_ALARM_HIGH   7   /* [%] */
+#define MODBUS_HR_PRESS_ALARM_LOW  8   /* [Pa] (2 rejestry) */
+#define MODBUS_HR_LOG_PERIOD       10  /* Okres zapisu do dziennika [s] (2 rejestry) */
+#define MODBUS_HR_COUNT            12
+
+/* Liczniki diagnostyczne */
+typedef struct
+{
+    uint32_t rxFrames;
+    uint32_t crcErrors;
+    uint32_t overruns;
+    uint32_t exceptions;
+    uint32_t responses;
+    uint32_t configWrites;
+} modbus_stats_t;
+
+void modbus_init(void);
+void modbus_poll(void);
+void modbus_setSample(int32_t temperature, int32_t pressure, int16_t humidity, uint8_t invalid);
+const modbus_stats_t* modbus_getStats(void);
+
+#endif /* MODBUS_H_ */
@@ -0,0 +1,687 @@
+#include <string.h>
+
+#include "lpc17xx_emac.h"
+#include "lpc17xx_pinsel.h"
+
+#include "net.h"
+#include "config.h"
+
+#define NET_ETHERTYPE_IP  0x0800
+#define NET_ETHERTYPE_ARP 0x0806
+
+#define NET_ARP_SIZE      28
+#define NET_ARP_REQUEST   1
+#define NET_ARP_REPLY     2
+
+/* Liczba zapamietanych adresow MAC i okres ponawiania zapytan ARP [ms] */
+#define NET_ARP_ENTRIES   4
+#define NET_ARP_RETRY_MS  1000
+
+/* Okres sprawdzania stanu lacza [ms] */
+#define NET_LINK_POLL_MS  500
+
+/* Bledy odbioru; EMAC_RINFO_LEN_ERR jest zglaszany dla kazdej ramki z polem EtherType */
+#define NET_RX_ERRORS     (EMAC_RINFO_CRC_ERR | EMAC_RINFO_SYM_ERR | EMAC_RINFO_ALIGN_ERR | EMAC_RINFO_OVERRUN)
+
+/* Wpis tablicy ARP */
+typedef struct
+{
+    uint32_t ip;
+    uint8_t mac[6];
+} net_arp_entry_t;
+
+static const uint8_t broadcastMac[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+static const uint8_t zeroMac[6] = { 0, 0, 0, 0, 0, 0 };
+
+static Bool ready = FALSE;          /* Kontroler EMAC i PHY skonfigurowane */
+static Bool up = FALSE;             /* Lacze aktywne */
+static uint32_t linkLast = 0;
+static Bool linkDue = FALSE;
+static uint8_t mac[6];
+static net_arp_entry_t arpTable[NET_ARP_ENTRIES];
+static uint8_t arpNext = 0;
+static uint32_t arpPendingIp = 0;
+static uint32_t arpLast = 0;
+static Bool arpDue = FALSE;
+static uint16_t ipId = 0;
+static net_stats_t stats;
+
+/* Ramka budowana w buforze nadawczym EMAC */
+static uint8_t* pTxFrame = NULL;
+static const uint8_t* pTxMac = NULL;
+
+static net_tcp_handler_t tcpHandler = NULL;
+
+/*!
+ *  @brief    Procedury zapisu i odczytu liczb w kolejnosci sieciowej
+ *            (big-endian)
+ */
+static void put16(uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+}
+
+static void put32(uint8_t* p, uint32_t value)
+{
+    put16(p, (uint16_t)(value >> 16));
+    put16(&p[2], (uint16_t)value);
+}
+
+static uint16_t get16(const uint8_t* p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t get32(const uint8_t* p)
+{
+    return ((uint32_t)get16(p) << 16) | get16(&p[2]);
+}
+
+/*!
+ *  @brief    Funkcja dodajaca dane do sumy kontrolnej Internetu (RFC 1071).
+ *            Wszystkie fragmenty poza ostatnim musza miec parzysta dlugosc.
+ *  @param    sum
+ *              Suma czesciowa (0 na poczatku)
+ *  @param    pData
+ *              Dane
+ *  @param    len
+ *              Dlugosc danych
+ *  @returns  Nowa suma czesciowa
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t net_checksumAdd(uint32_t sum, const uint8_t* pData, uint32_t len)
+{
+    while (len > 1)
+    {
+        sum += get16(pData);
+        pData += 2;
+        len -= 2;
+    }
+
+    if (len > 0)
+    {
+        sum += (uint32_t)pData[0] << 8;
+    }
+
+    return sum;
+}
+
+/*!
+ *  @brief    Funkcja konczaca obliczanie sumy kontrolnej Internetu
+ *  @param    sum
+ *              Suma czesciowa
+ *  @returns  Suma kontrolna gotowa do wpisania do naglowka
+ *  @side_effects:
+ *            Brak
+ */
+uint16_t net_checksumFold(uint32_t sum)
+{
+    while ((sum >> 16) != 0)
+    {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+
+    return (uint16_t)~sum;
+}
+
+/*!
+ *  @brief    Funkcja wyszukujaca adres MAC w tablicy ARP
+ *  @param    ip
+ *              Adres IPv4
+ *  @returns  Adres MAC lub NULL gdy adres nie jest znany
+ *  @side_effects:
+ *            Brak
+ */
+static const uint8_t* arpLookup(uint32_t ip)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < NET_ARP_ENTRIES; i++)
+    {
+        if ((arpTable[i].ip == ip) && (ip != 0))
+        {
+            return arpTable[i].mac;
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+ *  @brief    Procedura zapamietujaca adres MAC w tablicy ARP. Istniejacy wpis
+ *            jest aktualizowany, nowy zastepuje najstarszy.
+ *  @param    ip
+ *              Adres IPv4
+ *  @param    pMac
+ *              Adres MAC
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana tablicy ARP
+ */
+static void arpLearn(uint32_t ip, const uint8_t* pMac)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < NET_ARP_ENTRIES; i++)
+    {
+        if (arpTable[i].ip == ip)
+        {
+            memcpy(arpTable[i].mac, pMac, 6);
+            return;
+        }
+    }
+
+    arpTable[arpNext].ip = ip;
+    memcpy(arpTable[arpNext].mac, pMac, 6);
+    arpNext = (arpNext + 1) % NET_ARP_ENTRIES;
+
+    if (ip == arpPendingIp)
+    {
+        arpPendingIp = 0;
+    }
+}
+
+/*!
+ *  @brief    Procedura wpisujaca naglowek Ethernet do bufora ramki
+ *  @param    pFrame
+ *              Bufor ramki
+ *  @param    pDst
+ *              Adres MAC odbiorcy
+ *  @param    type
+ *              EtherType
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void putEthHeader(uint8_t* pFrame, const uint8_t* pDst, uint16_t type)
+{
+    memcpy(&pFrame[0], pDst, 6);
+    memcpy(&pFrame[6], mac, 6);
+    put16(&pFrame[12], type);
+}
+
+/*!
+ *  @brief    Procedura wpisujaca naglowek IPv4 do bufora ramki
+ *  @param    pIp
+ *              Miejsce na naglowek
+ *  @param    dstIp
+ *              Adres odbiorcy
+ *  @param    protocol
+ *              Protokol (NET_PROTO_xxx)
+ *  @param    len
+ *              Dlugosc danych pakietu
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana numeru identyfikacyjnego pakietu
+ */
+static void putIpHeader(uint8_t* pIp, uint32_t dstIp, uint8_t protocol, uint16_t len)
+{
+    pIp[0] = 0x45;
+    pIp[1] = 0;
+    put16(&pIp[2], NET_IP_HEADER_SIZE + len);
+    put16(&pIp[4], ipId++);
+    put16(&pIp[6], 0x4000);
+    pIp[8] = 64;
+    pIp[9] = protocol;
+    put16(&pIp[10], 0);
+    put32(&pIp[12], config_get()->netIp);
+    put32(&pIp[16], dstIp);
+    put16(&pIp[10], net_checksumFold(net_checksumAdd(0, pIp, NET_IP_HEADER_SIZE)));
+}
+
+/*!
+ *  @brief    Procedura wysylajaca pakiet ARP zbudowany wprost w buforze
+ *            nadawczym EMAC
+ *  @param    op
+ *              NET_ARP_REQUEST lub NET_ARP_REPLY
+ *  @param    pDstMac
+ *              Adres MAC odbiorcy (dla zapytania - adres rozgloszeniowy)
+ *  @param    dstIp
+ *              Szukany lub pytajacy adres IPv4
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyslanie ramki
+ */
+static void sendArp(uint16_t op, const uint8_t* pDstMac, uint32_t dstIp)
+{
+    uint8_t* pFrame = NULL;
+    uint8_t* pArp = NULL;
+
+    if (EMAC_CheckTransmitIndex() == FALSE)
+    {
+        stats.txDropped++;
+        return;
+    }
+
+    pFrame = EMAC_GetTxBuffer();
+    pArp = &pFrame[NET_ETH_HEADER_SIZE];
+
+    putEthHeader(pFrame, pDstMac, NET_ETHERTYPE_ARP);
+    put16(&pArp[0], 1);
+    put16(&pArp[2], NET_ETHERTYPE_IP);
+    pArp[4] = 6;
+    pArp[5] = 4;
+    put16(&pArp[6], op);
+    memcpy(&pArp[8], mac, 6);
+    put32(&pArp[14], config_get()->netIp);
+    memcpy(&pArp[18], (op == NET_ARP_REQUEST) ? zeroMac : pDstMac, 6);
+    put32(&pArp[24], dstIp);
+
+    EMAC_CommitTxBuffer(NET_ETH_HEADER_SIZE + NET_ARP_SIZE);
+    stats.txFrames++;
+}
+
+/*!
+ *  @brief    Procedura obslugujaca odebrany pakiet ARP
+ *  @param    pArp
+ *              Pakiet ARP
+ *  @param    len
+ *              Dlugosc pakietu
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana tablicy ARP, wyslanie odpowiedzi
+ */
+static void handleArp(const uint8_t* pArp, uint32_t len)
+{
+    uint32_t senderIp = 0;
+
+    if ((len < NET_ARP_SIZE) || (get16(&pArp[0]) != 1) || (get16(&pArp[2]) != NET_ETHERTYPE_IP)
+            || (pArp[4] != 6) || (pArp[5] != 4) || (get32(&pArp[24]) != config_get()->netIp))
+    {
+        return;
+    }
+
+    senderIp = get32(&pArp[14]);
+    arpLearn(senderIp, &pArp[8]);
+
+    if (get16(&pArp[6]) == NET_ARP_REQUEST)
+    {
+        sendArp(NET_ARP_REPLY, &pArp[8], senderIp);
+    }
+}
+
+/*!
+ *  @brief    Procedura obslugujaca odebrany pakiet IPv4 adresowany do stacji.
+ *            Pakiety z opcjami i fragmenty sa pomijane.
+ *  @param    pSrcMac
+ *              Adres MAC nadawcy ramki
+ *  @param    pIp
+ *              Pakiet IPv4
+ *  @param    len
+ *              Dlugosc danych za naglowkiem Ethernet
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void handleIp(const uint8_t* pSrcMac, const uint8_t* pIp, uint32_t len)
+{
+    uint16_t totalLen = 0;
+
+    if ((len < NET_IP_HEADER_SIZE) || (pIp[0] != 0x45) || (get32(&pIp[16]) != config_get()->netIp)
+            || ((get16(&pIp[6]) & 0x3FFF) != 0)
+            || (net_checksumFold(net_checksumAdd(0, pIp, NET_IP_HEADER_SIZE)) != 0))
+    {
+        return;
+    }
+
+    /* Ramki krotsze niz 60 bajtow sa dopelniane, dlugosc bierzemy z naglowka */
+    totalLen = get16(&pIp[2]);
+    if ((totalLen < NET_IP_HEADER_SIZE) || (totalLen > len))
+    {
+        return;
+    }
+
+    if ((pIp[9] == NET_PROTO_TCP) && (tcpHandler != NULL))
+    {
+        tcpHandler(get32(&pIp[12]), pSrcMac, &pIp[NET_IP_HEADER_SIZE], totalLen - NET_IP_HEADER_SIZE);
+    }
+}
+
+/*!
+ *  @brief    Procedura obslugujaca odebrana ramke Ethernet. Ramka jest
+ *            analizowana wprost w buforze odbiorczym EMAC.
+ *  @param    pFrame
+ *              Ramka
+ *  @param    len
+ *              Dlugosc ramki bez sumy FCS
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+static void handleFrame(const uint8_t* pFrame, uint32_t len)
+{
+    if (len < NET_ETH_HEADER_SIZE)
+    {
+        return;
+    }
+
+    switch (get16(&pFrame[12]))
+    {
+        case NET_ETHERTYPE_ARP:
+        {
+            handleArp(&pFrame[NET_ETH_HEADER_SIZE], len - NET_ETH_HEADER_SIZE);
+            break;
+        }
+        case NET_ETHERTYPE_IP:
+        {
+            handleIp(&pFrame[6], &pFrame[NET_ETH_HEADER_SIZE], len - NET_ETH_HEADER_SIZE);
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/*!
+ *  @brief    Funkcja inicjalizujaca interfejs Ethernet (piny RMII, EMAC i PHY).
+ *            Adres MAC jest adresem lokalnie administrowanym wyznaczonym z
+ *            adresu IP stacji. Funkcja nie czeka na autonegocjacje - stan
+ *            lacza jest sprawdzany w net_poll, wiec brak kabla nie wstrzymuje
+ *            uruchomienia stacji.
+ *  @param    Brak
+ *  @returns  TRUE jesli kontroler EMAC i PHY zostaly skonfigurowane
+ *  @side_effects:
+ *            Konfiguracja pinow P1.x i kontrolera EMAC
+ */
+Bool net_init(void)
+{
+    static const uint8_t rmiiPins[] = { 0, 1, 4, 8, 9, 10, 14, 15, 16, 17 };
+    PINSEL_CFG_Type PinCfg;
+    EMAC_CFG_Type emacCfg;
+    uint32_t ip = config_get()->netIp;
+    uint8_t i = 0;
+
+    ready = FALSE;
+    up = FALSE;
+    memset(arpTable, 0, sizeof(arpTable));
+    memset(&stats, 0, sizeof(stats));
+
+    if (ip == 0)
+    {
+        return FALSE;
+    }
+
+    PinCfg.Funcnum = 1;
+    PinCfg.OpenDrain = 0;
+    PinCfg.Pinmode = 0;
+    PinCfg.Portnum = 1;
+    for (i = 0; i < sizeof(rmiiPins); i++)
+    {
+        PinCfg.Pinnum = rmiiPins[i];
+        PINSEL_ConfigPin(&PinCfg);
+    }
+
+    mac[0] = 0x02;
+    mac[1] = 0x00;
+    put32(&mac[2], ip);
+
+    emacCfg.Mode = EMAC_MODE_AUTO_NOWAIT;
+    emacCfg.pbEMAC_Addr = mac;
+
+    if (EMAC_Init(&emacCfg) != SUCCESS)
+    {
+        return FALSE;
+    }
+
+    ready = TRUE;
+    linkDue = TRUE;
+    arpDue = FALSE;
+    arpPendingIp = 0;
+    return TRUE;
+}
+
+/*!
+ *  @brief    Funkcja sprawdzajaca czy interfejs Ethernet dziala
+ *  @param    Brak
+ *  @returns  TRUE jesli interfejs zostal uruchomiony i lacze jest aktywne
+ *  @side_effects:
+ *            Brak
+ */
+Bool net_isUp(void)
+{
+    return up;
+}
+
+/*!
+ *  @brief    Procedura obslugujaca interfejs Ethernet, wywolywana w petli
+ *            glownej. Sprawdza stan lacza, obsluguje odebrane ramki i ponawia
+ *            zapytania ARP.
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  Nic
+ *  @side_effects:
+ *            Odbior i wysylanie ramek, konfiguracja predkosci EMAC po
+ *            zestawieniu lacza
+ */
+void net_poll(uint32_t now)
+{
+    if (ready == FALSE)
+    {
+        return;
+    }
+
+    if ((linkDue == TRUE) || ((now - linkLast) >= NET_LINK_POLL_MS))
+    {
+        linkDue = FALSE;
+        linkLast = now;
+        up = (EMAC_PollPHYLink() > 0) ? TRUE : FALSE;
+    }
+
+    if (up == FALSE)
+    {
+        return;
+    }
+
+    while (EMAC_CheckReceiveIndex() == TRUE)
+    {
+        if (EMAC_CheckReceiveDataStatus(NET_RX_ERRORS) == SET)
+        {
+            stats.rxErrors++;
+        }
+        else
+        {
+            stats.rxFrames++;
+            /* Rozmiar w deskryptorze jest pomniejszony o 1 i zawiera FCS */
+            handleFrame(EMAC_GetRxBuffer(), EMAC_GetReceiveDataSize() + 1 - 4);
+        }
+        EMAC_UpdateRxConsumeIndex();
+    }
+
+    if ((arpPendingIp != 0) && ((arpDue == TRUE) || ((now - arpLast) >= NET_ARP_RETRY_MS)))
+    {
+        arpDue = FALSE;
+        arpLast = now;
+        sendArp(NET_ARP_REQUEST, broadcastMac, arpPendingIp);
+    }
+}
+
+/*!
+ *  @brief    Funkcja rozpoczynajaca datagram UDP do odbiorcy telemetrii.
+ *            Zwraca wskaznik na miejsce na dane wprost w buforze nadawczym
+ *            EMAC, naglowki sa uzupelniane przez net_udpSend.
+ *  @param    Brak
+ *  @returns  Wskaznik na dane datagramu (do NET_UDP_MAX_PAYLOAD bajtow) lub
+ *            NULL gdy datagramu nie mozna teraz wyslac
+ *  @side_effects:
+ *            Zapytanie ARP gdy adres MAC odbiorcy nie jest znany
+ */
+uint8_t* net_udpBegin(void)
+{
+    const config_t* pConfig = config_get();
+    uint32_t nextHop = pConfig->collectorIp;
+
+    pTxFrame = NULL;
+
+    if ((up == FALSE) || (pConfig->collectorIp == 0))
+    {
+        return NULL;
+    }
+
+    if (((nextHop ^ pConfig->netIp) & pConfig->netMask) != 0)
+    {
+        nextHop = pConfig->netGateway;
+    }
+
+    pTxMac = arpLookup(nextHop);
+    if (pTxMac == NULL)
+    {
+        if (arpPendingIp != nextHop)
+        {
+            arpPendingIp = nextHop;
+            arpDue = TRUE;
+        }
+        stats.txDropped++;
+        return NULL;
+    }
+
+    if (EMAC_CheckTransmitIndex() == FALSE)
+    {
+        stats.txDropped++;
+        return NULL;
+    }
+
+    pTxFrame = EMAC_GetTxBuffer();
+    return &pTxFrame[NET_UDP_PAYLOAD_OFFSET];
+}
+
+/*!
+ *  @brief    Procedura uzupelniajaca naglowki Ethernet, IPv4 i UDP datagramu
+ *            rozpoczetego przez net_udpBegin i przekazujaca go do wyslania
+ *  @param    len
+ *              Dlugosc danych datagramu
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyslanie ramki
+ */
+void net_udpSend(uint16_t len)
+{
+    const config_t* pConfig = config_get();
+    uint8_t* pIp = NULL;
+    uint8_t* pUdp = NULL;
+    uint32_t sum = 0;
+    uint16_t checksum = 0;
+
+    if (pTxFrame == NULL)
+    {
+        return;
+    }
+
+    pIp = &pTxFrame[NET_ETH_HEADER_SIZE];
+    pUdp = &pIp[NET_IP_HEADER_SIZE];
+
+    putEthHeader(pTxFrame, pTxMac, NET_ETHERTYPE_IP);
+    putIpHeader(pIp, pConfig->collectorIp, NET_PROTO_UDP, NET_UDP_HEADER_SIZE + len);
+
+    put16(&pUdp[0], NET_UDP_LOCAL_PORT);
+    put16(&pUdp[2], pConfig->collectorPort);
+    put16(&pUdp[4], NET_UDP_HEADER_SIZE + len);
+    put16(&pUdp[6], 0);
+
+    sum = net_pseudoHeaderSum(pConfig->collectorIp, NET_PROTO_UDP, NET_UDP_HEADER_SIZE + len);
+    checksum = net_checksumFold(net_checksumAdd(sum, pUdp, NET_UDP_HEADER_SIZE + len));
+    put16(&pUdp[6], (checksum == 0) ? 0xFFFF : checksum);
+
+    EMAC_CommitTxBuffer(NET_UDP_PAYLOAD_OFFSET + len);
+    stats.txFrames++;
+    pTxFrame = NULL;
+}
+
+/*!
+ *  @brief    Setter procedury obslugujacej odebrane segmenty TCP
+ *  @param    handler
+ *              Procedura obslugi lub NULL
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void net_setTcpHandler(net_tcp_handler_t handler)
+{
+    tcpHandler = handler;
+}
+
+/*!
+ *  @brief    Funkcja rozpoczynajaca pakiet IPv4. Zwraca wskaznik na miejsce na
+ *            dane pakietu wprost w buforze nadawczym EMAC.
+ *  @param    Brak
+ *  @returns  Wskaznik na dane pakietu lub NULL gdy brak wolnego bufora
+ *  @side_effects:
+ *            Brak
+ */
+uint8_t* net_ipBegin(void)
+{
+    pTxFrame = NULL;
+
+    if ((up == FALSE) || (EMAC_CheckTransmitIndex() == FALSE))
+    {
+        stats.txDropped++;
+        return NULL;
+    }
+
+    pTxFrame = EMAC_GetTxBuffer();
+    return &pTxFrame[NET_IP_PAYLOAD_OFFSET];
+}
+
+/*!
+ *  @brief    Procedura uzupelniajaca naglowki Ethernet i IPv4 pakietu
+ *            rozpoczetego przez net_ipBegin i przekazujaca go do wyslania
+ *  @param    pDstMac
+ *              Adres MAC odbiorcy (np. nadawcy zapytania)
+ *  @param    dstIp
+ *              Adres odbiorcy
+ *  @param    protocol
+ *              Protokol (NET_PROTO_xxx)
+ *  @param    len
+ *              Dlugosc danych pakietu
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyslanie ramki
+ */
+void net_ipSend(const uint8_t* pDstMac, uint32_t dstIp, uint8_t protocol, uint16_t len)
+{
+    if (pTxFrame == NULL)
+    {
+        return;
+    }
+
+    putEthHeader(pTxFrame, pDstMac, NET_ETHERTYPE_IP);
+    putIpHeader(&pTxFrame[NET_ETH_HEADER_SIZE], dstIp, protocol, len);
+
+    EMAC_CommitTxBuffer(NET_IP_PAYLOAD_OFFSET + len);
+    stats.txFrames++;
+    pTxFrame = NULL;
+}
+
+/*!
+ *  @brief    Funkcja obliczajaca sume czesciowa pseudo-naglowka TCP/UDP
+ *  @param    dstIp
+ *              Adres odbiorcy
+ *  @param    protocol
+ *              Protokol (NET_PROTO_xxx)
+ *  @param    len
+ *              Dlugosc segmentu lub datagramu razem z naglowkiem
+ *  @returns  Suma czesciowa do net_checksumAdd
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t net_pseudoHeaderSum(uint32_t dstIp, uint8_t protocol, uint16_t len)
+{
+    uint32_t srcIp = config_get()->netIp;
+
+    return (srcIp >> 16) + (srcIp & 0xFFFF) + (dstIp >> 16) + (dstIp & 0xFFFF) + protocol + len;
+}
+
+/*!
+ *  @brief    Getter licznikow diagnostycznych
+ *  @param    Brak
+ *  @returns  Wskaznik na liczniki
+ *  @side_effects:
+ *            Brak
+ */
+const net_stats_t* net_getStats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,49 @@
+#ifndef NET_H_
+#define NET_H_
+
+#include "lpc_types.h"
+
+/* Rozmiary naglowkow ramki Ethernet/IPv4/UDP */
+#define NET_ETH_HEADER_SIZE 14
+#define NET_IP_HEADER_SIZE  20
+#define NET_UDP_HEADER_SIZE 8
+
+/* Poczatek danych datagramu UDP w buforze ramki */
+#define NET_UDP_PAYLOAD_OFFSET (NET_ETH_HEADER_SIZE + NET_IP_HEADER_SIZE + NET_UDP_HEADER_SIZE)
+#define NET_UDP_MAX_PAYLOAD    (1500 - NET_IP_HEADER_SIZE - NET_UDP_HEADER_SIZE)
+
+#define NET_PROTO_TCP 6
+#define NET_PROTO_UDP 17
+
+/* Poczatek danych pakietu IPv4 w buforze ramki */
+#define NET_IP_PAYLOAD_OFFSET (NET_ETH_HEADER_SIZE + NET_IP_HEADER_SIZE)
+
+/* Port zrodlowy telemetrii UDP */
+#define NET_UDP_LOCAL_PORT 5005
+
+/* Liczniki diagnostyczne interfejsu Ethernet */
+typedef struct
+{
+    uint32_t rxFrames;
+    uint32_t rxErrors;
+    uint32_t txFrames;
+    uint32_t txDropped;          /* Brak wolnego deskryptora lub adresu MAC odbiorcy */
+} net_stats_t;
+
+/* Obsluga odebranego segmentu TCP: adres i MAC nadawcy, segment, dlugosc */
+typedef void (*net_tcp_handler_t)(uint32_t srcIp, const uint8_t* pSrcMac, const uint8_t* pTcp, uint32_t len);
+
+Bool net_init(void);
+Bool net_isUp(void);
+void net_poll(uint32_t now);
+uint8_t* net_udpBegin(void);
+void net_udpSend(uint16_t len);
+void net_setTcpHandler(net_tcp_handler_t handler);
+uint8_t* net_ipBegin(void);
+void net_ipSend(const uint8_t* pDstMac, uint32_t dstIp, uint8_t protocol, uint16_t len);
+uint32_t net_pseudoHeaderSum(uint32_t dstIp, uint8_t protocol, uint16_t len);
+uint32_t net_checksumAdd(uint32_t sum, const uint8_t* pData, uint32_t len);
+uint16_t net_checksumFold(uint32_t sum);
+const net_stats_t* net_getStats(void);
+
+#endif /* NET_H_ */
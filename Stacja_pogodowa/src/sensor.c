@@ -0,0 +1,256 @@
+#include "sensor.h"
+#include "filter.h"
+
+/* Stan pomiaru czujnika w biezacym cyklu */
+#define STATE_IDLE 0
+#define STATE_BUSY 1
+
+/* Czujnik zarejestrowany w tablicy */
+typedef struct
+{
+    const sensor_ops_t* pOps;
+    uint8_t filter;              /* FILTER_xxx lub SENSOR_NO_FILTER */
+    uint8_t state;
+    sensor_sample_t sample;
+} sensor_entry_t;
+
+static sensor_entry_t sensors[SENSOR_MAX];
+static uint32_t sensorCount = 0;
+static Bool cycleActive = FALSE;
+
+/*!
+ *  @brief    Procedura zapisujaca wynik pomiaru: filtracja w jednostkach
+ *            czujnika i przeliczenie do wspolnej skali
+ *  @param    pEntry
+ *              Czujnik
+ *  @param    raw
+ *              Wynik w jednostkach czujnika
+ *  @param    valid
+ *              FALSE po bledzie pomiaru
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana odczytu czujnika i stanu filtru
+ */
+static void complete(sensor_entry_t* pEntry, int32_t raw, Bool valid, uint32_t now)
+{
+    int32_t value = raw;
+    uint32_t rejected = 0;
+    uint8_t status = (valid == TRUE) ? SENSOR_STATUS_OK : SENSOR_STATUS_ERROR;
+
+    if (pEntry->filter != SENSOR_NO_FILTER)
+    {
+        /* Filtr odrzuca takze odczyty spoza zakresu czujnika */
+        rejected = filter_getRejected(pEntry->filter);
+        if (filter_update(pEntry->filter, raw, valid, &value) == FALSE)
+        {
+            status = SENSOR_STATUS_ERROR;
+        }
+        else if (filter_getRejected(pEntry->filter) != rejected)
+        {
+            status = SENSOR_STATUS_HELD;
+        }
+        else
+        {
+            status = SENSOR_STATUS_OK;
+        }
+    }
+
+    pEntry->state = STATE_IDLE;
+    pEntry->sample.time = now;
+    pEntry->sample.status = status;
+    pEntry->sample.value = (status == SENSOR_STATUS_ERROR) ? 0 : (value * pEntry->pOps->scale);
+}
+
+/*!
+ *  @brief    Funkcja dopisujaca czujnik do tablicy czujnikow
+ *  @param    pOps
+ *              Operacje czujnika
+ *  @param    filter
+ *              Filtr odczytow FILTER_xxx lub SENSOR_NO_FILTER
+ *  @returns  Numer czujnika lub -1, gdy tablica jest pelna
+ *  @side_effects:
+ *            Brak
+ */
+int32_t sensor_register(const sensor_ops_t* pOps, uint8_t filter)
+{
+    sensor_entry_t* pEntry = NULL;
+
+    if (sensorCount >= SENSOR_MAX)
+    {
+        return -1;
+    }
+
+    pEntry = &sensors[sensorCount];
+    pEntry->pOps = pOps;
+    pEntry->filter = filter;
+    pEntry->state = STATE_IDLE;
+    pEntry->sample.time = 0;
+    pEntry->sample.value = 0;
+    pEntry->sample.status = SENSOR_STATUS_NONE;
+
+    return (int32_t)sensorCount++;
+}
+
+/*!
+ *  @brief    Getter liczby zarejestrowanych czujnikow
+ *  @param    Brak
+ *  @returns  Liczba czujnikow
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t sensor_getCount(void)
+{
+    return sensorCount;
+}
+
+/*!
+ *  @brief    Getter operacji czujnika
+ *  @param    id
+ *              Numer czujnika
+ *  @returns  Wskaznik na operacje lub NULL dla niepoprawnego numeru
+ *  @side_effects:
+ *            Brak
+ */
+const sensor_ops_t* sensor_getOps(uint32_t id)
+{
+    if (id >= sensorCount)
+    {
+        return NULL;
+    }
+
+    return sensors[id].pOps;
+}
+
+/*!
+ *  @brief    Procedura uruchamiajaca pomiar wszystkich czujnikow. Pomiary
+ *            trwaja rownolegle, czujnik bez zakonczonego poprzedniego
+ *            pomiaru jest uruchamiany od nowa.
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  Nic
+ *  @side_effects:
+ *            Komunikacja z czujnikami
+ */
+void sensor_startCycle(uint32_t now)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < sensorCount; i++)
+    {
+        if (sensors[i].pOps->start(now) == TRUE)
+        {
+            sensors[i].state = STATE_BUSY;
+        }
+        else
+        {
+            complete(&sensors[i], 0, FALSE, now);
+        }
+    }
+
+    cycleActive = TRUE;
+}
+
+/*!
+ *  @brief    Funkcja odpytujaca czujniki z trwajacymi pomiarami, wywolywana
+ *            w kazdym obiegu petli glownej
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  TRUE jeden raz po zakonczeniu pomiarow wszystkich czujnikow
+ *            w cyklu
+ *  @side_effects:
+ *            Zmiana odczytow czujnikow
+ */
+Bool sensor_poll(uint32_t now)
+{
+    sensor_entry_t* pEntry = NULL;
+    Bool busy = FALSE;
+    int32_t status = SENSOR_BUSY;
+    uint32_t i = 0;
+
+    if (cycleActive == FALSE)
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i < sensorCount; i++)
+    {
+        pEntry = &sensors[i];
+        if (pEntry->state != STATE_BUSY)
+        {
+            continue;
+        }
+
+        status = pEntry->pOps->poll(now);
+        if (status == SENSOR_READY)
+        {
+            complete(pEntry, pEntry->pOps->read(), TRUE, now);
+        }
+        else if (status == SENSOR_ERROR)
+        {
+            complete(pEntry, 0, FALSE, now);
+        }
+        else
+        {
+            busy = TRUE;
+        }
+    }
+
+    if (busy == TRUE)
+    {
+        return FALSE;
+    }
+
+    cycleActive = FALSE;
+    return TRUE;
+}
+
+/*!
+ *  @brief    Getter ostatniego odczytu czujnika
+ *  @param    id
+ *              Numer czujnika
+ *  @returns  Wskaznik na odczyt lub NULL dla niepoprawnego numeru
+ *  @side_effects:
+ *            Brak
+ */
+const sensor_sample_t* sensor_getSample(uint32_t id)
+{
+    if (id >= sensorCount)
+    {
+        return NULL;
+    }
+
+    return &sensors[id].sample;
+}
+
+/*!
+ *  @brief    Funkcja odczytujaca wartosc ostatniego odczytu w innej skali.
+ *            Odczyt bez poprawnej wartosci (SENSOR_STATUS_NONE lub
+ *            SENSOR_STATUS_ERROR) nie zmienia *pValue.
+ *  @param    id
+ *              Numer czujnika
+ *  @param    scale
+ *              Skala wyniku, dzielnik SENSOR_SCALE, np. 10 - 0.1 jednostki
+ *  @param    pValue
+ *              Wartosc zaokraglona od zera
+ *  @returns  TRUE dla odczytu z wartoscia (SENSOR_STATUS_OK lub
+ *            SENSOR_STATUS_HELD), FALSE takze dla niepoprawnego numeru
+ *  @side_effects:
+ *            Brak
+ */
+Bool sensor_getValue(uint32_t id, int32_t scale, int32_t* pValue)
+{
+    int32_t divisor = SENSOR_SCALE / scale;
+    int32_t value = 0;
+
+    if ((id >= sensorCount) || (sensors[id].sample.status == SENSOR_STATUS_NONE)
+            || (sensors[id].sample.status == SENSOR_STATUS_ERROR))
+    {
+        return FALSE;
+    }
+
+    value = sensors[id].sample.value;
+    *pValue = (value + ((value >= 0) ? (divisor / 2) : -(divisor / 2))) / divisor;
+    return TRUE;
+}
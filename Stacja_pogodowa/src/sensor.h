@@ -0,0 +1,58 @@
+#ifndef SENSOR_H_
+#define SENSOR_H_
+
+#include "lpc_types.h"
+
+/* Najwieksza liczba zarejestrowanych czujnikow */
+#define SENSOR_MAX 8
+
+/* Wspolna skala wartosci odczytow: 0.001 jednostki (mC, mPa, 0.001 %) */
+#define SENSOR_SCALE 1000
+
+/* Wynik odpytania pomiaru (sensor_ops_t.poll) */
+#define SENSOR_BUSY  0
+#define SENSOR_READY 1
+#define SENSOR_ERROR 2
+
+/* Status odczytu */
+#define SENSOR_STATUS_NONE  0    /* Brak odczytu od startu */
+#define SENSOR_STATUS_OK    1    /* Nowy poprawny odczyt */
+#define SENSOR_STATUS_HELD  2    /* Blad odczytu, wartosc poprzednia z filtru */
+#define SENSOR_STATUS_ERROR 3    /* Brak poprawnej wartosci, value = 0 */
+
+/* Brak filtru odczytow (sensor_register) */
+#define SENSOR_NO_FILTER 0xFF
+
+/*
+ * Operacje czujnika. Pomiar jest uruchamiany przez start, a potem odpytywany
+ * przez poll w kolejnych obiegach petli glownej, az do SENSOR_READY lub
+ * SENSOR_ERROR. Wynik odczytuje read w jednostkach czujnika, ktore po
+ * filtracji sa mnozone przez scale.
+ */
+typedef struct
+{
+    const char* pName;           /* Nazwa w konsoli */
+    const char* pUnit;           /* Jednostka wartosci we wspolnej skali */
+    int32_t scale;               /* Mnoznik z jednostek czujnika do SENSOR_SCALE */
+    Bool (*start)(uint32_t now);
+    int32_t (*poll)(uint32_t now);
+    int32_t (*read)(void);
+} sensor_ops_t;
+
+/* Odczyt czujnika */
+typedef struct
+{
+    uint32_t time;               /* Czas zakonczenia pomiaru [ms] */
+    int32_t value;               /* Wartosc [1 / SENSOR_SCALE jednostki] */
+    uint8_t status;              /* SENSOR_STATUS_xxx */
+} sensor_sample_t;
+
+int32_t sensor_register(const sensor_ops_t* pOps, uint8_t filter);
+uint32_t sensor_getCount(void);
+const sensor_ops_t* sensor_getOps(uint32_t id);
+void sensor_startCycle(uint32_t now);
+Bool sensor_poll(uint32_t now);
+const sensor_sample_t* sensor_getSample(uint32_t id);
+Bool sensor_getValue(uint32_t id, int32_t scale, int32_t* pValue);
+
+#endif /* SENSOR_H_ */
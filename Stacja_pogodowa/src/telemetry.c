@@ -0,0 +1,318 @@
+#include "telemetry.h"
+#include "telemetry_frame.h"
+#include "uart0.h"
+#include "net.h"
+#include "crc.h"
+
+/*
+ * Stan kodera COBS. Ramka jest kodowana w locie bezposrednio do bufora
+ * nadawczego UART0, bajt kodu bloku jest uzupelniany po jego zamknieciu.
+ */
+typedef struct
+{
+    uint32_t codePos;
+    uint8_t code;
+    uint16_t crc;
+} cobs_encoder_t;
+
+/* Liczba odczytow odrzuconych z powodu braku miejsca w buforze nadawczym */
+static uint32_t dropped = 0;
+static uint8_t sequence = 0;
+/* Numer datagramow UDP, odbiorca wykrywa po nim zgubione datagramy niezaleznie od UART */
+static uint8_t udpSequence = 0;
+static Bool enabled = TRUE;
+
+/*!
+ *  @brief    Procedura dopisujaca bajt do ramki
+ *  @param    pEnc
+ *              Stan kodera
+ *  @param    data
+ *              Bajt
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do bufora nadawczego UART0
+ */
+static void framePut(cobs_encoder_t* pEnc, uint8_t data)
+{
+    pEnc->crc = crc16_update(pEnc->crc, &data, 1);
+
+    if (data == 0)
+    {
+        uart0_txSet(pEnc->codePos, pEnc->code);
+        pEnc->codePos = uart0_txPut(0);
+        pEnc->code = 1;
+        return;
+    }
+
+    uart0_txPut(data);
+    pEnc->code++;
+
+    if (pEnc->code == 0xFF)
+    {
+        uart0_txSet(pEnc->codePos, pEnc->code);
+        pEnc->codePos = uart0_txPut(0);
+        pEnc->code = 1;
+    }
+}
+
+/*!
+ *  @brief    Procedura rozpoczynajaca ramke
+ *  @param    pEnc
+ *              Stan kodera
+ *  @param    type
+ *              Typ rekordu
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do bufora nadawczego UART0
+ */
+static void frameBegin(cobs_encoder_t* pEnc, uint8_t type)
+{
+    pEnc->codePos = uart0_txPut(0);
+    pEnc->code = 1;
+    pEnc->crc = CRC16_INIT;
+
+    framePut(pEnc, type);
+    framePut(pEnc, sequence);
+    sequence++;
+}
+
+/*!
+ *  @brief    Procedura dopisujaca do ramki liczbe 16-bitowa
+ *  @param    pEnc
+ *              Stan kodera
+ *  @param    value
+ *              Wartosc
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do bufora nadawczego UART0
+ */
+static void framePutU16(cobs_encoder_t* pEnc, uint16_t value)
+{
+    framePut(pEnc, (uint8_t)value);
+    framePut(pEnc, (uint8_t)(value >> 8));
+}
+
+/*!
+ *  @brief    Procedura dopisujaca do ramki liczbe 32-bitowa
+ *  @param    pEnc
+ *              Stan kodera
+ *  @param    value
+ *              Wartosc
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do bufora nadawczego UART0
+ */
+static void framePutU32(cobs_encoder_t* pEnc, uint32_t value)
+{
+    framePutU16(pEnc, (uint16_t)value);
+    framePutU16(pEnc, (uint16_t)(value >> 16));
+}
+
+/*!
+ *  @brief    Procedura konczaca ramke: dopisuje CRC, zamyka ostatni blok COBS
+ *            i ogranicznik, po czym przekazuje ramke do wyslania
+ *  @param    pEnc
+ *              Stan kodera
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zapis do bufora nadawczego UART0
+ */
+static void frameEnd(cobs_encoder_t* pEnc)
+{
+    uint16_t crc = pEnc->crc;
+
+    framePutU16(pEnc, crc);
+
+    uart0_txSet(pEnc->codePos, pEnc->code);
+    uart0_txPut(0);
+    uart0_txCommit();
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca kanal telemetrii na UART0
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Konfiguracja UART0
+ */
+void telemetry_init(void)
+{
+    uart0_init(TELEMETRY_BAUD_RATE);
+}
+
+/*!
+ *  @brief    Procedura wysylajaca odczyt z czujnikow jako binarna ramke
+ *            TELEMETRY_REC_SAMPLE. Ramka jest kodowana wprost do bufora
+ *            nadawczego, procedura nigdy nie czeka na nadajnik. Gdy ramka
+ *            sie nie miesci, odczyt jest odrzucany w calosci.
+ *  @param    timestamp
+ *              Czas odczytu [ms]
+ *  @param    temperature
+ *              Temperatura [0.1 C]
+ *  @param    pressure
+ *              Cisnienie [Pa]
+ *  @param    humidity
+ *              Wilgotnosc [%]
+ *  @param    pDerived
+ *              Wielkosci pochodne odczytu
+ *  @param    invalid
+ *              Maska METRIC_BIT wielkosci bez poprawnej wartosci
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana licznika odrzuconych odczytow
+ */
+void telemetry_sendSample(uint32_t timestamp, int32_t temperature, int32_t pressure, int16_t humidity,
+        const derived_t* pDerived, uint8_t invalid)
+{
+    cobs_encoder_t enc;
+
+    if (enabled == FALSE)
+    {
+        return;
+    }
+
+    if (uart0_txReserve(TELEMETRY_HEADER_SIZE + TELEMETRY_SAMPLE_SIZE
+            + TELEMETRY_CRC_SIZE + TELEMETRY_COBS_OVERHEAD) == FALSE)
+    {
+        dropped++;
+        return;
+    }
+
+    frameBegin(&enc, TELEMETRY_REC_SAMPLE);
+    framePutU32(&enc, timestamp);
+    framePutU16(&enc, (uint16_t)(int16_t)temperature);
+    framePutU32(&enc, (uint32_t)pressure);
+    framePut(&enc, (uint8_t)humidity);
+    framePutU16(&enc, (uint16_t)pDerived->dewPoint);
+    framePutU16(&enc, pDerived->absHumidity);
+    framePutU16(&enc, (uint16_t)pDerived->heatIndex);
+    framePut(&enc, invalid);
+    frameEnd(&enc);
+}
+
+/*!
+ *  @brief    Procedura wysylajaca odczyt z czujnikow jako datagram UDP do
+ *            odbiorcy z konfiguracji. Rekord ma ten sam uklad co ramka
+ *            szeregowa, ale bez kodowania COBS, i jest budowany wprost w
+ *            buforze nadawczym EMAC. Datagramy maja wlasny numer
+ *            sekwencyjny.
+ *  @param    timestamp
+ *              Czas odczytu [ms]
+ *  @param    temperature
+ *              Temperatura [0.1 C]
+ *  @param    pressure
+ *              Cisnienie [Pa]
+ *  @param    humidity
+ *              Wilgotnosc [%]
+ *  @param    pDerived
+ *              Wielkosci pochodne odczytu
+ *  @param    invalid
+ *              Maska METRIC_BIT wielkosci bez poprawnej wartosci
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyslanie ramki Ethernet
+ */
+void telemetry_sendSampleUdp(uint32_t timestamp, int32_t temperature, int32_t pressure, int16_t humidity,
+        const derived_t* pDerived, uint8_t invalid)
+{
+    uint8_t* pData = net_udpBegin();
+    uint16_t crc = 0;
+
+    if (pData == NULL)
+    {
+        return;
+    }
+
+    pData[0] = TELEMETRY_REC_SAMPLE;
+    pData[1] = udpSequence++;
+    pData[2] = (uint8_t)timestamp;
+    pData[3] = (uint8_t)(timestamp >> 8);
+    pData[4] = (uint8_t)(timestamp >> 16);
+    pData[5] = (uint8_t)(timestamp >> 24);
+    pData[6] = (uint8_t)temperature;
+    pData[7] = (uint8_t)((uint16_t)temperature >> 8);
+    pData[8] = (uint8_t)pressure;
+    pData[9] = (uint8_t)(pressure >> 8);
+    pData[10] = (uint8_t)(pressure >> 16);
+    pData[11] = (uint8_t)(pressure >> 24);
+    pData[12] = (uint8_t)humidity;
+    pData[13] = (uint8_t)pDerived->dewPoint;
+    pData[14] = (uint8_t)((uint16_t)pDerived->dewPoint >> 8);
+    pData[15] = (uint8_t)pDerived->absHumidity;
+    pData[16] = (uint8_t)(pDerived->absHumidity >> 8);
+    pData[17] = (uint8_t)pDerived->heatIndex;
+    pData[18] = (uint8_t)((uint16_t)pDerived->heatIndex >> 8);
+    pData[19] = invalid;
+
+    crc = crc16(pData, TELEMETRY_HEADER_SIZE + TELEMETRY_SAMPLE_SIZE);
+    pData[20] = (uint8_t)crc;
+    pData[21] = (uint8_t)(crc >> 8);
+
+    net_udpSend(TELEMETRY_HEADER_SIZE + TELEMETRY_SAMPLE_SIZE + TELEMETRY_CRC_SIZE);
+}
+
+/*!
+ *  @brief    Funkcja wysylajaca zmiane stanu alarmu jako ramke
+ *            TELEMETRY_REC_ALARM
+ *  @param    rule
+ *              Numer reguly
+ *  @param    active
+ *              TRUE - alarm wlaczony
+ *  @param    metric
+ *              Wielkosc (METRIC_xxx)
+ *  @param    value
+ *              Wartosc w chwili zmiany
+ *  @returns  FALSE jesli strumien jest wylaczony lub brak miejsca w buforze
+ *  @side_effects:
+ *            Zmiana licznika odrzuconych odczytow
+ */
+Bool telemetry_sendAlarm(uint8_t rule, Bool active, uint8_t metric, int32_t value)
+{
+    cobs_encoder_t enc;
+
+    if (enabled == FALSE)
+    {
+        return FALSE;
+    }
+
+    if (uart0_txReserve(TELEMETRY_HEADER_SIZE + TELEMETRY_ALARM_SIZE
+            + TELEMETRY_CRC_SIZE + TELEMETRY_COBS_OVERHEAD) == FALSE)
+    {
+        dropped++;
+        return FALSE;
+    }
+
+    frameBegin(&enc, TELEMETRY_REC_ALARM);
+    framePut(&enc, rule);
+    framePut(&enc, (active == TRUE) ? 1 : 0);
+    framePut(&enc, metric);
+    framePutU32(&enc, (uint32_t)value);
+    frameEnd(&enc);
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Getter licznika odrzuconych odczytow
+ *  @param    Brak
+ *  @returns  Liczba odrzuconych odczytow
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t telemetry_getDropped(void)
+{
+    return dropped;
+}
+
+/*!
+ *  @brief    Setter wlaczajacy lub wylaczajacy wysylanie odczytow
+ *  @param    state
+ *              TRUE - odczyty sa wysylane
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void telemetry_setEnabled(Bool state)
+{
+    enabled = state;
+}
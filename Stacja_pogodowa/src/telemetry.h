@@ -0,0 +1,18 @@
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "lpc_types.h"
+#include "derived.h"
+
+#define TELEMETRY_BAUD_RATE 115200
+
+void telemetry_init(void);
+void telemetry_sendSample(uint32_t timestamp, int32_t temperature, int32_t pressure, int16_t humidity,
+        const derived_t* pDerived, uint8_t invalid);
+void telemetry_sendSampleUdp(uint32_t timestamp, int32_t temperature, int32_t pressure, int16_t humidity,
+        const derived_t* pDerived, uint8_t invalid);
+Bool telemetry_sendAlarm(uint8_t rule, Bool active, uint8_t metric, int32_t value);
+uint32_t telemetry_getDropped(void);
+void telemetry_setEnabled(Bool state);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,61 @@
+#ifndef TELEMETRY_FRAME_H_
+#define TELEMETRY_FRAME_H_
+
+/*
+ * Format binarnej ramki telemetrii, wspolny dla stacji i dekodera na PC
+ * (tools/telemetry_decode.c).
+ *
+ * Ramka przed zakodowaniem (wszystkie pola little-endian):
+ *   typ rekordu (1 B), numer sekwencyjny (1 B), pola rekordu, CRC-16/CCITT
+ *   (2 B) liczone z typu, numeru i pol rekordu.
+ * Ramka jest kodowana algorytmem COBS i zakonczona bajtem 0x00.
+ * Datagramy UDP (port NET_UDP_LOCAL_PORT) zawieraja jedna ramke bez
+ * kodowania COBS.
+ */
+
+#define TELEMETRY_REC_SAMPLE 0x01
+#define TELEMETRY_REC_EXPORT 0x02
+#define TELEMETRY_REC_ALARM  0x03
+
+/*
+ * Rekord TELEMETRY_REC_SAMPLE:
+ *   czas [ms] (uint32), temperatura [0.1 C] (int16),
+ *   cisnienie [Pa] (uint32), wilgotnosc [%] (uint8),
+ *   punkt rosy [0.1 C] (int16), wilgotnosc bezwzgledna [0.01 g/m3] (uint16),
+ *   wskaznik upalu [0.1 C] (int16), maska pol bez poprawnej wartosci (uint8)
+ */
+#define TELEMETRY_SAMPLE_SIZE 18
+
+/*
+ * Bity maski pol bez poprawnej wartosci (rowne METRIC_BIT z src/metric.h),
+ * takze w rekordach dziennika. Wartosc takiego pola nalezy pominac.
+ */
+#define TELEMETRY_INVALID_TEMPERATURE 0x02
+#define TELEMETRY_INVALID_PRESSURE    0x04
+#define TELEMETRY_INVALID_HUMIDITY    0x08
+#define TELEMETRY_INVALID_DEW_POINT   0x10   /* Takze wilgotnosc bezwzgledna */
+#define TELEMETRY_INVALID_HEAT_INDEX  0x20
+#define TELEMETRY_INVALID_LIGHT       0x40
+
+/*
+ * Rekord TELEMETRY_REC_EXPORT (jedna strona dziennika):
+ *   numer strony od najstarszej (uint32), liczba stron (uint32),
+ *   dlugosc danych (uint16), surowa strona dziennika.
+ * Rekord z dlugoscia 0 i numerem rownym liczbie stron konczy eksport.
+ */
+#define TELEMETRY_EXPORT_SIZE 10
+
+/*
+ * Rekord TELEMETRY_REC_ALARM (zmiana stanu alarmu):
+ *   numer reguly (uint8), stan 1 - wlaczony, 0 - wylaczony (uint8),
+ *   wielkosc METRIC_xxx (uint8), wartosc (int32)
+ */
+#define TELEMETRY_ALARM_SIZE 7
+
+#define TELEMETRY_HEADER_SIZE 2
+#define TELEMETRY_CRC_SIZE    2
+
+/* Maksymalny narzut COBS dla ramek krotszych niz 254 bajty i ogranicznik */
+#define TELEMETRY_COBS_OVERHEAD 2
+
+#endif /* TELEMETRY_FRAME_H_ */
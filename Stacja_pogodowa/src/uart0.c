@@ -0,0 +1,362 @@
+#include "lpc17xx_pinsel.h"
+#include "lpc17xx_uart.h"
+
+#include "uart0.h"
+
+#define UARTDEV ((LPC_UART_TypeDef *)LPC_UART0)
+
+#define UART0_FIFO_SIZE 16
+
+#define TX_MASK (UART0_TX_RING_SIZE - 1)
+#define RX_MASK (UART0_RX_RING_SIZE - 1)
+
+/*
+ * Bufory cykliczne. Bufor nadawczy jest zapelniany w petli glownej i
+ * oprozniany w przerwaniu THRE, bufor odbiorczy odwrotnie. Kazdy indeks
+ * jest modyfikowany tylko po jednej stronie.
+ */
+static uint8_t txRing[UART0_TX_RING_SIZE];
+static uint8_t rxRing[UART0_RX_RING_SIZE];
+static volatile uint32_t txHead = 0;
+static volatile uint32_t txTail = 0;
+static volatile uint32_t rxHead = 0;
+static volatile uint32_t rxTail = 0;
+
+/* Indeks zapisu w trakcie skladania ramki bezposrednio w buforze nadawczym */
+static uint32_t txStage = 0;
+
+static uart0_stats_t stats;
+
+/* Nadajnik zasilany przez GPDMA, bufor nadawczy jest wtedy wstrzymany */
+static Bool txDma = FALSE;
+
+/*!
+ *  @brief    Procedura przepisujaca dane z bufora nadawczego do kolejki FIFO
+ *            nadajnika. Wywolywana gdy kolejka FIFO jest pusta.
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana indeksu txTail
+ */
+static void fillTxFifo(void)
+{
+    uint32_t tail = txTail;
+    uint32_t count = 0;
+
+    while ((tail != txHead) && (count < UART0_FIFO_SIZE))
+    {
+        UARTDEV->THR = txRing[tail & TX_MASK];
+        tail++;
+        count++;
+    }
+
+    txTail = tail;
+    stats.txBytes += count;
+}
+
+/*!
+ *  @brief    Procedura uruchamiajaca nadawanie, gdy nadajnik jest bezczynny i
+ *            przerwanie THRE nie nadejdzie samo
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana indeksu txTail
+ */
+static void startTx(void)
+{
+    if (txDma == TRUE)
+    {
+        return;
+    }
+
+    UART_IntConfig(UARTDEV, UART_INTCFG_THRE, DISABLE);
+    if (UARTDEV->LSR & UART_LSR_THRE)
+    {
+        fillTxFifo();
+    }
+    UART_IntConfig(UARTDEV, UART_INTCFG_THRE, ENABLE);
+}
+
+/*!
+ *  @brief    Procedura obslugi przerwania UART0
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana indeksow buforow cyklicznych i licznikow
+ */
+void UART0_IRQHandler(void)
+{
+    uint32_t intId = UART_GetIntId(UARTDEV) & UART_IIR_INTID_MASK;
+    uint8_t lineStatus = 0;
+
+    if (intId == UART_IIR_INTID_RLS)
+    {
+        lineStatus = UART_GetLineStatus(UARTDEV);
+        if (lineStatus & (UART_LSR_OE | UART_LSR_PE | UART_LSR_FE | UART_LSR_BI | UART_LSR_RXFE))
+        {
+            stats.rxErrors++;
+        }
+    }
+
+    if ((intId == UART_IIR_INTID_RDA) || (intId == UART_IIR_INTID_CTI) || (intId == UART_IIR_INTID_RLS))
+    {
+        while (UARTDEV->LSR & UART_LSR_RDR)
+        {
+            uint8_t data = UARTDEV->RBR;
+
+            if ((rxHead - rxTail) < UART0_RX_RING_SIZE)
+            {
+                rxRing[rxHead & RX_MASK] = data;
+                rxHead++;
+                stats.rxBytes++;
+            }
+            else
+            {
+                stats.rxDropped++;
+            }
+        }
+    }
+
+    if (intId == UART_IIR_INTID_THRE)
+    {
+        fillTxFifo();
+    }
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca UART0 (P0.2 - TXD, P0.3 - RXD) w trybie
+ *            przerwaniowym
+ *  @param    baudRate
+ *              Predkosc transmisji
+ *  @returns  Nic
+ *  @side_effects:
+ *            Konfiguracja pinow, rejestrow UART0 i kontrolera NVIC
+ */
+void uart0_init(uint32_t baudRate)
+{
+    PINSEL_CFG_Type PinCfg;
+    UART_CFG_Type uartCfg;
+    UART_FIFO_CFG_Type fifoCfg;
+
+    PinCfg.Funcnum = 1;
+    PinCfg.OpenDrain = 0;
+    PinCfg.Pinmode = 0;
+    PinCfg.Portnum = 0;
+    PinCfg.Pinnum = 2;
+    PINSEL_ConfigPin(&PinCfg);
+    PinCfg.Pinnum = 3;
+    PINSEL_ConfigPin(&PinCfg);
+
+    UART_ConfigStructInit(&uartCfg);
+    uartCfg.Baud_rate = baudRate;
+    UART_Init(UARTDEV, &uartCfg);
+
+    UART_FIFOConfigStructInit(&fifoCfg);
+    fifoCfg.FIFO_Level = UART_FIFO_TRGLEV2;
+    UART_FIFOConfig(UARTDEV, &fifoCfg);
+
+    UART_TxCmd(UARTDEV, ENABLE);
+
+    UART_IntConfig(UARTDEV, UART_INTCFG_RBR, ENABLE);
+    UART_IntConfig(UARTDEV, UART_INTCFG_RLS, ENABLE);
+    UART_IntConfig(UARTDEV, UART_INTCFG_THRE, ENABLE);
+
+    NVIC_SetPriority(UART0_IRQn, 2);
+    NVIC_EnableIRQ(UART0_IRQn);
+}
+
+/*!
+ *  @brief    Funkcja wstawiajaca dane do bufora nadawczego. Nigdy nie czeka na
+ *            nadajnik, dane ktore sie nie mieszcza sa odrzucane.
+ *  @param    pData
+ *              Dane do wyslania
+ *  @param    len
+ *              Liczba bajtow
+ *  @returns  Liczba bajtow przyjetych do wyslania
+ *  @side_effects:
+ *            Zmiana indeksu txHead i licznikow
+ */
+uint32_t uart0_write(const uint8_t* pData, uint32_t len)
+{
+    uint32_t head = txHead;
+    uint32_t count = 0;
+
+    while ((count < len) && ((head - txTail) < UART0_TX_RING_SIZE))
+    {
+        txRing[head & TX_MASK] = pData[count];
+        head++;
+        count++;
+    }
+
+    txHead = head;
+    stats.txDropped += len - count;
+
+    startTx();
+
+    return count;
+}
+
+/*!
+ *  @brief    Funkcja rozpoczynajaca skladanie danych bezposrednio w buforze
+ *            nadawczym (bez kopii posredniej). Dane sa wysylane dopiero po
+ *            wywolaniu uart0_txCommit.
+ *  @param    len
+ *              Maksymalna liczba bajtow, ktora zostanie wstawiona
+ *  @returns  TRUE jesli w buforze jest wystarczajaco miejsca
+ *  @side_effects:
+ *            Zmiana indeksu txStage
+ */
+Bool uart0_txReserve(uint32_t len)
+{
+    if (uart0_txFree() < len)
+    {
+        stats.txDropped += len;
+        return FALSE;
+    }
+
+    txStage = txHead;
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Funkcja wstawiajaca bajt do zarezerwowanego obszaru bufora
+ *  @param    data
+ *              Bajt
+ *  @returns  Pozycja bajtu w buforze, do uzycia w uart0_txSet
+ *  @side_effects:
+ *            Zmiana indeksu txStage
+ */
+uint32_t uart0_txPut(uint8_t data)
+{
+    uint32_t pos = txStage;
+
+    txRing[pos & TX_MASK] = data;
+    txStage++;
+
+    return pos;
+}
+
+/*!
+ *  @brief    Procedura nadpisujaca wczesniej wstawiony, jeszcze nie wyslany bajt
+ *  @param    pos
+ *              Pozycja zwrocona przez uart0_txPut
+ *  @param    data
+ *              Bajt
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void uart0_txSet(uint32_t pos, uint8_t data)
+{
+    txRing[pos & TX_MASK] = data;
+}
+
+/*!
+ *  @brief    Procedura konczaca skladanie danych i przekazujaca je do wyslania
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana indeksu txHead
+ */
+void uart0_txCommit(void)
+{
+    txHead = txStage;
+
+    startTx();
+}
+
+/*!
+ *  @brief    Funkcja pobierajaca odebrane dane z bufora odbiorczego
+ *  @param    pData
+ *              Bufor na dane
+ *  @param    len
+ *              Rozmiar bufora
+ *  @returns  Liczba odczytanych bajtow, 0 gdy brak danych
+ *  @side_effects:
+ *            Zmiana indeksu rxTail
+ */
+uint32_t uart0_read(uint8_t* pData, uint32_t len)
+{
+    uint32_t tail = rxTail;
+    uint32_t count = 0;
+
+    while ((count < len) && (tail != rxHead))
+    {
+        pData[count] = rxRing[tail & RX_MASK];
+        tail++;
+        count++;
+    }
+
+    rxTail = tail;
+
+    return count;
+}
+
+/*!
+ *  @brief    Funkcja zwracajaca ilosc wolnego miejsca w buforze nadawczym
+ *  @param    Brak
+ *  @returns  Liczba bajtow
+ *  @side_effects:
+ *            Brak
+ */
+uint32_t uart0_txFree(void)
+{
+    return UART0_TX_RING_SIZE - (txHead - txTail);
+}
+
+/*!
+ *  @brief    Funkcja sprawdzajaca czy nadajnik skonczyl wysylac wszystkie dane
+ *  @param    Brak
+ *  @returns  TRUE jesli bufor nadawczy i nadajnik sa puste
+ *  @side_effects:
+ *            Brak
+ */
+Bool uart0_txIdle(void)
+{
+    return ((txHead == txTail) && (UARTDEV->LSR & UART_LSR_TEMT)) ? TRUE : FALSE;
+}
+
+/*!
+ *  @brief    Procedura przelaczajaca nadajnik miedzy buforem nadawczym a GPDMA.
+ *            W trybie DMA przerwanie THRE jest wylaczone, a dane wstawiane do
+ *            bufora nadawczego czekaja na powrot do trybu przerwaniowego.
+ *  @param    state
+ *              TRUE - nadajnik zasilany przez GPDMA
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana konfiguracji FIFO i przerwan UART0
+ */
+void uart0_setTxDma(Bool state)
+{
+    UART_FIFO_CFG_Type fifoCfg;
+
+    UART_IntConfig(UARTDEV, UART_INTCFG_THRE, DISABLE);
+
+    UART_FIFOConfigStructInit(&fifoCfg);
+    fifoCfg.FIFO_ResetRxBuf = DISABLE;
+    fifoCfg.FIFO_ResetTxBuf = DISABLE;
+    fifoCfg.FIFO_Level = UART_FIFO_TRGLEV2;
+    fifoCfg.FIFO_DMAMode = (state == TRUE) ? ENABLE : DISABLE;
+    UART_FIFOConfig(UARTDEV, &fifoCfg);
+
+    txDma = state;
+
+    if (state == FALSE)
+    {
+        UART_IntConfig(UARTDEV, UART_INTCFG_THRE, ENABLE);
+        startTx();
+    }
+}
+
+/*!
+ *  @brief    Getter licznikow diagnostycznych
+ *  @param    Brak
+ *  @returns  Wskaznik na liczniki
+ *  @side_effects:
+ *            Brak
+ */
+const uart0_stats_t* uart0_getStats(void)
+{
+    return &stats;
+}
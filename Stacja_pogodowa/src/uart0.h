@@ -0,0 +1,32 @@
+#ifndef UART0_H_
+#define UART0_H_
+
+#include "lpc_types.h"
+
+/* Rozmiary buforow cyklicznych, musza byc potegami dwojki */
+#define UART0_TX_RING_SIZE 1024
+#define UART0_RX_RING_SIZE 256
+
+/* Liczniki diagnostyczne portu UART0 */
+typedef struct
+{
+    uint32_t txBytes;
+    uint32_t txDropped;
+    uint32_t rxBytes;
+    uint32_t rxDropped;
+    uint32_t rxErrors;
+} uart0_stats_t;
+
+void uart0_init(uint32_t baudRate);
+uint32_t uart0_write(const uint8_t* pData, uint32_t len);
+Bool uart0_txReserve(uint32_t len);
+uint32_t uart0_txPut(uint8_t data);
+void uart0_txSet(uint32_t pos, uint8_t data);
+void uart0_txCommit(void);
+uint32_t uart0_read(uint8_t* pData, uint32_t len);
+uint32_t uart0_txFree(void);
+Bool uart0_txIdle(void);
+void uart0_setTxDma(Bool state);
+const uart0_stats_t* uart0_getStats(void);
+
+#endif /* UART0_H_ */
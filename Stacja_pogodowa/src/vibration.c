@@ -0,0 +1,473 @@
+#include <string.h>
+
+#include "lpc_types.h"
+#include "acc.h"
+
+#include "vibration.h"
+#include "config.h"
+
+/*
+ * Wyjscie INT1 MMA7455 nie jest doprowadzone do wolnego pinu kontrolera
+ * (P2.2 to wybor ukladu SSP1 wyswietlacza i pamieci DataFlash, zajmowany
+ * przez spibus). Zatrzasniety stan INT1 jest odczytywany z rejestru zrodla
+ * detekcji przez I2C co VIBRATION_POLL_MS - prog porownuje czujnik, flaga
+ * trzyma zdarzenie do skasowania, wiec zadne nie jest gubione.
+ */
+#define VIBRATION_POLL_MS 100
+
+/* Ponowna proba uruchomienia czujnika po bledzie komunikacji [ms] */
+#define VIBRATION_RETRY_MS (10UL * 1000UL)
+
+#define VIBRATION_AXES 3
+
+/*
+ * Przeliczenie kwadratu odchylenia na mg. Probki sa w zakresie 2g (64 na
+ * 1 g), sumy odchylen sa liczone dla VIBRATION_WINDOW-krotnosci probek, wiec
+ * mg^2 = v * (1000 / 64)^2 / N^2 = v * 15625 / (64 * N^2).
+ */
+#define VIBRATION_MG2_NUM 15625ULL
+#define VIBRATION_MG2_DEN (64ULL * VIBRATION_WINDOW * VIBRATION_WINDOW)
+
+/* Stan monitora */
+#define STATE_DISABLED 0
+#define STATE_OFF      1         /* Oczekiwanie na ponowna probe po bledzie */
+#define STATE_START    2         /* Pomiar polozenia spoczynkowego w nastepnym obiegu */
+#define STATE_CAPTURE  3
+#define STATE_ARMED    4         /* Detekcja poziomu, oczekiwanie na flage INT1 */
+
+static uint8_t state = STATE_DISABLED;
+static uint8_t level = 0;
+static uint16_t tamperPeak = 0;
+static uint32_t pollTime = 0;
+static uint32_t retryTime = 0;
+
+/* Osie zatrzasnietej detekcji poziomu, ktora uruchomila zbieranie okna */
+static uint8_t detectAxes = 0;
+
+/* Okno probek */
+static int8_t samples[VIBRATION_WINDOW][VIBRATION_AXES];
+static uint32_t sampleCount = 0;
+static uint32_t sampleTime = 0;
+static Bool captureRest = FALSE;
+
+/* Polozenie spoczynkowe jako suma probek okna */
+static int32_t restSum[VIBRATION_AXES];
+
+static vibration_result_t last;
+static Bool lastValid = FALSE;
+static vibration_stats_t stats;
+
+/*!
+ *  @brief    Funkcja liczaca calkowity pierwiastek kwadratowy
+ *  @param    value
+ *              Liczba
+ *  @returns  Czesc calkowita pierwiastka
+ *  @side_effects:
+ *            Brak
+ */
+static uint32_t isqrt(uint32_t value)
+{
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+
+    while (bit != 0)
+    {
+        if (value >= (result + bit))
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return result;
+}
+
+/*!
+ *  @brief    Funkcja przeliczajaca sume kwadratow odchylen na mg
+ *  @param    value
+ *              Suma kwadratow odchylen w jednostkach zakresu 2g,
+ *              pomnozona przez VIBRATION_WINDOW^2
+ *  @returns  Odchylenie [mg]
+ *  @side_effects:
+ *            Brak
+ */
+static uint16_t toMg(uint32_t value)
+{
+    return (uint16_t)isqrt((uint32_t)(((uint64_t)value * VIBRATION_MG2_NUM) / VIBRATION_MG2_DEN));
+}
+
+/*!
+ *  @brief    Procedura uruchamiajaca zbieranie okna probek w trybie pomiaru
+ *  @param    rest
+ *              TRUE - pomiar polozenia spoczynkowego
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana trybu czujnika
+ */
+static void startCapture(Bool rest, uint32_t now)
+{
+    acc_setMode(ACC_MODE_MEASURE);
+    captureRest = rest;
+    sampleCount = 0;
+    sampleTime = now - VIBRATION_SAMPLE_MS;
+    state = STATE_CAPTURE;
+}
+
+/*!
+ *  @brief    Procedura wlaczajaca detekcje poziomu. Os, na ktora dziala
+ *            grawitacja w polozeniu spoczynkowym, jest wylaczona z detekcji,
+ *            bo prog jest porownywany z wartoscia bezwzgledna.
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana trybu czujnika, skasowanie flagi INT1
+ */
+static void arm(uint32_t now)
+{
+    static const uint8_t axisMask[VIBRATION_AXES] = { ACC_DETECT_X, ACC_DETECT_Y, ACC_DETECT_Z };
+    uint32_t gravity = 0;
+    uint32_t i = 0;
+
+    for (i = 1; i < VIBRATION_AXES; i++)
+    {
+        if (((restSum[i] < 0) ? -restSum[i] : restSum[i])
+                > ((restSum[gravity] < 0) ? -restSum[gravity] : restSum[gravity]))
+        {
+            gravity = i;
+        }
+    }
+
+    acc_setLevelDetection(level, (uint8_t)((ACC_DETECT_X | ACC_DETECT_Y | ACC_DETECT_Z) & ~axisMask[gravity]));
+    acc_setMode(ACC_MODE_LEVEL);
+
+    acc_clearInterrupts();
+    pollTime = now;
+    state = STATE_ARMED;
+}
+
+/*!
+ *  @brief    Funkcja zamieniajaca bity LDx rejestru zrodla detekcji na maske
+ *            osi ACC_DETECT_xxx
+ *  @param    source
+ *              Rejestr zrodla detekcji
+ *  @returns  Maska osi
+ *  @side_effects:
+ *            Brak
+ */
+static uint8_t toAxes(uint8_t source)
+{
+    uint8_t axes = 0;
+
+    if ((source & ACC_DETSRC_LDX) != 0)
+    {
+        axes |= ACC_DETECT_X;
+    }
+    if ((source & ACC_DETSRC_LDY) != 0)
+    {
+        axes |= ACC_DETECT_Y;
+    }
+    if ((source & ACC_DETSRC_LDZ) != 0)
+    {
+        axes |= ACC_DETECT_Z;
+    }
+
+    return axes;
+}
+
+/*!
+ *  @brief    Procedura analizujaca pelne okno probek: wartosc skuteczna drgan
+ *            wokol sredniej okna, najwieksze odchylenie i przesuniecie
+ *            sredniej od polozenia spoczynkowego. Rachunek na sumach, bez
+ *            dzielenia przed pierwiastkiem. Zatrzasnieta detekcja poziomu
+ *            jest dowodem odchylenia co najmniej o prog detekcji - gdy okno
+ *            go nie pokazuje, uderzenie skonczylo sie przed startem okna i
+ *            jest liczone jako sabotaz.
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana wyniku, polozenia spoczynkowego i licznikow
+ */
+static void analyse(uint32_t now)
+{
+    int32_t sum[VIBRATION_AXES] = { 0, 0, 0 };
+    int32_t sumSq[VIBRATION_AXES] = { 0, 0, 0 };
+    uint32_t variance = 0;
+    uint32_t peak = 0;
+    uint32_t tilt = 0;
+    uint32_t deviation = 0;
+    uint16_t levelMg = (uint16_t)((level * 1000U) / 16U);
+    Bool missed = FALSE;
+    int32_t d = 0;
+    uint32_t i = 0;
+    uint32_t a = 0;
+
+    for (i = 0; i < VIBRATION_WINDOW; i++)
+    {
+        for (a = 0; a < VIBRATION_AXES; a++)
+        {
+            sum[a] += samples[i][a];
+            sumSq[a] += (int32_t)samples[i][a] * samples[i][a];
+        }
+    }
+
+    if (captureRest == TRUE)
+    {
+        memcpy(restSum, sum, sizeof(restSum));
+        return;
+    }
+
+    for (i = 0; i < VIBRATION_WINDOW; i++)
+    {
+        deviation = 0;
+        for (a = 0; a < VIBRATION_AXES; a++)
+        {
+            d = VIBRATION_WINDOW * samples[i][a] - restSum[a];
+            deviation += (uint32_t)(d * d);
+        }
+        if (deviation > peak)
+        {
+            peak = deviation;
+        }
+    }
+
+    for (a = 0; a < VIBRATION_AXES; a++)
+    {
+        variance += (uint32_t)(VIBRATION_WINDOW * sumSq[a] - sum[a] * sum[a]);
+        d = sum[a] - restSum[a];
+        tilt += (uint32_t)(d * d);
+    }
+
+    last.time = now;
+    last.rms = toMg(variance);
+    last.peak = toMg(peak);
+    last.tilt = toMg(tilt);
+    last.axes = detectAxes;
+    if ((detectAxes != 0) && (last.peak < levelMg))
+    {
+        last.peak = levelMg;
+        missed = TRUE;
+    }
+    last.tamper = ((last.peak > tamperPeak) || (missed == TRUE)) ? TRUE : FALSE;
+    lastValid = TRUE;
+    stats.windows++;
+
+    /* Spokojne okno przesuwa polozenie spoczynkowe (dryf, osiadanie masztu) */
+    if (last.tamper == TRUE)
+    {
+        stats.tamperEvents++;
+    }
+    else
+    {
+        memcpy(restSum, sum, sizeof(restSum));
+    }
+}
+
+/*!
+ *  @brief    Procedura inicjalizujaca monitor drgan z konfiguracji
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Komunikacja z czujnikiem przez I2C
+ */
+void vibration_init(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    memset(restSum, 0, sizeof(restSum));
+    lastValid = FALSE;
+
+    acc_init();
+
+    if (vibration_configure(config_get()->vibrationLevel, config_get()->tamperPeak) == FALSE)
+    {
+        vibration_configure(0, 0);
+    }
+}
+
+/*!
+ *  @brief    Funkcja ustawiajaca progi monitora drgan
+ *  @param    newLevel
+ *              Prog detekcji poziomu budzacy analize [1/16 g],
+ *              0 - monitor wylaczony, czujnik w trybie czuwania
+ *  @param    peak
+ *              Odchylenie od polozenia spoczynkowego, powyzej ktorego
+ *              zdarzenie jest sabotazem [mg]
+ *  @returns  FALSE dla progu wiekszego niz VIBRATION_LEVEL_MAX
+ *  @side_effects:
+ *            Ponowny pomiar polozenia spoczynkowego
+ */
+Bool vibration_configure(uint8_t newLevel, uint16_t peak)
+{
+    if (newLevel > VIBRATION_LEVEL_MAX)
+    {
+        return FALSE;
+    }
+
+    level = newLevel;
+    tamperPeak = peak;
+
+    if (level == 0)
+    {
+        acc_setMode(ACC_MODE_STANDBY);
+        state = STATE_DISABLED;
+    }
+    else
+    {
+        state = STATE_START;
+    }
+
+    return TRUE;
+}
+
+/*!
+ *  @brief    Procedura zlecajaca ponowny pomiar polozenia spoczynkowego,
+ *            np. po ustawieniu masztu
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana stanu monitora
+ */
+void vibration_setRest(void)
+{
+    if (state != STATE_DISABLED)
+    {
+        state = STATE_START;
+    }
+}
+
+/*!
+ *  @brief    Procedura prowadzaca monitor drgan, wywolywana w kazdym obiegu
+ *            petli glownej. Probki sa odczytywane tylko przez czas jednego
+ *            okna po detekcji poziomu, poza oknem co VIBRATION_POLL_MS
+ *            odczytywany jest jeden rejestr czujnika.
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  Nic
+ *  @side_effects:
+ *            Komunikacja z czujnikiem, zmiana wyniku
+ */
+void vibration_process(uint32_t now)
+{
+    uint8_t source = 0;
+
+    switch (state)
+    {
+    case STATE_OFF:
+        if ((now - retryTime) >= VIBRATION_RETRY_MS)
+        {
+            acc_init();
+            startCapture(TRUE, now);
+        }
+        break;
+
+    case STATE_START:
+        startCapture(TRUE, now);
+        break;
+
+    case STATE_ARMED:
+        if ((now - pollTime) < VIBRATION_POLL_MS)
+        {
+            break;
+        }
+        pollTime = now;
+
+        if (acc_getDetectionSource(&source) != 0)
+        {
+            stats.busErrors++;
+            retryTime = now;
+            state = STATE_OFF;
+            break;
+        }
+
+        if ((source & ACC_DETSRC_INT1) != 0)
+        {
+            stats.detections++;
+            detectAxes = toAxes(source);
+            startCapture(FALSE, now);
+        }
+        break;
+
+    case STATE_CAPTURE:
+        if ((now - sampleTime) < VIBRATION_SAMPLE_MS)
+        {
+            break;
+        }
+        sampleTime = now;
+
+        if (acc_readBurst(&samples[sampleCount][0], &samples[sampleCount][1],
+                &samples[sampleCount][2]) != 0)
+        {
+            stats.busErrors++;
+            retryTime = now;
+            state = STATE_OFF;
+            break;
+        }
+
+        sampleCount++;
+        if (sampleCount == VIBRATION_WINDOW)
+        {
+            analyse(now);
+            arm(now);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/*!
+ *  @brief    Funkcja zwracajaca szczyt ostatniego zdarzenia jako wartosc
+ *            wielkosci METRIC_VIBRATION
+ *  @param    now
+ *              Aktualny czas [ms]
+ *  @returns  Szczyt [mg] przez VIBRATION_HOLD_MS od zdarzenia, potem 0
+ *  @side_effects:
+ *            Brak
+ */
+int32_t vibration_getPeak(uint32_t now)
+{
+    if ((lastValid == FALSE) || ((now - last.time) >= VIBRATION_HOLD_MS))
+    {
+        return 0;
+    }
+
+    return last.peak;
+}
+
+/*!
+ *  @brief    Getter wyniku ostatniego zdarzenia
+ *  @param    Brak
+ *  @returns  Wskaznik na wynik lub NULL, gdy nie bylo zdarzenia
+ *  @side_effects:
+ *            Brak
+ */
+const vibration_result_t* vibration_getLast(void)
+{
+    return (lastValid == TRUE) ? &last : NULL;
+}
+
+/*!
+ *  @brief    Getter licznikow diagnostycznych
+ *  @param    Brak
+ *  @returns  Wskaznik na liczniki
+ *  @side_effects:
+ *            Brak
+ */
+const vibration_stats_t* vibration_getStats(void)
+{
+    return &stats;
+}
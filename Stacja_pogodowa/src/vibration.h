@@ -0,0 +1,44 @@
+#ifndef VIBRATION_H_
+#define VIBRATION_H_
+
+#include "lpc_types.h"
+
+/* Liczba probek okna analizy drgan (okres probkowania VIBRATION_SAMPLE_MS) */
+#define VIBRATION_WINDOW    64
+#define VIBRATION_SAMPLE_MS 8
+
+/* Najwiekszy prog detekcji poziomu MMA7455 [1/16 g] */
+#define VIBRATION_LEVEL_MAX 127
+
+/* Czas, przez ktory szczyt ostatniego zdarzenia jest wartoscia wielkosci [ms] */
+#define VIBRATION_HOLD_MS (10UL * 1000UL)
+
+/* Wynik analizy okna probek */
+typedef struct
+{
+    uint32_t time;               /* Koniec okna [ms] */
+    uint16_t rms;                /* Wartosc skuteczna drgan wokol sredniej okna [mg] */
+    uint16_t peak;               /* Najwieksze odchylenie od polozenia spoczynkowego [mg] */
+    uint16_t tilt;               /* Przesuniecie sredniej okna od polozenia spoczynkowego [mg] */
+    uint8_t axes;                /* Osie, ktore przekroczyly prog detekcji poziomu (ACC_DETECT_xxx) */
+    Bool tamper;                 /* Szczyt powyzej progu sabotazu lub uderzenie krotsze niz start okna */
+} vibration_result_t;
+
+/* Liczniki diagnostyczne */
+typedef struct
+{
+    uint32_t detections;         /* Zdarzenia detekcji poziomu */
+    uint32_t windows;            /* Przeanalizowane okna */
+    uint32_t tamperEvents;
+    uint32_t busErrors;
+} vibration_stats_t;
+
+void vibration_init(void);
+Bool vibration_configure(uint8_t level, uint16_t tamperPeak);
+void vibration_setRest(void);
+void vibration_process(uint32_t now);
+int32_t vibration_getPeak(uint32_t now);
+const vibration_result_t* vibration_getLast(void);
+const vibration_stats_t* vibration_getStats(void);
+
+#endif /* VIBRATION_H_ */
@@ -0,0 +1,223 @@
+#include "window.h"
+
+/* Okna kolejnych wielkosci (bez METRIC_NONE) */
+static window_t windows[METRIC_COUNT - 1];
+
+/* Sumy i liczby poprawnych odczytow z biezacego przedzialu */
+static int32_t accSum[METRIC_COUNT - 1];
+static uint32_t accCount[METRIC_COUNT - 1];
+static uint32_t intervalStart = 0;
+static Bool started = FALSE;
+
+/*!
+ *  @brief    Procedura inicjalizujaca puste okno
+ *  @param    pWindow
+ *              Okno
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void window_init(window_t* pWindow)
+{
+    pWindow->minHead = 0;
+    pWindow->minCount = 0;
+    pWindow->maxHead = 0;
+    pWindow->maxCount = 0;
+    pWindow->next = 0;
+    pWindow->count = 0;
+    pWindow->sum = 0;
+}
+
+/*!
+ *  @brief    Procedura dopisujaca wartosc do okna, najstarsza wartosc jest
+ *            usuwana z pelnego okna. Koszt zamortyzowany O(1): kazdy indeks
+ *            trafia do kolejki i jest z niej usuwany co najwyzej raz.
+ *  @param    pWindow
+ *              Okno
+ *  @param    value
+ *              Wartosc
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void window_push(window_t* pWindow, int32_t value)
+{
+    uint16_t index = pWindow->next;
+    uint16_t back = 0;
+
+    if (pWindow->count == WINDOW_SIZE)
+    {
+        /* Usuwana wartosc jest najstarsza, wiec moze byc tylko na poczatku kolejek */
+        if ((pWindow->minCount != 0) && (pWindow->minQueue[pWindow->minHead] == index))
+        {
+            pWindow->minHead = (uint16_t)((pWindow->minHead + 1) % WINDOW_SIZE);
+            pWindow->minCount--;
+        }
+        if ((pWindow->maxCount != 0) && (pWindow->maxQueue[pWindow->maxHead] == index))
+        {
+            pWindow->maxHead = (uint16_t)((pWindow->maxHead + 1) % WINDOW_SIZE);
+            pWindow->maxCount--;
+        }
+        pWindow->sum -= pWindow->values[index];
+    }
+    else
+    {
+        pWindow->count++;
+    }
+
+    pWindow->values[index] = value;
+    pWindow->sum += value;
+    pWindow->next = (uint16_t)((index + 1) % WINDOW_SIZE);
+
+    /* Wartosci, ktore juz nigdy nie beda minimum (maksimum), wypadaja z konca */
+    while (pWindow->minCount != 0)
+    {
+        back = pWindow->minQueue[(pWindow->minHead + pWindow->minCount - 1) % WINDOW_SIZE];
+        if (pWindow->values[back] < value)
+        {
+            break;
+        }
+        pWindow->minCount--;
+    }
+    pWindow->minQueue[(pWindow->minHead + pWindow->minCount) % WINDOW_SIZE] = index;
+    pWindow->minCount++;
+
+    while (pWindow->maxCount != 0)
+    {
+        back = pWindow->maxQueue[(pWindow->maxHead + pWindow->maxCount - 1) % WINDOW_SIZE];
+        if (pWindow->values[back] > value)
+        {
+            break;
+        }
+        pWindow->maxCount--;
+    }
+    pWindow->maxQueue[(pWindow->maxHead + pWindow->maxCount) % WINDOW_SIZE] = index;
+    pWindow->maxCount++;
+}
+
+/*!
+ *  @brief    Procedura odczytujaca minimum, maksimum i srednia okna w czasie
+ *            stalym
+ *  @param    pWindow
+ *              Okno
+ *  @param    pResult
+ *              Wynik
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void window_get(const window_t* pWindow, window_result_t* pResult)
+{
+    int32_t half = 0;
+
+    pResult->count = pWindow->count;
+    if (pWindow->count == 0)
+    {
+        return;
+    }
+
+    pResult->min = pWindow->values[pWindow->minQueue[pWindow->minHead]];
+    pResult->max = pWindow->values[pWindow->maxQueue[pWindow->maxHead]];
+
+    /* Srednia zaokraglona od zera */
+    half = (int32_t)(pWindow->count / 2);
+    pResult->mean = (pWindow->sum + ((pWindow->sum >= 0) ? half : -half)) / (int32_t)pWindow->count;
+}
+
+/*!
+ *  @brief    Procedura czyszczaca okna wszystkich wielkosci
+ *  @param    Brak
+ *  @returns  Nic
+ *  @side_effects:
+ *            Wyzerowanie okien i sum biezacego przedzialu
+ */
+void window_reset(void)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < (METRIC_COUNT - 1); i++)
+    {
+        window_init(&windows[i]);
+        accSum[i] = 0;
+        accCount[i] = 0;
+    }
+    started = FALSE;
+}
+
+/*!
+ *  @brief    Procedura przyjmujaca odczyt wszystkich wielkosci. Po uplywie
+ *            WINDOW_INTERVAL_MS srednie z przedzialu trafiaja do okien.
+ *            Wielkosc bez poprawnego odczytu w calym przedziale nie dopisuje
+ *            do okna nic.
+ *  @param    now
+ *              Czas odczytu [ms]
+ *  @param    pValues
+ *              Wartosci wielkosci, METRIC_COUNT elementow
+ *  @param    invalid
+ *              Maska METRIC_BIT wielkosci bez poprawnej wartosci, pomijanych
+ *  @returns  Nic
+ *  @side_effects:
+ *            Zmiana okien
+ */
+void window_addSample(uint32_t now, const int32_t* pValues, uint8_t invalid)
+{
+    uint32_t i = 0;
+
+    if (started == FALSE)
+    {
+        intervalStart = now;
+        started = TRUE;
+    }
+
+    for (i = 0; i < (METRIC_COUNT - 1); i++)
+    {
+        if ((invalid & METRIC_BIT(i + 1)) == 0)
+        {
+            accSum[i] += pValues[i + 1];
+            accCount[i]++;
+        }
+    }
+
+    if ((now - intervalStart) < WINDOW_INTERVAL_MS)
+    {
+        return;
+    }
+
+    /* Po dlugiej przerwie w odczytach przedzialy liczone sa od nowa */
+    intervalStart += WINDOW_INTERVAL_MS;
+    if ((now - intervalStart) >= WINDOW_INTERVAL_MS)
+    {
+        intervalStart = now;
+    }
+
+    for (i = 0; i < (METRIC_COUNT - 1); i++)
+    {
+        if (accCount[i] != 0)
+        {
+            window_push(&windows[i], accSum[i] / (int32_t)accCount[i]);
+        }
+        accSum[i] = 0;
+        accCount[i] = 0;
+    }
+}
+
+/*!
+ *  @brief    Procedura odczytujaca statystyki ostatniej godziny dla wielkosci
+ *  @param    metric
+ *              METRIC_xxx
+ *  @param    pResult
+ *              Wynik, count = 0 dla pustego okna lub niepoprawnej wielkosci
+ *  @returns  Nic
+ *  @side_effects:
+ *            Brak
+ */
+void window_getMetric(uint8_t metric, window_result_t* pResult)
+{
+    if ((metric == METRIC_NONE) || (metric >= METRIC_COUNT))
+    {
+        pResult->count = 0;
+        return;
+    }
+
+    window_get(&windows[metric - 1], pResult);
+}
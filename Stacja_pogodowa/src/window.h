@@ -0,0 +1,49 @@
+#ifndef WINDOW_H_
+#define WINDOW_H_
+
+#include "lpc_types.h"
+#include "metric.h"
+
+/*
+ * Okno przesuwne ostatnich WINDOW_SIZE wartosci. Do okna trafia srednia
+ * odczytow z kazdego przedzialu WINDOW_INTERVAL_MS, okno obejmuje 1 godzine.
+ */
+#define WINDOW_SIZE        120
+#define WINDOW_INTERVAL_MS (30UL * 1000UL)
+
+/*
+ * Okno z kolejkami monotonicznymi: minQueue zawiera indeksy wartosci
+ * rosnacych od najstarszej, maxQueue malejacych, wiec minimum i maksimum
+ * sa zawsze na poczatku kolejek. Suma wartosci musi sie miescic w int32.
+ */
+typedef struct
+{
+    int32_t values[WINDOW_SIZE];
+    uint16_t minQueue[WINDOW_SIZE];
+    uint16_t maxQueue[WINDOW_SIZE];
+    uint16_t minHead;
+    uint16_t minCount;
+    uint16_t maxHead;
+    uint16_t maxCount;
+    uint16_t next;               /* Indeks nastepnej wartosci */
+    uint16_t count;              /* Liczba wartosci w oknie */
+    int32_t sum;
+} window_t;
+
+typedef struct
+{
+    int32_t min;
+    int32_t max;
+    int32_t mean;
+    uint16_t count;              /* 0 - okno puste, pozostale pola nieokreslone */
+} window_result_t;
+
+void window_init(window_t* pWindow);
+void window_push(window_t* pWindow, int32_t value);
+void window_get(const window_t* pWindow, window_result_t* pResult);
+
+void window_reset(void);
+void window_addSample(uint32_t now, const int32_t* pValues, uint8_t invalid);
+void window_getMetric(uint8_t metric, window_result_t* pResult);
+
+#endif /* WINDOW_H_ */
@@ -0,0 +1,8 @@
+#include "stubs.h"
+
+config_t stub_config;
+
+const config_t* config_get(void)
+{
+    return &stub_config;
+}
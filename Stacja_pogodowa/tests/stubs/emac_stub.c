@@ -0,0 +1,109 @@
+#include <string.h>
+
+#include "lpc17xx_emac.h"
+#include "lpc17xx_pinsel.h"
+
+#include "stubs.h"
+
+Bool stub_emacInitOk = TRUE;
+int32_t stub_emacLink = 0;
+uint32_t stub_emacLinkPolls = 0;
+uint32_t stub_emacTxFree = STUB_EMAC_FRAMES;
+stub_frame_t stub_emacTx[STUB_EMAC_FRAMES];
+uint32_t stub_emacTxCount = 0;
+
+static stub_frame_t rx[STUB_EMAC_FRAMES];
+static uint32_t rxHead = 0;
+static uint32_t rxCount = 0;
+static uint8_t txBuf[STUB_EMAC_FRAME_SIZE];
+
+void stub_emacReset(void)
+{
+    stub_emacInitOk = TRUE;
+    stub_emacLink = 0;
+    stub_emacLinkPolls = 0;
+    stub_emacTxFree = STUB_EMAC_FRAMES;
+    stub_emacTxCount = 0;
+    rxHead = 0;
+    rxCount = 0;
+}
+
+/*!
+ *  @brief    Procedura dopisujaca ramke do kolejki odbiorczej
+ *  @param    pFrame
+ *              Ramka bez sumy FCS
+ *  @param    len
+ *              Dlugosc ramki
+ *  @param    status
+ *              Bledy odbioru (EMAC_RINFO_xxx), 0 - ramka poprawna
+ */
+void stub_emacReceive(const uint8_t* pFrame, uint32_t len, uint32_t status)
+{
+    stub_frame_t* pRx = &rx[(rxHead + rxCount) % STUB_EMAC_FRAMES];
+
+    memcpy(pRx->data, pFrame, len);
+    pRx->len = len;
+    pRx->status = status;
+    rxCount++;
+}
+
+Status EMAC_Init(EMAC_CFG_Type* EMAC_ConfigStruct)
+{
+    return (stub_emacInitOk == TRUE) ? SUCCESS : ERROR;
+}
+
+int32_t EMAC_PollPHYLink(void)
+{
+    stub_emacLinkPolls++;
+    return stub_emacLink;
+}
+
+Bool EMAC_CheckReceiveIndex(void)
+{
+    return (rxCount > 0) ? TRUE : FALSE;
+}
+
+FlagStatus EMAC_CheckReceiveDataStatus(uint32_t ulRxStatType)
+{
+    return ((rx[rxHead].status & ulRxStatType) != 0) ? SET : RESET;
+}
+
+uint8_t* EMAC_GetRxBuffer(void)
+{
+    return rx[rxHead].data;
+}
+
+/* Jak w kontrolerze: dlugosc z suma FCS pomniejszona o 1 */
+uint32_t EMAC_GetReceiveDataSize(void)
+{
+    return rx[rxHead].len + 4 - 1;
+}
+
+void EMAC_UpdateRxConsumeIndex(void)
+{
+    rxHead = (rxHead + 1) % STUB_EMAC_FRAMES;
+    rxCount--;
+}
+
+Bool EMAC_CheckTransmitIndex(void)
+{
+    return ((stub_emacTxFree > 0) && (stub_emacTxCount < STUB_EMAC_FRAMES)) ? TRUE : FALSE;
+}
+
+uint8_t* EMAC_GetTxBuffer(void)
+{
+    return txBuf;
+}
+
+void EMAC_CommitTxBuffer(uint32_t ulDataLen)
+{
+    memcpy(stub_emacTx[stub_emacTxCount].data, txBuf, ulDataLen);
+    stub_emacTx[stub_emacTxCount].len = ulDataLen;
+    stub_emacTxCount++;
+    stub_emacTxFree--;
+    memset(txBuf, 0xA5, sizeof(txBuf));
+}
+
+void PINSEL_ConfigPin(PINSEL_CFG_Type* PinCfg)
+{
+}
@@ -0,0 +1,55 @@
+#include <string.h>
+
+#include "lpc_types.h"
+#include "flash.h"
+
+#include "stubs.h"
+
+uint8_t stub_flash[STUB_FLASH_PAGES * STUB_FLASH_PAGE_SIZE];
+uint32_t stub_flashReads = 0;
+
+/*!
+ *  @brief    Procedura kasujaca pamiec (stan jak po wyjeciu z fabryki)
+ */
+void stub_flashErase(void)
+{
+    memset(stub_flash, 0xFF, sizeof(stub_flash));
+    stub_flashReads = 0;
+}
+
+uint32_t flash_init(void)
+{
+    return TRUE;
+}
+
+uint16_t flash_getPageSize(void)
+{
+    return STUB_FLASH_PAGE_SIZE;
+}
+
+void flash_setToBinaryPageSize(void)
+{
+}
+
+uint32_t flash_write(uint8_t* buf, uint32_t offset, uint32_t len)
+{
+    if ((offset >= sizeof(stub_flash)) || (len > sizeof(stub_flash) - offset))
+    {
+        return 0;
+    }
+
+    memcpy(&stub_flash[offset], buf, len);
+    return len;
+}
+
+uint32_t flash_read(uint8_t* buf, uint32_t offset, uint32_t len)
+{
+    if ((offset >= sizeof(stub_flash)) || (len > sizeof(stub_flash) - offset))
+    {
+        return 0;
+    }
+
+    stub_flashReads++;
+    memcpy(buf, &stub_flash[offset], len);
+    return len;
+}
@@ -0,0 +1,19 @@
+#include "net.h"
+
+#include "stubs.h"
+
+Bool stub_udpUp = TRUE;
+uint8_t stub_udpData[NET_UDP_MAX_PAYLOAD];
+uint32_t stub_udpLen = 0;
+uint32_t stub_udpCount = 0;
+
+uint8_t* net_udpBegin(void)
+{
+    return (stub_udpUp == TRUE) ? stub_udpData : NULL;
+}
+
+void net_udpSend(uint16_t len)
+{
+    stub_udpLen = len;
+    stub_udpCount++;
+}
@@ -0,0 +1,57 @@
+#ifndef STUBS_H_
+#define STUBS_H_
+
+/*
+ * Zaslepki sprzetu i modulow stacji dla testow na PC. Zamiast rejestrow
+ * kontrolera udostepniaja zmienne sterujace i zapis wykonanych operacji.
+ */
+
+#include "lpc_types.h"
+#include "config.h"
+
+/* config_stub.c - konfiguracja zwracana przez config_get */
+extern config_t stub_config;
+
+/* emac_stub.c - kontroler EMAC bez PHY: kolejka ramek odebranych i zapis wyslanych */
+#define STUB_EMAC_FRAMES     16
+#define STUB_EMAC_FRAME_SIZE 1536
+
+typedef struct
+{
+    uint8_t data[STUB_EMAC_FRAME_SIZE];
+    uint32_t len;                /* Dlugosc ramki bez sumy FCS */
+    uint32_t status;             /* Slowo statusu odbioru (EMAC_RINFO_xxx) */
+} stub_frame_t;
+
+extern Bool stub_emacInitOk;     /* Wynik EMAC_Init */
+extern int32_t stub_emacLink;    /* Wynik EMAC_PollPHYLink */
+extern uint32_t stub_emacLinkPolls;
+extern uint32_t stub_emacTxFree; /* Liczba wolnych deskryptorow nadawczych */
+extern stub_frame_t stub_emacTx[STUB_EMAC_FRAMES];
+extern uint32_t stub_emacTxCount;
+
+void stub_emacReset(void);
+void stub_emacReceive(const uint8_t* pFrame, uint32_t len, uint32_t status);
+
+/* flash_stub.c - pamiec DataFlash AT45DB081D w RAM */
+#define STUB_FLASH_PAGES     4096
+#define STUB_FLASH_PAGE_SIZE 264
+
+extern uint8_t stub_flash[STUB_FLASH_PAGES * STUB_FLASH_PAGE_SIZE];
+extern uint32_t stub_flashReads; /* Liczba wywolan flash_read */
+
+void stub_flashErase(void);
+
+/* uart0_stub.c - bufor nadawczy UART0, dane oprozniane przez test zamiast nadajnika */
+extern uint32_t stub_uart0Overruns; /* Zapisy poza obszarem z uart0_txReserve */
+
+void stub_uart0Reset(uint32_t start);
+uint32_t stub_uart0Drain(uint8_t* pOut, uint32_t max);
+
+/* net_stub.c - wysylanie datagramow UDP bez EMAC, zapis ostatniego datagramu */
+extern Bool stub_udpUp;          /* FALSE - net_udpBegin zwraca NULL */
+extern uint8_t stub_udpData[];
+extern uint32_t stub_udpLen;
+extern uint32_t stub_udpCount;
+
+#endif /* STUBS_H_ */
@@ -0,0 +1,100 @@
+#include <string.h>
+
+#include "uart0.h"
+
+#include "stubs.h"
+
+#define TX_MASK (UART0_TX_RING_SIZE - 1)
+
+uint32_t stub_uart0Overruns = 0;
+
+static uint8_t txRing[UART0_TX_RING_SIZE];
+static uint32_t txHead = 0;
+static uint32_t txTail = 0;
+static uint32_t txStage = 0;
+static uint32_t txReserved = 0;
+
+/*!
+ *  @brief    Procedura oprozniajaca bufor i ustawiajaca indeksy na start
+ *            (np. tuz przed koncem bufora, aby ramki przechodzily przez jego
+ *            poczatek)
+ */
+void stub_uart0Reset(uint32_t start)
+{
+    memset(txRing, 0xAA, sizeof(txRing));
+    txHead = start;
+    txTail = start;
+    txStage = start;
+    txReserved = start;
+    stub_uart0Overruns = 0;
+}
+
+/*!
+ *  @brief    Funkcja "wysylajaca" przekazane do nadania dane
+ *  @returns  Liczba bajtow skopiowanych do pOut
+ */
+uint32_t stub_uart0Drain(uint8_t* pOut, uint32_t max)
+{
+    uint32_t count = 0;
+
+    while ((txTail != txHead) && (count < max))
+    {
+        pOut[count++] = txRing[txTail & TX_MASK];
+        txTail++;
+    }
+
+    return count;
+}
+
+void uart0_init(uint32_t baudRate)
+{
+}
+
+uint32_t uart0_txFree(void)
+{
+    return UART0_TX_RING_SIZE - (txHead - txTail);
+}
+
+Bool uart0_txReserve(uint32_t len)
+{
+    if (uart0_txFree() < len)
+    {
+        return FALSE;
+    }
+
+    txStage = txHead;
+    txReserved = txHead + len;
+
+    return TRUE;
+}
+
+uint32_t uart0_txPut(uint8_t data)
+{
+    uint32_t pos = txStage;
+
+    /* Zapis poza zarezerwowanym obszarem nadpisalby dane czekajace na wyslanie */
+    if ((int32_t)(txReserved - pos) <= 0)
+    {
+        stub_uart0Overruns++;
+    }
+
+    txRing[pos & TX_MASK] = data;
+    txStage++;
+
+    return pos;
+}
+
+void uart0_txSet(uint32_t pos, uint8_t data)
+{
+    if (((pos - txHead) >= (txStage - txHead)))
+    {
+        stub_uart0Overruns++;
+    }
+
+    txRing[pos & TX_MASK] = data;
+}
+
+void uart0_txCommit(void)
+{
+    txHead = txStage;
+}
@@ -0,0 +1,71 @@
+#ifndef TEST_H_
+#define TEST_H_
+
+/*
+ * Minimalny zestaw makr dla testow modulow stacji uruchamianych na PC.
+ * Kazdy test jest osobnym programem, kod wyjscia 0 oznacza powodzenie.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+static unsigned long testChecks = 0;
+static unsigned long testFailures = 0;
+
+#define CHECK(cond) \
+    do { \
+        testChecks++; \
+        if (!(cond)) { \
+            testFailures++; \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        long long a_ = (long long)(actual); \
+        long long e_ = (long long)(expected); \
+        testChecks++; \
+        if (a_ != e_) { \
+            testFailures++; \
+            fprintf(stderr, "%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_); \
+        } \
+    } while (0)
+
+/*!
+ *  @brief    Funkcja zwracajaca czas monotoniczny w nanosekundach (pomiary wydajnosci)
+ */
+static inline double test_nowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/*!
+ *  @brief    Funkcja zwracajaca licznik cykli procesora (0 gdy niedostepny)
+ */
+static inline uint64_t test_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/*!
+ *  @brief    Funkcja wypisujaca podsumowanie testu
+ *  @returns  Kod wyjscia programu
+ */
+static inline int test_report(const char* pName)
+{
+    printf("%s: %lu checks, %lu failed\n", pName, testChecks, testFailures);
+
+    return (testFailures == 0) ? 0 : 1;
+}
+
+#endif /* TEST_H_ */
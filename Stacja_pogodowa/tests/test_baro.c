@@ -0,0 +1,205 @@
+/*
+ * Test redukcji cisnienia do poziomu morza i wyznaczania wysokosci
+ * (src/baro.c). Wyniki z tablic seaLevelFactors i ratioPowers sa porownywane
+ * ze wzorem barometrycznym liczonym w podwojnej precyzji dla kazdej wysokosci
+ * z zakresu i gestej siatki cisnien. Granice bledu sa te z komentarzy w
+ * baro.c: 3.5e-5 wzglednie dla QNH oraz 2.5 m / 5 m dla wysokosci. Z opcja -b
+ * mierzony jest czas wywolania.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "test.h"
+#include "baro.h"
+
+#define EXPONENT     5.25588
+#define SCALE_HEIGHT 44330.77
+
+#define SEA_LEVEL_MAX_ERROR 3.5e-5
+#define ALTITUDE_MAX_ERROR  5.0
+#define ALTITUDE_LOW_ERROR  2.5
+#define ALTITUDE_LOW_LIMIT  3000.0
+
+static double refSeaLevel(double pressure, double altitude)
+{
+    return pressure * pow(1.0 - altitude / SCALE_HEIGHT, -EXPONENT);
+}
+
+static double refAltitude(double pressure, double reference)
+{
+    return SCALE_HEIGHT * (1.0 - pow(pressure / reference, 1.0 / EXPONENT));
+}
+
+/*!
+ *  @brief    Kazda wysokosc z zakresu co 1 m, cisnienia od 30 kPa do 110 kPa
+ */
+static void testSeaLevel(void)
+{
+    double worst = 0;
+    int32_t worstAltitude = 0;
+    int32_t worstPressure = 0;
+    int32_t altitude = 0;
+    int32_t pressure = 0;
+
+    for (altitude = BARO_ALTITUDE_MIN; altitude <= BARO_ALTITUDE_MAX; altitude++)
+    {
+        for (pressure = 30000; pressure <= 110000; pressure += 997)
+        {
+            double expected = refSeaLevel(pressure, altitude);
+            double error = fabs(baro_seaLevel(pressure, (int16_t)altitude) - expected) / expected;
+
+            if (error > worst)
+            {
+                worst = error;
+                worstAltitude = altitude;
+                worstPressure = pressure;
+            }
+        }
+    }
+
+    testChecks++;
+    if (worst >= SEA_LEVEL_MAX_ERROR)
+    {
+        testFailures++;
+        fprintf(stderr, "baro_seaLevel: relative error %.2e at %d Pa, %d m\n", worst, worstPressure,
+                worstAltitude);
+    }
+    printf("baro_seaLevel: max relative error %.2e\n", worst);
+}
+
+/*!
+ *  @brief    Wartosci z tablicy atmosfery standardowej ICAO
+ */
+static void testStandardAtmosphere(void)
+{
+    static const struct
+    {
+        int16_t altitude;
+        int32_t pressure;
+    } table[] =
+    {
+        { -500, 107478 }, { 0, 101325 }, { 500, 95461 }, { 1000, 89876 }, { 1500, 84556 },
+        { 2000, 79495 }, { 3000, 70108 }, { 4000, 61640 }, { 5000, 54020 }, { 6000, 47181 }
+    };
+    uint32_t i = 0;
+
+    for (i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+    {
+        int32_t qnh = baro_seaLevel(table[i].pressure, table[i].altitude);
+        int32_t altitude = baro_altitude(table[i].pressure, BARO_STANDARD_PA);
+
+        CHECK(abs(qnh - BARO_STANDARD_PA) <= 5);
+        CHECK(abs(altitude - table[i].altitude) <= 3);
+    }
+}
+
+/*!
+ *  @brief    Caly zakres stosunku cisnien 0.25 .. 1.25 dla kilku cisnien odniesienia
+ */
+static void testAltitude(void)
+{
+    static const int32_t references[] = { 95000, 100000, BARO_STANDARD_PA, 103500 };
+    double worst = 0;
+    double worstLow = 0;
+    uint32_t i = 0;
+    int32_t pressure = 0;
+
+    for (i = 0; i < sizeof(references) / sizeof(references[0]); i++)
+    {
+        int32_t reference = references[i];
+
+        for (pressure = reference / 4 + 1; pressure < reference + reference / 4; pressure += 7)
+        {
+            double expected = refAltitude(pressure, reference);
+            double error = fabs(baro_altitude(pressure, reference) - expected);
+
+            if (error > worst)
+            {
+                worst = error;
+            }
+            if ((expected <= ALTITUDE_LOW_LIMIT) && (error > worstLow))
+            {
+                worstLow = error;
+            }
+        }
+    }
+
+    CHECK(worst < ALTITUDE_MAX_ERROR);
+    CHECK(worstLow < ALTITUDE_LOW_ERROR);
+    printf("baro_altitude: max error %.2f m, %.2f m up to %.0f m\n", worst, worstLow, ALTITUDE_LOW_LIMIT);
+}
+
+/* Wartosci poza zakresem sa ograniczane, niedodatnie cisnienia daja 0 */
+static void testLimits(void)
+{
+    CHECK_EQ(baro_seaLevel(0, 100), 0);
+    CHECK_EQ(baro_seaLevel(-5, 100), 0);
+    CHECK_EQ(baro_seaLevel(90000, -2000), baro_seaLevel(90000, BARO_ALTITUDE_MIN));
+    CHECK_EQ(baro_seaLevel(90000, 9000), baro_seaLevel(90000, BARO_ALTITUDE_MAX));
+    CHECK(abs(baro_seaLevel(BARO_STANDARD_PA, 0) - BARO_STANDARD_PA) <= 2);
+
+    /* Zmiana wysokosci uniewaznia zapamietany wspolczynnik */
+    CHECK(baro_seaLevel(90000, 1000) != baro_seaLevel(90000, 1001));
+    CHECK(fabs(baro_seaLevel(90000, 1000) - refSeaLevel(90000, 1000)) < 4);
+
+    CHECK_EQ(baro_altitude(0, BARO_STANDARD_PA), 0);
+    CHECK_EQ(baro_altitude(BARO_STANDARD_PA, 0), 0);
+    CHECK_EQ(baro_altitude(BARO_STANDARD_PA, BARO_STANDARD_PA), 0);
+    CHECK_EQ(baro_altitude(1000, BARO_STANDARD_PA), baro_altitude(BARO_STANDARD_PA / 4, BARO_STANDARD_PA));
+    CHECK_EQ(baro_altitude(200000, BARO_STANDARD_PA), baro_altitude(BARO_STANDARD_PA + BARO_STANDARD_PA / 4,
+            BARO_STANDARD_PA));
+}
+
+/*!
+ *  @brief    Pomiar czasu i liczby cykli na wywolanie
+ */
+static void bench(void)
+{
+    static int32_t pressures[4096];
+    volatile int32_t sink = 0;
+    const int loops = 20000000;
+    double start = 0;
+    uint64_t cycles = 0;
+    int i = 0;
+
+    for (i = 0; i < 4096; i++)
+    {
+        pressures[i] = 85000 + (i * 37) % 20000;
+    }
+
+#define BENCH(name, expr) \
+    start = test_nowNs(); \
+    cycles = test_cycles(); \
+    for (i = 0; i < loops; i++) \
+    { \
+        sink += (expr); \
+    } \
+    cycles = test_cycles() - cycles; \
+    printf("bench %-28s %6.1f ns/call %7.1f cycles/call\n", name, (test_nowNs() - start) / loops, \
+            (double)cycles / loops);
+
+    BENCH("baro_seaLevel fixed altitude", baro_seaLevel(pressures[i & 4095], 250));
+    BENCH("baro_seaLevel new altitude", baro_seaLevel(pressures[i & 4095], (int16_t)(i & 4095)));
+    BENCH("baro_altitude", baro_altitude(pressures[i & 4095], BARO_STANDARD_PA));
+    BENCH("double reference", (int32_t)refAltitude(pressures[i & 4095], BARO_STANDARD_PA));
+#undef BENCH
+
+    (void)sink;
+}
+
+int main(int argc, char* argv[])
+{
+    testSeaLevel();
+    testStandardAtmosphere();
+    testAltitude();
+    testLimits();
+
+    if ((argc > 1) && (strcmp(argv[1], "-b") == 0))
+    {
+        bench();
+    }
+
+    return test_report("test_baro");
+}
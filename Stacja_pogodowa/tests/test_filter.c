@@ -0,0 +1,382 @@
+/*
+ * Test filtru odczytow surowych (src/filter.c). Przez filter_update sa
+ * przepuszczane serie ze skokami, odczytami spoza zakresu i bledami
+ * komunikacji, a wynik jest porownywany z wartoscia prawdziwa serii.
+ * Sprawdzane jest tez podtrzymanie wyniku po bledzie, uniewaznienie po
+ * FILTER_HOLD_LIMIT bledach z rzedu i licznik odrzuconych odczytow.
+ *
+ * Z opcja -r plik odtwarzany jest zapis odczytow w formacie
+ * "czujnik,odczyt,poprawny" (jeden na linie), a na wyjscie trafia
+ * "odczyt,wynik,wazny" dla ustawien z konfiguracji. Z opcja -b mierzony jest
+ * czas filter_update.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "stubs.h"
+#include "filter.h"
+
+static uint32_t rngState = 88172645U;
+
+static uint32_t rng(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+/*!
+ *  @brief    Procedura ustawiajaca filtr wszystkich czujnikow i zerujaca liczniki
+ */
+static void setup(uint8_t median, uint8_t smoother, uint8_t shift, uint16_t q, uint16_t r)
+{
+    uint32_t i = 0;
+
+    memset(&stub_config, 0, sizeof(stub_config));
+    for (i = 0; i < FILTER_SENSORS; i++)
+    {
+        stub_config.filters[i].median = median;
+        stub_config.filters[i].smoother = smoother;
+        stub_config.filters[i].shift = shift;
+        stub_config.filters[i].processNoise = q;
+        stub_config.filters[i].measurementNoise = r;
+    }
+    filter_init();
+}
+
+/* Ustawienia z konfiguracji i ich sprawdzanie */
+static void testConfigure(void)
+{
+    filter_config_t config = { 3, FILTER_SMOOTH_EMA, 2, 0, 0, 0 };
+    int32_t output = 0;
+
+    setup(5, FILTER_SMOOTH_KALMAN, 0, 16, 256);
+    CHECK_EQ(filter_getConfig(FILTER_PRESSURE)->median, 5);
+    CHECK_EQ(filter_getConfig(FILTER_PRESSURE)->smoother, FILTER_SMOOTH_KALMAN);
+    CHECK(filter_getConfig(FILTER_SENSORS) == NULL);
+
+    CHECK(filter_configure(FILTER_HUMIDITY, &config) == TRUE);
+    config.median = 4;
+    CHECK(filter_configure(FILTER_HUMIDITY, &config) == FALSE);
+    config.median = 3;
+    config.shift = 8;
+    CHECK(filter_configure(FILTER_HUMIDITY, &config) == FALSE);
+    config.shift = 2;
+    config.smoother = FILTER_SMOOTH_KALMAN + 1;
+    CHECK(filter_configure(FILTER_HUMIDITY, &config) == FALSE);
+    CHECK(filter_configure(FILTER_SENSORS, &config) == FALSE);
+    CHECK_EQ(filter_getConfig(FILTER_HUMIDITY)->median, 3);
+    CHECK_EQ(filter_getConfig(FILTER_HUMIDITY)->smoother, FILTER_SMOOTH_EMA);
+
+    /* Niepoprawne ustawienia w konfiguracji - filtr wylaczony */
+    setup(2, FILTER_SMOOTH_EMA, 1, 0, 0);
+    CHECK_EQ(filter_getConfig(FILTER_TEMPERATURE)->median, 1);
+    CHECK_EQ(filter_getConfig(FILTER_TEMPERATURE)->smoother, FILTER_SMOOTH_NONE);
+    CHECK(filter_update(FILTER_TEMPERATURE, 215, TRUE, &output) == TRUE);
+    CHECK_EQ(output, 215);
+    CHECK(filter_update(FILTER_TEMPERATURE, 300, TRUE, &output) == TRUE);
+    CHECK_EQ(output, 300);
+
+    CHECK(filter_update(FILTER_SENSORS, 0, TRUE, &output) == FALSE);
+    CHECK_EQ(filter_getRejected(FILTER_SENSORS), 0);
+}
+
+/* Mediana 3 usuwa pojedynczy skok, mediana 5 dwa skoki z rzedu */
+static void testSpikes(void)
+{
+    int32_t output = 0;
+    int32_t i = 0;
+
+    setup(3, FILTER_SMOOTH_NONE, 0, 0, 0);
+    for (i = 0; i < 20; i++)
+    {
+        int32_t raw = (i == 10) ? 109000 : (i == 15) ? 30500 : 100000;
+
+        CHECK(filter_update(FILTER_PRESSURE, raw, TRUE, &output) == TRUE);
+        CHECK_EQ(output, 100000);
+    }
+
+    setup(5, FILTER_SMOOTH_NONE, 0, 0, 0);
+    for (i = 0; i < 20; i++)
+    {
+        int32_t raw = ((i == 10) || (i == 11)) ? 1200 : 215;
+
+        CHECK(filter_update(FILTER_TEMPERATURE, raw, TRUE, &output) == TRUE);
+        CHECK_EQ(output, 215);
+    }
+
+    /* Skok trwajacy dluzej niz polowa okna jest prawdziwa zmiana */
+    for (i = 0; i < 3; i++)
+    {
+        filter_update(FILTER_TEMPERATURE, 300, TRUE, &output);
+    }
+    CHECK_EQ(output, 300);
+    CHECK_EQ(filter_getRejected(FILTER_TEMPERATURE), 0);
+}
+
+/* Bledne odczyty: podtrzymanie wyniku, uniewaznienie i ponowny start */
+static void testHold(void)
+{
+    int32_t output = 0;
+    uint32_t i = 0;
+
+    setup(3, FILTER_SMOOTH_EMA, 2, 0, 0);
+
+    /* Przed pierwszym poprawnym odczytem wynik jest niewazny */
+    CHECK(filter_update(FILTER_HUMIDITY, 50, FALSE, &output) == FALSE);
+    CHECK(filter_update(FILTER_HUMIDITY, 101, TRUE, &output) == FALSE);
+    CHECK(filter_update(FILTER_HUMIDITY, -1, TRUE, &output) == FALSE);
+    CHECK_EQ(filter_getRejected(FILTER_HUMIDITY), 3);
+
+    /* Start od pierwszego poprawnego odczytu, bez opoznienia wygladzania */
+    CHECK(filter_update(FILTER_HUMIDITY, 60, TRUE, &output) == TRUE);
+    CHECK_EQ(output, 60);
+
+    /* FILTER_HOLD_LIMIT - 1 bledow: poprzedni wynik */
+    for (i = 0; i < FILTER_HOLD_LIMIT - 1; i++)
+    {
+        output = -1;
+        CHECK(filter_update(FILTER_HUMIDITY, (i & 1) ? 0 : 250, (i & 1) ? FALSE : TRUE, &output) == TRUE);
+        CHECK_EQ(output, 60);
+    }
+
+    /* Poprawny odczyt przerywa serie bledow */
+    CHECK(filter_update(FILTER_HUMIDITY, 60, TRUE, &output) == TRUE);
+    for (i = 0; i < FILTER_HOLD_LIMIT - 1; i++)
+    {
+        CHECK(filter_update(FILTER_HUMIDITY, 0, FALSE, &output) == TRUE);
+    }
+
+    /* FILTER_HOLD_LIMIT bledow z rzedu: wynik niewazny, rowniez dla kolejnych */
+    output = -1;
+    CHECK(filter_update(FILTER_HUMIDITY, 0, FALSE, &output) == FALSE);
+    CHECK_EQ(output, -1);
+    CHECK(filter_update(FILTER_HUMIDITY, 0, FALSE, &output) == FALSE);
+    CHECK_EQ(filter_getRejected(FILTER_HUMIDITY), 3 + 2 * (FILTER_HOLD_LIMIT - 1) + 2);
+
+    /* Ponowny start bez sladu starej historii i estymaty */
+    CHECK(filter_update(FILTER_HUMIDITY, 80, TRUE, &output) == TRUE);
+    CHECK_EQ(output, 80);
+    CHECK(filter_update(FILTER_HUMIDITY, 80, TRUE, &output) == TRUE);
+    CHECK_EQ(output, 80);
+
+    /* Liczniki czujnikow sa niezalezne */
+    CHECK_EQ(filter_getRejected(FILTER_TEMPERATURE), 0);
+    CHECK_EQ(filter_getRejected(FILTER_PRESSURE), 0);
+}
+
+/* Odpowiedz EMA na skok wartosci zgodna z wzorem e += (x - e) / 2^shift */
+static void testEma(void)
+{
+    int32_t output = 0;
+    int32_t estimate = 0;
+    uint32_t shift = 0;
+    uint32_t i = 0;
+
+    for (shift = 0; shift <= 7; shift++)
+    {
+        setup(1, FILTER_SMOOTH_EMA, (uint8_t)shift, 0, 0);
+        filter_update(FILTER_TEMPERATURE, 0, TRUE, &output);
+        estimate = 0;
+
+        for (i = 0; i < 3000; i++)
+        {
+            estimate += ((1000 << 8) - estimate) >> shift;
+            CHECK(filter_update(FILTER_TEMPERATURE, 1000, TRUE, &output) == TRUE);
+            if (output != ((estimate + 128) >> 8))
+            {
+                CHECK_EQ(output, (estimate + 128) >> 8);
+                break;
+            }
+        }
+        CHECK(abs(output - 1000) <= 1);
+    }
+}
+
+/* Kalman: szum na stalej wartosci jest tlumiony, skok jest w koncu sledzony */
+static void testKalman(void)
+{
+    int32_t output = 0;
+    int64_t rawError = 0;
+    int64_t outputError = 0;
+    uint32_t i = 0;
+
+    setup(1, FILTER_SMOOTH_KALMAN, 0, 4, 100 * 256);
+    for (i = 0; i < 2000; i++)
+    {
+        int32_t raw = 215 + (int32_t)(rng() % 41) - 20;
+
+        CHECK(filter_update(FILTER_TEMPERATURE, raw, TRUE, &output) == TRUE);
+        if (i >= 200)
+        {
+            rawError += (raw - 215) * (raw - 215);
+            outputError += (output - 215) * (output - 215);
+        }
+    }
+    CHECK(outputError * 10 < rawError);
+
+    for (i = 0; i < 2000; i++)
+    {
+        filter_update(FILTER_TEMPERATURE, 415, TRUE, &output);
+    }
+    CHECK(abs(output - 415) <= 1);
+
+    /* r = 0: wzmocnienie 1, wynik rowny odczytowi */
+    setup(1, FILTER_SMOOTH_KALMAN, 0, 0, 0);
+    for (i = 0; i < 10; i++)
+    {
+        filter_update(FILTER_TEMPERATURE, 200 + (int32_t)i * 7, TRUE, &output);
+        CHECK_EQ(output, 200 + (int32_t)i * 7);
+    }
+}
+
+/*!
+ *  @brief    Odtworzenie dlugiej serii cisnienia: narastanie 1 Pa na odczyt z
+ *            szumem +-20 Pa, skoki co 97 odczytow, odczyty spoza zakresu co
+ *            151 i bledy komunikacji co 53 odczyty. Wynik musi byc wazny i
+ *            bliski wartosci prawdziwej po kazdym odczycie.
+ */
+static void testReplay(uint8_t median, uint8_t smoother, uint8_t shift, uint16_t q, uint16_t r, int32_t tolerance)
+{
+    uint32_t rejected = 0;
+    int32_t worst = 0;
+    int32_t output = 0;
+    int32_t i = 0;
+
+    setup(median, smoother, shift, q, r);
+    for (i = 0; i < 20000; i++)
+    {
+        int32_t truth = 95000 + i / 4;
+        int32_t raw = truth + (int32_t)(rng() % 41) - 20;
+        Bool valid = TRUE;
+
+        if ((i % 97) == 50)
+        {
+            raw += ((i / 97) & 1) ? 4000 : -4000;
+        }
+        if ((i % 151) == 75)
+        {
+            raw = (i & 1) ? 0 : 200000;
+        }
+        if ((i % 53) == 20)
+        {
+            valid = FALSE;
+        }
+        if ((valid == FALSE) || ((i % 151) == 75))
+        {
+            rejected++;
+        }
+
+        CHECK(filter_update(FILTER_PRESSURE, raw, valid, &output) == TRUE);
+        if ((i > 10) && (abs(output - truth) > worst))
+        {
+            worst = abs(output - truth);
+        }
+    }
+
+    CHECK(worst <= tolerance);
+    CHECK_EQ(filter_getRejected(FILTER_PRESSURE), rejected);
+    printf("replay median %u smoother %u: max error %d Pa\n", median, smoother, worst);
+}
+
+/*!
+ *  @brief    Odtworzenie zapisu odczytow z pliku
+ */
+static int replay(const char* pFileName)
+{
+    FILE* pFile = fopen(pFileName, "r");
+    char line[80];
+
+    if (pFile == NULL)
+    {
+        perror(pFileName);
+        return 1;
+    }
+
+    filter_init();
+    while (fgets(line, sizeof(line), pFile) != NULL)
+    {
+        unsigned sensor = 0;
+        long raw = 0;
+        unsigned valid = 0;
+        int32_t output = 0;
+        Bool ok = FALSE;
+
+        if (sscanf(line, "%u,%ld,%u", &sensor, &raw, &valid) != 3)
+        {
+            continue;
+        }
+        ok = filter_update((uint8_t)sensor, (int32_t)raw, (valid != 0) ? TRUE : FALSE, &output);
+        printf("%ld,%d,%d\n", raw, (ok == TRUE) ? output : 0, (ok == TRUE) ? 1 : 0);
+    }
+
+    fclose(pFile);
+    return 0;
+}
+
+/*!
+ *  @brief    Pomiar czasu filter_update dla kazdego rodzaju wygladzania
+ */
+static void bench(void)
+{
+    static int32_t values[4096];
+    volatile int32_t sink = 0;
+    const int loops = 20000000;
+    int32_t output = 0;
+    double start = 0;
+    uint64_t cycles = 0;
+    int i = 0;
+
+    for (i = 0; i < 4096; i++)
+    {
+        values[i] = 100000 + (int32_t)(rng() % 201) - 100;
+    }
+
+#define BENCH(name, median, smoother) \
+    setup(median, smoother, 3, 4, 1024); \
+    start = test_nowNs(); \
+    cycles = test_cycles(); \
+    for (i = 0; i < loops; i++) \
+    { \
+        filter_update(FILTER_PRESSURE, values[i & 4095], TRUE, &output); \
+        sink += output; \
+    } \
+    cycles = test_cycles() - cycles; \
+    printf("bench %-28s %6.1f ns/call %7.1f cycles/call\n", name, (test_nowNs() - start) / loops, \
+            (double)cycles / loops);
+
+    BENCH("filter_update median 1", 1, FILTER_SMOOTH_NONE);
+    BENCH("filter_update median 5", 5, FILTER_SMOOTH_NONE);
+    BENCH("filter_update median 5 EMA", 5, FILTER_SMOOTH_EMA);
+    BENCH("filter_update median 5 Kalman", 5, FILTER_SMOOTH_KALMAN);
+#undef BENCH
+
+    (void)sink;
+}
+
+int main(int argc, char* argv[])
+{
+    if ((argc > 2) && (strcmp(argv[1], "-r") == 0))
+    {
+        return replay(argv[2]);
+    }
+
+    testConfigure();
+    testSpikes();
+    testHold();
+    testEma();
+    testKalman();
+    testReplay(5, FILTER_SMOOTH_NONE, 0, 0, 0, 30);
+    testReplay(5, FILTER_SMOOTH_EMA, 3, 0, 0, 25);
+    testReplay(3, FILTER_SMOOTH_KALMAN, 0, 64, 200 * 256, 25);
+
+    if ((argc > 1) && (strcmp(argv[1], "-b") == 0))
+    {
+        bench();
+    }
+
+    return test_report("test_filter");
+}
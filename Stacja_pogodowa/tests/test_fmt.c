@@ -0,0 +1,228 @@
+/*
+ * Test formatowania liczb (src/fmt.c) - wynik porownywany z snprintf dla
+ * wartosci granicznych (INT32_MIN, UINT32_MAX), wyrownania zerami i spacjami
+ * oraz ujemnych liczb stalopozycyjnych z zerowa czescia calkowita. Z opcja
+ * -b mierzony jest czas i liczba cykli na wywolanie w porownaniu z snprintf.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "test.h"
+#include "fmt.h"
+
+#define BUF_SIZE 40
+#define CANARY   '#'
+
+static uint32_t rngState = 12345;
+
+static uint32_t rng(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+/*!
+ *  @brief    Procedura porownujaca wynik z oczekiwanym tekstem oraz sprawdzajaca
+ *            zwracana dlugosc i brak zapisu za terminatorem
+ */
+static void compare(const char* pBuf, uint32_t len, const char* pExpected, const char* pWhat, long long value,
+        int width, char pad)
+{
+    uint32_t expectedLen = (uint32_t)strlen(pExpected);
+
+    testChecks++;
+    if ((len != expectedLen) || (strcmp(pBuf, pExpected) != 0) || (pBuf[len + 1] != CANARY))
+    {
+        testFailures++;
+        fprintf(stderr, "%s(%lld, width %d, pad '%c'): \"%s\" (%u), expected \"%s\" (%u)\n", pWhat, value,
+                width, pad, pBuf, len, pExpected, expectedLen);
+    }
+}
+
+static void checkUInt(uint32_t value, int width, char pad)
+{
+    char buf[BUF_SIZE];
+    char expected[BUF_SIZE];
+    uint32_t len = 0;
+
+    memset(buf, CANARY, sizeof(buf));
+    len = fmt_uint(buf, value, (uint8_t)width, pad);
+    snprintf(expected, sizeof(expected), (pad == '0') ? "%0*u" : "%*u", width, value);
+    compare(buf, len, expected, "fmt_uint", value, width, pad);
+}
+
+static void checkInt(int32_t value, int width, char pad)
+{
+    char buf[BUF_SIZE];
+    char expected[BUF_SIZE];
+    uint32_t len = 0;
+
+    memset(buf, CANARY, sizeof(buf));
+    len = fmt_int(buf, value, (uint8_t)width, pad);
+    snprintf(expected, sizeof(expected), (pad == '0') ? "%0*d" : "%*d", width, value);
+    compare(buf, len, expected, "fmt_int", value, width, pad);
+}
+
+/*!
+ *  @brief    Procedura porownujaca fmt_fixed z formatem %.*f. Iloraz value/10^d
+ *            rozni sie od dokladnej wartosci dziesietnej o ulamek ulp, wiec
+ *            zaokraglenie do d miejsc daje dokladnie oczekiwane cyfry.
+ */
+static void checkFixed(int32_t value, int decimals, int width, char pad)
+{
+    static const double scale[] = { 1, 10, 100, 1000, 10000, 100000 };
+    char buf[BUF_SIZE];
+    char expected[BUF_SIZE];
+    uint32_t len = 0;
+
+    memset(buf, CANARY, sizeof(buf));
+    len = fmt_fixed(buf, value, (uint8_t)decimals, (uint8_t)width, pad);
+    snprintf(expected, sizeof(expected), (pad == '0') ? "%0*.*f" : "%*.*f", width, decimals,
+            (double)value / scale[decimals]);
+    compare(buf, len, expected, "fmt_fixed", value, width, pad);
+}
+
+static void testEdges(void)
+{
+    static const int32_t ints[] = { 0, 1, -1, 9, -9, 10, -10, 99, 100, -100, 12345, -12345,
+            999999999, -999999999, 1000000000, INT32_MAX, INT32_MIN, INT32_MIN + 1 };
+    static const uint32_t uints[] = { 0, 1, 9, 10, 99, 100, 101, 65535, 4294967295U, 4000000000U };
+    static const int32_t fixed[] = { 0, 5, -5, 9, -9, 10, -10, 215, -215, -1, -99, -100, 101325,
+            INT32_MAX, INT32_MIN, INT32_MIN + 1 };
+    static const char pads[] = { '0', ' ' };
+    uint32_t i = 0;
+    int width = 0;
+    int p = 0;
+    int d = 0;
+
+    for (p = 0; p < 2; p++)
+    {
+        for (width = 0; width <= 16; width++)
+        {
+            for (i = 0; i < sizeof(ints) / sizeof(ints[0]); i++)
+            {
+                checkInt(ints[i], width, pads[p]);
+            }
+            for (i = 0; i < sizeof(uints) / sizeof(uints[0]); i++)
+            {
+                checkUInt(uints[i], width, pads[p]);
+            }
+            for (d = 0; d <= 5; d++)
+            {
+                for (i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++)
+                {
+                    checkFixed(fixed[i], d, width, pads[p]);
+                }
+            }
+        }
+    }
+}
+
+/* Ujemne wartosci z zerowa czescia calkowita musza miec znak, np. -5 -> "-0.5" */
+static void testNegativeFraction(void)
+{
+    char buf[BUF_SIZE];
+
+    memset(buf, CANARY, sizeof(buf));
+    fmt_fixed(buf, -5, 1, 0, ' ');
+    CHECK(strcmp(buf, "-0.5") == 0);
+    fmt_fixed(buf, -5, 2, 6, '0');
+    CHECK(strcmp(buf, "-00.05") == 0);
+    fmt_fixed(buf, -5, 2, 6, ' ');
+    CHECK(strcmp(buf, " -0.05") == 0);
+    fmt_fixed(buf, INT32_MIN, 1, 0, ' ');
+    CHECK(strcmp(buf, "-214748364.8") == 0);
+    fmt_int(buf, INT32_MIN, 0, ' ');
+    CHECK(strcmp(buf, "-2147483648") == 0);
+    CHECK_EQ(fmt_fixed(buf, INT32_MIN, 5, 0, ' '), FMT_MAX_LEN - 1);
+
+    /* Wiecej niz 5 miejsc jest ograniczane do 5 */
+    fmt_fixed(buf, 123456, 9, 0, ' ');
+    CHECK(strcmp(buf, "1.23456") == 0);
+}
+
+static void testRandom(void)
+{
+    int i = 0;
+
+    for (i = 0; i < 1000000; i++)
+    {
+        uint32_t r = rng();
+        int32_t value = (int32_t)rng();
+        int width = (int)(r % 18);
+        char pad = ((r >> 8) & 1) ? '0' : ' ';
+
+        /* Rowniez male wartosci, najczestsze na wyswietlaczu */
+        if ((r >> 9) & 1)
+        {
+            value >>= (r >> 10) % 31;
+        }
+
+        checkInt(value, width, pad);
+        checkUInt((uint32_t)value, width, pad);
+        checkFixed(value, (int)((r >> 16) % 6), width, pad);
+    }
+}
+
+/*!
+ *  @brief    Pomiar czasu i liczby cykli na wywolanie w porownaniu z snprintf
+ */
+static void bench(void)
+{
+    static int32_t values[4096];
+    char buf[BUF_SIZE];
+    volatile uint32_t sink = 0;
+    const int loops = 4000000;
+    double start = 0;
+    double ns = 0;
+    uint64_t cycles = 0;
+    int i = 0;
+
+    for (i = 0; i < 4096; i++)
+    {
+        values[i] = (int32_t)rng() >> (i % 24);
+    }
+
+#define BENCH(name, expr) \
+    start = test_nowNs(); \
+    cycles = test_cycles(); \
+    for (i = 0; i < loops; i++) \
+    { \
+        int32_t v = values[i & 4095]; \
+        sink += (uint32_t)(expr); \
+        (void)v; \
+    } \
+    cycles = test_cycles() - cycles; \
+    ns = (test_nowNs() - start) / loops; \
+    printf("bench %-28s %6.1f ns/call %7.1f cycles/call\n", name, ns, (double)cycles / loops);
+
+    BENCH("fmt_int", fmt_int(buf, v, 0, ' '));
+    BENCH("snprintf %d", snprintf(buf, sizeof(buf), "%d", v));
+    BENCH("fmt_int width 8 '0'", fmt_int(buf, v, 8, '0'));
+    BENCH("snprintf %08d", snprintf(buf, sizeof(buf), "%08d", v));
+    BENCH("fmt_fixed 1 decimal", fmt_fixed(buf, v, 1, 0, ' '));
+    BENCH("snprintf %d.%d", snprintf(buf, sizeof(buf), "%s%d.%d", (v < 0) ? "-" : "",
+            abs(v / 10), abs(v % 10)));
+    BENCH("fmt_uint small", fmt_uint(buf, (uint32_t)v & 0xFFF, 4, '0'));
+#undef BENCH
+
+    (void)sink;
+}
+
+int main(int argc, char* argv[])
+{
+    testEdges();
+    testNegativeFraction();
+    testRandom();
+
+    if ((argc > 1) && (strcmp(argv[1], "-b") == 0))
+    {
+        bench();
+    }
+
+    return test_report("test_fmt");
+}
@@ -0,0 +1,620 @@
+/*
+ * Test serwera HTTP (src/http.c) razem z warstwa sieciowa (src/net.c) i
+ * dziennikiem (src/datalog.c). Klient TCP jest symulowany w tescie: ramki
+ * od komputera PC trafiaja do kolejki odbiorczej zaslepki EMAC, a segmenty
+ * wyslane przez stacje sa potwierdzane az do zamkniecia polaczenia, jak w
+ * polaczeniu przez interfejs TAP. Dziennik jest zapisywany do pamieci
+ * DataFlash w RAM (stubs/flash_stub.c), w tym z cofnieciem czasu jak po
+ * utracie zasilania zegara RTC oraz z dopisywaniem rekordow w trakcie
+ * wysylania odpowiedzi.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "stubs.h"
+#include "net.h"
+#include "http.h"
+#include "datalog.h"
+#include "metric.h"
+
+#define STATION_IP NET_IP(192, 168, 1, 50)
+#define PC_IP      NET_IP(192, 168, 1, 10)
+#define PC_PORT    40000
+
+#define TCP_FIN 0x01
+#define TCP_SYN 0x02
+#define TCP_RST 0x04
+#define TCP_PSH 0x08
+#define TCP_ACK 0x10
+
+/* Rekordy na strone dla strony 264 B: (264 - 8) / 20 */
+#define RECORDS_PER_PAGE 12
+
+/* 1.10.2026 i domyslny czas zegara po utracie zasilania (13.06.2024 12:00) */
+#define TIME_REAL    1790812800U
+#define TIME_DEFAULT 1718280000U
+
+#define RESPONSE_SIZE 200000
+
+static const uint8_t stationMac[6] = { 0x02, 0x00, 192, 168, 1, 50 };
+static const uint8_t pcMac[6] = { 0x00, 0x1B, 0x21, 0x3A, 0x4F, 0x5C };
+
+/* Stan klienta TCP */
+static uint32_t now = 1000;
+static uint32_t clientSeq = 0;
+static uint32_t clientAck = 0;
+static uint16_t clientMss = 1460;
+static char response[RESPONSE_SIZE];
+static uint32_t responseLen = 0;
+static uint32_t maxDataLen = 0;
+static Bool resetReceived = FALSE;
+
+/* Dopisywanie rekordow przed potwierdzeniem pierwszego segmentu odpowiedzi */
+static uint32_t appendCount = 0;
+static uint32_t appendTime = 0;
+
+static uint16_t get16(const uint8_t* p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t get32(const uint8_t* p)
+{
+    return ((uint32_t)get16(p) << 16) | get16(&p[2]);
+}
+
+static void put16(uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+}
+
+static void put32(uint8_t* p, uint32_t value)
+{
+    put16(p, (uint16_t)(value >> 16));
+    put16(&p[2], (uint16_t)value);
+}
+
+/*!
+ *  @brief    Wzorcowa suma kontrolna Internetu (RFC 1071)
+ */
+static uint16_t refChecksum(uint32_t sum, const uint8_t* p, uint32_t len)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i + 1 < len; i += 2)
+    {
+        sum += (uint32_t)((p[i] << 8) | p[i + 1]);
+    }
+    if (len & 1)
+    {
+        sum += (uint32_t)(p[len - 1] << 8);
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+
+    return (uint16_t)~sum;
+}
+
+static uint32_t pseudoSum(uint32_t srcIp, uint32_t dstIp, uint32_t len)
+{
+    return (srcIp >> 16) + (srcIp & 0xFFFF) + (dstIp >> 16) + (dstIp & 0xFFFF) + NET_PROTO_TCP + len;
+}
+
+/*!
+ *  @brief    Procedura wysylajaca do stacji segment TCP od komputera PC
+ */
+static void clientSend(uint8_t flags, const char* pData)
+{
+    uint8_t frame[STUB_EMAC_FRAME_SIZE];
+    uint8_t* pIp = &frame[NET_ETH_HEADER_SIZE];
+    uint8_t* pTcp = &frame[NET_IP_PAYLOAD_OFFSET];
+    uint32_t headerLen = ((flags & TCP_SYN) != 0) ? 24 : 20;
+    uint32_t dataLen = (pData != NULL) ? strlen(pData) : 0;
+    uint32_t len = headerLen + dataLen;
+
+    memset(frame, 0, sizeof(frame));
+    memcpy(&frame[0], stationMac, 6);
+    memcpy(&frame[6], pcMac, 6);
+    put16(&frame[12], 0x0800);
+    pIp[0] = 0x45;
+    put16(&pIp[2], NET_IP_HEADER_SIZE + len);
+    put16(&pIp[6], 0x4000);
+    pIp[8] = 64;
+    pIp[9] = NET_PROTO_TCP;
+    put32(&pIp[12], PC_IP);
+    put32(&pIp[16], STATION_IP);
+    put16(&pIp[10], refChecksum(0, pIp, NET_IP_HEADER_SIZE));
+
+    put16(&pTcp[0], PC_PORT);
+    put16(&pTcp[2], HTTP_PORT);
+    put32(&pTcp[4], clientSeq);
+    put32(&pTcp[8], clientAck);
+    pTcp[12] = (uint8_t)((headerLen / 4) << 4);
+    pTcp[13] = flags;
+    put16(&pTcp[14], 8192);
+    if ((flags & TCP_SYN) != 0)
+    {
+        /* Opcja MSS, domyslnie 1460 - stacja ogranicza segmenty do swojego bufora */
+        pTcp[20] = 2;
+        pTcp[21] = 4;
+        put16(&pTcp[22], clientMss);
+    }
+    if (dataLen > 0)
+    {
+        memcpy(&pTcp[headerLen], pData, dataLen);
+    }
+    put16(&pTcp[16], refChecksum(pseudoSum(PC_IP, STATION_IP, len), pTcp, len));
+
+    clientSeq += dataLen + (((flags & (TCP_SYN | TCP_FIN)) != 0) ? 1 : 0);
+
+    stub_emacReceive(frame, (NET_IP_PAYLOAD_OFFSET + len < 60) ? 60 : (NET_IP_PAYLOAD_OFFSET + len), 0);
+    now += 10;
+    net_poll(now);
+    http_poll(now);
+}
+
+/*!
+ *  @brief    Funkcja pobierajaca segment wyslany przez stacje i sprawdzajaca
+ *            jego naglowki i sume kontrolna
+ *  @returns  Wskaznik na naglowek TCP lub NULL gdy stacja nic nie wyslala
+ */
+static const uint8_t* stationSegment(uint32_t* pDataLen)
+{
+    static stub_frame_t last;
+    const uint8_t* pIp = NULL;
+    const uint8_t* pTcp = NULL;
+    uint32_t len = 0;
+
+    if (stub_emacTxCount == 0)
+    {
+        return NULL;
+    }
+
+    last = stub_emacTx[stub_emacTxCount - 1];
+    stub_emacTxCount = 0;
+    stub_emacTxFree = STUB_EMAC_FRAMES;
+
+    pIp = &last.data[NET_ETH_HEADER_SIZE];
+    pTcp = &last.data[NET_IP_PAYLOAD_OFFSET];
+    len = get16(&pIp[2]) - NET_IP_HEADER_SIZE;
+
+    CHECK(memcmp(&last.data[0], pcMac, 6) == 0);
+    CHECK_EQ(pIp[9], NET_PROTO_TCP);
+    CHECK_EQ(get32(&pIp[16]), PC_IP);
+    CHECK_EQ(refChecksum(pseudoSum(STATION_IP, PC_IP, len), pTcp, len), 0);
+    CHECK_EQ(get16(&pTcp[0]), HTTP_PORT);
+    CHECK_EQ(get16(&pTcp[2]), PC_PORT);
+
+    *pDataLen = len - (pTcp[12] >> 4) * 4;
+    return pTcp;
+}
+
+static void append(uint32_t time)
+{
+    datalog_record_t record;
+
+    memset(&record, 0, sizeof(record));
+    record.time = time;
+    record.pressure = 101325 + (int32_t)(time % 100);
+    record.temperature = (int16_t)(time % 300);
+    record.humidity = 50;
+    datalog_append(&record);
+}
+
+/*!
+ *  @brief    Funkcja wykonujaca zapytanie GET: nawiazanie polaczenia,
+ *            wyslanie zapytania i potwierdzanie segmentow az do FIN. Przed
+ *            potwierdzeniem pierwszego segmentu dopisuje do dziennika
+ *            appendCount rekordow co 60 s od appendTime.
+ *  @returns  TRUE jesli polaczenie zostalo poprawnie zamkniete, FALSE
+ *            takze po zerwaniu polaczenia przez stacje (resetReceived)
+ */
+static Bool httpGet(const char* pPath)
+{
+    char request[128];
+    const uint8_t* pTcp = NULL;
+    uint32_t dataLen = 0;
+    uint32_t segments = 0;
+
+    responseLen = 0;
+    maxDataLen = 0;
+    resetReceived = FALSE;
+    clientSeq = 0x10000000 + now;
+    clientAck = 0;
+
+    clientSend(TCP_SYN, NULL);
+    pTcp = stationSegment(&dataLen);
+    if ((pTcp == NULL) || (pTcp[13] != (TCP_SYN | TCP_ACK)) || (get32(&pTcp[8]) != clientSeq))
+    {
+        CHECK(FALSE);
+        return FALSE;
+    }
+    clientAck = get32(&pTcp[4]) + 1;
+
+    snprintf(request, sizeof(request), "GET %s HTTP/1.0\r\n\r\n", pPath);
+    clientSend(TCP_ACK | TCP_PSH, request);
+
+    while (segments++ < 10000)
+    {
+        pTcp = stationSegment(&dataLen);
+        if (pTcp == NULL)
+        {
+            CHECK(FALSE);
+            return FALSE;
+        }
+        if ((pTcp[13] & TCP_RST) != 0)
+        {
+            CHECK_EQ(dataLen, 0);
+            resetReceived = TRUE;
+            return FALSE;
+        }
+        CHECK_EQ(get32(&pTcp[4]), clientAck);
+        CHECK(dataLen <= 1024);
+        if (dataLen > maxDataLen)
+        {
+            maxDataLen = dataLen;
+        }
+
+        if ((responseLen + dataLen) < RESPONSE_SIZE)
+        {
+            memcpy(&response[responseLen], &pTcp[(pTcp[12] >> 4) * 4], dataLen);
+            responseLen += dataLen;
+            response[responseLen] = '\0';
+        }
+        clientAck += dataLen;
+
+        if ((pTcp[13] & TCP_FIN) != 0)
+        {
+            clientAck++;
+            clientSend(TCP_ACK | TCP_FIN, NULL);
+            pTcp = stationSegment(&dataLen);
+            CHECK((pTcp == NULL) || ((pTcp[13] & TCP_RST) == 0));
+            return TRUE;
+        }
+        if (segments == 1)
+        {
+            uint32_t i = 0;
+
+            for (i = 0; i < appendCount; i++)
+            {
+                append(appendTime + i * 60);
+            }
+        }
+        clientSend(TCP_ACK, NULL);
+    }
+
+    CHECK(FALSE);
+    return FALSE;
+}
+
+/*!
+ *  @brief    Funkcja porownujaca czasy rekordow z odpowiedzi /history z
+ *            oczekiwanym ciagiem first, first + step, ... (count rekordow)
+ */
+static void checkHistory(uint32_t first, uint32_t step, uint32_t count)
+{
+    const char* pBody = strstr(response, "\r\n\r\n");
+    const char* p = NULL;
+    uint32_t found = 0;
+
+    CHECK(strncmp(response, "HTTP/1.0 200 OK\r\n", 17) == 0);
+    CHECK(pBody != NULL);
+    if (pBody == NULL)
+    {
+        return;
+    }
+    pBody += 4;
+    CHECK_EQ(pBody[0], '[');
+    CHECK(strcmp(&response[responseLen - 2], "]\n") == 0);
+
+    for (p = strstr(pBody, "{\"t\":"); p != NULL; p = strstr(p + 1, "{\"t\":"))
+    {
+        uint32_t time = (uint32_t)strtoul(p + 5, NULL, 10);
+
+        if (time != first + found * step)
+        {
+            CHECK_EQ(time, first + found * step);
+            return;
+        }
+        CHECK(strstr(p, ",\"temp\":") != NULL);
+        found++;
+    }
+    CHECK_EQ(found, count);
+}
+
+static void setupNet(void)
+{
+    memset(&stub_config, 0, sizeof(stub_config));
+    stub_config.netIp = STATION_IP;
+    stub_config.netMask = NET_IP(255, 255, 255, 0);
+    stub_emacReset();
+    CHECK(net_init() == TRUE);
+    stub_emacLink = 1;
+    http_init();
+    net_poll(now);
+    CHECK(net_isUp() == TRUE);
+}
+
+/* Odcinek z niemalejacym czasem: po dopisaniu i po ponownym odczycie pamieci */
+static void testSegment(void)
+{
+    uint32_t i = 0;
+
+    stub_flashErase();
+    CHECK(datalog_init() == TRUE);
+    CHECK_EQ(datalog_getRecordCount(), 0);
+    CHECK_EQ(datalog_getSegmentStart(), 0);
+
+    for (i = 0; i < 10 * RECORDS_PER_PAGE; i++)
+    {
+        append(TIME_REAL + i * 60);
+    }
+    CHECK_EQ(datalog_getSegmentStart(), 0);
+    CHECK(datalog_init() == TRUE);
+    CHECK_EQ(datalog_getRecordCount(), 10 * RECORDS_PER_PAGE);
+    CHECK_EQ(datalog_getSegmentStart(), 0);
+
+    /* Cofniecie czasu wewnatrz strony */
+    for (i = 0; i < 5; i++)
+    {
+        append(TIME_REAL + 100000 + i * 60);
+    }
+    for (i = 0; i < 2 * RECORDS_PER_PAGE; i++)
+    {
+        append(TIME_DEFAULT + i * 60);
+    }
+    CHECK_EQ(datalog_getSegmentStart(), 10 * RECORDS_PER_PAGE + 5);
+    CHECK(datalog_init() == TRUE);
+    CHECK_EQ(datalog_getSegmentStart(), 10 * RECORDS_PER_PAGE + 5);
+
+    /* Cofniecie czasu na granicy stron, rekordy z RAM zostaly utracone */
+    CHECK_EQ(datalog_getRecordCount(), 12 * RECORDS_PER_PAGE);
+    for (i = 0; i < RECORDS_PER_PAGE; i++)
+    {
+        append(TIME_DEFAULT + 10000 + i * 60);
+    }
+    for (i = 0; i < RECORDS_PER_PAGE; i++)
+    {
+        append(TIME_DEFAULT - 5000 + i * 60);
+    }
+    CHECK_EQ(datalog_getSegmentStart(), 13 * RECORDS_PER_PAGE);
+    CHECK(datalog_init() == TRUE);
+    CHECK_EQ(datalog_getSegmentStart(), 13 * RECORDS_PER_PAGE);
+
+    /* Rekordy tylko w RAM sa tracone przy ponownej inicjalizacji */
+    append(TIME_DEFAULT - 100000);
+    CHECK_EQ(datalog_getSegmentStart(), 14 * RECORDS_PER_PAGE);
+    CHECK(datalog_init() == TRUE);
+    CHECK_EQ(datalog_getSegmentStart(), 13 * RECORDS_PER_PAGE);
+
+    /* Bez cofniecia czasu caly dziennik jest jednym odcinkiem */
+    stub_flashErase();
+    CHECK(datalog_init() == TRUE);
+    for (i = 0; i < 50 * RECORDS_PER_PAGE; i++)
+    {
+        append(TIME_REAL + i);
+    }
+    stub_flashReads = 0;
+    CHECK(datalog_init() == TRUE);
+    CHECK_EQ(datalog_getSegmentStart(), 0);
+    CHECK(stub_flashReads < 2 * 50 + 100);
+}
+
+/* Po zapelnieniu pamieci nadpisanie najstarszej strony przesuwa poczatek odcinka */
+static void testSegmentWrap(void)
+{
+    uint32_t total = STUB_FLASH_PAGES * RECORDS_PER_PAGE;
+    uint32_t i = 0;
+
+    stub_flashErase();
+    CHECK(datalog_init() == TRUE);
+    for (i = 0; i < total - 3 * RECORDS_PER_PAGE; i++)
+    {
+        append(TIME_REAL + i * 60);
+    }
+    for (i = 0; i < 2 * RECORDS_PER_PAGE + 4; i++)
+    {
+        append(TIME_DEFAULT + i * 60);
+    }
+    CHECK_EQ(datalog_getSegmentStart(), total - 3 * RECORDS_PER_PAGE);
+
+    /* Pamiec pelna: kazda kolejna zapisana strona usuwa najstarsza */
+    for (; i < 5 * RECORDS_PER_PAGE; i++)
+    {
+        append(TIME_DEFAULT + i * 60);
+    }
+    CHECK_EQ(datalog_getRecordCount(), total);
+    CHECK_EQ(datalog_getSegmentStart(), total - 5 * RECORDS_PER_PAGE);
+    CHECK(datalog_init() == TRUE);
+    CHECK_EQ(datalog_getSegmentStart(), total - 5 * RECORDS_PER_PAGE);
+}
+
+/* Zapytania /history o zakres czasu w dzienniku z cofnieciem czasu */
+static void testHistory(void)
+{
+    uint32_t before = 6 * RECORDS_PER_PAGE + 3;
+    uint32_t after = 20 * RECORDS_PER_PAGE;
+    char path[96];
+    uint32_t i = 0;
+
+    stub_flashErase();
+    CHECK(datalog_init() == TRUE);
+    for (i = 0; i < before; i++)
+    {
+        append(TIME_REAL + i * 60);
+    }
+    for (i = 0; i < after; i++)
+    {
+        append(TIME_DEFAULT + i * 60);
+    }
+    CHECK(datalog_init() == TRUE);
+    after = datalog_getRecordCount() - before;
+    setupNet();
+
+    /* Caly najnowszy odcinek */
+    CHECK(httpGet("/history") == TRUE);
+    checkHistory(TIME_DEFAULT, 60, after);
+
+    /* Zakres wewnatrz odcinka, granice wlacznie */
+    snprintf(path, sizeof(path), "/history?from=%u&to=%u", TIME_DEFAULT + 600, TIME_DEFAULT + 1200);
+    CHECK(httpGet(path) == TRUE);
+    checkHistory(TIME_DEFAULT + 600, 60, 11);
+
+    snprintf(path, sizeof(path), "/history?from=%u&to=%u", TIME_DEFAULT + 601, TIME_DEFAULT + 1199);
+    CHECK(httpGet(path) == TRUE);
+    checkHistory(TIME_DEFAULT + 660, 60, 9);
+
+    /* Zakres czasu rekordow sprzed cofniecia zegara nie jest udostepniany */
+    snprintf(path, sizeof(path), "/history?from=%u&to=%u", TIME_REAL, TIME_REAL + 3600);
+    CHECK(httpGet(path) == TRUE);
+    checkHistory(0, 60, 0);
+
+    /* Zakres po koncu dziennika i odwrocony */
+    snprintf(path, sizeof(path), "/history?from=%u", TIME_DEFAULT + after * 60);
+    CHECK(httpGet(path) == TRUE);
+    checkHistory(0, 60, 0);
+    snprintf(path, sizeof(path), "/history?from=%u&to=%u", TIME_DEFAULT + 1200, TIME_DEFAULT + 600);
+    CHECK(httpGet(path) == TRUE);
+    checkHistory(0, 60, 0);
+
+    /* Inne zasoby */
+    CHECK(httpGet("/missing") == TRUE);
+    CHECK(strncmp(response, "HTTP/1.0 404 Not Found\r\n", 24) == 0);
+    CHECK(httpGet("/now") == TRUE);
+    CHECK(strstr(response, "\r\n\r\nnull\n") != NULL);
+    http_setSample(TIME_REAL, -55, 100900, 81, 0);
+    CHECK(httpGet("/now") == TRUE);
+    CHECK(strstr(response, "{\"t\":1790812800,\"temp\":-5.5,\"press\":100900,\"hum\":81}\n") != NULL);
+
+    /* Wielkosci bez poprawnej wartosci jako null */
+    http_setSample(TIME_REAL, -55, 100900, 81, METRIC_BIT(METRIC_PRESSURE) | METRIC_BIT(METRIC_DEW_POINT));
+    CHECK(httpGet("/now") == TRUE);
+    CHECK(strstr(response, "{\"t\":1790812800,\"temp\":-5.5,\"press\":null,\"hum\":81}\n") != NULL);
+    http_setSample(TIME_REAL, -55, 100900, 81, METRIC_BIT(METRIC_TEMPERATURE) | METRIC_BIT(METRIC_HUMIDITY));
+    CHECK(httpGet("/now") == TRUE);
+    CHECK(strstr(response, "{\"t\":1790812800,\"temp\":null,\"press\":100900,\"hum\":null}\n") != NULL);
+}
+
+/* Rekordy dopisane w trakcie wysylania odpowiedzi */
+static void testHistoryAppend(void)
+{
+    uint32_t total = STUB_FLASH_PAGES * RECORDS_PER_PAGE;
+    uint32_t end = TIME_REAL;
+    datalog_record_t record;
+    char path[96];
+    uint32_t i = 0;
+
+    stub_flashErase();
+    CHECK(datalog_init() == TRUE);
+    for (i = 0; i < 5 * RECORDS_PER_PAGE; i++)
+    {
+        append(end);
+        end += 60;
+    }
+    setupNet();
+
+    /* Odpowiedz konczy sie na ostatnim rekordzie sprzed zapytania */
+    appendCount = 2 * RECORDS_PER_PAGE;
+    appendTime = end;
+    end += appendCount * 60;
+    CHECK(httpGet("/history") == TRUE);
+    checkHistory(TIME_REAL, 60, 5 * RECORDS_PER_PAGE);
+    appendCount = 0;
+    CHECK(httpGet("/history") == TRUE);
+    checkHistory(TIME_REAL, 60, 7 * RECORDS_PER_PAGE);
+
+    /* Pamiec pelna: nadpisanie stron przed wysylanym rekordem nie przesuwa odpowiedzi */
+    for (i = 7 * RECORDS_PER_PAGE; i < total; i++)
+    {
+        append(end);
+        end += 60;
+    }
+    CHECK_EQ(datalog_getRecordCount(), total);
+    CHECK(datalog_readRecord(10 * RECORDS_PER_PAGE, &record) == TRUE);
+    appendCount = 3 * RECORDS_PER_PAGE;
+    appendTime = end;
+    end += appendCount * 60;
+    snprintf(path, sizeof(path), "/history?from=%u&to=%u", record.time, record.time + 100 * 60);
+    CHECK(httpGet(path) == TRUE);
+    checkHistory(record.time, 60, 101);
+
+    /* Nadpisanie rekordu jeszcze niewyslanego zrywa polaczenie */
+    CHECK(datalog_readRecord(2 * RECORDS_PER_PAGE, &record) == TRUE);
+    appendCount = 6 * RECORDS_PER_PAGE;
+    appendTime = end;
+    snprintf(path, sizeof(path), "/history?from=%u", record.time);
+    CHECK(httpGet(path) == FALSE);
+    CHECK(resetReceived == TRUE);
+    appendCount = 0;
+    CHECK(httpGet("/now") == TRUE);
+}
+
+/* Klient z opcja MSS mniejsza niz rekord odpowiedzi */
+static void testSmallMss(void)
+{
+    char path[96];
+    uint32_t i = 0;
+
+    stub_flashErase();
+    CHECK(datalog_init() == TRUE);
+    for (i = 0; i < 3 * RECORDS_PER_PAGE; i++)
+    {
+        append(TIME_REAL + i * 60);
+    }
+    setupNet();
+    http_setSample(TIME_REAL, -55, 100900, 81, 0);
+
+    clientMss = 16;
+    CHECK(httpGet("/now") == TRUE);
+    CHECK(strstr(response, "{\"t\":1790812800,\"temp\":-5.5,\"press\":100900,\"hum\":81}\n") != NULL);
+    snprintf(path, sizeof(path), "/history?from=%u&to=%u", TIME_REAL + 600, TIME_REAL + 1200);
+    CHECK(httpGet(path) == TRUE);
+    checkHistory(TIME_REAL + 600, 60, 11);
+    CHECK(maxDataLen <= 256);
+    clientMss = 1460;
+}
+
+/*!
+ *  @brief    Pomiar czasu wyszukania zakresu i wygenerowania odpowiedzi
+ */
+static void bench(void)
+{
+    char path[96];
+    const int loops = 2000;
+    double start = 0;
+    uint32_t reads = 0;
+    int i = 0;
+
+    stub_flashReads = 0;
+    start = test_nowNs();
+    for (i = 0; i < loops; i++)
+    {
+        snprintf(path, sizeof(path), "/history?from=%u&to=%u", TIME_DEFAULT + (uint32_t)(i % 200) * 60,
+                TIME_DEFAULT + (uint32_t)(i % 200) * 60 + 600);
+        httpGet(path);
+    }
+    reads = stub_flashReads;
+    printf("bench http /history 11 records: %.1f us/request, %.1f flash reads/request\n",
+            (test_nowNs() - start) / loops / 1000, (double)reads / loops);
+}
+
+int main(int argc, char* argv[])
+{
+    testSegment();
+    testSegmentWrap();
+    testHistory();
+    testHistoryAppend();
+    testSmallMss();
+
+    if ((argc > 1) && (strcmp(argv[1], "-b") == 0))
+    {
+        bench();
+    }
+
+    return test_report("test_http");
+}
@@ -0,0 +1,451 @@
+/*
+ * Test warstwy ARP/IPv4/UDP (src/net.c) bez PHY. Kontroler EMAC jest
+ * zastapiony kolejka ramek (stubs/emac_stub.c): ramki odebrane sa podawane
+ * jako zapisane wczesniej zrzuty, ramki wyslane sa sprawdzane bajt po bajcie
+ * i niezalezna implementacja sum kontrolnych.
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "stubs.h"
+#include "net.h"
+#include "lpc17xx_emac.h"
+
+#define STATION_IP   NET_IP(192, 168, 1, 50)
+#define PC_IP        NET_IP(192, 168, 1, 10)
+#define GATEWAY_IP   NET_IP(192, 168, 1, 1)
+
+static const uint8_t stationMac[6] = { 0x02, 0x00, 192, 168, 1, 50 };
+static const uint8_t pcMac[6] = { 0x00, 0x1B, 0x21, 0x3A, 0x4F, 0x5C };
+static const uint8_t gatewayMac[6] = { 0x00, 0x0C, 0x29, 0x11, 0x22, 0x33 };
+
+/* Zrzut zapytania ARP "who-has 192.168.1.50 tell 192.168.1.10" (ramka dopelniona do 60 bajtow) */
+static const uint8_t arpRequestFrame[60] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x1B, 0x21, 0x3A, 0x4F, 0x5C, 0x08, 0x06,
+    0x00, 0x01, 0x08, 0x00, 0x06, 0x04, 0x00, 0x01,
+    0x00, 0x1B, 0x21, 0x3A, 0x4F, 0x5C, 0xC0, 0xA8, 0x01, 0x0A,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0xA8, 0x01, 0x32
+};
+
+/* Oczekiwana odpowiedz ARP stacji */
+static const uint8_t arpReplyFrame[42] = {
+    0x00, 0x1B, 0x21, 0x3A, 0x4F, 0x5C, 0x02, 0x00, 0xC0, 0xA8, 0x01, 0x32, 0x08, 0x06,
+    0x00, 0x01, 0x08, 0x00, 0x06, 0x04, 0x00, 0x02,
+    0x02, 0x00, 0xC0, 0xA8, 0x01, 0x32, 0xC0, 0xA8, 0x01, 0x32,
+    0x00, 0x1B, 0x21, 0x3A, 0x4F, 0x5C, 0xC0, 0xA8, 0x01, 0x0A
+};
+
+static uint32_t tcpCalls = 0;
+static uint32_t tcpSrcIp = 0;
+static uint32_t tcpLen = 0;
+static uint8_t tcpSegment[64];
+
+static void tcpHandler(uint32_t srcIp, const uint8_t* pSrcMac, const uint8_t* pTcp, uint32_t len)
+{
+    tcpCalls++;
+    tcpSrcIp = srcIp;
+    tcpLen = len;
+    CHECK(memcmp(pSrcMac, pcMac, 6) == 0);
+    memcpy(tcpSegment, pTcp, (len < sizeof(tcpSegment)) ? len : sizeof(tcpSegment));
+}
+
+/*!
+ *  @brief    Wzorcowa suma kontrolna Internetu (RFC 1071)
+ */
+static uint16_t refChecksum(uint32_t sum, const uint8_t* p, uint32_t len)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i + 1 < len; i += 2)
+    {
+        sum += (uint32_t)((p[i] << 8) | p[i + 1]);
+    }
+    if (len & 1)
+    {
+        sum += (uint32_t)(p[len - 1] << 8);
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+
+    return (uint16_t)~sum;
+}
+
+static uint32_t get32(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint16_t get16(const uint8_t* p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static void put16(uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+}
+
+static void put32(uint8_t* p, uint32_t value)
+{
+    put16(p, (uint16_t)(value >> 16));
+    put16(&p[2], (uint16_t)value);
+}
+
+/*!
+ *  @brief    Funkcja budujaca ramke z pakietem IPv4 od komputera PC
+ *  @returns  Dlugosc ramki (co najmniej 60 bajtow jak w sieci)
+ */
+static uint32_t buildIpFrame(uint8_t* pFrame, uint8_t protocol, const uint8_t* pData, uint16_t len)
+{
+    uint8_t* pIp = &pFrame[NET_ETH_HEADER_SIZE];
+    uint32_t frameLen = NET_IP_PAYLOAD_OFFSET + len;
+
+    memset(pFrame, 0, 60);
+    memcpy(&pFrame[0], stationMac, 6);
+    memcpy(&pFrame[6], pcMac, 6);
+    put16(&pFrame[12], 0x0800);
+    pIp[0] = 0x45;
+    put16(&pIp[2], NET_IP_HEADER_SIZE + len);
+    put16(&pIp[4], 0x1234);
+    put16(&pIp[6], 0x4000);
+    pIp[8] = 64;
+    pIp[9] = protocol;
+    put32(&pIp[12], PC_IP);
+    put32(&pIp[16], STATION_IP);
+    put16(&pIp[10], refChecksum(0, pIp, NET_IP_HEADER_SIZE));
+    memcpy(&pIp[NET_IP_HEADER_SIZE], pData, len);
+
+    return (frameLen < 60) ? 60 : frameLen;
+}
+
+/*!
+ *  @brief    Procedura sprawdzajaca naglowki wyslanego pakietu IPv4
+ */
+static void checkIpFrame(const stub_frame_t* pFrame, const uint8_t* pDstMac, uint32_t dstIp, uint8_t protocol)
+{
+    const uint8_t* pIp = &pFrame->data[NET_ETH_HEADER_SIZE];
+
+    CHECK(memcmp(&pFrame->data[0], pDstMac, 6) == 0);
+    CHECK(memcmp(&pFrame->data[6], stationMac, 6) == 0);
+    CHECK_EQ(get16(&pFrame->data[12]), 0x0800);
+    CHECK_EQ(pIp[0], 0x45);
+    CHECK_EQ(get16(&pIp[2]), pFrame->len - NET_ETH_HEADER_SIZE);
+    CHECK_EQ(pIp[9], protocol);
+    CHECK_EQ(get32(&pIp[12]), STATION_IP);
+    CHECK_EQ(get32(&pIp[16]), dstIp);
+    CHECK_EQ(refChecksum(0, pIp, NET_IP_HEADER_SIZE), 0);
+}
+
+static void setup(void)
+{
+    memset(&stub_config, 0, sizeof(stub_config));
+    stub_config.netIp = STATION_IP;
+    stub_config.netMask = NET_IP(255, 255, 255, 0);
+    stub_config.netGateway = GATEWAY_IP;
+    stub_config.collectorIp = PC_IP;
+    stub_config.collectorPort = 5005;
+    stub_emacReset();
+    net_setTcpHandler(tcpHandler);
+}
+
+/* Brak kabla nie wstrzymuje uruchomienia, lacze jest wykrywane w net_poll */
+static void testLinkNotBlocking(void)
+{
+    setup();
+
+    CHECK(net_init() == TRUE);
+    CHECK(net_isUp() == FALSE);
+    CHECK(net_udpBegin() == NULL);
+    CHECK(net_ipBegin() == NULL);
+
+    /* Pierwsze wywolanie sprawdza lacze, kolejne co NET_LINK_POLL_MS */
+    net_poll(100);
+    CHECK_EQ(stub_emacLinkPolls, 1);
+    net_poll(500);
+    CHECK_EQ(stub_emacLinkPolls, 1);
+    net_poll(600);
+    CHECK_EQ(stub_emacLinkPolls, 2);
+    CHECK(net_isUp() == FALSE);
+
+    /* Ramki nie sa obslugiwane bez lacza */
+    stub_emacReceive(arpRequestFrame, sizeof(arpRequestFrame), 0);
+    net_poll(700);
+    CHECK_EQ(stub_emacTxCount, 0);
+
+    stub_emacLink = 1;
+    net_poll(1100);
+    CHECK(net_isUp() == TRUE);
+    CHECK_EQ(stub_emacTxCount, 1);
+
+    /* Utrata lacza */
+    stub_emacLink = 0;
+    net_poll(1600);
+    CHECK(net_isUp() == FALSE);
+    CHECK(net_udpBegin() == NULL);
+
+    stub_emacLink = -1;
+    net_poll(2100);
+    CHECK(net_isUp() == FALSE);
+}
+
+/* Interfejs wylaczony adresem 0 i brak PHY */
+static void testDisabled(void)
+{
+    setup();
+    stub_config.netIp = 0;
+    CHECK(net_init() == FALSE);
+    net_poll(1000);
+    CHECK_EQ(stub_emacLinkPolls, 0);
+
+    setup();
+    stub_emacInitOk = FALSE;
+    CHECK(net_init() == FALSE);
+    net_poll(1000);
+    CHECK(net_isUp() == FALSE);
+}
+
+static void bringUp(void)
+{
+    setup();
+    CHECK(net_init() == TRUE);
+    stub_emacLink = 1;
+    net_poll(1000);
+    CHECK(net_isUp() == TRUE);
+}
+
+static void testArpReply(void)
+{
+    uint8_t frame[60];
+
+    bringUp();
+
+    stub_emacReceive(arpRequestFrame, sizeof(arpRequestFrame), 0);
+    net_poll(1100);
+    CHECK_EQ(stub_emacTxCount, 1);
+    CHECK_EQ(stub_emacTx[0].len, sizeof(arpReplyFrame));
+    CHECK(memcmp(stub_emacTx[0].data, arpReplyFrame, sizeof(arpReplyFrame)) == 0);
+
+    /* Zapytanie o inny adres jest pomijane */
+    memcpy(frame, arpRequestFrame, sizeof(frame));
+    frame[41] = 0x33;
+    stub_emacReceive(frame, sizeof(frame), 0);
+    /* Ramka z bledem CRC jest tylko liczona */
+    stub_emacReceive(arpRequestFrame, sizeof(arpRequestFrame), EMAC_RINFO_CRC_ERR);
+    net_poll(1200);
+    CHECK_EQ(stub_emacTxCount, 1);
+    CHECK_EQ(net_getStats()->rxErrors, 1);
+    CHECK_EQ(net_getStats()->rxFrames, 2);
+}
+
+/* Datagram do odbiorcy w tej samej podsieci: zapytanie ARP, odpowiedz, wyslanie */
+static void testUdpSend(void)
+{
+    static const uint8_t payload[] = { 0x01, 0x07, 0x00, 0xFF, 0x10, 0x20, 0x30 };
+    uint8_t frame[60];
+    const stub_frame_t* pTx = NULL;
+    const uint8_t* pUdp = NULL;
+    uint8_t* pData = NULL;
+    uint32_t sum = 0;
+
+    bringUp();
+
+    CHECK(net_udpBegin() == NULL);
+    CHECK_EQ(net_getStats()->txDropped, 1);
+    net_poll(1100);
+    CHECK_EQ(stub_emacTxCount, 1);
+    pTx = &stub_emacTx[0];
+    CHECK_EQ(pTx->len, 42);
+    CHECK(memcmp(pTx->data, "\xFF\xFF\xFF\xFF\xFF\xFF", 6) == 0);
+    CHECK_EQ(get16(&pTx->data[20]), 1);
+    CHECK_EQ(get32(&pTx->data[38]), PC_IP);
+
+    /* Zapytanie jest ponawiane co sekunde */
+    net_poll(1500);
+    CHECK_EQ(stub_emacTxCount, 1);
+    net_poll(2100);
+    CHECK_EQ(stub_emacTxCount, 2);
+
+    /* Odpowiedz ARP od komputera PC */
+    memcpy(frame, arpReplyFrame, 42);
+    memset(&frame[42], 0, 18);
+    memcpy(&frame[0], stationMac, 6);
+    memcpy(&frame[6], pcMac, 6);
+    memcpy(&frame[22], pcMac, 6);
+    put32(&frame[28], PC_IP);
+    memcpy(&frame[32], stationMac, 6);
+    put32(&frame[38], STATION_IP);
+    stub_emacReceive(frame, sizeof(frame), 0);
+    net_poll(2200);
+    CHECK_EQ(stub_emacTxCount, 2);
+
+    pData = net_udpBegin();
+    CHECK(pData != NULL);
+    if (pData == NULL)
+    {
+        return;
+    }
+    memcpy(pData, payload, sizeof(payload));
+    net_udpSend(sizeof(payload));
+    CHECK_EQ(stub_emacTxCount, 3);
+
+    pTx = &stub_emacTx[2];
+    CHECK_EQ(pTx->len, NET_UDP_PAYLOAD_OFFSET + sizeof(payload));
+    checkIpFrame(pTx, pcMac, PC_IP, NET_PROTO_UDP);
+    pUdp = &pTx->data[NET_IP_PAYLOAD_OFFSET];
+    CHECK_EQ(get16(&pUdp[0]), NET_UDP_LOCAL_PORT);
+    CHECK_EQ(get16(&pUdp[2]), 5005);
+    CHECK_EQ(get16(&pUdp[4]), NET_UDP_HEADER_SIZE + sizeof(payload));
+    CHECK(memcmp(&pUdp[NET_UDP_HEADER_SIZE], payload, sizeof(payload)) == 0);
+    sum = (STATION_IP >> 16) + (STATION_IP & 0xFFFF) + (PC_IP >> 16) + (PC_IP & 0xFFFF)
+            + NET_PROTO_UDP + NET_UDP_HEADER_SIZE + sizeof(payload);
+    CHECK_EQ(refChecksum(sum, pUdp, NET_UDP_HEADER_SIZE + sizeof(payload)), 0);
+
+    /* Brak wolnego deskryptora */
+    stub_emacTxFree = 0;
+    CHECK(net_udpBegin() == NULL);
+}
+
+/* Odbiorca poza podsiecia - ramka jest adresowana do bramy */
+static void testUdpViaGateway(void)
+{
+    uint8_t frame[60];
+    const stub_frame_t* pTx = NULL;
+    uint8_t* pData = NULL;
+
+    bringUp();
+    stub_config.collectorIp = NET_IP(10, 0, 0, 7);
+
+    CHECK(net_udpBegin() == NULL);
+    net_poll(1100);
+    CHECK_EQ(stub_emacTxCount, 1);
+    CHECK_EQ(get32(&stub_emacTx[0].data[38]), GATEWAY_IP);
+
+    memset(frame, 0, sizeof(frame));
+    memcpy(&frame[0], stationMac, 6);
+    memcpy(&frame[6], gatewayMac, 6);
+    memcpy(&frame[12], "\x08\x06\x00\x01\x08\x00\x06\x04\x00\x02", 10);
+    memcpy(&frame[22], gatewayMac, 6);
+    put32(&frame[28], GATEWAY_IP);
+    memcpy(&frame[32], stationMac, 6);
+    put32(&frame[38], STATION_IP);
+    stub_emacReceive(frame, sizeof(frame), 0);
+    net_poll(1200);
+
+    pData = net_udpBegin();
+    CHECK(pData != NULL);
+    if (pData == NULL)
+    {
+        return;
+    }
+    pData[0] = 0x42;
+    net_udpSend(1);
+    pTx = &stub_emacTx[1];
+    checkIpFrame(pTx, gatewayMac, NET_IP(10, 0, 0, 7), NET_PROTO_UDP);
+}
+
+/* Segment TCP jest przekazywany do procedury obslugi, bledny naglowek IP nie */
+static void testTcpDispatch(void)
+{
+    static const uint8_t syn[24] = {
+        0x9C, 0x40, 0x00, 0x50, 0x11, 0x22, 0x33, 0x44, 0x00, 0x00, 0x00, 0x00,
+        0x60, 0x02, 0xFA, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x02, 0x04, 0x05, 0xB4
+    };
+    uint8_t frame[STUB_EMAC_FRAME_SIZE];
+    uint32_t len = 0;
+
+    bringUp();
+    tcpCalls = 0;
+
+    len = buildIpFrame(frame, NET_PROTO_TCP, syn, sizeof(syn));
+    CHECK_EQ(len, 60);
+    stub_emacReceive(frame, len, 0);
+    net_poll(1100);
+    CHECK_EQ(tcpCalls, 1);
+    CHECK_EQ(tcpSrcIp, PC_IP);
+    CHECK_EQ(tcpLen, sizeof(syn));
+    CHECK(memcmp(tcpSegment, syn, sizeof(syn)) == 0);
+
+    /* Bledna suma naglowka IP */
+    frame[NET_ETH_HEADER_SIZE + 10] ^= 0x01;
+    stub_emacReceive(frame, len, 0);
+    /* Fragment */
+    len = buildIpFrame(frame, NET_PROTO_TCP, syn, sizeof(syn));
+    put16(&frame[NET_ETH_HEADER_SIZE + 6], 0x2000);
+    put16(&frame[NET_ETH_HEADER_SIZE + 10], 0);
+    put16(&frame[NET_ETH_HEADER_SIZE + 10], refChecksum(0, &frame[NET_ETH_HEADER_SIZE], NET_IP_HEADER_SIZE));
+    stub_emacReceive(frame, len, 0);
+    net_poll(1200);
+    CHECK_EQ(tcpCalls, 1);
+
+    /* Pakiet wyslany przez net_ipBegin/net_ipSend */
+    {
+        uint8_t* pData = net_ipBegin();
+
+        CHECK(pData != NULL);
+        if (pData != NULL)
+        {
+            memset(pData, 0x5A, 20);
+            net_ipSend(pcMac, PC_IP, NET_PROTO_TCP, 20);
+            CHECK_EQ(stub_emacTx[stub_emacTxCount - 1].len, NET_IP_PAYLOAD_OFFSET + 20);
+            checkIpFrame(&stub_emacTx[stub_emacTxCount - 1], pcMac, PC_IP, NET_PROTO_TCP);
+        }
+    }
+}
+
+/*!
+ *  @brief    Pomiar czasu obslugi ramki ARP i budowy datagramu UDP
+ */
+static void bench(void)
+{
+    const int loops = 1000000;
+    double start = 0;
+    int i = 0;
+
+    bringUp();
+
+    start = test_nowNs();
+    for (i = 0; i < loops; i++)
+    {
+        stub_emacReceive(arpRequestFrame, sizeof(arpRequestFrame), 0);
+        net_poll(1100);
+        stub_emacTxCount = 0;
+        stub_emacTxFree = STUB_EMAC_FRAMES;
+    }
+    printf("bench net ARP request/reply: %.1f ns/frame\n", (test_nowNs() - start) / loops);
+
+    start = test_nowNs();
+    for (i = 0; i < loops; i++)
+    {
+        uint8_t* pData = net_udpBegin();
+
+        if (pData != NULL)
+        {
+            memset(pData, i, 17);
+            net_udpSend(17);
+        }
+        stub_emacTxCount = 0;
+        stub_emacTxFree = STUB_EMAC_FRAMES;
+    }
+    printf("bench net UDP datagram: %.1f ns/frame\n", (test_nowNs() - start) / loops);
+}
+
+int main(int argc, char* argv[])
+{
+    testLinkNotBlocking();
+    testDisabled();
+    testArpReply();
+    testUdpSend();
+    testUdpViaGateway();
+    testTcpDispatch();
+
+    if ((argc > 1) && (strcmp(argv[1], "-b") == 0))
+    {
+        bench();
+    }
+
+    return test_report("test_net");
+}
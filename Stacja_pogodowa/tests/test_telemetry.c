@@ -0,0 +1,493 @@
+/*
+ * Wektory testowe ramek telemetrii (src/telemetry.c, src/cobs.c, src/crc.c,
+ * src/telemetry_frame.h).
+ *
+ * Sprawdzane sa wzorcowe wektory COBS (w tym blok 254 bajtow bez zer i dane
+ * z samych zer) i wartosc kontrolna CRC-16/CCITT. Ramki odczytow i alarmow
+ * sa kodowane przez telemetry.c wprost w buforze nadawczym UART0
+ * (stubs/uart0_stub.c, indeksy bufora przechodza przez jego koniec) i
+ * porownywane ze stalymi bajtami. Z opcja -w ramki sa zapisywane do pliku,
+ * ktory make check podaje dekoderowi tools/telemetry_decode i porownuje wynik
+ * z vectors/telemetry_frames.csv.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "stubs.h"
+#include "cobs.h"
+#include "crc.h"
+#include "uart0.h"
+#include "telemetry.h"
+#include "telemetry_frame.h"
+
+#define FRAME_MAX 600
+
+/* Ramka odczytu po zakodowaniu COBS, z ogranicznikiem */
+#define FRAME_SAMPLE_ENCODED \
+    (TELEMETRY_HEADER_SIZE + TELEMETRY_SAMPLE_SIZE + TELEMETRY_CRC_SIZE + TELEMETRY_COBS_OVERHEAD)
+
+typedef struct
+{
+    uint8_t data[FRAME_MAX];
+    uint32_t len;
+} frame_t;
+
+/*!
+ *  @brief    Procedura dopisujaca pola little-endian do ramki
+ */
+static void putU8(frame_t* pFrame, uint8_t value)
+{
+    pFrame->data[pFrame->len++] = value;
+}
+
+static void putU16(frame_t* pFrame, uint16_t value)
+{
+    putU8(pFrame, (uint8_t)value);
+    putU8(pFrame, (uint8_t)(value >> 8));
+}
+
+static void putU32(frame_t* pFrame, uint32_t value)
+{
+    putU16(pFrame, (uint16_t)value);
+    putU16(pFrame, (uint16_t)(value >> 16));
+}
+
+/*!
+ *  @brief    Procedura rozpoczynajaca ramke eksportu dziennika (uklad jak w
+ *            src/export.c, ktory koduje cala ramke funkcja cobs_encode)
+ */
+static void frameBegin(frame_t* pFrame, uint8_t type, uint8_t sequence)
+{
+    pFrame->len = 0;
+    putU8(pFrame, type);
+    putU8(pFrame, sequence);
+}
+
+/*!
+ *  @brief    Procedura konczaca ramke suma CRC i kodujaca ja algorytmem COBS
+ *  @returns  Dlugosc zakodowanej ramki z ogranicznikiem 0x00
+ */
+static uint32_t frameEnd(frame_t* pFrame, uint8_t* pOut)
+{
+    uint32_t len = 0;
+
+    putU16(pFrame, crc16(pFrame->data, pFrame->len));
+    len = cobs_encode(pFrame->data, pFrame->len, pOut);
+    pOut[len++] = 0;
+
+    return len;
+}
+
+/*!
+ *  @brief    Procedura dopisujaca rekord dziennika (uklad datalog_record_t)
+ */
+static void putLogRecord(frame_t* pFrame, uint32_t time, int32_t pressure, int16_t temperature,
+        int16_t humidity, int16_t dewPoint, uint16_t absHumidity, uint16_t light, uint8_t invalid)
+{
+    putU32(pFrame, time);
+    putU32(pFrame, (uint32_t)pressure);
+    putU16(pFrame, (uint16_t)temperature);
+    putU16(pFrame, (uint16_t)humidity);
+    putU16(pFrame, (uint16_t)dewPoint);
+    putU16(pFrame, absHumidity);
+    putU16(pFrame, light);
+    putU8(pFrame, invalid);
+    putU8(pFrame, 0);
+}
+
+static void testCrc(void)
+{
+    static const uint8_t check[] = "123456789";
+    uint16_t crc = CRC16_INIT;
+
+    CHECK_EQ(crc16(check, 9), 0x29B1);
+
+    crc = crc16_update(crc, check, 4);
+    crc = crc16_update(crc, &check[4], 5);
+    CHECK_EQ(crc, 0x29B1);
+}
+
+static void checkCobs(const uint8_t* pIn, uint32_t len, const uint8_t* pExpected, uint32_t expectedLen)
+{
+    uint8_t out[COBS_MAX_ENCODED_SIZE(FRAME_MAX)];
+    uint32_t outLen = cobs_encode(pIn, len, out);
+
+    CHECK_EQ(outLen, expectedLen);
+    CHECK(outLen <= COBS_MAX_ENCODED_SIZE(len));
+    CHECK(memcmp(out, pExpected, expectedLen) == 0);
+    CHECK(memchr(out, 0, outLen) == NULL);
+}
+
+static void testCobs(void)
+{
+    static const uint8_t in1[] = {0x00};
+    static const uint8_t out1[] = {0x01, 0x01};
+    static const uint8_t in2[] = {0x00, 0x00};
+    static const uint8_t out2[] = {0x01, 0x01, 0x01};
+    static const uint8_t in3[] = {0x11, 0x22, 0x00, 0x33};
+    static const uint8_t out3[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+    static const uint8_t in4[] = {0x11, 0x22, 0x33, 0x44};
+    static const uint8_t out4[] = {0x05, 0x11, 0x22, 0x33, 0x44};
+    static const uint8_t in5[] = {0x11, 0x00, 0x00, 0x00};
+    static const uint8_t out5[] = {0x02, 0x11, 0x01, 0x01, 0x01};
+    uint8_t in[256];
+    uint8_t out[260];
+    uint32_t i = 0;
+
+    checkCobs(in1, sizeof(in1), out1, sizeof(out1));
+    checkCobs(in2, sizeof(in2), out2, sizeof(out2));
+    checkCobs(in3, sizeof(in3), out3, sizeof(out3));
+    checkCobs(in4, sizeof(in4), out4, sizeof(out4));
+    checkCobs(in5, sizeof(in5), out5, sizeof(out5));
+
+    /* 01..FE - pelny blok 254 bajtow, koder konczy go pustym blokiem 0x01 */
+    for (i = 0; i < 254; i++)
+    {
+        in[i] = (uint8_t)(i + 1);
+        out[i + 1] = (uint8_t)(i + 1);
+    }
+    out[0] = 0xFF;
+    out[255] = 0x01;
+    checkCobs(in, 254, out, 256);
+
+    /* 00 01..FE */
+    in[0] = 0x00;
+    out[0] = 0x01;
+    out[1] = 0xFF;
+    for (i = 1; i < 255; i++)
+    {
+        in[i] = (uint8_t)i;
+        out[i + 1] = (uint8_t)i;
+    }
+    out[256] = 0x01;
+    checkCobs(in, 255, out, 257);
+
+    /* 01..FF - blok 254 bajtow i blok z jednym bajtem */
+    for (i = 0; i < 255; i++)
+    {
+        in[i] = (uint8_t)(i + 1);
+    }
+    out[0] = 0xFF;
+    for (i = 0; i < 254; i++)
+    {
+        out[i + 1] = (uint8_t)(i + 1);
+    }
+    out[255] = 0x02;
+    out[256] = 0xFF;
+    checkCobs(in, 255, out, 257);
+}
+
+/*!
+ *  @brief    Funkcja przenoszaca ramki z bufora nadawczego UART0 do strumienia
+ *  @returns  Liczba przeniesionych bajtow
+ */
+static uint32_t drain(uint8_t* pOut, uint32_t* pTotal)
+{
+    uint32_t len = stub_uart0Drain(&pOut[*pTotal], FRAME_MAX);
+
+    *pTotal += len;
+    return len;
+}
+
+/*!
+ *  @brief    Funkcja wysylajaca zestaw ramek przez src/telemetry.c. Oczekiwane
+ *            bajty ramek sa stalymi ponizej, oczekiwane linie dekodera sa w
+ *            pliku vectors/telemetry_frames.csv.
+ *  @returns  Dlugosc strumienia ramek
+ */
+static uint32_t buildFrames(uint8_t* pOut)
+{
+    /* alarm,0,0,off,0,0 - ramka z samych zer poza typem i CRC */
+    static const uint8_t zeroEncoded[] = {
+        0x02, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x03, 0x36, 0x35, 0x00
+    };
+    /* sample,1,123456789,-12.3,101325,45,-5.2,12.34,-0.3 */
+    static const uint8_t sampleEncoded[] = {
+        0x0C, 0x01, 0x01, 0x15, 0xCD, 0x5B, 0x07, 0x85, 0xFF, 0xCD, 0x8B, 0x01, 0x08, 0x2D, 0xCC,
+        0xFF, 0xD2, 0x04, 0xFD, 0xFF, 0x03, 0xE0, 0x41, 0x00
+    };
+    /* alarm,3,4,on,7,1500 */
+    static const uint8_t alarmEncoded[] = {
+        0x08, 0x03, 0x03, 0x04, 0x01, 0x07, 0xDC, 0x05, 0x01, 0x03, 0x30, 0x12, 0x00
+    };
+    derived_t derived;
+    uint32_t total = 0;
+    uint32_t len = 0;
+    frame_t frame;
+    uint32_t i = 0;
+
+    /* Indeksy bufora tuz przed przepelnieniem, ramki przechodza przez poczatek bufora */
+    stub_uart0Reset(0xFFFFFFF8);
+    telemetry_setEnabled(TRUE);
+
+    CHECK(telemetry_sendAlarm(0, FALSE, 0, 0) == TRUE);
+    len = drain(pOut, &total);
+    CHECK_EQ(len, sizeof(zeroEncoded));
+    CHECK(memcmp(&pOut[total - len], zeroEncoded, sizeof(zeroEncoded)) == 0);
+
+    derived.dewPoint = -52;
+    derived.absHumidity = 1234;
+    derived.heatIndex = -3;
+    telemetry_sendSample(123456789, -123, 101325, 45, &derived, 0);
+    len = drain(pOut, &total);
+    CHECK_EQ(len, sizeof(sampleEncoded));
+    CHECK(memcmp(&pOut[total - len], sampleEncoded, sizeof(sampleEncoded)) == 0);
+
+    /* sample,2,123457789,-12.3,,45,,,-0.3 - cisnienie i punkt rosy bez poprawnej wartosci */
+    telemetry_sendSample(123457789, -123, 101325, 45, &derived,
+            TELEMETRY_INVALID_PRESSURE | TELEMETRY_INVALID_DEW_POINT);
+    drain(pOut, &total);
+
+    CHECK(telemetry_sendAlarm(4, TRUE, 7, 1500) == TRUE);
+    len = drain(pOut, &total);
+    CHECK_EQ(len, sizeof(alarmEncoded));
+    CHECK(memcmp(&pOut[total - len], alarmEncoded, sizeof(alarmEncoded)) == 0);
+
+    /* alarm,3,0,off,1,-250 */
+    CHECK(telemetry_sendAlarm(0, FALSE, 1, -250) == TRUE);
+    drain(pOut, &total);
+
+    /* Wylaczony strumien nie zuzywa numeru sekwencyjnego */
+    telemetry_setEnabled(FALSE);
+    CHECK(telemetry_sendAlarm(5, TRUE, 2, 1) == FALSE);
+    telemetry_sendSample(1, 2, 3, 4, &derived, 0);
+    CHECK_EQ(drain(pOut, &total), 0);
+    telemetry_setEnabled(TRUE);
+
+    /*
+     * Eksport dziennika (export.c: CRC-16 i cobs_encode calej ramki). Strona
+     * w wersji 2: naglowek i dwa rekordy po 20 bajtow.
+     */
+    frameBegin(&frame, TELEMETRY_REC_EXPORT, 10);
+    putU32(&frame, 3);
+    putU32(&frame, 10);
+    putU16(&frame, 8 + 2 * 20);
+    putU32(&frame, 5);
+    putU8(&frame, 2);
+    putU8(&frame, 2);
+    putU16(&frame, 0x1234);
+    putLogRecord(&frame, 1718280000, 101325, 215, 40, 75, 754, 320, 0);
+    putLogRecord(&frame, 1718280060, 99000, -45, 95, -58, 412, 0,
+            TELEMETRY_INVALID_TEMPERATURE | TELEMETRY_INVALID_DEW_POINT | TELEMETRY_INVALID_LIGHT);
+    len = frameEnd(&frame, &pOut[total]);
+    total += len;
+
+    /* Strona innej wersji dziennika jest pomijana - brak linii na stdout */
+    frameBegin(&frame, TELEMETRY_REC_EXPORT, 11);
+    putU32(&frame, 0);
+    putU32(&frame, 10);
+    putU16(&frame, 8 + 20);
+    putU32(&frame, 1);
+    putU8(&frame, 1);
+    putU8(&frame, 1);
+    putU16(&frame, 0x4321);
+    putLogRecord(&frame, 1700000000, 100000, -5, 100, -7, 5, 0, 0);
+    len = frameEnd(&frame, &pOut[total]);
+    total += len;
+
+    /* Koniec eksportu - brak linii na stdout */
+    frameBegin(&frame, TELEMETRY_REC_EXPORT, 12);
+    putU32(&frame, 10);
+    putU32(&frame, 10);
+    putU16(&frame, 0);
+    len = frameEnd(&frame, &pOut[total]);
+    total += len;
+
+    /* Nieznany typ z 252 bajtami danych: typ, numer i dane tworza blok 254 bajtow bez zer */
+    frameBegin(&frame, 0x7F, 1);
+    for (i = 1; i <= 252; i++)
+    {
+        putU8(&frame, (uint8_t)i);
+    }
+    len = frameEnd(&frame, &pOut[total]);
+    CHECK_EQ(pOut[total], 0xFF);
+    CHECK_EQ(pOut[total + 1], 0x7F);
+    CHECK_EQ(pOut[total + 255], frame.len - 254 + 1);
+    CHECK(memchr(&pOut[total], 0, len - 1) == NULL);
+    total += len;
+
+    /* Ramka z blednym CRC jest pomijana przez dekoder */
+    CHECK(telemetry_sendAlarm(1, TRUE, 2, 777) == TRUE);
+    len = drain(pOut, &total);
+    pOut[total - len + 4] ^= 0x10;
+
+    /* alarm,5,2,on,3,65 - po blednej ramce dekoder synchronizuje sie na ograniczniku */
+    CHECK(telemetry_sendAlarm(2, TRUE, 3, 65) == TRUE);
+    drain(pOut, &total);
+
+    CHECK_EQ(stub_uart0Overruns, 0);
+    return total;
+}
+
+/*
+ * Pelny bufor nadawczy: ramka jest odrzucana w calosci, bez zapisu do
+ * bufora i bez zuzycia numeru sekwencyjnego
+ */
+static void testFullRing(void)
+{
+    static uint8_t stream[2 * UART0_TX_RING_SIZE];
+    derived_t derived;
+    uint32_t dropped = telemetry_getDropped();
+    uint32_t sent = 0;
+    uint32_t len = 0;
+
+    memset(&derived, 0, sizeof(derived));
+    stub_uart0Reset(0);
+
+    while (telemetry_getDropped() == dropped)
+    {
+        telemetry_sendSample(sent, 1, 2, 3, &derived, 0);
+        sent++;
+    }
+    sent--;
+    CHECK_EQ(sent, UART0_TX_RING_SIZE / FRAME_SAMPLE_ENCODED);
+    CHECK(uart0_txFree() < FRAME_SAMPLE_ENCODED);
+    CHECK_EQ(telemetry_getDropped(), dropped + 1);
+
+    len = stub_uart0Drain(stream, sizeof(stream));
+    CHECK_EQ(len, sent * FRAME_SAMPLE_ENCODED);
+
+    /* Numer nastepnej ramki (bajt po kodzie COBS i typie) zaraz po ostatniej wyslanej */
+    CHECK(telemetry_sendAlarm(0, TRUE, 1, 1) == TRUE);
+    CHECK_EQ(stub_uart0Drain(&stream[len], FRAME_MAX), 13);
+    CHECK_EQ(stream[len + 2], (uint8_t)(stream[2] + sent));
+    CHECK_EQ(stub_uart0Overruns, 0);
+}
+
+static uint32_t rngState = 2463534242U;
+
+static uint32_t rng(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+/*
+ * Datagram UDP to ta sama ramka bez kodowania COBS. Losowe odczyty (takze
+ * z bajtami zerowymi) wysylane obiema drogami musza sie zgadzac po
+ * zakodowaniu datagramu. Datagramy maja wlasny numer, niezalezny od ramek
+ * alarmow na UART.
+ */
+static void testUdp(void)
+{
+    uint8_t serial[FRAME_MAX];
+    uint8_t encoded[COBS_MAX_ENCODED_SIZE(FRAME_MAX)];
+    derived_t derived;
+    uint32_t mismatches = 0;
+    uint32_t count = stub_udpCount;
+    uint32_t len = 0;
+    uint8_t first = 0;
+    uint32_t i = 0;
+
+    memset(&derived, 0, sizeof(derived));
+    stub_uart0Reset(0);
+
+    /* Zrownanie numerow ramek szeregowych z numerem datagramow */
+    telemetry_sendSampleUdp(0, 0, 0, 0, &derived, 0);
+    first = stub_udpData[1];
+    do
+    {
+        CHECK(telemetry_sendAlarm(0, FALSE, 0, 0) == TRUE);
+        stub_uart0Drain(serial, sizeof(serial));
+        /* Numer 0 zamyka pierwszy blok COBS po typie rekordu */
+    } while (((serial[0] == 2) ? 0 : serial[2]) != first);
+
+    for (i = 0; i < 5000; i++)
+    {
+        uint32_t value = rng();
+        int32_t pressure = (int32_t)(rng() & ((value & 4) ? 0x1FF00 : 0x1FFFF));
+        uint8_t invalid = (uint8_t)(rng() & ((value & 8) ? 0x7E : 0));
+
+        derived.dewPoint = (int16_t)(rng() & ((value & 1) ? 0xFF00 : 0x00FF));
+        derived.absHumidity = (uint16_t)rng();
+        derived.heatIndex = (int16_t)((value & 2) ? 0 : rng());
+        value = rng();
+
+        telemetry_sendSample(value, (int16_t)(value >> 3), pressure, (int16_t)(value & 0x7F), &derived, invalid);
+        telemetry_sendSampleUdp(value, (int16_t)(value >> 3), pressure, (int16_t)(value & 0x7F), &derived,
+                invalid);
+        len = stub_uart0Drain(serial, sizeof(serial));
+
+        if ((stub_udpLen != TELEMETRY_HEADER_SIZE + TELEMETRY_SAMPLE_SIZE + TELEMETRY_CRC_SIZE)
+                || (cobs_encode(stub_udpData, stub_udpLen, encoded) + 1 != len)
+                || (memcmp(encoded, serial, len - 1) != 0))
+        {
+            mismatches++;
+        }
+    }
+
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(stub_udpCount, count + 5001);
+    CHECK_EQ(stub_uart0Overruns, 0);
+}
+
+/*!
+ *  @brief    Pomiar czasu kodowania ramki COBS i liczenia CRC
+ */
+static void bench(void)
+{
+    uint8_t in[256];
+    uint8_t out[COBS_MAX_ENCODED_SIZE(256)];
+    volatile uint32_t sink = 0;
+    const int loops = 200000;
+    double start = 0;
+    int i = 0;
+
+    for (i = 0; i < 256; i++)
+    {
+        in[i] = (uint8_t)(i * 7);
+    }
+
+    start = test_nowNs();
+    for (i = 0; i < loops; i++)
+    {
+        in[0] = (uint8_t)i;
+        sink += crc16(in, sizeof(in));
+    }
+    printf("bench crc16: %.2f ns/byte\n", (test_nowNs() - start) / loops / sizeof(in));
+
+    start = test_nowNs();
+    for (i = 0; i < loops; i++)
+    {
+        in[0] = (uint8_t)i;
+        sink += cobs_encode(in, sizeof(in), out);
+    }
+    printf("bench cobs_encode: %.2f ns/byte\n", (test_nowNs() - start) / loops / sizeof(in));
+    (void)sink;
+}
+
+int main(int argc, char* argv[])
+{
+    static uint8_t stream[8 * FRAME_MAX];
+    uint32_t len = 0;
+
+    testCrc();
+    testCobs();
+    len = buildFrames(stream);
+    testFullRing();
+    testUdp();
+
+    if ((argc > 2) && (strcmp(argv[1], "-w") == 0))
+    {
+        FILE* pFile = fopen(argv[2], "wb");
+
+        if ((pFile == NULL) || (fwrite(stream, 1, len, pFile) != len))
+        {
+            perror(argv[2]);
+            return 1;
+        }
+        fclose(pFile);
+        return (testFailures == 0) ? 0 : 1;
+    }
+
+    if ((argc > 1) && (strcmp(argv[1], "-b") == 0))
+    {
+        bench();
+    }
+
+    return test_report("test_telemetry");
+}
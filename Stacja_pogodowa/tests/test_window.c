@@ -0,0 +1,235 @@
+/*
+ * Test okna przesuwnego z kolejkami monotonicznymi (src/window.c). Po kazdym
+ * z 200000 dopisan minimum, maksimum i srednia sa porownywane z wynikiem
+ * liczonym wprost z ostatnich WINDOW_SIZE wartosci. Z opcja -b mierzony jest
+ * czas window_push i window_get.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "test.h"
+#include "window.h"
+
+#define PUSHES 200000
+
+static uint32_t rngState = 2463534242U;
+
+static uint32_t rng(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+/*!
+ *  @brief    Wartosc testowa: przebiegi losowe, monotoniczne, stale i
+ *            pilokszaltne (najgorszy przypadek dla kolejek), zmieniane co 1000
+ *            dopisan. Modul ograniczony tak, aby suma okna miescila sie w int32.
+ */
+static int32_t nextValue(uint32_t i)
+{
+    static int32_t ramp = 0;
+    uint32_t pattern = (i / 1000) % 6;
+
+    switch (pattern)
+    {
+        case 0:
+            return (int32_t)(rng() % 20000001) - 10000000;
+        case 1:
+            return ++ramp;
+        case 2:
+            return --ramp;
+        case 3:
+            return 42;
+        case 4:
+            return (int32_t)(i % 37) * (((i / 37) & 1) ? 1 : -1);
+        default:
+            return (int32_t)(rng() % 5) - 2;
+    }
+}
+
+static void testBruteForce(void)
+{
+    static int32_t history[PUSHES];
+    window_t window;
+    window_result_t result;
+    uint32_t failures = 0;
+    uint32_t i = 0;
+
+    window_init(&window);
+    window_get(&window, &result);
+    CHECK_EQ(result.count, 0);
+
+    for (i = 0; i < PUSHES; i++)
+    {
+        uint32_t count = (i + 1 < WINDOW_SIZE) ? (i + 1) : WINDOW_SIZE;
+        int32_t min = 0;
+        int32_t max = 0;
+        int64_t sum = 0;
+        int64_t mean = 0;
+        uint32_t j = 0;
+
+        history[i] = nextValue(i);
+        window_push(&window, history[i]);
+        window_get(&window, &result);
+
+        min = history[i];
+        max = history[i];
+        for (j = i + 1 - count; j <= i; j++)
+        {
+            min = (history[j] < min) ? history[j] : min;
+            max = (history[j] > max) ? history[j] : max;
+            sum += history[j];
+        }
+        /* Srednia zaokraglona od zera */
+        mean = llround((double)sum / count);
+
+        if ((result.count != count) || (result.min != min) || (result.max != max) || (result.mean != mean))
+        {
+            if (failures++ < 10)
+            {
+                fprintf(stderr, "push %u: count %u min %d max %d mean %d, expected %u %d %d %lld\n", i,
+                        result.count, result.min, result.max, result.mean, count, min, max, (long long)mean);
+            }
+        }
+    }
+
+    testChecks++;
+    if (failures != 0)
+    {
+        testFailures++;
+        fprintf(stderr, "test_window: %u of %u pushes differ from brute force\n", failures, PUSHES);
+    }
+
+    /* Kolejki nie przekraczaja rozmiaru okna */
+    CHECK(window.minCount <= WINDOW_SIZE);
+    CHECK(window.maxCount <= WINDOW_SIZE);
+}
+
+/* Srednie z przedzialow WINDOW_INTERVAL_MS trafiaja do okien wielkosci */
+static void testIntervals(void)
+{
+    int32_t values[METRIC_COUNT];
+    window_result_t result;
+    uint32_t now = 0;
+    uint32_t i = 0;
+
+    window_reset();
+    memset(values, 0, sizeof(values));
+
+    /* Odczyty co sekunde: 1..31 w pierwszym przedziale */
+    for (i = 0; i <= 30; i++)
+    {
+        values[METRIC_TEMPERATURE] = (int32_t)i + 1;
+        values[METRIC_PRESSURE] = -((int32_t)i + 1);
+        window_addSample(now, values, 0);
+        window_getMetric(METRIC_TEMPERATURE, &result);
+        CHECK_EQ(result.count, (i < 30) ? 0 : 1);
+        now += 1000;
+    }
+    window_getMetric(METRIC_TEMPERATURE, &result);
+    CHECK_EQ(result.mean, 16);
+    window_getMetric(METRIC_PRESSURE, &result);
+    CHECK_EQ(result.mean, -16);
+
+    /* Przerwa dluzsza niz przedzial - kolejny przedzial liczony od nowa */
+    now += 5 * WINDOW_INTERVAL_MS;
+    values[METRIC_TEMPERATURE] = 100;
+    window_addSample(now, values, 0);
+    window_getMetric(METRIC_TEMPERATURE, &result);
+    CHECK_EQ(result.count, 2);
+    CHECK_EQ(result.max, 100);
+    window_addSample(now + WINDOW_INTERVAL_MS - 1, values, 0);
+    window_getMetric(METRIC_TEMPERATURE, &result);
+    CHECK_EQ(result.count, 2);
+    window_addSample(now + WINDOW_INTERVAL_MS, values, 0);
+    window_getMetric(METRIC_TEMPERATURE, &result);
+    CHECK_EQ(result.count, 3);
+
+    /*
+     * Odczyty bez poprawnej wartosci nie wchodza do sredniej, przedzial bez
+     * zadnego poprawnego odczytu nie dopisuje nic do okna
+     */
+    now += 3 * WINDOW_INTERVAL_MS;
+    values[METRIC_TEMPERATURE] = 0;
+    values[METRIC_PRESSURE] = 0;
+    window_addSample(now, values, METRIC_BIT(METRIC_TEMPERATURE) | METRIC_BIT(METRIC_PRESSURE));
+    values[METRIC_PRESSURE] = -40;
+    window_addSample(now + 1000, values, METRIC_BIT(METRIC_TEMPERATURE));
+    window_addSample(now + WINDOW_INTERVAL_MS, values, METRIC_BIT(METRIC_TEMPERATURE));
+    window_getMetric(METRIC_TEMPERATURE, &result);
+    CHECK_EQ(result.count, 3);
+    window_getMetric(METRIC_PRESSURE, &result);
+    CHECK_EQ(result.count, 4);
+    CHECK_EQ(result.min, -40);
+
+    window_getMetric(METRIC_NONE, &result);
+    CHECK_EQ(result.count, 0);
+    window_getMetric(METRIC_COUNT, &result);
+    CHECK_EQ(result.count, 0);
+}
+
+/*!
+ *  @brief    Pomiar czasu dopisania wartosci i odczytu wyniku
+ */
+static void bench(void)
+{
+    static int32_t values[4096];
+    window_t window;
+    window_result_t result;
+    volatile int32_t sink = 0;
+    const int loops = 20000000;
+    double start = 0;
+    uint64_t cycles = 0;
+    int i = 0;
+
+    for (i = 0; i < 4096; i++)
+    {
+        values[i] = (int32_t)(rng() % 2000001) - 1000000;
+    }
+
+    window_init(&window);
+    start = test_nowNs();
+    cycles = test_cycles();
+    for (i = 0; i < loops; i++)
+    {
+        window_push(&window, values[i & 4095]);
+    }
+    cycles = test_cycles() - cycles;
+    printf("bench window_push random: %.1f ns/push %.1f cycles/push\n", (test_nowNs() - start) / loops,
+            (double)cycles / loops);
+
+    window_init(&window);
+    start = test_nowNs();
+    for (i = 0; i < loops; i++)
+    {
+        window_push(&window, i);
+    }
+    printf("bench window_push rising: %.1f ns/push\n", (test_nowNs() - start) / loops);
+
+    start = test_nowNs();
+    for (i = 0; i < loops; i++)
+    {
+        window_get(&window, &result);
+        sink += result.mean;
+        window.sum += 1;
+    }
+    printf("bench window_get: %.1f ns/call\n", (test_nowNs() - start) / loops);
+    (void)sink;
+}
+
+int main(int argc, char* argv[])
+{
+    testBruteForce();
+    testIntervals();
+
+    if ((argc > 1) && (strcmp(argv[1], "-b") == 0))
+    {
+        bench();
+    }
+
+    return test_report("test_window");
+}
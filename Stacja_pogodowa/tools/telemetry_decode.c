@@ -0,0 +1,329 @@
+/*
+ * Dekoder binarnej telemetrii stacji pogodowej dla PC (Linux).
+ *
+ * Kompilacja:
+ *   gcc -Wall -O2 -o telemetry_decode telemetry_decode.c
+ * Uzycie:
+ *   stty -F /dev/ttyUSB0 115200 raw -echo
+ *   ./telemetry_decode < /dev/ttyUSB0
+ *   ./telemetry_decode -u 5005        (datagramy UDP z interfejsu Ethernet)
+ * Testy (wektory ramek z oczekiwanym wynikiem w tests/vectors):
+ *   make -C tests check
+ *
+ * Kazda poprawna ramka jest wypisywana jako linia CSV, ramki z blednym
+ * CRC lub niepoprawnym kodowaniem COBS sa zliczane i pomijane. Odczyty sa
+ * wypisywane jako linie "sample,nr,czas,temperatura,cisnienie,wilgotnosc,
+ * punkt rosy,wilgotnosc bezwzgledna,wskaznik upalu", zmiany stanu alarmow
+ * jako "alarm,nr,regula,stan,wielkosc,wartosc".
+ *
+ * Eksport dziennika (polecenie konsoli "export [strona]") jest wypisywany
+ * jako linie "log,czas,temperatura,cisnienie,wilgotnosc,punkt rosy,
+ * wilgotnosc bezwzgledna,natezenie swiatla". Strony innej wersji dziennika
+ * niz LOG_VERSION sa pomijane z komunikatem na stderr. Pola oznaczone przez
+ * stacje jako niepoprawne (blad czujnika) sa wypisywane jako puste. Postep
+ * eksportu jest wypisywany na stderr - po przerwaniu transmisji eksport mozna
+ * wznowic od ostatniej odebranej strony.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "../src/telemetry_frame.h"
+
+#define MAX_FRAME_SIZE 600
+
+/* Uklad strony dziennika (jak src/datalog.h) */
+#define LOG_VERSION          2
+#define LOG_PAGE_HEADER_SIZE 8
+#define LOG_RECORD_SIZE      20
+
+static unsigned long badFrames = 0;
+
+/*!
+ *  @brief    Funkcja obliczajaca sume kontrolna CRC-16/CCITT (jak src/crc.c)
+ */
+static uint16_t crc16(const uint8_t* pData, uint32_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (len > 0)
+    {
+        crc = (uint16_t)((crc >> 8) | (crc << 8));
+        crc ^= *pData;
+        crc ^= (crc & 0xFF) >> 4;
+        crc ^= (uint16_t)(crc << 12);
+        crc ^= (uint16_t)((crc & 0xFF) << 5);
+
+        pData++;
+        len--;
+    }
+
+    return crc;
+}
+
+/*!
+ *  @brief    Funkcja dekodujaca blok COBS (bez ogranicznika)
+ *  @returns  Dlugosc zdekodowanych danych lub -1 przy blednym kodowaniu
+ */
+static int cobsDecode(const uint8_t* pIn, uint32_t len, uint8_t* pOut)
+{
+    uint32_t in = 0;
+    uint32_t out = 0;
+
+    while (in < len)
+    {
+        uint8_t code = pIn[in++];
+        uint8_t i = 0;
+
+        if ((code == 0) || ((in + code - 1) > len))
+        {
+            return -1;
+        }
+
+        for (i = 1; i < code; i++)
+        {
+            pOut[out++] = pIn[in++];
+        }
+
+        if ((code != 0xFF) && (in < len))
+        {
+            pOut[out++] = 0;
+        }
+    }
+
+    return (int)out;
+}
+
+static uint16_t getU16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t* p)
+{
+    return getU16(p) | ((uint32_t)getU16(&p[2]) << 16);
+}
+
+/*!
+ *  @brief    Procedura wypisujaca wartosc w setnych lub dziesiatych czesciach
+ */
+static void printFixed(int value, int scale)
+{
+    printf(",%s%d.%0*d", (value < 0) ? "-" : "", abs(value) / scale, (scale == 100) ? 2 : 1,
+            abs(value) % scale);
+}
+
+/*!
+ *  @brief    Procedura wypisujaca pole CSV: puste, gdy bit pola jest w masce
+ *            niepoprawnych pol, liczbe calkowita dla skali 1 lub wartosc
+ *            w dziesiatych / setnych czesciach
+ */
+static void printField(uint8_t invalid, uint8_t bit, long value, int scale)
+{
+    if ((invalid & bit) != 0)
+    {
+        printf(",");
+    }
+    else if (scale == 1)
+    {
+        printf(",%ld", value);
+    }
+    else
+    {
+        printFixed((int)value, scale);
+    }
+}
+
+/*!
+ *  @brief    Procedura wypisujaca rekordy jednej strony dziennika z eksportu
+ */
+static void handleExport(const uint8_t* pRec, int len)
+{
+    uint32_t page = getU32(&pRec[0]);
+    uint32_t count = getU32(&pRec[4]);
+    uint16_t dataLen = getU16(&pRec[8]);
+    const uint8_t* pPage = &pRec[TELEMETRY_EXPORT_SIZE];
+    uint32_t i = 0;
+
+    if (len != TELEMETRY_EXPORT_SIZE + dataLen)
+    {
+        badFrames++;
+        return;
+    }
+
+    if (dataLen == 0)
+    {
+        fprintf(stderr, "export done, %lu pages\n", (unsigned long)count);
+        return;
+    }
+
+    /* Stacja eksportuje tylko strony biezacej wersji, inne nie maja znanego ukladu */
+    if ((dataLen < LOG_PAGE_HEADER_SIZE) || (pPage[4] != LOG_VERSION))
+    {
+        fprintf(stderr, "export page %lu: log version %u not supported\n", (unsigned long)page + 1,
+                (dataLen < LOG_PAGE_HEADER_SIZE) ? 0 : pPage[4]);
+        return;
+    }
+
+    for (i = 0; (i < pPage[5]) && (LOG_PAGE_HEADER_SIZE + (i + 1) * LOG_RECORD_SIZE <= dataLen); i++)
+    {
+        const uint8_t* pLog = &pPage[LOG_PAGE_HEADER_SIZE + i * LOG_RECORD_SIZE];
+        uint8_t invalid = pLog[18];
+
+        printf("log,%lu", (unsigned long)getU32(&pLog[0]));
+        printField(invalid, TELEMETRY_INVALID_TEMPERATURE, (int16_t)getU16(&pLog[8]), 10);
+        printField(invalid, TELEMETRY_INVALID_PRESSURE, (int32_t)getU32(&pLog[4]), 1);
+        printField(invalid, TELEMETRY_INVALID_HUMIDITY, (int16_t)getU16(&pLog[10]), 1);
+        printField(invalid, TELEMETRY_INVALID_DEW_POINT, (int16_t)getU16(&pLog[12]), 10);
+        printField(invalid, TELEMETRY_INVALID_DEW_POINT, getU16(&pLog[14]), 100);
+        printField(invalid, TELEMETRY_INVALID_LIGHT, getU16(&pLog[16]), 1);
+        printf("\n");
+    }
+
+    fprintf(stderr, "export page %lu/%lu\n", (unsigned long)page + 1, (unsigned long)count);
+}
+
+/*!
+ *  @brief    Procedura sprawdzajaca i wypisujaca jedna zdekodowana ramke
+ */
+static void handleFrame(const uint8_t* pFrame, int len)
+{
+    const uint8_t* pRec = &pFrame[TELEMETRY_HEADER_SIZE];
+    uint8_t invalid = 0;
+
+    if ((len < TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE)
+            || (crc16(pFrame, len - TELEMETRY_CRC_SIZE) != getU16(&pFrame[len - TELEMETRY_CRC_SIZE])))
+    {
+        badFrames++;
+        fprintf(stderr, "bad frame (%lu)\n", badFrames);
+        return;
+    }
+
+    switch (pFrame[0])
+    {
+        case TELEMETRY_REC_SAMPLE:
+        {
+            if (len != TELEMETRY_HEADER_SIZE + TELEMETRY_SAMPLE_SIZE + TELEMETRY_CRC_SIZE)
+            {
+                badFrames++;
+                return;
+            }
+            invalid = pRec[17];
+            printf("sample,%u,%lu", pFrame[1], (unsigned long)getU32(&pRec[0]));
+            printField(invalid, TELEMETRY_INVALID_TEMPERATURE, (int16_t)getU16(&pRec[4]), 10);
+            printField(invalid, TELEMETRY_INVALID_PRESSURE, (long)getU32(&pRec[6]), 1);
+            printField(invalid, TELEMETRY_INVALID_HUMIDITY, pRec[10], 1);
+            printField(invalid, TELEMETRY_INVALID_DEW_POINT, (int16_t)getU16(&pRec[11]), 10);
+            printField(invalid, TELEMETRY_INVALID_DEW_POINT, getU16(&pRec[13]), 100);
+            printField(invalid, TELEMETRY_INVALID_HEAT_INDEX, (int16_t)getU16(&pRec[15]), 10);
+            printf("\n");
+            break;
+        }
+        case TELEMETRY_REC_ALARM:
+        {
+            if (len != TELEMETRY_HEADER_SIZE + TELEMETRY_ALARM_SIZE + TELEMETRY_CRC_SIZE)
+            {
+                badFrames++;
+                return;
+            }
+            printf("alarm,%u,%u,%s,%u,%ld\n", pFrame[1], pRec[0], (pRec[1] != 0) ? "on" : "off",
+                    pRec[2], (long)(int32_t)getU32(&pRec[3]));
+            break;
+        }
+        case TELEMETRY_REC_EXPORT:
+        {
+            if (len < TELEMETRY_HEADER_SIZE + TELEMETRY_EXPORT_SIZE + TELEMETRY_CRC_SIZE)
+            {
+                badFrames++;
+                return;
+            }
+            handleExport(pRec, len - TELEMETRY_HEADER_SIZE - TELEMETRY_CRC_SIZE);
+            break;
+        }
+        default:
+        {
+            printf("unknown,%u,%u\n", pFrame[1], pFrame[0]);
+            break;
+        }
+    }
+
+    fflush(stdout);
+}
+
+/*!
+ *  @brief    Procedura odbierajaca datagramy UDP - kazdy zawiera jedna ramke
+ *            bez kodowania COBS
+ */
+static int receiveUdp(int port)
+{
+    uint8_t frame[MAX_FRAME_SIZE];
+    struct sockaddr_in addr;
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    ssize_t len = 0;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+
+    if ((sock < 0) || (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0))
+    {
+        perror("udp");
+        return 1;
+    }
+
+    while ((len = recv(sock, frame, sizeof(frame), 0)) >= 0)
+    {
+        handleFrame(frame, (int)len);
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    uint8_t encoded[MAX_FRAME_SIZE];
+    uint8_t frame[MAX_FRAME_SIZE];
+    uint32_t len = 0;
+    int c = 0;
+
+    if ((argc > 2) && (strcmp(argv[1], "-u") == 0))
+    {
+        return receiveUdp(atoi(argv[2]));
+    }
+
+    while ((c = getchar()) != EOF)
+    {
+        if (c != 0)
+        {
+            if (len < sizeof(encoded))
+            {
+                encoded[len] = (uint8_t)c;
+            }
+            len++;
+            continue;
+        }
+
+        if ((len > 0) && (len <= sizeof(encoded)))
+        {
+            int frameLen = cobsDecode(encoded, len, frame);
+
+            if (frameLen < 0)
+            {
+                badFrames++;
+            }
+            else
+            {
+                handleFrame(frame, frameLen);
+            }
+        }
+        len = 0;
+    }
+
+    return 0;
+}